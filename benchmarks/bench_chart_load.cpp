@@ -0,0 +1,206 @@
+// benchmarks/bench_chart_load.cpp — 谱面加载基准：JSON 解析 vs .skc 预编译缓存
+//
+// 用法：sakura-bench-chart-load [键盘音符数=10000] [重复次数=20]
+// 生成一张合成谱面（键盘音符 + 1/4 数量的鼠标音符），分别计时并统计堆峰值：
+//   dom    — nlohmann::json::parse 构建完整 DOM（旧解析路径的下限，不含拷贝到 ChartData）
+//   stream — ChartJsonStream::Parse（SAX 单遍填充 ChartData，有序时跳过排序）
+//   skc    — ChartLoader::LoadChartData 命中缓存（mmap + 定长记录解码）
+
+#include "game/chart_binary.h"
+#include "game/chart_json_stream.h"
+#include "game/chart_loader.h"
+#include "utils/logger.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace sakura::game;
+
+// ── 堆峰值统计（替换全局 operator new/delete，仅用于本基准）─────────────────
+
+namespace
+{
+
+std::atomic<size_t> g_liveBytes{ 0 };
+std::atomic<size_t> g_peakBytes{ 0 };
+
+// 每块前置 16 字节记录大小，保持 max_align_t 对齐
+constexpr size_t kHeaderSize = 16;
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    auto* raw = static_cast<unsigned char*>(std::malloc(size + kHeaderSize));
+    if (!raw) throw std::bad_alloc();
+    *reinterpret_cast<std::size_t*>(raw) = size;
+
+    const size_t live = g_liveBytes.fetch_add(size) + size;
+    size_t peak = g_peakBytes.load();
+    while (live > peak && !g_peakBytes.compare_exchange_weak(peak, live)) {}
+    return raw + kHeaderSize;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (!ptr) return;
+    auto* raw = static_cast<unsigned char*>(ptr) - kHeaderSize;
+    g_liveBytes.fetch_sub(*reinterpret_cast<std::size_t*>(raw));
+    std::free(raw);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace
+{
+
+void WriteSyntheticChart(const std::filesystem::path& path, int keyboardNotes)
+{
+    std::ofstream ofs(path, std::ios::trunc);
+    ofs << "{\n  \"version\": 2,\n";
+    ofs << "  \"timing_points\": [{ \"time\": 0, \"bpm\": 180.0, \"time_signature\": [4, 4] }],\n";
+    ofs << "  \"sv_points\": [";
+    for (int i = 0; i < 64; ++i)
+    {
+        ofs << (i ? ", " : "") << "{ \"time\": " << i * 4000
+            << ", \"speed\": " << (i % 2 ? 1.5 : 1.0) << ", \"easing\": \"linear\" }";
+    }
+    ofs << "],\n  \"keyboard_notes\": [\n";
+    for (int i = 0; i < keyboardNotes; ++i)
+    {
+        const bool hold = (i % 8 == 0);
+        ofs << "    { \"time\": " << i * 40 << ", \"lane\": " << i % 4
+            << ", \"type\": \"" << (hold ? "hold" : "tap") << "\", \"duration\": " << (hold ? 300 : 0) << " }"
+            << (i + 1 < keyboardNotes ? ",\n" : "\n");
+    }
+    ofs << "  ],\n  \"mouse_notes\": [\n";
+    const int mouseNotes = keyboardNotes / 4;
+    for (int i = 0; i < mouseNotes; ++i)
+    {
+        const bool slider = (i % 3 == 0);
+        ofs << "    { \"time\": " << i * 160 << ", \"x\": 0.25, \"y\": 0.5, \"type\": \""
+            << (slider ? "slider" : "circle") << "\"";
+        if (slider)
+            ofs << ", \"slider_duration\": 400, \"slider_path\": [[0.4, 0.5], [0.6, 0.6], [0.7, 0.4]]";
+        ofs << " }" << (i + 1 < mouseNotes ? ",\n" : "\n");
+    }
+    ofs << "  ]\n}\n";
+}
+
+template<typename Fn>
+double MeasureMedianMs(int iterations, Fn&& fn)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        fn();
+        const auto t1 = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// 执行 fn 并返回其间相对起点新增的堆峰值（字节）
+template<typename Fn>
+size_t MeasurePeakBytes(Fn&& fn)
+{
+    const size_t base = g_liveBytes.load();
+    g_peakBytes.store(base);
+    fn();
+    return g_peakBytes.load() - base;
+}
+
+std::string ReadText(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int noteCount  = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10000;
+    const int iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 20;
+
+    sakura::utils::Logger::Init("logs/sakura-bench.log");
+
+    const auto dir = std::filesystem::temp_directory_path() / "sakura-bench-chart-load";
+    std::filesystem::create_directories(dir);
+    const auto chartPath = dir / "expert.json";
+    WriteSyntheticChart(chartPath, noteCount);
+    std::filesystem::remove(ChartBinary::GetCachePath(chartPath.string()));
+
+    ChartLoader loader;
+
+    // 首次加载：解析 JSON 并生成缓存
+    const double coldMs = MeasureMedianMs(1, [&] { loader.LoadChartData(chartPath.string()); });
+
+    const std::string text = ReadText(chartPath);
+    const std::string source = chartPath.string();
+
+    size_t checksum = 0;
+    const double domMs = MeasureMedianMs(iterations, [&]
+    {
+        auto j = nlohmann::json::parse(text);
+        checksum += j["keyboard_notes"].size();
+    });
+    const double streamMs = MeasureMedianMs(iterations, [&]
+    {
+        auto data = ChartJsonStream::Parse(text, source);
+        checksum += data ? data->keyboardNotes.size() : 0;
+    });
+    const double skcMs = MeasureMedianMs(iterations, [&]
+    {
+        auto data = loader.LoadChartData(chartPath.string());
+        checksum += data ? data->keyboardNotes.size() : 0;
+    });
+
+    std::printf("chart: %d keyboard notes, %d mouse notes, json=%.1f KiB, skc=%.1f KiB\n",
+                noteCount, noteCount / 4,
+                static_cast<double>(std::filesystem::file_size(chartPath)) / 1024.0,
+                static_cast<double>(std::filesystem::file_size(ChartBinary::GetCachePath(chartPath.string()))) / 1024.0);
+    const size_t domPeak = MeasurePeakBytes([&]
+    {
+        auto j = nlohmann::json::parse(text);
+        checksum += j.size();
+    });
+    const size_t streamPeak = MeasurePeakBytes([&]
+    {
+        auto data = ChartJsonStream::Parse(text, source);
+        checksum += data ? data->mouseNotes.size() : 0;
+    });
+
+    std::printf("cold (json + write skc): %8.3f ms\n", coldMs);
+    std::printf("dom parse    (median):   %8.3f ms   peak heap %8.1f KiB\n",
+                domMs, static_cast<double>(domPeak) / 1024.0);
+    std::printf("stream parse (median):   %8.3f ms   peak heap %8.1f KiB\n",
+                streamMs, static_cast<double>(streamPeak) / 1024.0);
+    std::printf("skc mmap     (median):   %8.3f ms\n", skcMs);
+    std::printf("stream vs dom: %.1fx faster, %.1fx less peak heap; skc vs stream: %.1fx faster   (checksum %zu)\n",
+                domMs / std::max(streamMs, 1e-6),
+                static_cast<double>(domPeak) / static_cast<double>(std::max<size_t>(streamPeak, 1)),
+                streamMs / std::max(skcMs, 1e-6), checksum);
+
+    sakura::utils::Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,437 @@
+// benchmarks/bench_database.cpp — 成绩库基准：旧查询路径 vs 索引 + best_scores 物化表
+//
+// 用法：sakura-bench-database [成绩条数=100000] [谱面数=2000] [重复次数=20]
+// 先按迁移机制引入前的表结构（无索引、user_version = 0）批量写入合成成绩，再计时：
+//   legacy  — 每次 sqlite3_prepare_v2 + 相关子查询 MAX(score) / ORDER BY score LIMIT 1（旧实现），
+//             无索引的全量最高分仅在成绩数不超过 2 万时运行；迁移后再在 v2 索引上跑一次旧查询
+//   migrate — Database::Initialize 执行 v1–v5 迁移（建索引，回填 best_scores、player_aggregates、PP 与判定偏差 BLOB）
+//   cached  — Database::GetAllBestScores / GetBestScore（预编译语句缓存 + best_scores 主键查找）
+//   stats   — 统计页的 8 条全表聚合查询（旧实现） vs GetStatsSnapshot（player_aggregates 单行）
+// 最后追加若干局 SaveScore，分别统计每局立即提交的耗时，以及只入队（由数据库线程攒批提交）
+// 时调用线程的耗时；读取会先提交队列中的写入，代价与前者相同。
+// hit errors — 向单个谱面写入 200 局 × 1000 个判定偏差，比较 JSON 文本与 hit_errors BLOB 的字节数，
+//              以及按局解码为 vector 再两遍计算 UR（GetTopScores）与 GetHitErrorStats 流式累计的耗时。
+
+#include "data/database.h"
+#include "game/chart.h"
+#include "utils/logger.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using sakura::data::Database;
+
+namespace
+{
+
+constexpr const char* kDifficulties[] = { "Easy", "Normal", "Hard" };
+constexpr int kLegacyFullScanLimit = 20000;
+
+constexpr const char* SQL_LEGACY_SCHEMA = R"sql(
+CREATE TABLE scores (
+    id               INTEGER PRIMARY KEY AUTOINCREMENT,
+    chart_id         TEXT    NOT NULL,
+    chart_title      TEXT    NOT NULL DEFAULT '',
+    difficulty       TEXT    NOT NULL DEFAULT '',
+    difficulty_level REAL    NOT NULL DEFAULT 0.0,
+    score            INTEGER NOT NULL DEFAULT 0,
+    accuracy         REAL    NOT NULL DEFAULT 0.0,
+    max_combo        INTEGER NOT NULL DEFAULT 0,
+    grade            TEXT    NOT NULL DEFAULT 'D',
+    perfect_count    INTEGER NOT NULL DEFAULT 0,
+    great_count      INTEGER NOT NULL DEFAULT 0,
+    good_count       INTEGER NOT NULL DEFAULT 0,
+    bad_count        INTEGER NOT NULL DEFAULT 0,
+    miss_count       INTEGER NOT NULL DEFAULT 0,
+    is_full_combo    INTEGER NOT NULL DEFAULT 0,
+    is_all_perfect   INTEGER NOT NULL DEFAULT 0,
+    played_at        INTEGER NOT NULL DEFAULT 0,
+    hit_errors_json  TEXT    NOT NULL DEFAULT '[]'
+);
+CREATE TABLE statistics (key TEXT PRIMARY KEY NOT NULL, value REAL NOT NULL DEFAULT 0.0);
+CREATE TABLE achievements (id TEXT PRIMARY KEY NOT NULL, unlocked_at INTEGER NOT NULL DEFAULT 0);
+)sql";
+
+constexpr const char* SQL_LEGACY_INSERT = R"sql(
+    INSERT INTO scores (chart_id, chart_title, difficulty, difficulty_level,
+                        score, accuracy, max_combo, grade, perfect_count, miss_count,
+                        is_full_combo, played_at, hit_errors_json)
+    VALUES (?, ?, ?, ?, ?, ?, ?, 'A', ?, ?, ?, ?, '[-3,0,5]');
+)sql";
+
+// 与旧 Database::GetAllBestScores 相同
+constexpr const char* SQL_LEGACY_ALL_BEST = R"sql(
+    SELECT chart_id, chart_title, difficulty, difficulty_level,
+           score, accuracy, max_combo, grade,
+           perfect_count, great_count, good_count, bad_count, miss_count,
+           is_full_combo, is_all_perfect, played_at, hit_errors_json
+    FROM scores AS s1
+    WHERE score = (
+        SELECT MAX(score) FROM scores AS s2
+        WHERE s2.chart_id = s1.chart_id AND s2.difficulty = s1.difficulty
+    )
+    GROUP BY chart_id, difficulty
+    ORDER BY difficulty_level DESC;
+)sql";
+
+// 与旧 Database::GetBestScore 相同
+constexpr const char* SQL_LEGACY_BEST = R"sql(
+    SELECT chart_id, chart_title, difficulty, difficulty_level,
+           score, accuracy, max_combo, grade,
+           perfect_count, great_count, good_count, bad_count, miss_count,
+           is_full_combo, is_all_perfect, played_at, hit_errors_json
+    FROM scores
+    WHERE chart_id = ? AND difficulty = ?
+    ORDER BY score DESC
+    LIMIT 1;
+)sql";
+
+// 与旧统计页（SceneStats::RefreshData）依次执行的聚合查询相同
+constexpr const char* kLegacyStatsQueries[] = {
+    "SELECT COALESCE(MAX(score), 0) FROM scores;",
+    "SELECT COALESCE(MAX(accuracy), 0.0) FROM scores;",
+    "SELECT COALESCE(MAX(max_combo), 0) FROM scores;",
+    "SELECT COALESCE(AVG(accuracy), 0.0) FROM scores;",
+    "SELECT COALESCE(SUM(perfect_count + great_count + good_count + bad_count + miss_count), 0) FROM scores;",
+    "SELECT COUNT(*) FROM scores WHERE is_full_combo = 1;",
+    "SELECT COUNT(*) FROM scores WHERE is_all_perfect = 1;",
+    "SELECT grade, COUNT(*) FROM scores GROUP BY grade;",
+};
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template<typename Fn>
+double MeasureMedianMs(int iterations, Fn&& fn)
+{
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto t0 = Clock::now();
+        fn();
+        samples.push_back(ElapsedMs(t0));
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+std::string ChartId(int index)
+{
+    return "bench_chart_" + std::to_string(index);
+}
+
+void RemoveDatabaseFiles(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(path.string() + "-wal", ec);
+    std::filesystem::remove(path.string() + "-shm", ec);
+}
+
+// 以旧表结构建库并在单个事务内写入 rows 条合成成绩
+bool WriteLegacyDatabase(const std::filesystem::path& path, int rows, int charts)
+{
+    sqlite3* db = nullptr;
+    if (sqlite3_open(path.string().c_str(), &db) != SQLITE_OK)
+        return false;
+
+    bool ok = sqlite3_exec(db, SQL_LEGACY_SCHEMA, nullptr, nullptr, nullptr) == SQLITE_OK
+           && sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK;
+
+    sqlite3_stmt* stmt = nullptr;
+    ok = ok && sqlite3_prepare_v2(db, SQL_LEGACY_INSERT, -1, &stmt, nullptr) == SQLITE_OK;
+
+    std::mt19937 rng(20240615);
+    std::uniform_int_distribution<int> chartDist(0, charts - 1);
+    std::uniform_int_distribution<int> diffDist(0, 2);
+    std::uniform_int_distribution<int> scoreDist(0, 1000000);
+
+    for (int i = 0; ok && i < rows; ++i)
+    {
+        const std::string chartId = ChartId(chartDist(rng));
+        const int diff  = diffDist(rng);
+        const int score = scoreDist(rng);
+        sqlite3_bind_text  (stmt,  1, chartId.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text  (stmt,  2, chartId.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text  (stmt,  3, kDifficulties[diff], -1, SQLITE_STATIC);
+        sqlite3_bind_double(stmt,  4, 2.0 + diff * 3.0);
+        sqlite3_bind_int   (stmt,  5, score);
+        sqlite3_bind_double(stmt,  6, score / 10000.0);
+        sqlite3_bind_int   (stmt,  7, score / 1000);
+        sqlite3_bind_int   (stmt,  8, score / 2000);
+        sqlite3_bind_int   (stmt,  9, (1000000 - score) / 20000);
+        sqlite3_bind_int   (stmt, 10, score > 950000 ? 1 : 0);
+        sqlite3_bind_int64 (stmt, 11, 1700000000LL + i);
+        ok = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    ok = ok && sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+    sqlite3_close(db);
+    return ok;
+}
+
+// 按旧实现的方式执行：每次调用都重新 prepare / finalize
+size_t RunLegacyAllBest(sqlite3* db)
+{
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, SQL_LEGACY_ALL_BEST, -1, &stmt, nullptr) != SQLITE_OK)
+        return 0;
+    size_t rows = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        ++rows;
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+int RunLegacyBest(sqlite3* db, const std::string& chartId, const char* difficulty)
+{
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, SQL_LEGACY_BEST, -1, &stmt, nullptr) != SQLITE_OK)
+        return 0;
+    sqlite3_bind_text(stmt, 1, chartId.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, difficulty,      -1, SQLITE_STATIC);
+    int score = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+        score = sqlite3_column_int(stmt, 4);
+    sqlite3_finalize(stmt);
+    return score;
+}
+
+size_t RunLegacyStats(sqlite3* db)
+{
+    size_t checksum = 0;
+    for (const char* sql : kLegacyStatsQueries)
+    {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            continue;
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+            checksum += static_cast<size_t>(sqlite3_column_int64(stmt, sqlite3_column_count(stmt) - 1));
+        sqlite3_finalize(stmt);
+    }
+    return checksum;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const int rows       = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+    const int charts     = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2000;
+    const int iterations = argc > 3 ? std::max(1, std::atoi(argv[3])) : 20;
+
+    sakura::utils::Logger::Init("logs/sakura-bench.log");
+
+    const auto dir = std::filesystem::temp_directory_path() / "sakura-bench-database";
+    std::filesystem::create_directories(dir);
+    const auto dbPath = dir / "scores.db";
+    RemoveDatabaseFiles(dbPath);
+
+    auto t0 = Clock::now();
+    if (!WriteLegacyDatabase(dbPath, rows, charts))
+    {
+        std::fprintf(stderr, "failed to write synthetic database %s\n", dbPath.string().c_str());
+        return 1;
+    }
+    const double fillMs = ElapsedMs(t0);
+
+    // 单谱面查询：每次重复查询同一批随机 (chart, difficulty)
+    constexpr int kLookups = 200;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> chartDist(0, charts - 1);
+    std::uniform_int_distribution<int> diffDist(0, 2);
+    std::vector<std::pair<std::string, const char*>> lookups;
+    for (int i = 0; i < kLookups; ++i)
+        lookups.emplace_back(ChartId(chartDist(rng)), kDifficulties[diffDist(rng)]);
+
+    // ── 旧路径（无索引，直接连接） ─────────────────────────────────────────────
+    // 无索引时相关子查询随成绩数平方增长（1 万条约数秒），超过上限只跑单谱面查询
+    size_t checksum = 0;
+    double legacyAllMs = -1.0, legacyLookupMs = 0.0;
+    {
+        sqlite3* raw = nullptr;
+        if (sqlite3_open(dbPath.string().c_str(), &raw) != SQLITE_OK)
+            return 1;
+        if (rows <= kLegacyFullScanLimit)
+            legacyAllMs = MeasureMedianMs(1, [&] { checksum += RunLegacyAllBest(raw); });
+        legacyLookupMs = MeasureMedianMs(iterations, [&]
+        {
+            for (const auto& [chartId, diff] : lookups)
+                checksum += static_cast<size_t>(RunLegacyBest(raw, chartId, diff));
+        });
+        sqlite3_close(raw);
+    }
+
+    // ── 迁移 + 新路径 ─────────────────────────────────────────────────────────
+    auto& db = Database::GetInstance();
+    t0 = Clock::now();
+    if (!db.Initialize(dbPath.string()))
+        return 1;
+    const double migrateMs = ElapsedMs(t0);
+
+    // 旧查询在 v2 索引上的耗时（区分索引与物化表各自的贡献）
+    double indexedAllMs = 0.0, legacyStatsMs = 0.0;
+    {
+        sqlite3* raw = nullptr;
+        if (sqlite3_open(dbPath.string().c_str(), &raw) != SQLITE_OK)
+            return 1;
+        indexedAllMs = MeasureMedianMs(std::min(iterations, 5), [&] { checksum += RunLegacyAllBest(raw); });
+        legacyStatsMs = MeasureMedianMs(iterations, [&] { checksum += RunLegacyStats(raw); });
+        sqlite3_close(raw);
+    }
+
+    size_t bestCount = 0;
+    const double cachedAllMs = MeasureMedianMs(iterations, [&]
+    {
+        bestCount = db.GetAllBestScores().size();
+        checksum += bestCount;
+    });
+    const double cachedLookupMs = MeasureMedianMs(iterations, [&]
+    {
+        for (const auto& [chartId, diff] : lookups)
+            if (auto best = db.GetBestScore(chartId, diff))
+                checksum += static_cast<size_t>(best->score);
+    });
+
+    const double cachedStatsMs = MeasureMedianMs(iterations, [&]
+    {
+        const auto snapshot = db.GetStatsSnapshot();
+        checksum += static_cast<size_t>(snapshot.notesJudged + snapshot.highestScore);
+    });
+
+    // ── 追加写入 ──────────────────────────────────────────────────────────────
+    const int saves = std::min(iterations * 10, 200);
+    int saveIndex = 0;
+    auto nextResult = [&]
+    {
+        sakura::game::GameResult r;
+        r.chartId      = ChartId(chartDist(rng));
+        r.chartTitle   = r.chartId;
+        r.difficulty   = kDifficulties[diffDist(rng)];
+        r.score        = 900000 + saveIndex;
+        r.accuracy     = 95.0f;
+        r.playedAt     = 1800000000LL + saveIndex++;
+        r.hitErrors    = { -3, 0, 5 };
+        return r;
+    };
+
+    // 每局单独提交（旧行为：调用线程等待一次 WAL 同步）
+    const double saveMs = MeasureMedianMs(saves, [&]
+    {
+        auto saved = db.SaveScore(nextResult());
+        db.Flush();
+        checksum += saved.get() ? 1 : 0;
+    });
+
+    // 结算场景调用线程付出的代价：入队成绩与统计，提交留给数据库线程
+    const double enqueueMs = MeasureMedianMs(saves, [&]
+    {
+        db.SaveScore(nextResult());
+        db.IncrementStatistic("bench_retry_count");
+    });
+    db.Flush();
+
+    // ── 判定偏差存储与按谱面 UR ───────────────────────────────────────────────
+    constexpr int kHitErrorPlays = 200;
+    constexpr int kHitErrorNotes = 1000;
+    const std::string hitChart = "bench_hit_errors";
+    std::normal_distribution<double> errorDist(3.0, 28.0);
+    size_t jsonBytes = 0;
+    for (int i = 0; i < kHitErrorPlays; ++i)
+    {
+        auto r = nextResult();
+        r.chartId    = hitChart;
+        r.difficulty = "Hard";
+        r.hitErrors.resize(kHitErrorNotes);
+        for (int& err : r.hitErrors)
+        {
+            err = static_cast<int>(std::lround(std::clamp(errorDist(rng), -150.0, 150.0)));
+            jsonBytes += std::to_string(err).size() + 1;   // 数字 + 逗号 / 括号
+        }
+        jsonBytes += 1;
+        db.SaveScore(r);
+    }
+    db.Flush();
+
+    long long blobBytes = 0;
+    {
+        sqlite3* raw = nullptr;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_open(dbPath.string().c_str(), &raw) == SQLITE_OK
+            && sqlite3_prepare_v2(raw, "SELECT SUM(LENGTH(hit_errors)) FROM scores WHERE chart_id = ?;",
+                                  -1, &stmt, nullptr) == SQLITE_OK)
+        {
+            sqlite3_bind_text(stmt, 1, hitChart.c_str(), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(stmt) == SQLITE_ROW)
+                blobBytes = sqlite3_column_int64(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(raw);
+    }
+
+    double decodedUr = 0.0, streamedUr = 0.0;
+    const double decodedUrMs = MeasureMedianMs(iterations, [&]
+    {
+        const auto plays = db.GetTopScores(hitChart, "Hard", kHitErrorPlays);
+        double sum = 0.0, count = 0.0, squares = 0.0;
+        for (const auto& play : plays)
+            for (int err : play.hitErrors) { sum += err; count += 1.0; }
+        const double mean = count > 0.0 ? sum / count : 0.0;
+        for (const auto& play : plays)
+            for (int err : play.hitErrors) squares += (err - mean) * (err - mean);
+        decodedUr = count > 0.0 ? std::sqrt(squares / count) * 10.0 : 0.0;
+    });
+    const double streamedUrMs = MeasureMedianMs(iterations, [&]
+    {
+        streamedUr = db.GetHitErrorStats(hitChart, "Hard").UnstableRate();
+    });
+    checksum += static_cast<size_t>(std::lround(decodedUr + streamedUr));
+
+    db.Shutdown();
+    RemoveDatabaseFiles(dbPath);
+
+    std::printf("db: %d scores over %d charts x 3 difficulties, %zu best entries, fill %.1f ms\n",
+                rows, charts, bestCount, fillMs);
+    std::printf("migrate to v5 (schema + backfills):     %9.3f ms\n", migrateMs);
+    if (legacyAllMs >= 0.0)
+        std::printf("all best   legacy, no index:            %9.3f ms\n", legacyAllMs);
+    else
+        std::printf("all best   legacy, no index:            skipped (O(n^2), rerun with <= %d scores)\n",
+                    kLegacyFullScanLimit);
+    std::printf("all best   legacy, v2 indexes (median): %9.3f ms\n", indexedAllMs);
+    std::printf("all best   cached (median):             %9.3f ms\n", cachedAllMs);
+    std::printf("%d lookups legacy (median):            %9.3f ms\n", kLookups, legacyLookupMs);
+    std::printf("%d lookups cached (median):            %9.3f ms\n", kLookups, cachedLookupMs);
+    std::printf("stats page legacy, 8 scans (median):    %9.3f ms\n", legacyStatsMs);
+    std::printf("stats page GetStatsSnapshot (median):   %9.3f ms\n", cachedStatsMs);
+    std::printf("SaveScore + commit (median of %d):     %9.3f ms\n", saves, saveMs);
+    std::printf("SaveScore write-behind enqueue (median):%9.3f ms\n", enqueueMs);
+    std::printf("hit errors %d x %d: JSON %zu bytes, BLOB %lld bytes (%.2f bytes/note)\n",
+                kHitErrorPlays, kHitErrorNotes, jsonBytes, blobBytes,
+                static_cast<double>(blobBytes) / (kHitErrorPlays * kHitErrorNotes));
+    std::printf("chart UR decode to vectors (median):    %9.3f ms   (UR %.3f)\n", decodedUrMs, decodedUr);
+    std::printf("chart UR GetHitErrorStats (median):     %9.3f ms   (UR %.3f)\n", streamedUrMs, streamedUr);
+    std::printf("all best: %.1fx faster than indexed legacy; lookups: %.1fx faster   (checksum %zu)\n",
+                indexedAllMs / std::max(cachedAllMs, 1e-6),
+                legacyLookupMs / std::max(cachedLookupMs, 1e-6), checksum);
+
+    sakura::utils::Logger::Shutdown();
+    return 0;
+}
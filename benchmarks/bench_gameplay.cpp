@@ -0,0 +1,91 @@
+// benchmarks/bench_gameplay.cpp — 无界面对局吞吐基准
+//
+// 用法：sakura-bench-gameplay [tick 频率=1000] [音符数...=10000 100000 1000000]
+// 对每个规模生成合成谱面（20% 鼠标音符），用自动演奏脚本（±30ms 伪随机偏差）
+// 以虚拟时钟跑完整局，报告每 tick 开销分位数、每 tick 堆分配次数与最终结算。
+
+#include "game/gameplay_sim.h"
+#include "utils/logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace sakura::game;
+
+// ── 分配计数（替换全局 operator new/delete，仅用于本基准）─────────────────────
+
+namespace
+{
+
+std::atomic<uint64_t> g_allocations{ 0 };
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char** argv)
+{
+    const double tickHz = argc > 1 ? std::max(1.0, std::atof(argv[1])) : 1000.0;
+    std::vector<size_t> sizes;
+    for (int i = 2; i < argc; ++i)
+        sizes.push_back(static_cast<size_t>(std::max(1, std::atoi(argv[i]))));
+    if (sizes.empty())
+        sizes = { 10000, 100000, 1000000 };
+
+    sakura::utils::Logger::Init("logs/sakura-bench.log");
+
+    std::printf("tick rate: %.0f Hz\n", tickHz);
+    std::printf("%9s %10s %9s | %8s %8s %8s %9s | %10s | %9s %8s %7s %6s\n",
+                "notes", "ticks", "sim s", "p50 ns", "p90 ns", "p99 ns", "max ns",
+                "allocs/tk", "wall ms", "score", "acc%", "miss");
+
+    for (size_t count : sizes)
+    {
+        SyntheticChartOptions opt;
+        opt.noteCount = count;
+        const auto genStart = std::chrono::steady_clock::now();
+        const auto chart    = GenerateSyntheticChart(opt);
+        const auto script   = BuildAutoplayScript(chart, 30.0, 42);
+        const double genMs  = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - genStart).count();
+
+        GameplaySimulator sim(chart);
+        SimulationOptions simOpt;
+        simOpt.tickRateHz        = tickHz;
+        simOpt.allocationCounter = [] { return g_allocations.load(std::memory_order_relaxed); };
+        const auto r = sim.Run(script, simOpt);
+
+        std::printf("%9zu %10zu %9.1f | %8.0f %8.0f %8.0f %9.0f | %10.4f | %9.1f %8d %7.2f %6d\n",
+                    count, r.ticks, r.simulatedMs / 1000.0,
+                    r.tickNsP50, r.tickNsP90, r.tickNsP99, r.tickNsMax,
+                    r.allocationsPerTick, r.wallMs,
+                    r.result.score, r.result.accuracy, r.result.missCount);
+        std::printf("          (chart + script generated in %.1f ms; %zu inputs, %zu events, "
+                    "P/G/Gd/B/M = %d/%d/%d/%d/%d, max combo %d)\n",
+                    genMs, r.inputs, r.events,
+                    r.result.perfectCount, r.result.greatCount, r.result.goodCount,
+                    r.result.badCount, r.result.missCount, r.result.maxCombo);
+    }
+
+    sakura::utils::Logger::Shutdown();
+    return 0;
+}
@@ -0,0 +1,263 @@
+// benchmarks/bench_particles.cpp — 粒子系统基准：旧 AoS 对象池 vs SoA 粒子池
+//
+// 用法：sakura-bench-particles [粒子数=50000] [帧数=600]
+// 每帧补满到目标粒子数（寿命 0.5~2s，持续有死亡与发射），随后积分并生成渲染几何。
+//   旧：AoS 定长数组 + 线性扫描空槽 + 遍历全部槽位 + 每个圆单独建顶点并提交一次
+//   新：ParticlePool（SoA、稠密区间、SIMD 积分）+ 全部粒子写入单个图元
+// 形状比例：80% 圆、20% 樱花混合（其中 30% 整朵樱花），与游戏内命中 / 飘落特效相近。
+// ParticleSystem 本身依赖 SDL 渲染器，这里直接驱动其存储核心与等价的旧实现。
+
+#include "core/geometry_batch.h"
+#include "effects/particle_pool.h"
+#include "utils/simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace sakura::effects;
+using sakura::core::BatchVertex;
+using sakura::core::FlushReason;
+using sakura::core::GeometryBatch;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr float SCREEN_W = 1920.0f;
+constexpr float SCREEN_H = 1080.0f;
+constexpr float DT       = 1.0f / 240.0f;
+constexpr float kPi      = std::numbers::pi_v<float>;
+
+double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+ParticleSpawn RandomSpawn(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.0f, 1.0f);
+    ParticleSpawn s;
+    s.x = u(rng);
+    s.y = u(rng);
+    s.vx = (u(rng) - 0.5f) * 0.3f;
+    s.vy = -u(rng) * 0.4f;
+    s.ay = 0.3f;
+    s.size = 0.003f + u(rng) * 0.01f;
+    s.sizeEnd = s.size * 0.2f;
+    s.rotation = u(rng) * 360.0f;
+    s.rotSpeed = (u(rng) - 0.5f) * 360.0f;
+    s.life = 0.5f + u(rng) * 1.5f;
+    const float shape = u(rng);
+    s.kind = shape < 0.8f ? ParticleKind::Circle
+           : shape < 0.86f ? ParticleKind::Blossom : ParticleKind::Petal;
+    s.colorStart = { 255, 220, 120, 240 };
+    s.colorEnd   = { 255, 200,  80,   0 };
+    return s;
+}
+
+// ── 旧实现（与重构前的 ParticleSystem 等价）──────────────────────────────────
+
+struct LegacyParticle
+{
+    float x = 0, y = 0, vx = 0, vy = 0, ax = 0, ay = 0;
+    float size = 0, sizeEnd = 0, rotation = 0, rotSpeed = 0, life = 0, maxLife = 0, shapeSeed = 0;
+    ParticleKind kind = ParticleKind::Circle;
+    ParticleRgba colorStart, colorEnd;
+    bool active = false;
+};
+
+struct LegacySystem
+{
+    std::vector<LegacyParticle> pool;
+    int drawCalls = 0;
+
+    explicit LegacySystem(size_t capacity) : pool(capacity) {}
+
+    bool Spawn(const ParticleSpawn& s)
+    {
+        for (auto& p : pool)   // 线性扫描空槽
+        {
+            if (p.active) continue;
+            p = { s.x, s.y, s.vx, s.vy, s.ax, s.ay, s.size, s.sizeEnd, s.rotation, s.rotSpeed,
+                  s.life, s.life, 0.0f, s.kind, s.colorStart, s.colorEnd, true };
+            return true;
+        }
+        return false;
+    }
+
+    size_t Update(float dt)
+    {
+        size_t active = 0;
+        for (auto& p : pool)
+        {
+            if (!p.active) continue;
+            p.life -= dt;
+            if (p.life <= 0.0f) { p.active = false; continue; }
+            p.vx += p.ax * dt;
+            p.vy += p.ay * dt;
+            p.x  += p.vx * dt;
+            p.y  += p.vy * dt;
+            p.rotation += p.rotSpeed * dt;
+            ++active;
+        }
+        return active;
+    }
+
+    // 与旧 Renderer::DrawCircleFilled 相同：每个圆临时分配顶点并单独提交
+    void Circle(float cx, float cy, float r, int segments, float& sink)
+    {
+        std::vector<BatchVertex> verts;
+        std::vector<int> indices;
+        verts.reserve(static_cast<size_t>(segments + 2));
+        indices.reserve(static_cast<size_t>(segments * 3));
+        verts.push_back({ cx * SCREEN_W, cy * SCREEN_H });
+        const float step = 2.0f * kPi / static_cast<float>(segments);
+        for (int i = 0; i <= segments; ++i)
+        {
+            const float a = step * static_cast<float>(i);
+            verts.push_back({ cx * SCREEN_W + std::cos(a) * r * SCREEN_H,
+                              cy * SCREEN_H + std::sin(a) * r * SCREEN_H });
+            if (i > 0)
+            {
+                indices.push_back(0);
+                indices.push_back(i);
+                indices.push_back(i + 1);
+            }
+        }
+        sink += verts.back().x + static_cast<float>(indices.size());
+        ++drawCalls;
+    }
+
+    void Render(float& sink)
+    {
+        for (const auto& p : pool)
+        {
+            if (!p.active) continue;
+            const float t  = 1.0f - p.life / p.maxLife;
+            const float sz = p.size + (p.sizeEnd - p.size) * t;
+            if (p.kind == ParticleKind::Circle)
+            {
+                Circle(p.x, p.y, sz, 8, sink);
+                continue;
+            }
+            const float rad = p.rotation * kPi / 180.0f;
+            const float c = std::cos(rad), s = std::sin(rad);
+            if (p.kind == ParticleKind::Blossom)
+            {
+                for (int k = 0; k < 5; ++k)
+                {
+                    const float a = 2.0f * kPi * static_cast<float>(k) / 5.0f;
+                    Circle(p.x + (c * std::cos(a) - s * std::sin(a)) * sz * 0.68f,
+                           p.y + (s * std::cos(a) + c * std::sin(a)) * sz * 0.68f * 0.82f,
+                           sz * 0.58f, 10, sink);
+                }
+                Circle(p.x, p.y, sz * 0.36f, 8, sink);
+            }
+            else
+            {
+                Circle(p.x + c * sz * 0.45f, p.y + s * 0.82f * sz * 0.45f, sz * 0.62f, 10, sink);
+                Circle(p.x - c * sz * 0.18f, p.y - s * 0.82f * sz * 0.18f, sz * 0.46f, 10, sink);
+            }
+        }
+    }
+};
+
+struct Result
+{
+    double emitMs   = 0.0;
+    double updateMs = 0.0;
+    double renderMs = 0.0;
+    double drawCallsPerFrame = 0.0;
+};
+
+void Print(const char* name, const Result& r, int frames)
+{
+    const double total = (r.emitMs + r.updateMs + r.renderMs) / frames;
+    std::printf("%-8s %10.3f %10.3f %10.3f %10.3f %12.0f\n", name,
+                r.emitMs / frames, r.updateMs / frames, r.renderMs / frames, total,
+                r.drawCallsPerFrame);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const size_t target = argc > 1 ? static_cast<size_t>(std::max(1, std::atoi(argv[1]))) : 50000;
+    const int    frames = argc > 2 ? std::max(1, std::atoi(argv[2])) : 600;
+
+    std::printf("particles: %zu, frames: %d, dt %.4f s, SIMD: %s x%zu\n\n",
+                target, frames, DT, sakura::utils::simd::FloatV::Name,
+                sakura::utils::simd::FloatV::Width);
+
+    float sink = 0.0f;
+
+    // ── 旧：AoS ──────────────────────────────────────────────────────────────
+    Result legacy;
+    {
+        std::mt19937 rng(42);
+        LegacySystem sys(target);
+        size_t active = 0;
+        for (int f = 0; f < frames; ++f)
+        {
+            auto start = Clock::now();
+            while (active < target && sys.Spawn(RandomSpawn(rng))) ++active;
+            legacy.emitMs += ElapsedMs(start);
+
+            start = Clock::now();
+            active = sys.Update(DT);
+            legacy.updateMs += ElapsedMs(start);
+
+            sys.drawCalls = 0;
+            start = Clock::now();
+            sys.Render(sink);
+            legacy.renderMs += ElapsedMs(start);
+            legacy.drawCallsPerFrame += sys.drawCalls;
+        }
+        legacy.drawCallsPerFrame /= frames;
+    }
+
+    // ── 新：SoA 粒子池 ────────────────────────────────────────────────────────
+    Result soa;
+    {
+        std::mt19937 rng(42);
+        ParticlePool pool(target);
+        GeometryBatch batch([&](void*, const BatchVertex* v, int vc, const int*, int ic) {
+            sink += v[vc - 1].x + static_cast<float>(ic);
+        });
+        for (int f = 0; f < frames; ++f)
+        {
+            auto start = Clock::now();
+            while (pool.Spawn(RandomSpawn(rng))) {}
+            soa.emitMs += ElapsedMs(start);
+
+            start = Clock::now();
+            pool.Update(DT);
+            soa.updateMs += ElapsedMs(start);
+
+            batch.ResetStats();
+            start = Clock::now();
+            pool.AppendGeometry(batch, SCREEN_W, SCREEN_H);
+            batch.Flush(FlushReason::FrameEnd);
+            soa.renderMs += ElapsedMs(start);
+            soa.drawCallsPerFrame += batch.GetStats().drawCalls;
+        }
+        soa.drawCallsPerFrame /= frames;
+    }
+
+    std::printf("%-8s %10s %10s %10s %10s %12s\n", "mode", "emit ms", "update ms", "geom ms", "total ms", "draws/frame");
+    Print("AoS", legacy, frames);
+    Print("SoA", soa, frames);
+    std::printf("\nupdate speedup: %.1fx, total speedup: %.1fx (checksum %.1f)\n",
+                legacy.updateMs / std::max(soa.updateMs, 1e-9),
+                (legacy.emitMs + legacy.updateMs + legacy.renderMs)
+                    / std::max(soa.emitMs + soa.updateMs + soa.renderMs, 1e-9),
+                static_cast<double>(sink));
+    return 0;
+}
@@ -0,0 +1,139 @@
+// benchmarks/bench_visualizer.cpp — 可视化频带来源基准：实时 FFT vs 离线频谱缓存
+//
+// 用法：sakura-bench-visualizer [歌曲秒数=180] [帧率=60]
+// 模拟主菜单播放背景音乐时可视化的每秒开销（SceneMenu 依赖 SDL，这里以无界面方式复现其负载）：
+//   实时：分析线程 100Hz × (取窗 + 1024 点 FFT + 频带)
+//   缓存：主线程 帧率 × 时间轴插值 + 分析线程 100Hz × 波形抽样（不做 FFT）
+// 另报告一次性离线分析（整首歌）与缓存文件读写耗时。
+
+#include "audio/spectral_cache.h"
+#include "utils/logger.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <vector>
+
+using namespace sakura::audio;
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t RATE        = 44100;
+constexpr int      ANALYSIS_HZ = 100;
+
+double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 合成“音乐”：底鼓 + 和弦 + 高频噪声，足以让各频带都有能量
+std::vector<float> SynthesizeSong(double seconds)
+{
+    const size_t count = static_cast<size_t>(seconds * RATE);
+    std::vector<float> mono(count);
+    uint32_t noise = 1;
+    constexpr float twoPi = 2.0f * std::numbers::pi_v<float>;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float t    = static_cast<float>(i) / RATE;
+        const float beat = std::fmod(t, 0.5f);
+        noise = noise * 1664525u + 1013904223u;
+        const float white = static_cast<float>(noise >> 8) / 8388608.0f - 1.0f;
+        mono[i] = 0.5f * std::exp(-beat * 18.0f) * std::sin(twoPi * 55.0f * t)
+                + 0.15f * (std::sin(twoPi * 261.6f * t) + std::sin(twoPi * 329.6f * t) + std::sin(twoPi * 392.0f * t))
+                + 0.05f * white;
+    }
+    return mono;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const double seconds = argc > 1 ? std::max(1.0, std::atof(argv[1])) : 180.0;
+    const double fps     = argc > 2 ? std::max(1.0, std::atof(argv[2])) : 60.0;
+
+    sakura::utils::Logger::Init("logs/sakura-bench.log");
+
+    const auto mono = SynthesizeSong(seconds);
+    std::printf("song: %.0f s @ %u Hz mono, render %.0f fps, analysis %d Hz\n\n",
+                seconds, RATE, fps, ANALYSIS_HZ);
+
+    // ── 一次性成本：离线分析 + 缓存读写 ──────────────────────────────────────
+    auto start = Clock::now();
+    const auto timeline = SpectralCache::Build(mono.data(), mono.size(), RATE);
+    const double buildMs = ElapsedMs(start);
+
+    const auto dir = std::filesystem::temp_directory_path() / "sakura-bench-visualizer";
+    const auto cachePath = SpectralCache::GetCachePath(dir.string(), 0x5A4B5552u);
+    start = Clock::now();
+    SpectralCache::Write(cachePath, timeline, 0x5A4B5552u);
+    const double writeMs = ElapsedMs(start);
+    start = Clock::now();
+    const auto loaded = SpectralCache::Read(cachePath, 0x5A4B5552u);
+    const double readMs = ElapsedMs(start);
+    std::filesystem::remove_all(dir);
+
+    std::printf("offline build : %8.1f ms (%zu frames, %.1f KB)\n",
+                buildMs, timeline.GetFrameCount(), static_cast<double>(timeline.levels.size()) / 1024.0);
+    std::printf("cache write   : %8.2f ms\n", writeMs);
+    std::printf("cache read    : %8.2f ms (%s)\n\n", readMs, loaded ? "ok" : "FAILED");
+
+    // ── 每秒播放的稳态开销 ────────────────────────────────────────────────────
+    SpectrumAnalyzer analyzer(RATE);
+    SpectrumFrame    frame;
+    const size_t     window = SpectrumAnalyzer::WINDOW;
+    const size_t     analysisCount = static_cast<size_t>(seconds * ANALYSIS_HZ);
+    const size_t     renderCount   = static_cast<size_t>(seconds * fps);
+    float sink = 0.0f;
+
+    // 实时：每个分析周期对最新窗口做 FFT
+    start = Clock::now();
+    for (size_t i = 0; i < analysisCount; ++i)
+    {
+        const size_t end = std::min(mono.size(), window + i * RATE / ANALYSIS_HZ);
+        analyzer.Analyze(mono.data() + end - window, frame);
+        sink += frame.bands[i % SpectrumFrame::BAND_COUNT];
+    }
+    const double liveMs = ElapsedMs(start);
+
+    // 缓存：每渲染帧插值一次 + 每分析周期只抽取波形
+    std::array<float, SpectralTimeline::BAND_COUNT> bands{};
+    start = Clock::now();
+    for (size_t i = 0; i < renderCount; ++i)
+    {
+        timeline.Sample(static_cast<double>(i) / fps, bands);
+        sink += bands[i % SpectralTimeline::BAND_COUNT];
+    }
+    const double sampleMs = ElapsedMs(start);
+    start = Clock::now();
+    for (size_t i = 0; i < analysisCount; ++i)
+    {
+        const size_t end = std::min(mono.size(), window + i * RATE / ANALYSIS_HZ);
+        analyzer.SampleWaveform(mono.data() + end - window, frame);
+        sink += frame.waveform[i % SpectrumFrame::WAVE_POINTS];
+    }
+    const double waveMs = ElapsedMs(start);
+    const double cachedMs = sampleMs + waveMs;
+
+    std::printf("%-8s %14s %14s %12s\n", "mode", "us / playback s", "ns / op", "core %");
+    std::printf("%-8s %14.1f %14.0f %11.4f%%\n", "live",
+                liveMs * 1000.0 / seconds, liveMs * 1e6 / static_cast<double>(analysisCount),
+                liveMs / (seconds * 1000.0) * 100.0);
+    std::printf("%-8s %14.1f %14.0f %11.4f%%   (sample %.0f ns + waveform %.0f ns)\n", "cached",
+                cachedMs * 1000.0 / seconds, sampleMs * 1e6 / static_cast<double>(renderCount),
+                cachedMs / (seconds * 1000.0) * 100.0,
+                sampleMs * 1e6 / static_cast<double>(renderCount),
+                waveMs * 1e6 / static_cast<double>(analysisCount));
+    std::printf("\nspeedup: %.1fx (checksum %.3f)\n", liveMs / std::max(cachedMs, 1e-9), sink);
+
+    sakura::utils::Logger::Shutdown();
+    return 0;
+}
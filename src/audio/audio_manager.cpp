@@ -17,6 +17,77 @@
 namespace sakura::audio
 {
 
+// ── 常驻混音数据源 ────────────────────────────────────────────────────────────
+// 自定义 ma_data_source：音频线程读取时由 VoicePool 混合所有活动发声。
+// 格式与引擎一致（f32 / 引擎声道数 / 引擎采样率），引擎无需重采样。
+
+struct VoiceSource
+{
+    ma_data_source_base base;       // 须为首成员
+    VoicePool*          pool       = nullptr;
+    ma_uint32           channels   = 2;
+    ma_uint32           sampleRate = 48000;
+    ma_uint64           cursor     = 0;
+};
+
+namespace
+{
+
+ma_result VoiceSourceRead(ma_data_source* ds, void* framesOut, ma_uint64 frameCount, ma_uint64* framesRead)
+{
+    auto* src = static_cast<VoiceSource*>(ds);
+    src->pool->Mix(static_cast<float*>(framesOut), static_cast<size_t>(frameCount));
+    src->cursor += frameCount;
+    if (framesRead) *framesRead = frameCount;
+    return MA_SUCCESS;
+}
+
+ma_result VoiceSourceSeek(ma_data_source* ds, ma_uint64 frameIndex)
+{
+    static_cast<VoiceSource*>(ds)->cursor = frameIndex;
+    return MA_SUCCESS;
+}
+
+ma_result VoiceSourceGetFormat(ma_data_source* ds, ma_format* format, ma_uint32* channels,
+                               ma_uint32* sampleRate, ma_channel* /*channelMap*/, size_t /*channelMapCap*/)
+{
+    const auto* src = static_cast<const VoiceSource*>(ds);
+    if (format)     *format     = ma_format_f32;
+    if (channels)   *channels   = src->channels;
+    if (sampleRate) *sampleRate = src->sampleRate;
+    return MA_SUCCESS;
+}
+
+ma_result VoiceSourceGetCursor(ma_data_source* ds, ma_uint64* cursor)
+{
+    *cursor = static_cast<const VoiceSource*>(ds)->cursor;
+    return MA_SUCCESS;
+}
+
+ma_result VoiceSourceGetLength(ma_data_source* /*ds*/, ma_uint64* length)
+{
+    *length = 0;   // 无限流
+    return MA_NOT_IMPLEMENTED;
+}
+
+// 引擎输出回调（音频线程）：把最终混音送给可视化分析的抽头
+void EngineOutputTap(void* /*userData*/, float* framesOut, ma_uint64 frameCount)
+{
+    AudioVisualizer::GetInstance().FeedOutput(framesOut, static_cast<size_t>(frameCount));
+}
+
+ma_data_source_vtable g_voiceSourceVTable = {
+    VoiceSourceRead,
+    VoiceSourceSeek,
+    VoiceSourceGetFormat,
+    VoiceSourceGetCursor,
+    VoiceSourceGetLength,
+    nullptr,   // onSetLooping
+    0
+};
+
+} // namespace
+
 // ── 析构 ──────────────────────────────────────────────────────────────────────
 
 AudioManager::~AudioManager()
@@ -54,7 +125,8 @@ bool AudioManager::Initialize()
     // 创建 ma_engine
     m_engine = new ma_engine();
     ma_engine_config engineConfig = ma_engine_config_init();
-    // 使用默认设备和格式
+    // 使用默认设备和格式；引擎输出经 onProcess 抽头送给可视化分析线程
+    engineConfig.onProcess = EngineOutputTap;
 
     ma_result result = ma_engine_init(&engineConfig, m_engine);
     if (result != MA_SUCCESS)
@@ -68,6 +140,16 @@ bool AudioManager::Initialize()
     // 设置主音量
     ma_engine_set_volume(m_engine, m_masterVolume);
 
+    // 引擎格式在初始化后才确定；分析线程启动前抽头回调直接忽略输出
+    AudioVisualizer::GetInstance().StartAnalysis(ma_engine_get_sample_rate(m_engine),
+                                                 ma_engine_get_channels(m_engine));
+
+    // 常驻混音输出（失败时 PlaySFX 回退到 ma_engine_play_sound）
+    if (!InitVoiceOutput())
+    {
+        LOG_WARN("AudioManager: 发声池输出初始化失败，hitsound / UI 音效不可用，PlaySFX 回退为逐次从文件播放");
+    }
+
     m_initialized = true;
     LOG_INFO("AudioManager 初始化成功，主音量={:.2f}，音乐音量={:.2f}，音效音量={:.2f}",
              m_masterVolume, m_musicVolume, m_sfxVolume);
@@ -90,6 +172,9 @@ void AudioManager::Shutdown()
     }
     AudioVisualizer::GetInstance().ClearSource();
 
+    // 先停止混音，再释放样本（音频线程不再读取 PCM）
+    ShutdownVoiceOutput();
+
     // 释放引擎
     if (m_engine)
     {
@@ -97,6 +182,12 @@ void AudioManager::Shutdown()
         delete m_engine;
         m_engine = nullptr;
     }
+    AudioVisualizer::GetInstance().StopAnalysis();
+
+    m_hitsoundSamples.fill(nullptr);
+    m_judgeSamples.fill(nullptr);
+    m_uiSamples.fill(nullptr);
+    m_sampleBank.Clear();
 
     m_initialized  = false;
     m_musicPaused  = false;
@@ -299,14 +390,20 @@ void AudioManager::PlaySFX(const std::string& path)
 {
     if (!m_initialized || !m_engine) return;
 
+    if (m_voiceSound)
+    {
+        // 已解码的样本直接命中（无分配）；首次播放时解码一次
+        PlaySample(LoadSample(path));
+        return;
+    }
+
     if (!std::filesystem::exists(path))
     {
         LOG_WARN("音效文件不存在: {}", path);
         return;
     }
 
-    // 使用 ma_engine_play_sound 实现 fire-and-forget 音效播放
-    // 无需手动管理 ma_sound 生命周期
+    // 回退：ma_engine_play_sound 实现 fire-and-forget 音效播放
     ma_result result = ma_engine_play_sound(m_engine, path.c_str(), nullptr);
     if (result != MA_SUCCESS)
     {
@@ -330,6 +427,101 @@ void AudioManager::PlaySFXFromHandle(sakura::core::SoundHandle handle)
     PlaySFX(*path);
 }
 
+// ── 样本库 / 发声池 ───────────────────────────────────────────────────────────
+
+const PcmBuffer* AudioManager::LoadSample(const std::string& path)
+{
+    if (const PcmBuffer* cached = m_sampleBank.Find(path)) return cached;
+    if (!m_engine) return nullptr;
+
+    if (!std::filesystem::exists(path))
+    {
+        LOG_WARN("音效文件不存在: {}", path);
+        return nullptr;
+    }
+
+    // 直接解码为引擎格式，混音时无需转换
+    const ma_uint32 channels   = ma_engine_get_channels(m_engine);
+    const ma_uint32 sampleRate = ma_engine_get_sample_rate(m_engine);
+    ma_decoder_config config   = ma_decoder_config_init(ma_format_f32, channels, sampleRate);
+
+    ma_uint64 frameCount = 0;
+    void*     frames     = nullptr;
+    ma_result result     = ma_decode_file(path.c_str(), &config, &frameCount, &frames);
+    if (result != MA_SUCCESS || !frames)
+    {
+        LOG_WARN("音效解码失败 [{}]: error={}", path, static_cast<int>(result));
+        return nullptr;
+    }
+
+    PcmBuffer buffer;
+    buffer.channels   = channels;
+    buffer.sampleRate = sampleRate;
+    const auto* pcm   = static_cast<const float*>(frames);
+    buffer.samples.assign(pcm, pcm + frameCount * channels);
+    ma_free(frames, nullptr);
+
+    LOG_DEBUG("音效已解码: {} ({} 帧)", path, frameCount);
+    return m_sampleBank.Add(path, std::move(buffer));
+}
+
+void AudioManager::PlaySample(const PcmBuffer* sample, float gain)
+{
+    if (!sample || !m_voiceSound) return;
+    if (m_voicePool.Trigger(sample, gain * m_sfxVolume))
+        AudioVisualizer::GetInstance().AddImpulse(0.30f);
+}
+
+bool AudioManager::InitVoiceOutput()
+{
+    m_voiceSource             = new VoiceSource();
+    m_voiceSource->pool       = &m_voicePool;
+    m_voiceSource->channels   = ma_engine_get_channels(m_engine);
+    m_voiceSource->sampleRate = ma_engine_get_sample_rate(m_engine);
+    m_voicePool.SetOutputChannels(m_voiceSource->channels);
+
+    ma_data_source_config dsConfig = ma_data_source_config_init();
+    dsConfig.vtable = &g_voiceSourceVTable;
+    if (ma_data_source_init(&dsConfig, &m_voiceSource->base) != MA_SUCCESS)
+    {
+        delete m_voiceSource;
+        m_voiceSource = nullptr;
+        return false;
+    }
+
+    m_voiceSound = new ma_sound();
+    ma_result result = ma_sound_init_from_data_source(m_engine, &m_voiceSource->base, 0, nullptr, m_voiceSound);
+    if (result == MA_SUCCESS) result = ma_sound_start(m_voiceSound);
+    if (result != MA_SUCCESS)
+    {
+        LOG_ERROR("发声池 ma_sound 初始化失败: error={}", static_cast<int>(result));
+        ShutdownVoiceOutput();
+        return false;
+    }
+
+    LOG_INFO("发声池已启动: {} 复音, {} 声道 @ {}Hz",
+             VoicePool::MAX_VOICES, m_voiceSource->channels, m_voiceSource->sampleRate);
+    return true;
+}
+
+void AudioManager::ShutdownVoiceOutput()
+{
+    if (m_voiceSound)
+    {
+        ma_sound_stop(m_voiceSound);
+        ma_sound_uninit(m_voiceSound);
+        delete m_voiceSound;
+        m_voiceSound = nullptr;
+    }
+    if (m_voiceSource)
+    {
+        ma_data_source_uninit(&m_voiceSource->base);
+        delete m_voiceSource;
+        m_voiceSource = nullptr;
+    }
+    m_voicePool.StopAll();
+}
+
 // ── 音量控制 ──────────────────────────────────────────────────────────────────
 
 void AudioManager::SetMasterVolume(float vol)
@@ -351,7 +543,7 @@ void AudioManager::SetMusicVolume(float vol)
 void AudioManager::SetSFXVolume(float vol)
 {
     m_sfxVolume = std::max(0.0f, std::min(1.0f, vol));
-    // SFX 通过 engine 音量控制，这里仅记录（fire-and-forget 音效不单独控制）
+    // 发声池在每次触发时乘以 SFX 音量；回退路径（fire-and-forget）不单独控制
 }
 
 void AudioManager::ApplyMusicVolume()
@@ -384,30 +576,32 @@ bool AudioManager::LoadHitsoundSet(std::string_view name)
     m_hitsoundSetName = std::string(name);
     std::string base = "resources/sound/sfx/" + m_hitsoundSetName + "/";
 
-    m_hitsoundPaths[static_cast<int>(HitsoundType::Tap)]         = base + "tap.wav";
-    m_hitsoundPaths[static_cast<int>(HitsoundType::HoldStart)]   = base + "hold_start.wav";
-    m_hitsoundPaths[static_cast<int>(HitsoundType::HoldTick)]    = base + "hold_tick.wav";
-    m_hitsoundPaths[static_cast<int>(HitsoundType::Circle)]      = base + "circle.wav";
-    m_hitsoundPaths[static_cast<int>(HitsoundType::SliderStart)] = base + "slider_start.wav";
+    // 一次性解码为内存 PCM（同一路径已缓存则复用）
+    m_hitsoundSamples[static_cast<int>(HitsoundType::Tap)]         = LoadSample(base + "tap.wav");
+    m_hitsoundSamples[static_cast<int>(HitsoundType::HoldStart)]   = LoadSample(base + "hold_start.wav");
+    m_hitsoundSamples[static_cast<int>(HitsoundType::HoldTick)]    = LoadSample(base + "hold_tick.wav");
+    m_hitsoundSamples[static_cast<int>(HitsoundType::Circle)]      = LoadSample(base + "circle.wav");
+    m_hitsoundSamples[static_cast<int>(HitsoundType::SliderStart)] = LoadSample(base + "slider_start.wav");
 
-    m_judgeSFXPaths[0] = base + "perfect.wav";
-    m_judgeSFXPaths[1] = base + "great.wav";
-    m_judgeSFXPaths[2] = base + "good.wav";
-    m_judgeSFXPaths[3] = base + "bad.wav";
-    m_judgeSFXPaths[4] = base + "miss.wav";
+    m_judgeSamples[0] = LoadSample(base + "perfect.wav");
+    m_judgeSamples[1] = LoadSample(base + "great.wav");
+    m_judgeSamples[2] = LoadSample(base + "good.wav");
+    m_judgeSamples[3] = LoadSample(base + "bad.wav");
+    m_judgeSamples[4] = LoadSample(base + "miss.wav");
 
     // UI 音效统一放 ui/
     std::string ui = "resources/sound/sfx/ui/";
-    m_uiSFXPaths[static_cast<int>(UISFXType::ButtonHover)]   = ui + "button_hover.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::ButtonClick)]   = ui + "button_click.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::Transition)]    = ui + "transition.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::ResultScore)]   = ui + "result_score.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::ResultGrade)]   = ui + "result_grade.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::Toast)]         = ui + "toast.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::CalibrationBeat)] = ui + "calibration_beat.wav";
-    m_uiSFXPaths[static_cast<int>(UISFXType::CalibrationHit)]  = ui + "calibration_hit.wav";
-
-    LOG_INFO("[AudioManager] 已加载 hitsound set: {}", name);
+    m_uiSamples[static_cast<int>(UISFXType::ButtonHover)]     = LoadSample(ui + "button_hover.wav");
+    m_uiSamples[static_cast<int>(UISFXType::ButtonClick)]     = LoadSample(ui + "button_click.wav");
+    m_uiSamples[static_cast<int>(UISFXType::Transition)]      = LoadSample(ui + "transition.wav");
+    m_uiSamples[static_cast<int>(UISFXType::ResultScore)]     = LoadSample(ui + "result_score.wav");
+    m_uiSamples[static_cast<int>(UISFXType::ResultGrade)]     = LoadSample(ui + "result_grade.wav");
+    m_uiSamples[static_cast<int>(UISFXType::Toast)]           = LoadSample(ui + "toast.wav");
+    m_uiSamples[static_cast<int>(UISFXType::CalibrationBeat)] = LoadSample(ui + "calibration_beat.wav");
+    m_uiSamples[static_cast<int>(UISFXType::CalibrationHit)]  = LoadSample(ui + "calibration_hit.wav");
+
+    LOG_INFO("[AudioManager] 已加载 hitsound set: {}（样本库 {} 个，{} KB）",
+             name, m_sampleBank.GetCount(), m_sampleBank.GetTotalBytes() / 1024);
     return true;
 }
 
@@ -415,10 +609,8 @@ void AudioManager::PlayHitsound(HitsoundType type)
 {
     if (!m_initialized) return;
     int idx = static_cast<int>(type);
-    if (idx < 0 || idx >= static_cast<int>(m_hitsoundPaths.size())) return;
-    const auto& path = m_hitsoundPaths[idx];
-    if (!path.empty() && std::filesystem::exists(path))
-        PlaySFX(path);
+    if (idx < 0 || idx >= static_cast<int>(m_hitsoundSamples.size())) return;
+    PlaySample(m_hitsoundSamples[idx]);
 }
 
 void AudioManager::PlayHitsoundForNote(sakura::game::NoteType noteType)
@@ -438,20 +630,16 @@ void AudioManager::PlayJudgeSFX(sakura::game::JudgeResult result)
 {
     if (!m_initialized) return;
     int idx = static_cast<int>(result);
-    if (idx < 0 || idx >= static_cast<int>(m_judgeSFXPaths.size())) return;
-    const auto& path = m_judgeSFXPaths[idx];
-    if (!path.empty() && std::filesystem::exists(path))
-        PlaySFX(path);
+    if (idx < 0 || idx >= static_cast<int>(m_judgeSamples.size())) return;
+    PlaySample(m_judgeSamples[idx]);
 }
 
 void AudioManager::PlayUISFX(UISFXType type)
 {
     if (!m_initialized) return;
     int idx = static_cast<int>(type);
-    if (idx < 0 || idx >= static_cast<int>(m_uiSFXPaths.size())) return;
-    const auto& path = m_uiSFXPaths[idx];
-    if (!path.empty() && std::filesystem::exists(path))
-        PlaySFX(path);
+    if (idx < 0 || idx >= static_cast<int>(m_uiSamples.size())) return;
+    PlaySample(m_uiSamples[idx]);
 }
 
 } // namespace sakura::audio
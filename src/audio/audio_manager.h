@@ -1,10 +1,14 @@
 #pragma once
 
 // audio_manager.h — 音频管理器（基于 miniaudio ma_engine 高层API）
-// 单例，管理背景音乐和音效播放
+// 单例，管理背景音乐和音效播放。
+// 音效（hitsound / 判定音 / UI 音效）在加载时解码为内存 PCM（SampleBank），
+// 播放时只向发声池（VoicePool）投递一条命令，由常驻的 ma_sound 在音频线程混音：
+// 每次播放无文件 I/O、无堆分配。
 
 #include "core/resource_manager.h"
 #include "game/note.h"
+#include "voice_pool.h"
 #include <cstddef>
 #include <string>
 #include <string_view>
@@ -18,6 +22,9 @@ struct ma_sound;
 namespace sakura::audio
 {
 
+// 常驻混音数据源（定义在 .cpp，依赖 miniaudio 类型）
+struct VoiceSource;
+
 // ── UI 音效类型 ────────────────────────────────────────────────────────────────
 
 enum class UISFXType
@@ -93,11 +100,20 @@ public:
 
     // ── 音效 ──────────────────────────────────────────────────────────────────
 
-    // 一次性播放音效（不循环）
+    // 一次性播放音效（不循环）；首次播放某个路径时解码并缓存到样本库
     void PlaySFX(const std::string& path);
     // 使用已加载的 SoundHandle 播放（通过句柄反查原始路径）
     void PlaySFXFromHandle(sakura::core::SoundHandle handle);
 
+    // 解码音效文件到样本库（已缓存则直接返回）；失败返回 nullptr
+    const PcmBuffer* LoadSample(const std::string& path);
+
+    // 通过发声池播放已解码的样本（gain 再乘以 SFX 音量）
+    void PlaySample(const PcmBuffer* sample, float gain = 1.0f);
+
+    const SampleBank& GetSampleBank() const { return m_sampleBank; }
+    const VoicePool&  GetVoicePool()  const { return m_voicePool; }
+
     // ── 音量控制 ──────────────────────────────────────────────────────────────
 
     // 设置各通道音量（0.0~1.0），自动与 MasterVolume 相乘
@@ -147,6 +163,10 @@ private:
     // 更新音乐 ma_sound 的实际音量（master * music）
     void ApplyMusicVolume();
 
+    // 创建 / 销毁常驻混音 ma_sound（数据源为 m_voicePool）
+    bool InitVoiceOutput();
+    void ShutdownVoiceOutput();
+
     ma_engine* m_engine    = nullptr;   // miniaudio 高层引擎
     ma_sound*  m_music     = nullptr;   // 当前背景音乐 sound 对象
     std::string m_musicPath;            // 当前音乐文件路径
@@ -165,11 +185,17 @@ private:
     float m_fadeDuration   = 0.0f;
     float m_fadeStartVol   = 0.0f;
 
-    // Hitsound 文件路径缓存（按类型索引）
+    // 预解码样本与发声池
+    SampleBank   m_sampleBank;
+    VoicePool    m_voicePool;
+    VoiceSource* m_voiceSource = nullptr;
+    ma_sound*    m_voiceSound  = nullptr;
+
+    // Hitsound 样本（按类型索引，指向 m_sampleBank；未加载为 nullptr）
     std::string m_hitsoundSetName;
-    std::array<std::string, 5>  m_hitsoundPaths;   // indexed by HitsoundType
-    std::array<std::string, 5>  m_judgeSFXPaths;   // Perfect/Great/Good/Bad/Miss
-    std::array<std::string, static_cast<std::size_t>(UISFXType::Count)> m_uiSFXPaths; // indexed by UISFXType
+    std::array<const PcmBuffer*, 5> m_hitsoundSamples{};   // indexed by HitsoundType
+    std::array<const PcmBuffer*, 5> m_judgeSamples{};      // Perfect/Great/Good/Bad/Miss
+    std::array<const PcmBuffer*, static_cast<std::size_t>(UISFXType::Count)> m_uiSamples{}; // indexed by UISFXType
 };
 
 } // namespace sakura::audio
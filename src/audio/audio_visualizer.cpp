@@ -1,13 +1,16 @@
 // audio_visualizer.cpp — 音频可视化分析与渲染
 
+// miniaudio 实现在 resource_manager.cpp 中定义，这里只用解码器 API
 #include <miniaudio.h>
 
 #include "audio_visualizer.h"
+#include "utils/logger.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <filesystem>
 #include <numbers>
+#include <utility>
 
 namespace sakura::audio
 {
@@ -15,10 +18,7 @@ namespace sakura::audio
 namespace
 {
 
-constexpr std::size_t kBandCount = 32;
-constexpr std::size_t kAnalysisFrames = 1024;
-constexpr int kAnalysisChannels = 2;
-constexpr int kAnalysisSampleRate = 44100;
+constexpr std::size_t kBandCount = SpectrumFrame::BAND_COUNT;
 
 sakura::core::Color ScaleAlpha(sakura::core::Color color, float opacity)
 {
@@ -37,6 +37,35 @@ sakura::core::Color LerpColor(sakura::core::Color a, sakura::core::Color b, floa
     };
 }
 
+// 把整首音频解码为单声道 float（分块读取，每块之间检查取消标志）
+bool DecodeMono(const std::string& path, uint32_t sampleRate,
+                const std::atomic<bool>& cancelled, std::vector<float>& mono)
+{
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, sampleRate);
+    ma_decoder decoder;
+    if (ma_decoder_init_file(path.c_str(), &config, &decoder) != MA_SUCCESS)
+    {
+        LOG_WARN("[AudioVisualizer] 频谱分析解码失败: {}", path);
+        return false;
+    }
+
+    constexpr ma_uint64 CHUNK_FRAMES = 65536;
+    mono.clear();
+    while (!cancelled.load(std::memory_order_relaxed))
+    {
+        const size_t offset = mono.size();
+        mono.resize(offset + CHUNK_FRAMES);
+        ma_uint64 framesRead = 0;
+        const ma_result res = ma_decoder_read_pcm_frames(&decoder, mono.data() + offset,
+                                                         CHUNK_FRAMES, &framesRead);
+        mono.resize(offset + static_cast<size_t>(framesRead));
+        if (framesRead < CHUNK_FRAMES || res != MA_SUCCESS) break;
+    }
+
+    ma_decoder_uninit(&decoder);
+    return !cancelled.load(std::memory_order_relaxed);
+}
+
 } // namespace
 
 AudioVisualizer& AudioVisualizer::GetInstance()
@@ -47,7 +76,8 @@ AudioVisualizer& AudioVisualizer::GetInstance()
 
 AudioVisualizer::~AudioVisualizer()
 {
-    CloseDecoder();
+    StopAnalysis();
+    CancelTimelineJob();
 }
 
 void AudioVisualizer::SetSourceFile(std::string_view path)
@@ -57,16 +87,17 @@ void AudioVisualizer::SetSourceFile(std::string_view path)
         ClearSource();
         return;
     }
+    m_sourcePath = std::string(path);
 
-    if (m_sourcePath == path)
-        return;
-
-    OpenDecoder(path);
+    // 已有该文件的时间轴，或正在为它构建时不重复分析
+    if (m_timeline && m_timelinePath == m_sourcePath) return;
+    if (m_timelineJob && m_timelineJob->path == m_sourcePath) return;
+    StartTimelineJob(m_sourcePath);
 }
 
 void AudioVisualizer::ClearSource()
 {
-    CloseDecoder();
+    m_sourcePath.clear();
 }
 
 void AudioVisualizer::AddImpulse(float strength)
@@ -76,36 +107,140 @@ void AudioVisualizer::AddImpulse(float strength)
 
 void AudioVisualizer::Update(float dt, double playbackPositionSeconds, bool isPlaying)
 {
-    if (!isPlaying || !m_decoder)
+    PollTimelineJob();
+
+    if (!isPlaying || m_sourcePath.empty())
     {
+        m_bandsFromTimeline.store(false, std::memory_order_relaxed);
         ApplyDecay(dt);
         return;
     }
 
-    ma_result seekResult = ma_decoder_seek_to_pcm_frame(
-        m_decoder,
-        static_cast<ma_uint64>(std::max(0.0, playbackPositionSeconds) * kAnalysisSampleRate));
-    if (seekResult != MA_SUCCESS)
+    // 时间轴就绪：频带直接插值（超出时间轴范围时回退到实时分析）
+    const bool fromTimeline = HasTimeline()
+        && m_timeline->Sample(playbackPositionSeconds, m_timelineBands);
+    m_bandsFromTimeline.store(fromTimeline, std::memory_order_relaxed);
+
+    // 取分析线程最新发布的一帧（无新帧时沿用上一帧的目标值）
+    m_published.Fetch();
+    const SpectrumFrame& frame = m_published.ReadBuffer();
+    if (frame.sequence != 0 && frame.sequence != m_lastSequence)
     {
-        ApplyDecay(dt);
-        return;
+        m_lastSequence = frame.sequence;
+        m_waveform     = frame.waveform;
+        m_hasWaveform  = true;
     }
 
-    std::array<float, kAnalysisFrames * kAnalysisChannels> buffer = {};
-    ma_uint64 framesRead = 0;
-    ma_result readResult = ma_decoder_read_pcm_frames(
-        m_decoder,
-        buffer.data(),
-        kAnalysisFrames,
-        &framesRead);
+    if (fromTimeline)
+        ApplyTargets(m_timelineBands, dt);
+    else if (frame.sequence == 0)
+        ApplyDecay(dt);
+    else
+        ApplyTargets(frame.bands, dt);
+}
+
+// ── 频谱时间轴任务 ────────────────────────────────────────────────────────────
+
+void AudioVisualizer::StartTimelineJob(const std::string& path)
+{
+    CancelTimelineJob();
+
+    auto job  = std::make_shared<TimelineJob>();
+    job->path = path;
+    m_timelineJob    = job;
+    m_timelineThread = std::thread([job] {
+        const auto start = std::chrono::steady_clock::now();
+        job->result = SpectralCache::LoadOrBuild(job->path, TIMELINE_CACHE_DIR,
+            [&job](const std::string& audioPath, std::vector<float>& mono, uint32_t& sampleRate) {
+                sampleRate = TIMELINE_SAMPLE_RATE;
+                return DecodeMono(audioPath, sampleRate, job->cancelled, mono);
+            },
+            &job->cancelled);
+        if (job->result)
+        {
+            LOG_DEBUG("[AudioVisualizer] 频谱时间轴就绪: {}（{:.1f}s, 耗时 {}ms）",
+                      job->path, job->result->GetDurationSeconds(),
+                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start).count());
+        }
+        job->done.store(true, std::memory_order_release);
+    });
+}
 
-    if (readResult != MA_SUCCESS || framesRead == 0)
+void AudioVisualizer::CancelTimelineJob()
+{
+    if (m_timelineJob) m_timelineJob->cancelled.store(true, std::memory_order_relaxed);
+    if (m_timelineThread.joinable()) m_timelineThread.join();
+    m_timelineJob.reset();
+}
+
+void AudioVisualizer::PollTimelineJob()
+{
+    if (!m_timelineJob || !m_timelineJob->done.load(std::memory_order_acquire)) return;
+
+    m_timelineThread.join();
+    if (m_timelineJob->result)
     {
-        ApplyDecay(dt);
-        return;
+        m_timeline     = std::move(m_timelineJob->result);
+        m_timelinePath = m_timelineJob->path;
     }
+    m_timelineJob.reset();
+}
+
+// ── 分析线程 ──────────────────────────────────────────────────────────────────
+
+void AudioVisualizer::StartAnalysis(uint32_t sampleRate, uint32_t channels)
+{
+    StopAnalysis();
+    m_tap.Reset();
+    m_tapChannels.store(channels, std::memory_order_release);
+    m_analysisRunning.store(true, std::memory_order_release);
+    m_analysisThread = std::thread([this, sampleRate] { AnalysisLoop(sampleRate); });
+    LOG_INFO("AudioVisualizer 分析线程已启动（{}Hz, {} 点 FFT @ {}Hz）",
+             ANALYSIS_HZ, SpectrumAnalyzer::WINDOW, sampleRate);
+}
 
-    AnalyzeSamples(buffer.data(), static_cast<std::size_t>(framesRead), kAnalysisChannels, kAnalysisSampleRate, dt);
+void AudioVisualizer::StopAnalysis()
+{
+    m_tapChannels.store(0, std::memory_order_release);
+    if (!m_analysisThread.joinable()) return;
+    m_analysisRunning.store(false, std::memory_order_release);
+    m_analysisThread.join();
+}
+
+void AudioVisualizer::AnalysisLoop(uint32_t sampleRate)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 所有缓冲在线程开始时分配一次，循环内不再分配
+    SpectrumAnalyzer analyzer(sampleRate);
+    std::array<float, SpectrumAnalyzer::WINDOW> window{};
+    uint64_t lastWritten = 0;
+    uint64_t sequence    = 0;
+
+    const auto period = std::chrono::microseconds(1'000'000 / ANALYSIS_HZ);
+    auto next = Clock::now();
+    while (m_analysisRunning.load(std::memory_order_acquire))
+    {
+        const uint64_t written = m_tap.GetWrittenCount();
+        if (written != lastWritten && m_tap.ReadLatest(window.data(), window.size()))
+        {
+            lastWritten = written;
+            SpectrumFrame& frame = m_published.WriteBuffer();
+            // 频带来自离线时间轴时只抽取波形
+            if (m_bandsFromTimeline.load(std::memory_order_relaxed))
+                analyzer.SampleWaveform(window.data(), frame);
+            else
+                analyzer.Analyze(window.data(), frame);
+            frame.sequence = ++sequence;
+            m_published.Publish();
+        }
+
+        next += period;
+        const auto now = Clock::now();
+        if (next < now) next = now;   // 落后时不追帧
+        std::this_thread::sleep_until(next);
+    }
 }
 
 void AudioVisualizer::RenderBars(sakura::core::Renderer& renderer,
@@ -163,7 +298,7 @@ void AudioVisualizer::RenderWave(sakura::core::Renderer& renderer,
                                  sakura::core::Color color,
                                  float opacity) const
 {
-    if (m_waveform.size() < 2)
+    if (!m_hasWaveform)
         return;
 
     sakura::core::Color waveColor = ScaleAlpha(color, opacity);
@@ -181,43 +316,6 @@ void AudioVisualizer::RenderWave(sakura::core::Renderer& renderer,
     }
 }
 
-bool AudioVisualizer::OpenDecoder(std::string_view path)
-{
-    CloseDecoder();
-
-    if (path.empty() || !std::filesystem::exists(path))
-        return false;
-
-    ma_decoder_config config = ma_decoder_config_init(
-        ma_format_f32,
-        kAnalysisChannels,
-        kAnalysisSampleRate);
-
-    m_decoder = new ma_decoder();
-    ma_result result = ma_decoder_init_file(path.data(), &config, m_decoder);
-    if (result != MA_SUCCESS)
-    {
-        delete m_decoder;
-        m_decoder = nullptr;
-        return false;
-    }
-
-    m_sourcePath = std::string(path);
-    return true;
-}
-
-void AudioVisualizer::CloseDecoder()
-{
-    if (m_decoder)
-    {
-        ma_decoder_uninit(m_decoder);
-        delete m_decoder;
-        m_decoder = nullptr;
-    }
-
-    m_sourcePath.clear();
-}
-
 void AudioVisualizer::ApplyDecay(float dt)
 {
     for (std::size_t index = 0; index < kBandCount; ++index)
@@ -228,69 +326,8 @@ void AudioVisualizer::ApplyDecay(float dt)
     m_impulse = std::max(0.0f, m_impulse - dt * 2.2f);
 }
 
-void AudioVisualizer::AnalyzeSamples(const float* samples, std::size_t frameCount, int channels, int sampleRate, float dt)
+void AudioVisualizer::ApplyTargets(const std::array<float, kBandCount>& targets, float dt)
 {
-    if (!samples || frameCount == 0 || channels <= 0 || sampleRate <= 0)
-    {
-        ApplyDecay(dt);
-        return;
-    }
-
-    std::vector<float> mono(frameCount, 0.0f);
-    for (std::size_t frame = 0; frame < frameCount; ++frame)
-    {
-        float sum = 0.0f;
-        for (int channel = 0; channel < channels; ++channel)
-            sum += samples[frame * channels + channel];
-        mono[frame] = (sum / static_cast<float>(channels))
-                    * (0.54f - 0.46f * std::cos(2.0f * std::numbers::pi_v<float> * static_cast<float>(frame) / static_cast<float>(std::max<std::size_t>(1, frameCount - 1))));
-    }
-
-    m_waveform.clear();
-    constexpr std::size_t kWavePoints = 96;
-    m_waveform.reserve(kWavePoints);
-    for (std::size_t index = 0; index < kWavePoints; ++index)
-    {
-        std::size_t sampleIndex = (index * frameCount) / kWavePoints;
-        sampleIndex = std::min(sampleIndex, frameCount - 1);
-        m_waveform.push_back(std::clamp(mono[sampleIndex] * 1.8f, -1.0f, 1.0f));
-    }
-
-    std::array<float, kBandCount> targets = {};
-    constexpr float minFreq = 40.0f;
-    constexpr float maxFreq = 12000.0f;
-    float logMin = std::log(minFreq);
-    float logMax = std::log(maxFreq);
-
-    for (std::size_t band = 0; band < kBandCount; ++band)
-    {
-        float bandT0 = static_cast<float>(band) / static_cast<float>(kBandCount);
-        float bandT1 = static_cast<float>(band + 1) / static_cast<float>(kBandCount);
-        float lowFreq = std::exp(logMin + (logMax - logMin) * bandT0);
-        float highFreq = std::exp(logMin + (logMax - logMin) * bandT1);
-        int lowBin = std::max(1, static_cast<int>(std::floor(lowFreq * static_cast<float>(frameCount) / static_cast<float>(sampleRate))));
-        int highBin = std::min(static_cast<int>(frameCount / 2 - 1), static_cast<int>(std::ceil(highFreq * static_cast<float>(frameCount) / static_cast<float>(sampleRate))));
-
-        float energy = 0.0f;
-        int binCount = 0;
-        for (int bin = lowBin; bin <= highBin; ++bin)
-        {
-            float real = 0.0f;
-            float imag = 0.0f;
-            for (std::size_t sample = 0; sample < frameCount; ++sample)
-            {
-                float phase = 2.0f * std::numbers::pi_v<float> * static_cast<float>(bin) * static_cast<float>(sample) / static_cast<float>(frameCount);
-                real += mono[sample] * std::cos(phase);
-                imag -= mono[sample] * std::sin(phase);
-            }
-            energy += std::sqrt(real * real + imag * imag);
-            ++binCount;
-        }
-
-        if (binCount > 0)
-            targets[band] = std::clamp((energy / static_cast<float>(binCount)) * 0.02f, 0.0f, 1.0f);
-    }
-
     for (std::size_t band = 0; band < kBandCount; ++band)
     {
         float shapedTarget = std::clamp(targets[band] + m_impulse * (0.35f + 0.65f * (1.0f - static_cast<float>(band) / static_cast<float>(kBandCount))), 0.0f, 1.0f);
@@ -303,4 +340,4 @@ void AudioVisualizer::AnalyzeSamples(const float* samples, std::size_t frameCoun
     m_impulse = std::max(0.0f, m_impulse - dt * 1.5f);
 }
 
-} // namespace sakura::audio
\ No newline at end of file
+} // namespace sakura::audio
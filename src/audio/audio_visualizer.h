@@ -1,15 +1,25 @@
 #pragma once
 
 // audio_visualizer.h — 音频可视化分析与渲染
+// 频谱来自播放引擎的输出（AudioManager 在引擎 onProcess 回调中调用 FeedOutput），
+// 后台分析线程定期取最新 1024 个样本做 FFT，经三缓冲无锁发布；
+// 主线程 Update 只取最新一帧做平滑（与 dt 相关），渲染只读平滑后的结果。
+// 离线频谱缓存：SetSourceFile 时后台任务把整首歌分析为量化的频谱时间轴（按文件哈希缓存到磁盘，
+// 每首歌只分析一次）；就绪后 Update 直接在播放位置插值取频带，分析线程只抽取波形、不再做 FFT。
 
 #include "core/renderer.h"
+#include "spectral_cache.h"
+#include "spectrum.h"
+#include "utils/triple_buffer.h"
 
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
-#include <vector>
-
-struct ma_decoder;
+#include <thread>
 
 namespace sakura::audio
 {
@@ -29,11 +39,31 @@ public:
     AudioVisualizer(const AudioVisualizer&) = delete;
     AudioVisualizer& operator=(const AudioVisualizer&) = delete;
 
+    // 当前音乐来源；尚无该文件的频谱时间轴时在后台加载缓存或解码分析
     void SetSourceFile(std::string_view path);
     void ClearSource();
     void AddImpulse(float strength);
+    // 时间轴就绪时按 playbackPositionSeconds 插值取频带，否则使用实时输出的分析结果
     void Update(float dt, double playbackPositionSeconds, bool isPlaying);
 
+    // 当前来源的频谱时间轴是否已就绪（之后不再做实时 FFT）
+    bool HasTimeline() const { return m_timeline.has_value() && m_timelinePath == m_sourcePath; }
+
+    // ── 分析线程 ──────────────────────────────────────────────────────────────
+
+    // 启动 / 停止后台分析线程（AudioManager 初始化 / 关闭引擎时调用）
+    // sampleRate / channels 为引擎输出格式
+    void StartAnalysis(uint32_t sampleRate, uint32_t channels);
+    void StopAnalysis();
+    bool IsAnalyzing() const { return m_analysisThread.joinable(); }
+
+    // 音频线程：送入引擎输出的交错 float 帧（不分配、不加锁；未启动分析时忽略）
+    void FeedOutput(const float* frames, size_t frameCount)
+    {
+        const uint32_t channels = m_tapChannels.load(std::memory_order_acquire);
+        if (channels != 0) m_tap.Write(frames, frameCount, channels);
+    }
+
     const std::array<float, 32>& GetBands() const { return m_bands; }
 
     void RenderBars(sakura::core::Renderer& renderer,
@@ -58,17 +88,53 @@ private:
     AudioVisualizer() = default;
     ~AudioVisualizer();
 
-    bool OpenDecoder(std::string_view path);
-    void CloseDecoder();
+    // 分析线程频率
+    static constexpr int ANALYSIS_HZ = 100;
+    // 离线分析的解码采样率与缓存目录
+    static constexpr uint32_t TIMELINE_SAMPLE_RATE = 44100;
+    static constexpr const char* TIMELINE_CACHE_DIR = "cache/spectrum";
+
+    // 频谱时间轴后台任务（done 之后 result 只读）
+    struct TimelineJob
+    {
+        std::string                     path;
+        std::atomic<bool>               cancelled{ false };
+        std::atomic<bool>               done{ false };
+        std::optional<SpectralTimeline> result;
+    };
+
+    void AnalysisLoop(uint32_t sampleRate);
+    void StartTimelineJob(const std::string& path);
+    void CancelTimelineJob();
+    void PollTimelineJob();
     void ApplyDecay(float dt);
-    void AnalyzeSamples(const float* samples, std::size_t frameCount, int channels, int sampleRate, float dt);
-
-    ma_decoder* m_decoder = nullptr;
+    void ApplyTargets(const std::array<float, SpectrumFrame::BAND_COUNT>& targets, float dt);
+
+    // 引擎输出抽头（音频线程写，分析线程读）
+    SampleTap             m_tap;
+    std::atomic<uint32_t> m_tapChannels{ 0 };   // 0 = 未启动
+
+    // 分析结果（分析线程写，主线程读）
+    sakura::utils::TripleBuffer<SpectrumFrame> m_published;
+    std::thread       m_analysisThread;
+    std::atomic<bool> m_analysisRunning{ false };
+    std::atomic<bool> m_bandsFromTimeline{ false };   // 主线程写：为 true 时分析线程跳过 FFT
+
+    // 频谱时间轴（任务线程构建，主线程在 PollTimelineJob 中接收）
+    std::shared_ptr<TimelineJob>    m_timelineJob;
+    std::thread                     m_timelineThread;
+    std::optional<SpectralTimeline> m_timeline;
+    std::string                     m_timelinePath;
+    std::array<float, SpectrumFrame::BAND_COUNT> m_timelineBands = {};
+
+    // 以下仅主线程访问
     std::string m_sourcePath;
+    uint64_t    m_lastSequence = 0;
 
     std::array<float, 32> m_bands = {};
     std::array<float, 32> m_peaks = {};
-    std::vector<float> m_waveform;
+    std::array<float, SpectrumFrame::WAVE_POINTS> m_waveform = {};
+    bool  m_hasWaveform = false;
     float m_impulse = 0.0f;
 };
 
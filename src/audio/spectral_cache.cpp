@@ -0,0 +1,242 @@
+// spectral_cache.cpp — 离线频谱时间轴与磁盘缓存实现
+
+#include "spectral_cache.h"
+#include "game/chart_binary.h"
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace sakura::audio
+{
+
+static_assert(std::endian::native == std::endian::little,
+              ".sksp 以小端定长头部存储，当前仅支持小端平台");
+
+namespace
+{
+
+constexpr char SKSP_MAGIC[4] = { 'S', 'K', 'S', 'P' };
+
+struct SkspHeader
+{
+    char     magic[4];
+    uint32_t formatVersion;
+    uint64_t sourceHash;
+    uint32_t framesPerSecond;
+    uint32_t bandCount;
+    uint32_t frameCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(SkspHeader) == 32);
+
+} // namespace
+
+// ── SpectralTimeline ──────────────────────────────────────────────────────────
+
+bool SpectralTimeline::Sample(double seconds, std::array<float, BAND_COUNT>& out) const
+{
+    const size_t frames = GetFrameCount();
+    if (frames == 0 || seconds < 0.0) return false;
+
+    const double pos = seconds * static_cast<double>(framesPerSecond);
+    const size_t i0  = static_cast<size_t>(pos);
+    if (i0 >= frames) return false;
+    const size_t i1 = std::min(i0 + 1, frames - 1);
+    const float  t  = static_cast<float>(pos - static_cast<double>(i0));
+
+    const uint8_t* a = levels.data() + i0 * BAND_COUNT;
+    const uint8_t* b = levels.data() + i1 * BAND_COUNT;
+    constexpr float scale = 1.0f / 255.0f;
+    for (size_t band = 0; band < BAND_COUNT; ++band)
+    {
+        const float va = static_cast<float>(a[band]);
+        const float vb = static_cast<float>(b[band]);
+        out[band] = (va + (vb - va) * t) * scale;
+    }
+    return true;
+}
+
+// ── Build ─────────────────────────────────────────────────────────────────────
+
+SpectralTimeline SpectralCache::Build(const float* mono, size_t sampleCount, uint32_t sampleRate,
+                                      uint32_t framesPerSecond, const std::atomic<bool>* cancelled)
+{
+    SpectralTimeline timeline;
+    timeline.framesPerSecond = std::max(1u, framesPerSecond);
+    if (sampleRate == 0 || sampleCount == 0) return timeline;
+
+    constexpr size_t window = SpectrumAnalyzer::WINDOW;
+    const double hop    = static_cast<double>(sampleRate) / timeline.framesPerSecond;
+    const size_t frames = static_cast<size_t>(std::ceil(static_cast<double>(sampleCount) / hop));
+    timeline.levels.resize(frames * SpectralTimeline::BAND_COUNT);
+
+    SpectrumAnalyzer analyzer(sampleRate);
+    SpectrumFrame    frame;
+    std::vector<float> buffer(window, 0.0f);
+    for (size_t i = 0; i < frames; ++i)
+    {
+        if (cancelled && (i & 255) == 0 && cancelled->load(std::memory_order_relaxed))
+        {
+            timeline.levels.clear();
+            return timeline;
+        }
+
+        // 以帧时刻为中心取窗；开头 / 结尾越界部分补零
+        const int64_t center = static_cast<int64_t>(std::llround(static_cast<double>(i) * hop));
+        const int64_t begin  = center - static_cast<int64_t>(window / 2);
+        const int64_t end    = begin + static_cast<int64_t>(window);
+        const int64_t srcLo  = std::max<int64_t>(begin, 0);
+        const int64_t srcHi  = std::min<int64_t>(end, static_cast<int64_t>(sampleCount));
+        const float*  src    = mono;
+
+        if (srcLo == begin && srcHi == end)
+        {
+            src += begin;
+        }
+        else
+        {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            if (srcHi > srcLo)
+                std::copy(mono + srcLo, mono + srcHi, buffer.begin() + (srcLo - begin));
+            src = buffer.data();
+        }
+
+        analyzer.Analyze(src, frame);
+        uint8_t* dst = timeline.levels.data() + i * SpectralTimeline::BAND_COUNT;
+        for (size_t band = 0; band < SpectralTimeline::BAND_COUNT; ++band)
+            dst[band] = static_cast<uint8_t>(std::lround(std::clamp(frame.bands[band], 0.0f, 1.0f) * 255.0f));
+    }
+    return timeline;
+}
+
+// ── 路径 / 哈希 ───────────────────────────────────────────────────────────────
+
+std::string SpectralCache::GetCachePath(const std::string& cacheDir, uint64_t sourceHash)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".sksp", sourceHash);
+    return (fs::path(cacheDir) / name).string();
+}
+
+std::optional<uint64_t> SpectralCache::HashFile(const std::string& path)
+{
+    sakura::utils::MappedFile mapped;
+    if (!mapped.Open(path)) return std::nullopt;
+    return sakura::game::ChartBinary::HashBytes(
+        std::string_view(reinterpret_cast<const char*>(mapped.Data()), mapped.Size()));
+}
+
+// ── Read / Write ──────────────────────────────────────────────────────────────
+
+std::optional<SpectralTimeline> SpectralCache::Read(const std::string& cachePath, uint64_t sourceHash)
+{
+    sakura::utils::MappedFile mapped;
+    if (!mapped.Open(cachePath)) return std::nullopt;
+    if (mapped.Size() < sizeof(SkspHeader)) return std::nullopt;
+
+    SkspHeader header;
+    std::memcpy(&header, mapped.Data(), sizeof(header));
+    if (std::memcmp(header.magic, SKSP_MAGIC, sizeof(SKSP_MAGIC)) != 0) return std::nullopt;
+    if (header.formatVersion != FORMAT_VERSION) return std::nullopt;
+    if (header.sourceHash != sourceHash) return std::nullopt;
+    if (header.bandCount != SpectralTimeline::BAND_COUNT || header.framesPerSecond == 0)
+        return std::nullopt;
+
+    const uint64_t payload = uint64_t{ header.frameCount } * header.bandCount;
+    if (sizeof(SkspHeader) + payload != mapped.Size())
+    {
+        LOG_WARN("频谱缓存大小不符，视为损坏: {}", cachePath);
+        return std::nullopt;
+    }
+
+    SpectralTimeline timeline;
+    timeline.framesPerSecond = header.framesPerSecond;
+    const uint8_t* levels = mapped.Data() + sizeof(SkspHeader);
+    timeline.levels.assign(levels, levels + payload);
+    return timeline;
+}
+
+bool SpectralCache::Write(const std::string& cachePath, const SpectralTimeline& timeline, uint64_t sourceHash)
+{
+    SkspHeader header{};
+    std::memcpy(header.magic, SKSP_MAGIC, sizeof(SKSP_MAGIC));
+    header.formatVersion   = FORMAT_VERSION;
+    header.sourceHash      = sourceHash;
+    header.framesPerSecond = timeline.framesPerSecond;
+    header.bandCount       = static_cast<uint32_t>(SpectralTimeline::BAND_COUNT);
+    header.frameCount      = static_cast<uint32_t>(timeline.GetFrameCount());
+
+    std::error_code ec;
+    const fs::path parent = fs::path(cachePath).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+
+    // 先写临时文件再替换，避免并发读取到写了一半的缓存
+    const std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARN("无法写入频谱缓存: {}", tmpPath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(timeline.levels.data()),
+                   static_cast<std::streamsize>(header.frameCount * SpectralTimeline::BAND_COUNT));
+        if (!file)
+        {
+            LOG_WARN("写入频谱缓存失败: {}", tmpPath);
+            file.close();
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        LOG_WARN("替换频谱缓存失败 [{}]: {}", cachePath, ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// ── LoadOrBuild ───────────────────────────────────────────────────────────────
+
+std::optional<SpectralTimeline> SpectralCache::LoadOrBuild(const std::string& audioPath,
+                                                           const std::string& cacheDir,
+                                                           const DecodeFn& decode,
+                                                           const std::atomic<bool>* cancelled)
+{
+    const auto hash = HashFile(audioPath);
+    if (!hash) return std::nullopt;
+
+    const std::string cachePath = GetCachePath(cacheDir, *hash);
+    if (auto cached = Read(cachePath, *hash))
+        return cached;
+
+    std::vector<float> mono;
+    uint32_t sampleRate = 0;
+    if (!decode || !decode(audioPath, mono, sampleRate) || mono.empty() || sampleRate == 0)
+        return std::nullopt;
+
+    SpectralTimeline timeline = Build(mono.data(), mono.size(), sampleRate, FRAMES_PER_SECOND, cancelled);
+    if (timeline.Empty()) return std::nullopt;
+    if (Write(cachePath, timeline, *hash))
+        LOG_INFO("频谱缓存已生成: {}（{} 帧）", cachePath, timeline.GetFrameCount());
+    return timeline;
+}
+
+} // namespace sakura::audio
@@ -0,0 +1,85 @@
+#pragma once
+
+// spectral_cache.h — 离线频谱时间轴与磁盘缓存（与 miniaudio / SDL 解耦，可单元测试）
+// 每首歌只分析一次：整首 PCM 按固定帧率（默认 100 帧/秒）做 FFT，32 个频带能量量化为 uint8，
+// 得到紧凑的频谱时间轴（约 3.2KB/秒）。结果以音频文件内容哈希为键写入缓存目录，
+// 之后播放同一文件时可视化只需在相邻两帧间插值，不再做实时 FFT。
+//
+// 文件布局（小端）：
+//   SkspHeader（32 字节）
+//   频带能量 uint8 × frameCount × bandCount（按帧连续存放）
+
+#include "spectrum.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sakura::audio
+{
+
+// ── SpectralTimeline ──────────────────────────────────────────────────────────
+
+struct SpectralTimeline
+{
+    static constexpr size_t BAND_COUNT = SpectrumFrame::BAND_COUNT;
+
+    uint32_t             framesPerSecond = 100;
+    std::vector<uint8_t> levels;   // 第 i 帧的频带位于 [i * BAND_COUNT, (i + 1) * BAND_COUNT)，255 = 1.0
+
+    size_t GetFrameCount() const { return levels.size() / BAND_COUNT; }
+    bool   Empty() const         { return levels.size() < BAND_COUNT; }
+    double GetDurationSeconds() const
+    {
+        return framesPerSecond ? static_cast<double>(GetFrameCount()) / framesPerSecond : 0.0;
+    }
+
+    // 在 seconds 处对相邻两帧线性插值，写入 0~1 的频带能量（不分配）；
+    // 时间轴为空或 seconds 超出 [0, 时长) 时返回 false，out 不变
+    bool Sample(double seconds, std::array<float, BAND_COUNT>& out) const;
+};
+
+// ── SpectralCache ─────────────────────────────────────────────────────────────
+
+class SpectralCache
+{
+public:
+    // 格式版本：布局或分析参数变化时递增，旧缓存会被自动重建
+    static constexpr uint32_t FORMAT_VERSION    = 1;
+    static constexpr uint32_t FRAMES_PER_SECOND = 100;
+
+    // 解码回调：把音频文件解码为单声道 float，返回 false 表示失败（或被取消）
+    using DecodeFn = std::function<bool(const std::string& audioPath,
+                                        std::vector<float>& mono, uint32_t& sampleRate)>;
+
+    // 分析整段单声道 PCM：第 i 帧以 i / framesPerSecond 秒为中心取 WINDOW 个样本（越界补零）；
+    // cancelled 非空且被置位时提前结束并返回空时间轴
+    static SpectralTimeline Build(const float* mono, size_t sampleCount, uint32_t sampleRate,
+                                  uint32_t framesPerSecond = FRAMES_PER_SECOND,
+                                  const std::atomic<bool>* cancelled = nullptr);
+
+    // 缓存路径：{cacheDir}/{hash 的 16 位十六进制}.sksp
+    static std::string GetCachePath(const std::string& cacheDir, uint64_t sourceHash);
+
+    // 音频文件内容哈希（FNV-1a 64，与谱面缓存一致）；文件无法读取返回 nullopt
+    static std::optional<uint64_t> HashFile(const std::string& path);
+
+    // 读取缓存并校验头部中的源哈希；文件缺失、损坏、版本或哈希不符返回 nullopt
+    static std::optional<SpectralTimeline> Read(const std::string& cachePath, uint64_t sourceHash);
+
+    // 写入缓存（先写临时文件再原子替换，必要时创建目录），失败时返回 false 并 LOG_WARN
+    static bool Write(const std::string& cachePath, const SpectralTimeline& timeline, uint64_t sourceHash);
+
+    // 命中缓存直接读取，否则调用 decode 解码、分析并写回缓存；解码失败或被取消返回 nullopt
+    static std::optional<SpectralTimeline> LoadOrBuild(const std::string& audioPath,
+                                                       const std::string& cacheDir,
+                                                       const DecodeFn& decode,
+                                                       const std::atomic<bool>* cancelled = nullptr);
+};
+
+} // namespace sakura::audio
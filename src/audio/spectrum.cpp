@@ -0,0 +1,190 @@
+// spectrum.cpp — 频谱分析基础组件实现
+
+#include "spectrum.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace sakura::audio
+{
+
+// ── Fft ───────────────────────────────────────────────────────────────────────
+
+Fft::Fft(size_t size)
+    : m_size(size)
+{
+    unsigned bits = 0;
+    while ((size_t{ 1 } << bits) < size) ++bits;
+
+    m_bitReverse.resize(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        uint32_t r = 0;
+        for (unsigned b = 0; b < bits; ++b)
+            r |= static_cast<uint32_t>((i >> b) & 1u) << (bits - 1 - b);
+        m_bitReverse[i] = r;
+    }
+
+    m_twiddleRe.resize(size > 1 ? size - 1 : 0);
+    m_twiddleIm.resize(m_twiddleRe.size());
+    for (size_t half = 1; half < size; half <<= 1)
+    {
+        for (size_t k = 0; k < half; ++k)
+        {
+            const double angle = -std::numbers::pi * static_cast<double>(k) / static_cast<double>(half);
+            m_twiddleRe[half - 1 + k] = static_cast<float>(std::cos(angle));
+            m_twiddleIm[half - 1 + k] = static_cast<float>(std::sin(angle));
+        }
+    }
+}
+
+void Fft::Forward(float* re, float* im) const
+{
+    const size_t n = m_size;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const size_t j = m_bitReverse[i];
+        if (j > i)
+        {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    for (size_t half = 1; half < n; half <<= 1)
+    {
+        const float* wr = m_twiddleRe.data() + half - 1;
+        const float* wi = m_twiddleIm.data() + half - 1;
+        for (size_t base = 0; base < n; base += half * 2)
+        {
+            float* aRe = re + base;
+            float* aIm = im + base;
+            float* bRe = aRe + half;
+            float* bIm = aIm + half;
+            for (size_t k = 0; k < half; ++k)
+            {
+                const float tr = bRe[k] * wr[k] - bIm[k] * wi[k];
+                const float ti = bRe[k] * wi[k] + bIm[k] * wr[k];
+                bRe[k] = aRe[k] - tr;
+                bIm[k] = aIm[k] - ti;
+                aRe[k] += tr;
+                aIm[k] += ti;
+            }
+        }
+    }
+}
+
+// ── SampleTap ─────────────────────────────────────────────────────────────────
+
+void SampleTap::Write(const float* interleaved, size_t frames, uint32_t channels)
+{
+    if (!interleaved || channels == 0) return;
+
+    const uint64_t start = m_written.load(std::memory_order_relaxed);
+    const float    scale = 1.0f / static_cast<float>(channels);
+    for (size_t f = 0; f < frames; ++f)
+    {
+        float sum = 0.0f;
+        for (uint32_t c = 0; c < channels; ++c)
+            sum += interleaved[f * channels + c];
+        m_samples[(start + f) & MASK].store(sum * scale, std::memory_order_relaxed);
+    }
+    m_written.store(start + frames, std::memory_order_release);
+}
+
+bool SampleTap::ReadLatest(float* out, size_t count) const
+{
+    if (count > CAPACITY / 2) return false;
+
+    const uint64_t end = m_written.load(std::memory_order_acquire);
+    if (end < count) return false;
+
+    const uint64_t begin = end - count;
+    for (size_t i = 0; i < count; ++i)
+        out[i] = m_samples[(begin + i) & MASK].load(std::memory_order_relaxed);
+
+    // 读取期间写者若可能已绕回覆盖 [begin, end)（含一个尚未发布、不超过 CAPACITY/2 的写入块），
+    // 本次结果作废
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t after = m_written.load(std::memory_order_relaxed);
+    return after - begin <= CAPACITY / 2;
+}
+
+// ── SpectrumAnalyzer ──────────────────────────────────────────────────────────
+
+SpectrumAnalyzer::SpectrumAnalyzer(uint32_t sampleRate)
+    : m_fft(WINDOW)
+    , m_window(WINDOW)
+    , m_re(WINDOW)
+    , m_im(WINDOW)
+{
+    for (size_t i = 0; i < WINDOW; ++i)
+    {
+        m_window[i] = 0.54f - 0.46f * std::cos(2.0f * std::numbers::pi_v<float>
+                      * static_cast<float>(i) / static_cast<float>(WINDOW - 1));
+    }
+    SetSampleRate(sampleRate);
+}
+
+void SpectrumAnalyzer::SetSampleRate(uint32_t sampleRate)
+{
+    m_sampleRate = sampleRate ? sampleRate : 48000;
+
+    constexpr float minFreq = 40.0f;
+    constexpr float maxFreq = 12000.0f;
+    const float logMin = std::log(minFreq);
+    const float logMax = std::log(maxFreq);
+    const float binHz  = static_cast<float>(m_sampleRate) / static_cast<float>(WINDOW);
+    constexpr size_t bands = SpectrumFrame::BAND_COUNT;
+
+    for (size_t band = 0; band < bands; ++band)
+    {
+        const float t0 = static_cast<float>(band) / static_cast<float>(bands);
+        const float t1 = static_cast<float>(band + 1) / static_cast<float>(bands);
+        const float lowFreq  = std::exp(logMin + (logMax - logMin) * t0);
+        const float highFreq = std::exp(logMin + (logMax - logMin) * t1);
+        m_bandLow[band]  = std::max(1, static_cast<int>(std::floor(lowFreq / binHz)));
+        m_bandHigh[band] = std::min(static_cast<int>(WINDOW / 2 - 1),
+                                    static_cast<int>(std::ceil(highFreq / binHz)));
+    }
+}
+
+void SpectrumAnalyzer::SampleWaveform(const float* mono, SpectrumFrame& out) const
+{
+    constexpr size_t points = SpectrumFrame::WAVE_POINTS;
+    for (size_t i = 0; i < points; ++i)
+    {
+        const size_t idx = (i * WINDOW) / points;
+        out.waveform[i] = std::clamp(mono[idx] * m_window[idx] * 1.8f, -1.0f, 1.0f);
+    }
+}
+
+void SpectrumAnalyzer::Analyze(const float* mono, SpectrumFrame& out)
+{
+    for (size_t i = 0; i < WINDOW; ++i)
+    {
+        m_re[i] = mono[i] * m_window[i];
+        m_im[i] = 0.0f;
+    }
+
+    SampleWaveform(mono, out);
+
+    m_fft.Forward(m_re.data(), m_im.data());
+
+    for (size_t band = 0; band < SpectrumFrame::BAND_COUNT; ++band)
+    {
+        float energy   = 0.0f;
+        int   binCount = 0;
+        for (int bin = m_bandLow[band]; bin <= m_bandHigh[band]; ++bin)
+        {
+            energy += std::sqrt(m_re[bin] * m_re[bin] + m_im[bin] * m_im[bin]);
+            ++binCount;
+        }
+        out.bands[band] = binCount > 0
+            ? std::clamp((energy / static_cast<float>(binCount)) * 0.02f, 0.0f, 1.0f)
+            : 0.0f;
+    }
+}
+
+} // namespace sakura::audio
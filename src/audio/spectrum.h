@@ -0,0 +1,104 @@
+#pragma once
+
+// spectrum.h — 频谱分析基础组件（与 miniaudio / SDL 解耦，可单元测试）
+// Fft：原地迭代 radix-2 FFT，实部 / 虚部分离存放，逐级 twiddle 表连续存放，
+//      蝶形内层循环为连续访存、无分支，便于编译器自动向量化。
+// SampleTap：播放引擎输出的“抽头”，音频线程写入（缩混为单声道），分析线程读取最新窗口；
+//      写者从不等待，读者检测到被覆盖时放弃本次读取。
+// SpectrumAnalyzer：加窗 + FFT + 对数频带能量，所有缓冲在构造时分配并复用。
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sakura::audio
+{
+
+// ── Fft ───────────────────────────────────────────────────────────────────────
+
+class Fft
+{
+public:
+    // size 须为 2 的幂（>= 2）
+    explicit Fft(size_t size);
+
+    size_t GetSize() const { return m_size; }
+
+    // 原地正变换：re / im 各 GetSize() 个元素
+    void Forward(float* re, float* im) const;
+
+private:
+    size_t                m_size;
+    std::vector<uint32_t> m_bitReverse;
+    std::vector<float>    m_twiddleRe;   // 第 s 级（半长 h）的 twiddle 位于 [h-1, 2h-1)
+    std::vector<float>    m_twiddleIm;
+};
+
+// ── SampleTap ─────────────────────────────────────────────────────────────────
+
+class SampleTap
+{
+public:
+    static constexpr size_t CAPACITY = 8192;   // 单声道样本数（2 的幂）
+
+    // 音频线程：写入交错 float 帧（缩混为单声道）；单次 frames 不应超过 CAPACITY / 2
+    void Write(const float* interleaved, size_t frames, uint32_t channels);
+
+    // 分析线程：复制最新的 count 个样本（按时间顺序）；数据不足或读取期间被覆盖返回 false
+    bool ReadLatest(float* out, size_t count) const;
+
+    // 累计写入样本数（可用于判断是否有新数据）
+    uint64_t GetWrittenCount() const { return m_written.load(std::memory_order_acquire); }
+
+    void Reset() { m_written.store(0, std::memory_order_release); }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+
+    std::array<std::atomic<float>, CAPACITY> m_samples{};
+    std::atomic<uint64_t>                    m_written{ 0 };
+};
+
+// ── SpectrumAnalyzer ──────────────────────────────────────────────────────────
+
+struct SpectrumFrame
+{
+    static constexpr size_t BAND_COUNT = 32;
+    static constexpr size_t WAVE_POINTS = 96;
+
+    std::array<float, BAND_COUNT>  bands    = {};   // 0~1，频带能量（对数分布 40Hz~12kHz）
+    std::array<float, WAVE_POINTS> waveform = {};   // -1~1，加窗后的波形抽样
+    uint64_t                       sequence = 0;    // 发布序号（0 = 尚无数据）
+};
+
+class SpectrumAnalyzer
+{
+public:
+    static constexpr size_t WINDOW = 1024;
+
+    explicit SpectrumAnalyzer(uint32_t sampleRate = 48000);
+
+    // 改变采样率时重新计算频带对应的 bin 区间
+    void SetSampleRate(uint32_t sampleRate);
+    uint32_t GetSampleRate() const { return m_sampleRate; }
+
+    // 分析 WINDOW 个单声道样本，写入 out.bands / out.waveform（不分配）
+    void Analyze(const float* mono, SpectrumFrame& out);
+
+    // 只抽取加窗波形写入 out.waveform（不做 FFT；频带来自离线缓存时使用）
+    void SampleWaveform(const float* mono, SpectrumFrame& out) const;
+
+private:
+    Fft      m_fft;
+    uint32_t m_sampleRate = 48000;
+
+    std::vector<float> m_window;   // Hamming 窗
+    std::vector<float> m_re;
+    std::vector<float> m_im;
+    std::array<int, SpectrumFrame::BAND_COUNT> m_bandLow  = {};
+    std::array<int, SpectrumFrame::BAND_COUNT> m_bandHigh = {};
+};
+
+} // namespace sakura::audio
@@ -0,0 +1,121 @@
+// voice_pool.cpp — 预解码 PCM 样本库与发声池实现
+
+#include "voice_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sakura::audio
+{
+
+// ── SampleBank ────────────────────────────────────────────────────────────────
+
+const PcmBuffer* SampleBank::Add(std::string key, PcmBuffer buffer)
+{
+    auto& slot = m_samples[std::move(key)];
+    slot = std::make_unique<PcmBuffer>(std::move(buffer));
+    return slot.get();
+}
+
+const PcmBuffer* SampleBank::Find(std::string_view key) const
+{
+    auto it = m_samples.find(key);
+    return it != m_samples.end() ? it->second.get() : nullptr;
+}
+
+size_t SampleBank::GetTotalBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& [key, buffer] : m_samples)
+        bytes += buffer->samples.size() * sizeof(float);
+    return bytes;
+}
+
+// ── VoicePool：生产者 ─────────────────────────────────────────────────────────
+
+bool VoicePool::Trigger(const PcmBuffer* buffer, float gain)
+{
+    if (!buffer || buffer->FrameCount() == 0) return false;
+    const uint32_t generation = m_stopGeneration.load(std::memory_order_relaxed);
+    if (!m_commands.TryPush(Command{ buffer, gain, generation }))
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+// ── VoicePool：消费者 ─────────────────────────────────────────────────────────
+
+void VoicePool::Start(const Command& cmd)
+{
+    // 优先使用空闲发声；满载时抢占最早开始的
+    Voice* slot = nullptr;
+    for (auto& v : m_voices)
+    {
+        if (!v.buffer) { slot = &v; break; }
+        if (!slot || v.order < slot->order) slot = &v;
+    }
+    if (slot->buffer) m_stolen.fetch_add(1, std::memory_order_relaxed);
+
+    slot->buffer = cmd.buffer;
+    slot->cursor = 0;
+    slot->gain   = cmd.gain;
+    slot->order  = m_nextOrder++;
+    m_triggered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VoicePool::Mix(float* out, size_t frames)
+{
+    // StopAll：代数变化时清空发声；命令携带的代数更新（本次读取之后又有 StopAll）时同样处理
+    auto advance = [this](uint32_t generation) {
+        if (generation == m_mixedGeneration) return;
+        for (auto& v : m_voices) v.buffer = nullptr;
+        m_mixedGeneration = generation;
+    };
+    advance(m_stopGeneration.load(std::memory_order_acquire));
+
+    Command cmd{};
+    while (m_commands.TryPop(cmd))
+    {
+        if (static_cast<int32_t>(cmd.generation - m_mixedGeneration) < 0) continue;   // 过期
+        advance(cmd.generation);
+        Start(cmd);
+    }
+
+    const uint32_t outCh = m_outputChannels;
+    std::memset(out, 0, frames * outCh * sizeof(float));
+
+    size_t active = 0;
+    for (auto& v : m_voices)
+    {
+        if (!v.buffer) continue;
+
+        const PcmBuffer& buf   = *v.buffer;
+        const uint32_t   inCh  = buf.channels;
+        const size_t     count = std::min(frames, buf.FrameCount() - v.cursor);
+        const float*     src   = buf.samples.data() + v.cursor * inCh;
+
+        if (inCh == outCh)
+        {
+            for (size_t i = 0; i < count * outCh; ++i)
+                out[i] += src[i] * v.gain;
+        }
+        else
+        {
+            // 声道数不同：单声道复制到所有输出声道，其余按声道下标取模
+            for (size_t f = 0; f < count; ++f)
+                for (uint32_t c = 0; c < outCh; ++c)
+                    out[f * outCh + c] += src[f * inCh + (c % inCh)] * v.gain;
+        }
+
+        v.cursor += count;
+        if (v.cursor >= buf.FrameCount())
+            v.buffer = nullptr;
+        else
+            ++active;
+    }
+    m_activeVoices.store(active, std::memory_order_relaxed);
+}
+
+} // namespace sakura::audio
@@ -0,0 +1,127 @@
+#pragma once
+
+// voice_pool.h — 预解码 PCM 样本库 + 固定容量音效发声池（与 miniaudio 解耦）
+// SampleBank：按键（文件路径）缓存解码后的交错 float PCM。样本一经加入即不可变、地址稳定，
+//   直到 Clear()（须在混音线程停止后调用），因此发声命令只需携带裸指针。
+// VoicePool：主线程 Trigger() 经无锁 SPSC 队列把发声命令交给音频线程，
+//   音频线程在 Mix() 中取出命令并混音。复音数固定为 MAX_VOICES，
+//   满载时抢占最早开始的发声（steal-oldest）。Trigger / Mix 不分配内存、不做文件 I/O。
+
+#include "utils/spsc_ring.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sakura::audio
+{
+
+// ── PCM 样本 ──────────────────────────────────────────────────────────────────
+
+struct PcmBuffer
+{
+    std::vector<float> samples;        // 交错 float PCM
+    uint32_t           channels   = 1;
+    uint32_t           sampleRate = 44100;
+
+    size_t FrameCount() const { return channels ? samples.size() / channels : 0; }
+};
+
+class SampleBank
+{
+public:
+    // 加入（或替换同键的）样本，返回稳定指针。替换会使旧指针失效，仅在混音停止时使用；
+    // 正常加载路径先 Find 命中则直接复用
+    const PcmBuffer* Add(std::string key, PcmBuffer buffer);
+
+    // 未加载返回 nullptr（不分配）
+    const PcmBuffer* Find(std::string_view key) const;
+
+    void   Clear() { m_samples.clear(); }
+    size_t GetCount() const { return m_samples.size(); }
+    size_t GetTotalBytes() const;
+
+private:
+    struct KeyHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<PcmBuffer>, KeyHash, std::equal_to<>> m_samples;
+};
+
+// ── 发声池 ────────────────────────────────────────────────────────────────────
+
+class VoicePool
+{
+public:
+    static constexpr size_t MAX_VOICES       = 32;
+    static constexpr size_t COMMAND_CAPACITY = 256;
+
+    // 输出声道数（Mix 写入的交错格式）；须在混音开始前设置
+    void SetOutputChannels(uint32_t channels) { m_outputChannels = channels ? channels : 1; }
+    uint32_t GetOutputChannels() const { return m_outputChannels; }
+
+    // ── 生产者（主线程）────────────────────────────────────────────────────────
+
+    // 请求播放：命令队列已满时丢弃并返回 false
+    bool Trigger(const PcmBuffer* buffer, float gain = 1.0f);
+
+    // 请求停止全部发声及此前尚未开始的命令（下一次 Mix 生效；不阻塞）
+    void StopAll() { m_stopGeneration.fetch_add(1, std::memory_order_release); }
+
+    // ── 消费者（音频线程）──────────────────────────────────────────────────────
+
+    // 处理待执行命令，把所有活动发声混合写入 out（frames × 输出声道，覆盖写）
+    void Mix(float* out, size_t frames);
+
+    // ── 统计（任意线程，近似值）──────────────────────────────────────────────
+
+    size_t   GetActiveVoices()   const { return m_activeVoices.load(std::memory_order_relaxed); }
+    uint64_t GetTriggeredCount() const { return m_triggered.load(std::memory_order_relaxed); }
+    uint64_t GetStolenCount()    const { return m_stolen.load(std::memory_order_relaxed); }
+    uint64_t GetDroppedCount()   const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Command
+    {
+        const PcmBuffer* buffer;
+        float            gain;
+        uint32_t         generation;   // Trigger 时的 StopAll 代数，过期命令被丢弃
+    };
+
+    struct Voice
+    {
+        const PcmBuffer* buffer = nullptr;   // nullptr = 空闲
+        size_t           cursor = 0;         // 帧
+        float            gain   = 1.0f;
+        uint64_t         order  = 0;         // 开始顺序（越小越早）
+    };
+
+    void Start(const Command& cmd);
+
+    uint32_t m_outputChannels = 2;
+
+    sakura::utils::SpscRing<Command, COMMAND_CAPACITY> m_commands;
+
+    // 以下仅音频线程访问
+    std::array<Voice, MAX_VOICES> m_voices{};
+    uint64_t                      m_nextOrder       = 0;
+    uint32_t                      m_mixedGeneration = 0;
+
+    std::atomic<uint32_t> m_stopGeneration{ 0 };
+
+    std::atomic<size_t>   m_activeVoices{ 0 };
+    std::atomic<uint64_t> m_triggered{ 0 };
+    std::atomic<uint64_t> m_stolen{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+};
+
+} // namespace sakura::audio
@@ -0,0 +1,264 @@
+// waveform_pyramid.cpp — 多分辨率波形金字塔实现
+
+#include "waveform_pyramid.h"
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace sakura::audio
+{
+
+static_assert(std::endian::native == std::endian::little,
+              ".skw 以小端定长记录存储，当前仅支持小端平台");
+
+namespace
+{
+
+constexpr char SKW_MAGIC[4] = { 'S', 'K', 'W', 'F' };
+
+struct SkwHeader
+{
+    char     magic[4];
+    uint32_t formatVersion;
+    uint32_t sampleRate;
+    uint32_t baseBucketSamples;
+    uint32_t levelCount;
+    uint32_t reserved;
+    uint64_t totalSamples;
+    int64_t  sourceMtime;
+    uint64_t sourceSize;
+};
+static_assert(sizeof(SkwHeader) == 48);
+
+uint64_t BucketCount(uint64_t samples, size_t level)
+{
+    const uint64_t perBucket = uint64_t{ WaveformPyramid::BASE_BUCKET_SAMPLES } << level;
+    return (samples + perBucket - 1) / perBucket;
+}
+
+int8_t QuantizeSigned(float v)
+{
+    return static_cast<int8_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+}
+
+uint8_t QuantizeUnsigned(double v)
+{
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0, 1.0) * 255.0));
+}
+
+} // namespace
+
+WaveformPyramid::WaveformPyramid(uint64_t totalSamples)
+    : m_totalSamples(totalSamples)
+{
+    for (size_t level = 0; level < LEVEL_COUNT; ++level)
+        m_levels[level].resize(static_cast<size_t>(BucketCount(totalSamples, level)));
+}
+
+float WaveformPyramid::GetProgress() const
+{
+    if (IsComplete() || m_totalSamples == 0) return 1.0f;
+    return static_cast<float>(static_cast<double>(m_progress.load(std::memory_order_relaxed))
+                              / static_cast<double>(m_totalSamples));
+}
+
+size_t WaveformPyramid::ChooseLevel(double maxBucketMs)
+{
+    size_t level = 0;
+    while (level + 1 < LEVEL_COUNT && static_cast<double>(GetBucketMs(level + 1)) <= maxBucketMs)
+        ++level;
+    return level;
+}
+
+// ── 构建 ──────────────────────────────────────────────────────────────────────
+
+void WaveformPyramid::Append(const float* mono, size_t count)
+{
+    const uint64_t room = m_totalSamples - m_written;
+    count = static_cast<size_t>(std::min<uint64_t>(count, room));
+
+    Accumulator& acc = m_acc[0];
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float v = mono[i];
+        if (acc.samples == 0)
+        {
+            acc.min = v;
+            acc.max = v;
+        }
+        else
+        {
+            acc.min = std::min(acc.min, v);
+            acc.max = std::max(acc.max, v);
+        }
+        acc.sumSq += static_cast<double>(v) * v;
+        if (++acc.samples == BASE_BUCKET_SAMPLES)
+            Emit(0);
+    }
+
+    m_written += count;
+    m_progress.store(m_written, std::memory_order_relaxed);
+}
+
+void WaveformPyramid::Finish()
+{
+    for (size_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        if (m_acc[level].samples > 0)
+            Emit(level);
+    }
+    m_complete.store(true, std::memory_order_release);
+}
+
+void WaveformPyramid::Emit(size_t level)
+{
+    Accumulator& acc = m_acc[level];
+    const size_t index = m_ready[level].load(std::memory_order_relaxed);
+    if (index < m_levels[level].size())
+    {
+        WaveformBucket& bucket = m_levels[level][index];
+        bucket.min = QuantizeSigned(acc.min);
+        bucket.max = QuantizeSigned(acc.max);
+        bucket.rms = QuantizeUnsigned(std::sqrt(acc.sumSq / static_cast<double>(acc.samples)));
+        m_ready[level].store(index + 1, std::memory_order_release);
+    }
+
+    // 并入上一级（两个子桶合成一个父桶）
+    if (level + 1 < LEVEL_COUNT)
+    {
+        Accumulator& parent = m_acc[level + 1];
+        if (parent.samples == 0)
+        {
+            parent.min = acc.min;
+            parent.max = acc.max;
+        }
+        else
+        {
+            parent.min = std::min(parent.min, acc.min);
+            parent.max = std::max(parent.max, acc.max);
+        }
+        parent.sumSq   += acc.sumSq;
+        parent.samples += acc.samples;
+        ++parent.children;
+        acc = Accumulator{};
+        if (parent.children == 2)
+            Emit(level + 1);
+    }
+    else
+    {
+        acc = Accumulator{};
+    }
+}
+
+// ── 磁盘缓存 ──────────────────────────────────────────────────────────────────
+
+std::string WaveformPyramid::GetCachePath(const std::string& audioPath)
+{
+    fs::path path(audioPath);
+    path.replace_extension(".skw");
+    return path.string();
+}
+
+std::unique_ptr<WaveformPyramid> WaveformPyramid::Read(const std::string& cachePath,
+                                                       const sakura::game::ChartSourceStamp& source)
+{
+    sakura::utils::MappedFile mapped;
+    if (!mapped.Open(cachePath)) return nullptr;
+    if (mapped.Size() < sizeof(SkwHeader)) return nullptr;
+
+    SkwHeader header;
+    std::memcpy(&header, mapped.Data(), sizeof(header));
+    if (std::memcmp(header.magic, SKW_MAGIC, sizeof(SKW_MAGIC)) != 0) return nullptr;
+    if (header.formatVersion != FORMAT_VERSION
+        || header.sampleRate != SAMPLE_RATE
+        || header.baseBucketSamples != BASE_BUCKET_SAMPLES
+        || header.levelCount != LEVEL_COUNT)
+        return nullptr;
+    if (header.sourceMtime != source.mtime || header.sourceSize != source.size) return nullptr;
+
+    uint64_t expected = sizeof(SkwHeader);
+    for (size_t level = 0; level < LEVEL_COUNT; ++level)
+        expected += BucketCount(header.totalSamples, level) * sizeof(WaveformBucket);
+    if (expected != mapped.Size())
+    {
+        LOG_WARN("波形缓存大小不符，视为损坏: {}", cachePath);
+        return nullptr;
+    }
+
+    auto pyramid = std::make_unique<WaveformPyramid>(header.totalSamples);
+    const uint8_t* cursor = mapped.Data() + sizeof(SkwHeader);
+    for (size_t level = 0; level < LEVEL_COUNT; ++level)
+    {
+        auto& buckets = pyramid->m_levels[level];
+        const size_t bytes = buckets.size() * sizeof(WaveformBucket);
+        std::memcpy(buckets.data(), cursor, bytes);
+        cursor += bytes;
+        pyramid->m_ready[level].store(buckets.size(), std::memory_order_relaxed);
+    }
+    pyramid->m_written = header.totalSamples;
+    pyramid->m_progress.store(header.totalSamples, std::memory_order_relaxed);
+    pyramid->m_complete.store(true, std::memory_order_release);
+    return pyramid;
+}
+
+bool WaveformPyramid::Write(const std::string& cachePath, const sakura::game::ChartSourceStamp& source) const
+{
+    if (!IsComplete()) return false;
+
+    SkwHeader header{};
+    std::memcpy(header.magic, SKW_MAGIC, sizeof(SKW_MAGIC));
+    header.formatVersion     = FORMAT_VERSION;
+    header.sampleRate        = SAMPLE_RATE;
+    header.baseBucketSamples = BASE_BUCKET_SAMPLES;
+    header.levelCount        = static_cast<uint32_t>(LEVEL_COUNT);
+    header.totalSamples      = m_written;
+    header.sourceMtime       = source.mtime;
+    header.sourceSize        = source.size;
+
+    // 先写临时文件再替换，避免并发读取到写了一半的缓存
+    const std::string tmpPath = cachePath + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARN("无法写入波形缓存: {}", tmpPath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (size_t level = 0; level < LEVEL_COUNT; ++level)
+        {
+            // 实际样本数少于预估时，各级就绪桶数恰好等于按实际样本数计算的桶数
+            const size_t count = GetReadyCount(level);
+            file.write(reinterpret_cast<const char*>(m_levels[level].data()),
+                       static_cast<std::streamsize>(count * sizeof(WaveformBucket)));
+        }
+        if (!file)
+        {
+            LOG_WARN("写入波形缓存失败: {}", tmpPath);
+            file.close();
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        LOG_WARN("替换波形缓存失败 [{}]: {}", cachePath, ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace sakura::audio
@@ -0,0 +1,105 @@
+#pragma once
+
+// waveform_pyramid.h — 多分辨率波形金字塔（min / max / RMS，与 miniaudio / SDL 解耦，可单元测试）
+// 第 k 级每个桶覆盖 2^k 毫秒（1ms ~ 1024ms 共 11 级），各级在流式输入时同步生成：
+// 写入线程每补齐一个桶即以 release 发布该级的就绪计数，读者只访问已就绪的桶，
+// 因此解码过程中即可逐步绘制。桶数组按预估总长度一次分配，写入期间不会重新分配。
+//
+// 缓存文件（与音频同目录、同名、扩展名 .skw，小端）：
+//   SkwHeader（48 字节，含音频文件 mtime / size 指纹）
+//   WaveformBucket × 第 0 级桶数，…，WaveformBucket × 第 10 级桶数
+
+#include "game/chart_binary.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sakura::audio
+{
+
+// 量化桶：min / max 以 ±127 表示 ±1.0，rms 以 255 表示 1.0
+struct WaveformBucket
+{
+    int8_t  min = 0;
+    int8_t  max = 0;
+    uint8_t rms = 0;
+    uint8_t reserved = 0;
+};
+static_assert(sizeof(WaveformBucket) == 4);
+
+class WaveformPyramid
+{
+public:
+    static constexpr uint32_t FORMAT_VERSION      = 1;
+    static constexpr size_t   LEVEL_COUNT         = 11;
+    static constexpr uint32_t SAMPLE_RATE         = 48000;   // 输入须为该采样率的单声道
+    static constexpr uint32_t BASE_BUCKET_SAMPLES = SAMPLE_RATE / 1000;
+
+    // 按 totalSamples 预分配各级桶；超出部分的输入被忽略
+    explicit WaveformPyramid(uint64_t totalSamples);
+
+    WaveformPyramid(const WaveformPyramid&)            = delete;
+    WaveformPyramid& operator=(const WaveformPyramid&) = delete;
+
+    // ── 写入线程 ──────────────────────────────────────────────────────────────
+
+    void Append(const float* mono, size_t count);
+    // 输入结束：刷出各级未满的尾桶并标记完成
+    void Finish();
+
+    // ── 读者（任意线程）──────────────────────────────────────────────────────
+
+    bool     IsComplete() const { return m_complete.load(std::memory_order_acquire); }
+    uint64_t GetTotalSamples() const { return m_totalSamples; }
+    // 已写入样本占预估总长度的比例（0~1）
+    float    GetProgress() const;
+
+    size_t GetBucketCount(size_t level) const { return m_levels[level].size(); }
+    size_t GetReadyCount(size_t level) const  { return m_ready[level].load(std::memory_order_acquire); }
+    // 只可访问 [0, GetReadyCount(level)) 内的桶
+    const WaveformBucket* GetLevel(size_t level) const { return m_levels[level].data(); }
+
+    static int GetBucketMs(size_t level) { return 1 << level; }
+    // 每桶时长不超过 maxBucketMs 的最粗层级（不足 1ms 时取第 0 级）
+    static size_t ChooseLevel(double maxBucketMs);
+
+    // ── 磁盘缓存 ──────────────────────────────────────────────────────────────
+
+    // 音频文件对应的缓存路径（同目录、同名、扩展名 .skw）
+    static std::string GetCachePath(const std::string& audioPath);
+
+    // 读取缓存；文件缺失、损坏、版本或音频指纹（mtime + size）不符返回 nullptr
+    static std::unique_ptr<WaveformPyramid> Read(const std::string& cachePath,
+                                                 const sakura::game::ChartSourceStamp& source);
+
+    // 写入已完成的金字塔（先写临时文件再原子替换），失败时返回 false 并 LOG_WARN
+    bool Write(const std::string& cachePath, const sakura::game::ChartSourceStamp& source) const;
+
+private:
+    // 各级正在累积的桶（浮点，保证 RMS 逐级合并无量化误差）
+    struct Accumulator
+    {
+        float    min      = 0.0f;
+        float    max      = 0.0f;
+        double   sumSq    = 0.0;
+        uint32_t samples  = 0;
+        uint32_t children = 0;   // 第 0 级以外：已并入的子桶数
+    };
+
+    void Emit(size_t level);
+
+    uint64_t m_totalSamples = 0;
+    uint64_t m_written      = 0;   // 仅写入线程
+    std::array<std::vector<WaveformBucket>, LEVEL_COUNT> m_levels;
+    std::array<std::atomic<size_t>, LEVEL_COUNT>         m_ready{};
+    std::array<Accumulator, LEVEL_COUNT>                 m_acc{};
+    std::atomic<uint64_t> m_progress{ 0 };
+    std::atomic<bool>     m_complete{ false };
+};
+
+} // namespace sakura::audio
@@ -7,6 +7,7 @@
 #include "audio/audio_manager.h"
 #include "audio/audio_visualizer.h"
 #include "game/chart_loader.h"
+#include "game/chart_library.h"
 #include "game/achievement_manager.h"
 #include "data/database.h"
 #include "effects/screen_shake.h"
@@ -14,6 +15,7 @@
 #include "ui/button.h"
 
 #include <cstdlib>
+#include <filesystem>
 #include <string>
 
 namespace
@@ -72,10 +74,15 @@ bool App::Initialize()
     Theme::GetInstance().Initialize();
 
     // ── 数据库 ───────────────────────────────────────────────────────────────────
-    if (!sakura::data::Database::GetInstance().Initialize(ResolveDatabasePath()))
+    const std::string dbPath = ResolveDatabasePath();
+    if (!sakura::data::Database::GetInstance().Initialize(dbPath))
     {
         LOG_WARN("Database 初始化失败（非致命）");
     }
+    // 谱面库索引与数据库放在同一目录
+    sakura::game::ChartLibrary::GetInstance().SetIndexPath(
+        (std::filesystem::path(dbPath).parent_path()
+         / sakura::game::ChartLibrary::INDEX_FILE_NAME).string());
     if (!sakura::game::AchievementManager::GetInstance().LoadAchievements())
     {
         LOG_WARN("AchievementManager 初始化失败（非致命）");
@@ -99,6 +106,8 @@ bool App::Initialize()
     {
         return false;
     }
+    m_renderer.SetBatchingEnabled(Config::GetInstance().Get<bool>(
+        std::string(ConfigKeys::kRenderBatching), true));
     Input::SetScreenSize(m_renderer.GetScreenWidth(), m_renderer.GetScreenHeight());
 
     // ── 资源管理器 ───────────────────────────────────────────────────────────
@@ -111,7 +120,7 @@ bool App::Initialize()
         int sw = m_renderer.GetScreenWidth();
         int sh = m_renderer.GetScreenHeight();
         if (!sakura::effects::ShaderManager::GetInstance().Initialize(
-                m_renderer.GetSDLRenderer(), sw, sh))
+                m_renderer, sw, sh))
         {
             LOG_WARN("ShaderManager 初始化失败（非致命）");
         }
@@ -143,10 +152,10 @@ bool App::Initialize()
     // ── 谱面加载器验证（Step 1.3 验收）──────────────────────────────────────────
     {
         sakura::game::ChartLoader loader;
-        auto charts = loader.ScanCharts("resources/charts/");
-        if (!charts.empty())
+        auto charts = sakura::game::ChartLibrary::GetInstance().GetCharts("resources/charts/");
+        if (!charts->empty())
         {
-            const auto& firstChart = charts[0];
+            const auto& firstChart = (*charts)[0];
             if (!firstChart.difficulties.empty())
             {
                 std::string chartDataPath = firstChart.folderPath + "/"
@@ -207,10 +216,13 @@ void App::Run()
         if (m_fpsLogTimer >= FPS_LOG_INTERVAL)
         {
             m_fpsLogTimer = 0.0f;
-            LOG_DEBUG("FPS: {:.1f}  帧数: {}  运行时间: {:.1f}s",
+            const auto& batch = m_renderer.GetFrameStats();
+            LOG_DEBUG("FPS: {:.1f}  帧数: {}  运行时间: {:.1f}s  draw call: {}  图元: {}",
                 m_timer.GetFPS(),
                 m_timer.GetFrameCount(),
-                m_timer.GetElapsedTime());
+                m_timer.GetElapsedTime(),
+                batch.drawCalls,
+                batch.primitives);
         }
     }
 
@@ -247,6 +259,9 @@ void App::Shutdown()
 
 void App::ProcessEvents()
 {
+    // 先记录泵取时刻：此前发生的事件都会在下面的循环中取到
+    Input::BeginEventPump();
+
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
@@ -286,10 +301,9 @@ void App::Update(float dt)
     // 同步屏幕尺寸给输入系统（用于归一化鼠标坐标）
     Input::SetScreenSize(m_renderer.GetScreenWidth(), m_renderer.GetScreenHeight());
 
-    // 全屏配置同步：检测 Config 中设置是否与当前窗口状态一致
+    // 全屏配置同步：检测 Config 中设置是否与当前窗口状态一致（读快照，不逐帧查 JSON）
     {
-        bool cfgFullscreen = Config::GetInstance().Get<bool>(
-            std::string(ConfigKeys::kFullscreen), false);
+        const bool cfgFullscreen = Config::GetInstance().GetSnapshot().fullscreen;
         if (cfgFullscreen != m_window.IsFullscreen())
             m_window.SetFullscreen(cfgFullscreen);
     }
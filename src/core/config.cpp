@@ -1,12 +1,60 @@
 #include "config.h"
 #include "utils/logger.h"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
 namespace sakura::core
 {
 
+// ── 快照使用的预编译键（首次重建时构造一次）─────────────────────────────────
+
+namespace
+{
+
+struct SnapshotKeys
+{
+    ConfigKey<bool>        fullscreen    { ConfigKeys::kFullscreen,    false };
+    ConfigKey<bool>        vsync         { ConfigKeys::kVSync,         true };
+    ConfigKey<int>         fpsLimit      { ConfigKeys::kFpsLimit,      0 };
+    ConfigKey<float>       backgroundDim { ConfigKeys::kBackgroundDim, 0.5f };
+
+    ConfigKey<float>       masterVolume  { ConfigKeys::kMasterVolume,  1.0f };
+    ConfigKey<float>       musicVolume   { ConfigKeys::kMusicVolume,   0.8f };
+    ConfigKey<float>       sfxVolume     { ConfigKeys::kSfxVolume,     1.0f };
+    ConfigKey<int>         audioOffset   { ConfigKeys::kAudioOffset,   0 };
+
+    ConfigKey<float>       noteSpeed     { ConfigKeys::kNoteSpeed,     5.0f };
+    ConfigKey<bool>        autoPlay      { ConfigKeys::kAutoPlay,      false };
+    ConfigKey<std::string> scrollDir     { ConfigKeys::kScrollDir,     "down" };
+    ConfigKey<bool>        judgeThread   { ConfigKeys::kJudgeThread,   false };
+    ConfigKey<int>         judgeOffset   { ConfigKeys::kJudgeOffset,   0 };
+
+    std::array<ConfigKey<int>, 4> laneKeys {{
+        { ConfigKeys::kKeyLane0, 4 },    // SDL_SCANCODE_A
+        { ConfigKeys::kKeyLane1, 22 },   // SDL_SCANCODE_S
+        { ConfigKeys::kKeyLane2, 7 },    // SDL_SCANCODE_D
+        { ConfigKeys::kKeyLane3, 9 },    // SDL_SCANCODE_F
+    }};
+    ConfigKey<int>         keyPause      { ConfigKeys::kKeyPause,      41 };
+    ConfigKey<int>         keyRetry      { ConfigKeys::kKeyRetry,      21 };
+    ConfigKey<int>         keyBack       { ConfigKeys::kKeyBack,       41 };
+
+    ConfigKey<bool>        particles     { ConfigKeys::kParticles,     true };
+    ConfigKey<bool>        bloom         { ConfigKeys::kBloom,         false };
+
+    ConfigKey<int>         stressStall   { ConfigKeys::kJudgeStressStallMs, 0 };
+};
+
+const SnapshotKeys& GetSnapshotKeys()
+{
+    static const SnapshotKeys keys;
+    return keys;
+}
+
+} // namespace
+
 // ── 默认配置值 ────────────────────────────────────────────────────────────────
 
 void Config::ApplyDefaults()
@@ -16,6 +64,7 @@ void Config::ApplyDefaults()
     {
         if (!Has(key)) Set(key, val);
     };
+    ++m_batchDepth;
 
     // 显示
     setDefault(ConfigKeys::kWindowWidth,  1920);
@@ -34,6 +83,7 @@ void Config::ApplyDefaults()
     setDefault(ConfigKeys::kNoteSpeed,    5.0f);
     setDefault(ConfigKeys::kAutoPlay,     false);
     setDefault(ConfigKeys::kScrollDir,    std::string("down"));
+    setDefault(ConfigKeys::kJudgeThread,  false);
 
     // 输入绑定（SDL_SCANCODE 数值）
     setDefault(ConfigKeys::kKeyPause,     41);   // SDL_SCANCODE_ESCAPE
@@ -50,14 +100,80 @@ void Config::ApplyDefaults()
     setDefault(ConfigKeys::kParticles,    true);
     setDefault(ConfigKeys::kBloom,        false);
     setDefault(ConfigKeys::kSkinPath,     std::string("resources/skins/default"));
+    setDefault(ConfigKeys::kRenderBatching, true);
 
     // 教程
     setDefault(ConfigKeys::kTutorialCompleted,   false);
     setDefault(ConfigKeys::kTutorialPromptShown, false);
 
+    --m_batchDepth;
     m_dirty = false;  // 默认值不算脏
 }
 
+// ── 快照与变更通知 ────────────────────────────────────────────────────────────
+
+void Config::RebuildSnapshot()
+{
+    const auto& k = GetSnapshotKeys();
+    ConfigSnapshot s;
+
+    s.fullscreen    = Get(k.fullscreen);
+    s.vsync         = Get(k.vsync);
+    s.fpsLimit      = Get(k.fpsLimit);
+    s.backgroundDim = Get(k.backgroundDim);
+
+    s.masterVolume  = Get(k.masterVolume);
+    s.musicVolume   = Get(k.musicVolume);
+    s.sfxVolume     = Get(k.sfxVolume);
+    s.audioOffsetMs = Get(k.audioOffset);
+
+    s.noteSpeed     = Get(k.noteSpeed);
+    s.autoPlay      = Get(k.autoPlay);
+    s.scrollUp      = Get(k.scrollDir) == "up";
+    s.judgeThread   = Get(k.judgeThread);
+    s.judgeOffsetMs = Get(k.judgeOffset);
+
+    for (size_t i = 0; i < s.laneKeys.size(); ++i)
+        s.laneKeys[i] = Get(k.laneKeys[i]);
+    s.keyPause      = Get(k.keyPause);
+    s.keyRetry      = Get(k.keyRetry);
+    s.keyBack       = Get(k.keyBack);
+
+    s.particles     = Get(k.particles);
+    s.bloom         = Get(k.bloom);
+
+    s.judgeStressStallMs = Get(k.stressStall);
+
+    s.version  = m_snapshot.version + 1;
+    m_snapshot = s;
+}
+
+void Config::OnChanged(std::string_view key)
+{
+    if (m_batchDepth > 0) return;
+
+    RebuildSnapshot();
+
+    // 拷贝一份，允许回调内订阅 / 退订
+    const auto listeners = m_listeners;
+    for (const auto& [id, listener] : listeners)
+    {
+        if (listener) listener(key);
+    }
+}
+
+Config::ListenerId Config::Subscribe(ChangeListener listener)
+{
+    const ListenerId id = m_nextListenerId++;
+    m_listeners.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void Config::Unsubscribe(ListenerId id)
+{
+    std::erase_if(m_listeners, [id](const auto& entry) { return entry.first == id; });
+}
+
 // ── 文件操作 ──────────────────────────────────────────────────────────────────
 
 bool Config::Load(std::string_view path)
@@ -70,6 +186,7 @@ bool Config::Load(std::string_view path)
     {
         LOG_INFO("Config: 配置文件不存在 ({}), 使用默认值", path);
         ApplyDefaults();
+        OnChanged({});
         // 立即保存默认配置
         m_dirty = true;
         SaveForce();
@@ -83,6 +200,7 @@ bool Config::Load(std::string_view path)
         {
             LOG_ERROR("Config: 无法打开配置文件: {}", path);
             ApplyDefaults();
+            OnChanged({});
             return false;
         }
         m_data = nlohmann::json::parse(ifs, nullptr, true, true);  // 允许注释
@@ -90,6 +208,7 @@ bool Config::Load(std::string_view path)
 
         // 补充新版本添加的缺失键
         ApplyDefaults();
+        OnChanged({});
 
         LOG_INFO("Config: 已加载 ({})", path);
         return true;
@@ -99,6 +218,7 @@ bool Config::Load(std::string_view path)
         LOG_ERROR("Config: JSON 解析失败: {} ({})", e.what(), path);
         m_data = {};
         ApplyDefaults();
+        OnChanged({});
         return false;
     }
 }
@@ -213,6 +333,7 @@ void Config::Remove(std::string_view key)
         }
     }
     m_dirty = true;
+    OnChanged(key);
 }
 
 void Config::ResetToDefaults()
@@ -221,6 +342,7 @@ void Config::ResetToDefaults()
     m_dirty = true;
     ApplyDefaults();
     m_dirty = true;   // 确保会追加保存
+    OnChanged({});
 }
 
 } // namespace sakura::core
@@ -2,11 +2,18 @@
 
 // config.h — 游戏配置管理器（基于 nlohmann_json，单例）
 // 支持嵌套键（"display.width"），线程不安全（游戏单线程使用）。
+// 热路径不要逐帧调用 Get（每次都按 "." 拆分键并遍历 JSON 树），
+// 应读取 GetSnapshot() 返回的类型化快照；快照在每次 Set / Load / Remove 后重建。
 
 #include <nlohmann/json.hpp>
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <string_view>
 #include <filesystem>
+#include <utility>
+#include <vector>
 
 namespace sakura::core
 {
@@ -32,11 +39,18 @@ namespace ConfigKeys
     inline constexpr std::string_view kNoteSpeed      = "gameplay.note_speed";     // float 1.0~10.0
     inline constexpr std::string_view kAutoPlay       = "gameplay.auto_play";       // bool
     inline constexpr std::string_view kScrollDir      = "gameplay.scroll_dir";      // string "down"/"up"
+    inline constexpr std::string_view kJudgeThread    = "gameplay.judge_thread";    // bool  1kHz 独立判定线程
+    inline constexpr std::string_view kJudgeOffset    = "game.judge_offset";        // int   判定窗口微调（±5ms）
+    inline constexpr std::string_view kBackgroundDim  = "background_dimming";       // float 0.0~1.0
 
     // ── 输入绑定 ──────────────────────────────────────────────────────────────
     inline constexpr std::string_view kKeyPause       = "input.key_pause";         // int (SDL_Scancode)
     inline constexpr std::string_view kKeyRetry       = "input.key_retry";         // int
     inline constexpr std::string_view kKeyBack        = "input.key_back";          // int
+    inline constexpr std::string_view kKeyLane0       = "input.key_lane_0";        // int
+    inline constexpr std::string_view kKeyLane1       = "input.key_lane_1";        // int
+    inline constexpr std::string_view kKeyLane2       = "input.key_lane_2";        // int
+    inline constexpr std::string_view kKeyLane3       = "input.key_lane_3";        // int
 
     // ── 数据 ─────────────────────────────────────────────────────────────────
     inline constexpr std::string_view kDatabasePath   = "data.database_path";      // string
@@ -48,12 +62,90 @@ namespace ConfigKeys
     inline constexpr std::string_view kParticles      = "graphics.particles";      // bool
     inline constexpr std::string_view kBloom          = "graphics.bloom";           // bool
     inline constexpr std::string_view kSkinPath       = "graphics.skin_path";       // string
+    inline constexpr std::string_view kRenderBatching = "graphics.render_batching"; // bool 关闭后逐图元提交（对比 draw call）
+
+    // ── 调试 ─────────────────────────────────────────────────────────────────
+    inline constexpr std::string_view kJudgeStressStallMs = "debug.judge_stress_stall_ms"; // int 渲染卡顿压力测试（0=关闭）
 
     // ── 教程 ─────────────────────────────────────────────────────────────────
     inline constexpr std::string_view kTutorialCompleted  = "tutorial.completed";    // bool
     inline constexpr std::string_view kTutorialPromptShown = "tutorial.prompt_shown"; // bool
 }
 
+// ── 预编译键 ──────────────────────────────────────────────────────────────────
+
+// 构造时把 "a.b.c" 一次性转换为 JSON Pointer（"/a/b/c"），读取时不再拆分字符串
+template<typename T>
+class ConfigKey
+{
+public:
+    ConfigKey(std::string_view key, T defaultVal)
+        : m_name(key)
+        , m_pointer(ToPointer(key))
+        , m_default(std::move(defaultVal))
+    {
+    }
+
+    std::string_view                   Name()    const { return m_name; }
+    const nlohmann::json::json_pointer& Pointer() const { return m_pointer; }
+    const T&                           Default() const { return m_default; }
+
+private:
+    static nlohmann::json::json_pointer ToPointer(std::string_view key)
+    {
+        std::string path;
+        path.reserve(key.size() + 1);
+        path += '/';
+        for (char c : key) path += (c == '.') ? '/' : c;
+        return nlohmann::json::json_pointer(path);
+    }
+
+    std::string_view             m_name;
+    nlohmann::json::json_pointer m_pointer;
+    T                            m_default;
+};
+
+// ── 类型化快照 ────────────────────────────────────────────────────────────────
+
+// 运行期频繁读取的配置项（纯数据，可按值拷贝）
+struct ConfigSnapshot
+{
+    // 显示
+    bool  fullscreen         = false;
+    bool  vsync              = true;
+    int   fpsLimit           = 0;
+    float backgroundDim      = 0.5f;
+
+    // 音频
+    float masterVolume       = 1.0f;
+    float musicVolume        = 0.8f;
+    float sfxVolume          = 1.0f;
+    int   audioOffsetMs      = 0;
+
+    // 游戏玩法
+    float noteSpeed          = 5.0f;
+    bool  autoPlay           = false;
+    bool  scrollUp           = false;   // scroll_dir == "up"
+    bool  judgeThread        = false;
+    int   judgeOffsetMs      = 0;
+
+    // 输入绑定（SDL_Scancode 数值）
+    std::array<int, 4> laneKeys = { 4, 22, 7, 9 };   // A S D F
+    int   keyPause           = 41;
+    int   keyRetry           = 21;
+    int   keyBack            = 41;
+
+    // 图形
+    bool  particles          = true;
+    bool  bloom              = false;
+
+    // 调试
+    int   judgeStressStallMs = 0;
+
+    // 每次重建 +1，可用于检测变化
+    uint64_t version         = 0;
+};
+
 // ============================================================================
 // Config — 配置管理单例
 // ============================================================================
@@ -100,6 +192,24 @@ public:
         }
     }
 
+    // 按预编译键读取（不拆分字符串）；不存在或类型不符时返回键的默认值
+    template<typename T>
+    T Get(const ConfigKey<T>& key) const
+    {
+        try
+        {
+            if (!m_data.contains(key.Pointer())) return key.Default();
+            return m_data.at(key.Pointer()).template get<T>();
+        }
+        catch (...)
+        {
+            return key.Default();
+        }
+    }
+
+    // 类型化快照（热路径使用）：引用在 Config 生命周期内有效，内容随配置变更更新
+    const ConfigSnapshot& GetSnapshot() const { return m_snapshot; }
+
     // ── 写入 ──────────────────────────────────────────────────────────────────
 
     template<typename T>
@@ -107,8 +217,27 @@ public:
     {
         TraverseWrite(key) = value;
         m_dirty = true;
+        OnChanged(key);
     }
 
+    template<typename T>
+    void Set(const ConfigKey<T>& key, T value)
+    {
+        m_data[key.Pointer()] = std::move(value);
+        m_dirty = true;
+        OnChanged(key.Name());
+    }
+
+    // ── 变更通知 ──────────────────────────────────────────────────────────────
+
+    // 回调参数为发生变化的键；整体变化（Load / ResetToDefaults）时为空字符串。
+    // 回调在快照重建之后调用，可直接读取 GetSnapshot()
+    using ChangeListener = std::function<void(std::string_view key)>;
+    using ListenerId     = uint32_t;
+
+    ListenerId Subscribe(ChangeListener listener);
+    void       Unsubscribe(ListenerId id);
+
     // 检测键是否存在
     bool Has(std::string_view key) const;
 
@@ -127,7 +256,11 @@ public:
     const nlohmann::json& GetRoot() const { return m_data; }
 
 private:
-    Config() = default;
+    Config() { RebuildSnapshot(); }
+
+    // 重建快照并通知订阅者（批量写入期间推迟到批量结束）
+    void OnChanged(std::string_view key);
+    void RebuildSnapshot();
 
     // 写入默认值（首次运行时调用）
     void ApplyDefaults();
@@ -141,6 +274,11 @@ private:
     nlohmann::json  m_data;
     std::string     m_filePath;
     bool            m_dirty = false;
+
+    ConfigSnapshot  m_snapshot;
+    std::vector<std::pair<ListenerId, ChangeListener>> m_listeners;
+    ListenerId      m_nextListenerId = 1;
+    int             m_batchDepth     = 0;   // >0 时 Set 不触发重建 / 通知
 };
 
 } // namespace sakura::core
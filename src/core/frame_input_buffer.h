@@ -1,14 +1,18 @@
 #pragma once
 
+#include <cstdint>
 #include <span>
 #include <vector>
 
 namespace sakura::core
 {
 
+// timestampNs: SDL 事件时间戳（SDL_GetTicksNS 时基，纳秒；0 = 未知），
+// 供游戏场景把按下映射到歌曲时间轴，而不是使用固定步长更新时刻
 struct KeyPressFrameEvent
 {
-    int scancode = 0;
+    int      scancode    = 0;
+    uint64_t timestampNs = 0;
 };
 
 struct MouseButtonFrameEvent
@@ -18,23 +22,25 @@ struct MouseButtonFrameEvent
     float normY  = 0.0f;
     float pixelX = 0.0f;
     float pixelY = 0.0f;
+    uint64_t timestampNs = 0;
 };
 
 class FrameInputBuffer
 {
 public:
-    void PushKeyPress(int scancode)
+    void PushKeyPress(int scancode, uint64_t timestampNs = 0)
     {
-        m_keyPresses.push_back({ scancode });
+        m_keyPresses.push_back({ scancode, timestampNs });
     }
 
     void PushMouseButtonPress(int button,
                               float normX,
                               float normY,
                               float pixelX,
-                              float pixelY)
+                              float pixelY,
+                              uint64_t timestampNs = 0)
     {
-        m_mouseButtonPresses.push_back({ button, normX, normY, pixelX, pixelY });
+        m_mouseButtonPresses.push_back({ button, normX, normY, pixelX, pixelY, timestampNs });
     }
 
     std::span<const KeyPressFrameEvent> GetKeyPresses() const
@@ -0,0 +1,90 @@
+// geometry_batch.cpp — 帧级几何批处理实现
+
+#include "geometry_batch.h"
+
+#include <utility>
+
+namespace sakura::core
+{
+
+GeometryBatch::GeometryBatch(SubmitFn submit)
+    : m_submit(std::move(submit))
+{
+    m_vertices.reserve(4096);
+    m_indices.reserve(8192);
+}
+
+void GeometryBatch::SetEnabled(bool enabled)
+{
+    if (m_enabled == enabled) return;
+    Flush(FlushReason::FrameEnd);
+    m_enabled = enabled;
+}
+
+GeometryBatch::Primitive GeometryBatch::Add(void* texture, size_t vertexCount, size_t indexCount)
+{
+    if (!Empty())
+    {
+        if (!m_enabled)
+            Flush(FlushReason::Unbatched);
+        else if (texture != m_texture)
+            Flush(FlushReason::Texture);
+    }
+    m_texture = texture;
+
+    const size_t baseVertex = m_vertices.size();
+    const size_t baseIndex  = m_indices.size();
+    m_vertices.resize(baseVertex + vertexCount);
+    m_indices.resize(baseIndex + indexCount);
+
+    ++m_stats.primitives;
+    m_stats.vertices += static_cast<uint32_t>(vertexCount);
+    m_stats.indices  += static_cast<uint32_t>(indexCount);
+
+    return { m_vertices.data() + baseVertex, m_indices.data() + baseIndex, static_cast<int>(baseVertex) };
+}
+
+void GeometryBatch::AddQuad(void* texture, const BatchVertex& v0, const BatchVertex& v1,
+                            const BatchVertex& v2, const BatchVertex& v3)
+{
+    Primitive p = Add(texture, 4, 6);
+    p.vertices[0] = v0;
+    p.vertices[1] = v1;
+    p.vertices[2] = v2;
+    p.vertices[3] = v3;
+    const int b = p.baseVertex;
+    p.indices[0] = b;     p.indices[1] = b + 1; p.indices[2] = b + 2;
+    p.indices[3] = b;     p.indices[4] = b + 2; p.indices[5] = b + 3;
+}
+
+void GeometryBatch::Flush(FlushReason reason)
+{
+    if (Empty())
+    {
+        m_vertices.clear();
+        return;
+    }
+
+    if (m_submit)
+    {
+        m_submit(m_texture,
+                 m_vertices.data(), static_cast<int>(m_vertices.size()),
+                 m_indices.data(), static_cast<int>(m_indices.size()));
+    }
+    ++m_stats.drawCalls;
+    ++m_stats.flushes[static_cast<size_t>(reason)];
+
+    // clear 保留容量，后续帧复用
+    m_vertices.clear();
+    m_indices.clear();
+    m_texture = nullptr;
+}
+
+void GeometryBatch::Discard()
+{
+    m_vertices.clear();
+    m_indices.clear();
+    m_texture = nullptr;
+}
+
+} // namespace sakura::core
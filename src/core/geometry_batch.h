@@ -0,0 +1,100 @@
+#pragma once
+
+// geometry_batch.h — 帧级几何批处理（与 SDL 解耦，可单元测试）
+// Renderer 的图元（矩形、圆、弧、线、圆角矩形、贴图、文字）先写入持久的顶点 / 索引缓冲，
+// 只有纹理切换、混合模式切换、渲染目标切换、外部原生绘制之前或帧末才合并提交一次。
+// 缓冲在帧间复用，容量稳定后每帧不再分配；BatchStats 记录实际提交次数与图元数以便对比。
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace sakura::core
+{
+
+// 与 SDL_Vertex 布局一致（position / color / tex_coord），由 Renderer 静态断言保证
+struct BatchVertex
+{
+    float x = 0.0f, y = 0.0f;
+    float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
+    float u = 0.0f, v = 0.0f;
+};
+
+// 提交原因（用于统计）
+enum class FlushReason : uint8_t
+{
+    Texture,        // 下一图元的纹理不同
+    BlendMode,      // 混合模式切换
+    RenderTarget,   // 渲染目标切换
+    External,       // 外部代码即将直接调用 SDL 绘制
+    FrameEnd,       // 帧末 / 视口变化
+    Unbatched,      // 批处理关闭：每个图元单独提交
+    Count
+};
+
+struct BatchStats
+{
+    uint32_t drawCalls  = 0;   // 实际提交次数
+    uint32_t primitives = 0;   // 图元数（即未批处理时的提交次数）
+    uint32_t vertices   = 0;
+    uint32_t indices    = 0;
+    std::array<uint32_t, static_cast<size_t>(FlushReason::Count)> flushes{};
+
+    uint32_t FlushCount(FlushReason reason) const { return flushes[static_cast<size_t>(reason)]; }
+};
+
+class GeometryBatch
+{
+public:
+    // texture 为不透明的纹理指针（nullptr = 纯色），索引已是批次内的绝对下标
+    using SubmitFn = std::function<void(void* texture,
+                                        const BatchVertex* vertices, int vertexCount,
+                                        const int* indices, int indexCount)>;
+
+    // Add 返回的可写区：索引须加上 baseVertex；指针在下一次 Add / Flush 前有效
+    struct Primitive
+    {
+        BatchVertex* vertices   = nullptr;
+        int*         indices    = nullptr;
+        int          baseVertex = 0;
+    };
+
+    explicit GeometryBatch(SubmitFn submit = {});
+
+    void SetSubmit(SubmitFn submit) { m_submit = std::move(submit); }
+
+    // 关闭后每个图元单独提交（与逐图元 SDL_RenderGeometry 等价，用于对比测量）
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_enabled; }
+
+    // 追加一个图元；纹理与当前批次不同时先提交
+    Primitive Add(void* texture, size_t vertexCount, size_t indexCount);
+
+    // 追加一个四边形（v0-v1-v2-v3 顺时针或逆时针均可）
+    void AddQuad(void* texture, const BatchVertex& v0, const BatchVertex& v1,
+                 const BatchVertex& v2, const BatchVertex& v3);
+
+    // 提交当前批次（为空时不计数）
+    void Flush(FlushReason reason);
+    // 丢弃未提交的图元（渲染器销毁时）
+    void Discard();
+
+    bool   Empty() const               { return m_indices.empty(); }
+    size_t GetPendingVertexCount() const { return m_vertices.size(); }
+    void*  GetPendingTexture() const   { return m_texture; }
+
+    const BatchStats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = BatchStats{}; }
+
+private:
+    SubmitFn                 m_submit;
+    std::vector<BatchVertex> m_vertices;
+    std::vector<int>         m_indices;
+    void*                    m_texture = nullptr;
+    bool                     m_enabled = true;
+    BatchStats               m_stats;
+};
+
+} // namespace sakura::core
@@ -0,0 +1,166 @@
+// glyph_atlas.cpp — 字形图集簿记实现
+
+#include "glyph_atlas.h"
+
+namespace sakura::core
+{
+
+// ── ShelfPacker ───────────────────────────────────────────────────────────────
+
+ShelfPacker::ShelfPacker(int width, int height, int padding)
+    : m_width(width)
+    , m_height(height)
+    , m_padding(padding)
+{
+}
+
+bool ShelfPacker::Pack(int w, int h, AtlasRect& out)
+{
+    const int paddedW = w + m_padding * 2;
+    const int paddedH = h + m_padding * 2;
+    if (paddedW > m_width || paddedH > m_height) return false;
+
+    // 选择放得下的最矮货架，减少纵向浪费
+    Shelf* best = nullptr;
+    for (auto& shelf : m_shelves)
+    {
+        if (shelf.height >= paddedH && shelf.cursorX + paddedW <= m_width
+            && (!best || shelf.height < best->height))
+            best = &shelf;
+    }
+
+    if (!best)
+    {
+        if (m_nextY + paddedH > m_height) return false;
+        m_shelves.push_back({ m_nextY, paddedH, 0 });
+        m_nextY += paddedH;
+        best = &m_shelves.back();
+    }
+
+    out = { best->cursorX + m_padding, best->y + m_padding, w, h };
+    best->cursorX += paddedW;
+    return true;
+}
+
+// ── UTF-8 ─────────────────────────────────────────────────────────────────────
+
+uint32_t NextCodepoint(std::string_view text, size_t& pos)
+{
+    constexpr uint32_t REPLACEMENT = 0xFFFD;
+
+    const auto byte = [&](size_t i) { return static_cast<uint8_t>(text[i]); };
+    const uint8_t lead = byte(pos);
+
+    size_t   length = 0;
+    uint32_t cp     = 0;
+    if (lead < 0x80)              { ++pos; return lead; }
+    else if ((lead & 0xE0) == 0xC0) { length = 2; cp = lead & 0x1F; }
+    else if ((lead & 0xF0) == 0xE0) { length = 3; cp = lead & 0x0F; }
+    else if ((lead & 0xF8) == 0xF0) { length = 4; cp = lead & 0x07; }
+    else                          { ++pos; return REPLACEMENT; }
+
+    if (pos + length > text.size()) { ++pos; return REPLACEMENT; }
+    for (size_t i = 1; i < length; ++i)
+    {
+        const uint8_t cont = byte(pos + i);
+        if ((cont & 0xC0) != 0x80) { ++pos; return REPLACEMENT; }
+        cp = (cp << 6) | (cont & 0x3F);
+    }
+
+    // 过长编码、代理区与超出范围的码点视为非法
+    static constexpr uint32_t MIN_FOR_LENGTH[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+    if (cp < MIN_FOR_LENGTH[length] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+    {
+        ++pos;
+        return REPLACEMENT;
+    }
+
+    pos += length;
+    return cp;
+}
+
+// ── GlyphAtlas ────────────────────────────────────────────────────────────────
+
+GlyphAtlas::GlyphAtlas(int lineHeight, int pageSize)
+    : m_lineHeight(lineHeight)
+    , m_pageSize(pageSize)
+{
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::Find(uint32_t codepoint) const
+{
+    auto it = m_glyphs.find(codepoint);
+    return it != m_glyphs.end() ? &it->second : nullptr;
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::Insert(uint32_t codepoint, int advance,
+                                            int bitmapW, int bitmapH, bool& newPage)
+{
+    newPage = false;
+
+    Glyph glyph;
+    glyph.advance = advance;
+
+    if (bitmapW > 0 && bitmapH > 0)
+    {
+        AtlasRect rect;
+        if (!m_pages.empty() && m_pages.back().Pack(bitmapW, bitmapH, rect))
+        {
+            glyph.page = static_cast<int>(m_pages.size()) - 1;
+            glyph.rect = rect;
+        }
+        else
+        {
+            ShelfPacker fresh(m_pageSize, m_pageSize);
+            if (fresh.Pack(bitmapW, bitmapH, rect))
+            {
+                m_pages.push_back(fresh);
+                newPage = true;
+                glyph.page = static_cast<int>(m_pages.size()) - 1;
+                glyph.rect = rect;
+            }
+        }
+    }
+
+    return m_glyphs.insert_or_assign(codepoint, glyph).first->second;
+}
+
+bool GlyphAtlas::FindKerning(uint32_t previous, uint32_t codepoint, int& kerning) const
+{
+    auto it = m_kerning.find(KerningKey(previous, codepoint));
+    if (it == m_kerning.end()) return false;
+    kerning = it->second;
+    return true;
+}
+
+void GlyphAtlas::SetKerning(uint32_t previous, uint32_t codepoint, int kerning)
+{
+    m_kerning[KerningKey(previous, codepoint)] = kerning;
+}
+
+bool GlyphAtlas::IsCached(std::string_view text) const
+{
+    uint32_t previous = 0;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        const uint32_t cp = NextCodepoint(text, pos);
+        if (!Find(cp)) return false;
+        int kerning = 0;
+        if (previous != 0 && !FindKerning(previous, cp, kerning)) return false;
+        previous = cp;
+    }
+    return true;
+}
+
+bool GlyphAtlas::Measure(std::string_view text, int& width) const
+{
+    int end = 0;
+    const bool cached = Layout(text, [&](const Glyph& glyph, int penX) {
+        end = penX + glyph.advance;
+    });
+    if (cached) width = end;
+    return cached;
+}
+
+} // namespace sakura::core
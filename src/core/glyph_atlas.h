@@ -0,0 +1,126 @@
+#pragma once
+
+// glyph_atlas.h — 字形图集簿记（与 SDL 解耦，可单元测试）
+// 每个（字体, 像素字号）一份图集：字形只光栅化一次，以货架式装箱写入固定大小的页，
+// 之后文字按字形排版为贴图四边形经 GeometryBatch 合批绘制，测量直接累加缓存的步进与字距。
+// 纹理页与光栅化由 Renderer 负责，这里只记录字形所在页、矩形与度量。
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sakura::core
+{
+
+struct AtlasRect
+{
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+};
+
+// ============================================================================
+// ShelfPacker — 货架式矩形装箱（同一字号的字形高度相近，浪费很小）
+// ============================================================================
+class ShelfPacker
+{
+public:
+    ShelfPacker(int width, int height, int padding = 1);
+
+    // 分配 w×h 的矩形（四周留 padding），空间不足返回 false
+    bool Pack(int w, int h, AtlasRect& out);
+
+private:
+    struct Shelf
+    {
+        int y       = 0;
+        int height  = 0;
+        int cursorX = 0;
+    };
+
+    int m_width   = 0;
+    int m_height  = 0;
+    int m_padding = 0;
+    int m_nextY   = 0;
+    std::vector<Shelf> m_shelves;
+};
+
+// 从 pos 处解码一个 UTF-8 码点并前移 pos；非法序列返回 U+FFFD 并跳过一个字节
+uint32_t NextCodepoint(std::string_view text, size_t& pos);
+
+// ============================================================================
+// GlyphAtlas — 单一（字体, 像素字号）的字形表
+// ============================================================================
+class GlyphAtlas
+{
+public:
+    static constexpr int PAGE_SIZE = 1024;
+
+    struct Glyph
+    {
+        int       page    = -1;   // -1 = 无位图（空白字符或光栅化失败），只参与步进
+        AtlasRect rect;           // 页内像素矩形（位图左上角对齐笔位置与行顶）
+        int       advance = 0;
+    };
+
+    explicit GlyphAtlas(int lineHeight, int pageSize = PAGE_SIZE);
+
+    int    GetLineHeight() const { return m_lineHeight; }
+    int    GetPageSize() const   { return m_pageSize; }
+    size_t GetPageCount() const  { return m_pages.size(); }
+    size_t GetGlyphCount() const { return m_glyphs.size(); }
+
+    const Glyph* Find(uint32_t codepoint) const;
+
+    // 记录新字形；bitmapW/H > 0 时在当前页分配矩形，当前页已满则开新页（newPage 置 true）。
+    // 位图大于一页时按无位图记录。
+    const Glyph& Insert(uint32_t codepoint, int advance, int bitmapW, int bitmapH, bool& newPage);
+
+    bool FindKerning(uint32_t previous, uint32_t codepoint, int& kerning) const;
+    void SetKerning(uint32_t previous, uint32_t codepoint, int kerning);
+
+    // 所有字形与相邻字距均已缓存时返回 true
+    bool IsCached(std::string_view text) const;
+
+    // 逐字形排版：fn(const Glyph&, int penX)。有未缓存的字形或字距时返回 false 且不回调
+    template <typename Fn>
+    bool Layout(std::string_view text, Fn&& fn) const
+    {
+        if (!IsCached(text)) return false;
+        int penX = 0;
+        uint32_t previous = 0;
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            const uint32_t cp = NextCodepoint(text, pos);
+            int kerning = 0;
+            if (previous != 0) FindKerning(previous, cp, kerning);
+            penX += kerning;
+            const Glyph& glyph = *Find(cp);
+            fn(glyph, penX);
+            penX += glyph.advance;
+            previous = cp;
+        }
+        return true;
+    }
+
+    // 像素宽度（步进 + 字距之和）；有未缓存内容时返回 false
+    bool Measure(std::string_view text, int& width) const;
+
+private:
+    static uint64_t KerningKey(uint32_t previous, uint32_t codepoint)
+    {
+        return (static_cast<uint64_t>(previous) << 32) | codepoint;
+    }
+
+    int m_lineHeight = 0;
+    int m_pageSize   = PAGE_SIZE;
+    std::unordered_map<uint32_t, Glyph>    m_glyphs;
+    std::unordered_map<uint64_t, int>      m_kerning;
+    std::vector<ShelfPacker>               m_pages;
+};
+
+} // namespace sakura::core
@@ -22,10 +22,16 @@ float        Input::s_wheelDelta    = 0.0f;
 SDL_Scancode Input::s_lastPressedKey = SDL_SCANCODE_UNKNOWN;
 std::string  Input::s_textInput;
 FrameInputBuffer Input::s_frameInputBuffer;
+uint64_t     Input::s_eventPumpTimeNs = 0;
 bool         Input::s_debugLog      = false;
 
 // ── 事件处理 ──────────────────────────────────────────────────────────────────
 
+void Input::BeginEventPump()
+{
+    s_eventPumpTimeNs = SDL_GetTicksNS();
+}
+
 void Input::ProcessEvent(const SDL_Event& event)
 {
     switch (event.type)
@@ -41,7 +47,7 @@ void Input::ProcessEvent(const SDL_Event& event)
             {
                 s_currKeys[code]  = true;
                 s_lastPressedKey  = code;
-                s_frameInputBuffer.PushKeyPress(static_cast<int>(code));
+                s_frameInputBuffer.PushKeyPress(static_cast<int>(code), event.key.timestamp);
 
                 if (s_debugLog)
                 {
@@ -87,7 +93,8 @@ void Input::ProcessEvent(const SDL_Event& event)
                 normX,
                 normY,
                 s_mousePixelX,
-                s_mousePixelY);
+                s_mousePixelY,
+                event.button.timestamp);
 
             if (s_debugLog)
             {
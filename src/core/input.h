@@ -35,6 +35,9 @@ class Input
 public:
     // ── 生命周期 ──────────────────────────────────────────────────────────────
 
+    // 本帧开始泵取事件（SDL_PollEvent 循环之前调用），记录泵取时刻
+    static void BeginEventPump();
+
     // 事件处理（每帧在 SDL_PollEvent 循环内调用，可多次）
     static void ProcessEvent(const SDL_Event& event);
 
@@ -71,12 +74,15 @@ public:
     // 本帧最后一次按下的键（无则 SDL_SCANCODE_UNKNOWN）
     static SDL_Scancode GetLastPressedKey()           { return s_lastPressedKey; }
 
-    // 本帧收到的全部非 repeat 键盘按下事件（按到达顺序保留）
+    // 本帧收到的全部非 repeat 键盘按下事件（按到达顺序保留，附带 SDL 事件时间戳）
     static std::span<const KeyPressFrameEvent> GetKeyPressEvents()
     {
         return s_frameInputBuffer.GetKeyPresses();
     }
 
+    // 本帧泵取事件的主机时刻（SDL_GetTicksNS 时基）：此前发生的按键均已出现在本帧缓冲中
+    static uint64_t GetEventPumpTimeNs() { return s_eventPumpTimeNs; }
+
     // SDL 键名（英文）— 用于调试输出 / 按键绑定 UI
     static const char*  GetKeyName(SDL_Scancode code) { return SDL_GetScancodeName(code); }
 
@@ -89,7 +95,7 @@ public:
     // 任意鼠标键本帧刚按下
     static bool IsAnyMouseButtonPressed();
 
-    // 本帧收到的全部鼠标按下事件（按到达顺序保留）
+    // 本帧收到的全部鼠标按下事件（按到达顺序保留，附带 SDL 事件时间戳）
     static std::span<const MouseButtonFrameEvent> GetMouseButtonPressEvents()
     {
         return s_frameInputBuffer.GetMouseButtonPresses();
@@ -158,6 +164,9 @@ private:
     // 同帧按下事件缓冲，避免多个键鼠输入互相覆盖
     static FrameInputBuffer s_frameInputBuffer;
 
+    // 本帧泵取事件的主机时刻（纳秒）
+    static uint64_t     s_eventPumpTimeNs;
+
     // 调试日志开关
     static bool         s_debugLog;
 };
@@ -5,13 +5,18 @@
 #include <SDL3_image/SDL_image.h>
 #include <algorithm>
 #include <cmath>
-#include <limits>
+#include <cstddef>
 #include <string>
 #include <vector>
 
 namespace sakura::core
 {
 
+// BatchVertex 直接作为 SDL_Vertex 数组提交
+static_assert(sizeof(BatchVertex) == sizeof(SDL_Vertex));
+static_assert(offsetof(BatchVertex, r) == offsetof(SDL_Vertex, color));
+static_assert(offsetof(BatchVertex, u) == offsetof(SDL_Vertex, tex_coord));
+
 // ============================================================================
 // 预制颜色定义
 // ============================================================================
@@ -26,6 +31,139 @@ const Color Color::Magenta     = { 255,   0, 255, 255 };
 const Color Color::Transparent = {   0,   0,   0,   0 };
 const Color Color::DarkBlue    = {  15,  15,  35, 255 };
 
+// ============================================================================
+// 批处理工具
+// ============================================================================
+
+namespace
+{
+
+constexpr float kPi = 3.14159265358979323846f;
+
+BatchVertex MakeVertex(float x, float y, const SDL_FColor& c, float u = 0.0f, float v = 0.0f)
+{
+    return { x, y, c.r, c.g, c.b, c.a, u, v };
+}
+
+void PushRect(GeometryBatch& batch, const SDL_FRect& r, const SDL_FColor& c)
+{
+    batch.AddQuad(nullptr,
+                  MakeVertex(r.x,       r.y,       c),
+                  MakeVertex(r.x + r.w, r.y,       c),
+                  MakeVertex(r.x + r.w, r.y + r.h, c),
+                  MakeVertex(r.x,       r.y + r.h, c));
+}
+
+// 贴图四边形：src 为纹理坐标（0~1），rotationDeg 为绕目标矩形中心的顺时针角度
+void PushTexturedQuad(GeometryBatch& batch, SDL_Texture* tex, const SDL_FRect& dst,
+                      float u0, float v0, float u1, float v1,
+                      float rotationDeg, const SDL_FColor& c)
+{
+    float xs[4] = { dst.x, dst.x + dst.w, dst.x + dst.w, dst.x };
+    float ys[4] = { dst.y, dst.y,         dst.y + dst.h, dst.y + dst.h };
+
+    if (rotationDeg != 0.0f)
+    {
+        const float rad  = rotationDeg * kPi / 180.0f;
+        const float cosA = std::cos(rad);
+        const float sinA = std::sin(rad);
+        const float cx = dst.x + dst.w * 0.5f;
+        const float cy = dst.y + dst.h * 0.5f;
+        for (int i = 0; i < 4; ++i)
+        {
+            const float dx = xs[i] - cx;
+            const float dy = ys[i] - cy;
+            xs[i] = cx + dx * cosA - dy * sinA;
+            ys[i] = cy + dx * sinA + dy * cosA;
+        }
+    }
+
+    batch.AddQuad(tex,
+                  MakeVertex(xs[0], ys[0], c, u0, v0),
+                  MakeVertex(xs[1], ys[1], c, u1, v0),
+                  MakeVertex(xs[2], ys[2], c, u1, v1),
+                  MakeVertex(xs[3], ys[3], c, u0, v1));
+}
+
+// 三角扇形（圆心 + segments+1 个边缘顶点），直接写入批次
+void PushFan(GeometryBatch& batch, float pxCX, float pxCY, float pxRadius, int segments,
+             float angleStartRad, float angleEndRad, const SDL_FColor& fc)
+{
+    segments = std::max(1, segments);
+    const float step = (angleEndRad - angleStartRad) / static_cast<float>(segments);
+
+    auto prim = batch.Add(nullptr, static_cast<size_t>(segments) + 2, static_cast<size_t>(segments) * 3);
+    prim.vertices[0] = MakeVertex(pxCX, pxCY, fc, 0.5f, 0.5f);
+    for (int i = 0; i <= segments; ++i)
+    {
+        const float angle = angleStartRad + step * static_cast<float>(i);
+        const float cosA = std::cos(angle);
+        const float sinA = std::sin(angle);
+        prim.vertices[i + 1] = MakeVertex(pxCX + cosA * pxRadius, pxCY + sinA * pxRadius, fc,
+                                          0.5f + 0.5f * cosA, 0.5f + 0.5f * sinA);
+    }
+    const int center = prim.baseVertex;
+    for (int i = 0; i < segments; ++i)
+    {
+        prim.indices[i * 3]     = center;
+        prim.indices[i * 3 + 1] = center + i + 1;
+        prim.indices[i * 3 + 2] = center + i + 2;
+    }
+}
+
+// 环带（外圈 & 内圈顶点交替，每段两个三角形），直接写入批次
+void PushRing(GeometryBatch& batch, float pxCX, float pxCY, float outerR, float innerR, int segments,
+              float angleStartRad, float angleEndRad, const SDL_FColor& fc)
+{
+    segments = std::max(1, segments);
+    const float step = (angleEndRad - angleStartRad) / static_cast<float>(segments);
+
+    auto prim = batch.Add(nullptr, (static_cast<size_t>(segments) + 1) * 2, static_cast<size_t>(segments) * 6);
+    for (int i = 0; i <= segments; ++i)
+    {
+        const float angle = angleStartRad + step * static_cast<float>(i);
+        const float cosA = std::cos(angle);
+        const float sinA = std::sin(angle);
+        prim.vertices[i * 2]     = MakeVertex(pxCX + cosA * outerR, pxCY + sinA * outerR, fc);
+        prim.vertices[i * 2 + 1] = MakeVertex(pxCX + cosA * innerR, pxCY + sinA * innerR, fc);
+    }
+    for (int i = 0; i < segments; ++i)
+    {
+        const int bo = prim.baseVertex + i * 2;
+        int* idx = prim.indices + i * 6;
+        idx[0] = bo;     idx[1] = bo + 1; idx[2] = bo + 2;
+        idx[3] = bo + 1; idx[4] = bo + 3; idx[5] = bo + 2;
+    }
+}
+
+// 共享的 TTF_Font 以加载字号为基准：临时切换到目标像素字号，离开作用域时还原
+class ScopedFontSize
+{
+public:
+    ScopedFontSize(TTF_Font* font, int pixelSize)
+        : m_font(font)
+        , m_originalSize(TTF_GetFontSize(font))
+        , m_changed(std::abs(static_cast<float>(pixelSize) - m_originalSize) > 0.5f)
+    {
+        if (m_changed) TTF_SetFontSize(m_font, static_cast<float>(pixelSize));
+    }
+
+    ~ScopedFontSize()
+    {
+        if (m_changed) TTF_SetFontSize(m_font, m_originalSize);
+    }
+
+    ScopedFontSize(const ScopedFontSize&)            = delete;
+    ScopedFontSize& operator=(const ScopedFontSize&) = delete;
+
+private:
+    TTF_Font* m_font;
+    float     m_originalSize;
+    bool      m_changed;
+};
+
+} // namespace
+
 // ============================================================================
 // Renderer 实现
 // ============================================================================
@@ -65,13 +203,22 @@ bool Renderer::Initialize(SDL_Window* window)
     // 启用 Alpha 混合
     SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
 
+    m_batch.SetSubmit([this](void* texture, const BatchVertex* vertices, int vertexCount,
+                             const int* indices, int indexCount)
+    {
+        SDL_RenderGeometry(m_renderer, static_cast<SDL_Texture*>(texture),
+                           reinterpret_cast<const SDL_Vertex*>(vertices), vertexCount,
+                           indices, indexCount);
+    });
+
     LOG_INFO("渲染器初始化成功，后端: {}", SDL_GetRendererName(m_renderer));
     return true;
 }
 
 void Renderer::Destroy()
 {
-    ClearTextCache();
+    m_batch.Discard();
+    ClearFontAtlases();
 
     if (m_renderer)
     {
@@ -84,12 +231,18 @@ void Renderer::Destroy()
 
 void Renderer::BeginFrame()
 {
-    // SDL_Renderer 无需显式 BeginFrame，但我们保留此接口供扩展
+    m_batch.ResetStats();
 }
 
 void Renderer::EndFrame()
 {
-    // 渲染结束：重置 viewport 再提交
+    // 渲染结束：提交剩余图元，重置 viewport 再提交
+    m_batch.Flush(FlushReason::FrameEnd);
+    m_lastFrameStats = m_batch.GetStats();
+
+    for (SDL_Texture* texture : m_retiredTextures)
+        SDL_DestroyTexture(texture);
+    m_retiredTextures.clear();
     SDL_SetRenderViewport(m_renderer, nullptr);
     SDL_RenderPresent(m_renderer);
 }
@@ -108,7 +261,8 @@ void Renderer::ResetViewportShake()
 
 void Renderer::Clear(Color color)
 {
-    // 先重置 viewport 填充全屏背景
+    // 先提交此前的图元（其 viewport 即将改变），再重置 viewport 填充全屏背景
+    m_batch.Flush(FlushReason::FrameEnd);
     SDL_SetRenderViewport(m_renderer, nullptr);
     SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
     SDL_RenderClear(m_renderer);
@@ -154,13 +308,14 @@ float Renderer::ToPixelH(float normH) const
 
 void Renderer::DrawFilledRect(NormRect rect, Color color)
 {
-    SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
-    SDL_FRect pixelRect = rect.ToPixel(GetScreenWidth(), GetScreenHeight());
-    SDL_RenderFillRect(m_renderer, &pixelRect);
+    if (!m_renderer) return;
+    PushRect(m_batch, rect.ToPixel(GetScreenWidth(), GetScreenHeight()), color.ToSDLFColor());
 }
 
 void Renderer::DrawRectOutline(NormRect rect, Color color, float normThickness)
 {
+    if (!m_renderer) return;
+
     // 将外框拆解为四个填充矩形（上/下/左/右边框）
     int sw = GetScreenWidth();
     int sh = GetScreenHeight();
@@ -171,7 +326,7 @@ void Renderer::DrawRectOutline(NormRect rect, Color color, float normThickness)
     float pxH = rect.height * sh;
     float t   = normThickness * std::min(sw, sh);  // 边框粗细（像素）
 
-    SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
+    const SDL_FColor fc = color.ToSDLFColor();
 
     // 上边
     SDL_FRect top    = { pxX,           pxY,           pxW,  t  };
@@ -182,10 +337,10 @@ void Renderer::DrawRectOutline(NormRect rect, Color color, float normThickness)
     // 右边
     SDL_FRect right  = { pxX + pxW - t, pxY + t,       t,    pxH - 2*t };
 
-    SDL_RenderFillRect(m_renderer, &top);
-    SDL_RenderFillRect(m_renderer, &bottom);
-    SDL_RenderFillRect(m_renderer, &left);
-    SDL_RenderFillRect(m_renderer, &right);
+    PushRect(m_batch, top,    fc);
+    PushRect(m_batch, bottom, fc);
+    PushRect(m_batch, left,   fc);
+    PushRect(m_batch, right,  fc);
 }
 
 void Renderer::DrawGradientRect(NormRect rect, Color colorTopLeft, Color colorTopRight, Color colorBottomLeft, Color colorBottomRight)
@@ -194,26 +349,11 @@ void Renderer::DrawGradientRect(NormRect rect, Color colorTopLeft, Color colorTo
 
     SDL_FRect dstRect = rect.ToPixel(GetScreenWidth(), GetScreenHeight());
 
-    SDL_Vertex verts[4];
-    verts[0].position = { dstRect.x, dstRect.y };
-    verts[0].color = colorTopLeft.ToSDLFColor();
-    verts[0].tex_coord = {0.0f, 0.0f};
-
-    verts[1].position = { dstRect.x + dstRect.w, dstRect.y };
-    verts[1].color = colorTopRight.ToSDLFColor();
-    verts[1].tex_coord = {1.0f, 0.0f};
-
-    verts[2].position = { dstRect.x + dstRect.w, dstRect.y + dstRect.h };
-    verts[2].color = colorBottomRight.ToSDLFColor();
-    verts[2].tex_coord = {1.0f, 1.0f};
-
-    verts[3].position = { dstRect.x, dstRect.y + dstRect.h };
-    verts[3].color = colorBottomLeft.ToSDLFColor();
-    verts[3].tex_coord = {0.0f, 1.0f};
-
-    int indices[6] = {0, 1, 2, 0, 2, 3};
-
-    SDL_RenderGeometry(m_renderer, nullptr, verts, 4, indices, 6);
+    m_batch.AddQuad(nullptr,
+        MakeVertex(dstRect.x,             dstRect.y,             colorTopLeft.ToSDLFColor(),     0.0f, 0.0f),
+        MakeVertex(dstRect.x + dstRect.w, dstRect.y,             colorTopRight.ToSDLFColor(),    1.0f, 0.0f),
+        MakeVertex(dstRect.x + dstRect.w, dstRect.y + dstRect.h, colorBottomRight.ToSDLFColor(), 1.0f, 1.0f),
+        MakeVertex(dstRect.x,             dstRect.y + dstRect.h, colorBottomLeft.ToSDLFColor(),  0.0f, 1.0f));
 }
 
 // ── 混合模式 ──────────────────────────────────────────────────────────────────
@@ -228,9 +368,31 @@ void Renderer::SetBlendMode(BlendMode mode)
         case BlendMode::Additive:  sdlMode = SDL_BLENDMODE_ADD;   break;
         case BlendMode::Multiply:  sdlMode = SDL_BLENDMODE_MUL;   break;
     }
+    if (!m_renderer) return;
+
+    // 纯色图元的混合模式在提交时生效：仅在真正切换时提交已累积的图元
+    SDL_BlendMode current = SDL_BLENDMODE_INVALID;
+    SDL_GetRenderDrawBlendMode(m_renderer, &current);
+    if (current == sdlMode) return;
+
+    m_batch.Flush(FlushReason::BlendMode);
     SDL_SetRenderDrawBlendMode(m_renderer, sdlMode);
 }
 
+// ── 批处理 ────────────────────────────────────────────────────────────────────
+
+void Renderer::Flush()
+{
+    m_batch.Flush(FlushReason::External);
+}
+
+bool Renderer::SetRenderTarget(SDL_Texture* target)
+{
+    if (!m_renderer) return false;
+    m_batch.Flush(FlushReason::RenderTarget);
+    return SDL_SetRenderTarget(m_renderer, target);
+}
+
 // ── 屏幕信息 ──────────────────────────────────────────────────────────────────
 
 int Renderer::GetScreenWidth() const
@@ -261,6 +423,12 @@ SDL_GPUDevice* Renderer::GetGPUDevice() const
 
 // ── 文字渲染 ──────────────────────────────────────────────────────────────────
 
+int Renderer::ToPixelFontSize(float normFontSize) const
+{
+    return std::max(1, static_cast<int>(std::lround(
+        normFontSize * static_cast<float>(GetScreenHeight()))));
+}
+
 void Renderer::DrawText(FontHandle fontHandle,
                         std::string_view text,
                         float normX,
@@ -271,38 +439,40 @@ void Renderer::DrawText(FontHandle fontHandle,
 {
     if (!m_renderer || text.empty()) return;
 
-    const int screenH = GetScreenHeight();
-    const int screenW = GetScreenWidth();
-    const int pixelFontSize = std::max(1, static_cast<int>(std::lround(
-        normFontSize * static_cast<float>(screenH))));
-
-    TextCacheEntry* entry = GetOrCreateTextCacheEntry(fontHandle, text, pixelFontSize);
-    if (!entry || !entry->texture)
+    FontAtlas* atlas = GetFontAtlas(fontHandle, ToPixelFontSize(normFontSize));
+    if (!atlas || !EnsureGlyphs(*atlas, text))
         return;
 
-    // 根据对齐方式计算左上角像素坐标
-    float pxX = normX * static_cast<float>(screenW);
-    float pxY = normY * static_cast<float>(screenH);
+    // 根据对齐方式计算左上角像素坐标（取整以免字形采样模糊）
+    float pxX = normX * static_cast<float>(GetScreenWidth());
+    float pxY = normY * static_cast<float>(GetScreenHeight());
 
-    switch (align)
+    if (align != TextAlign::Left)
     {
-        case TextAlign::Center:
-            pxX -= entry->width * 0.5f;
-            break;
-        case TextAlign::Right:
-            pxX -= entry->width;
-            break;
-        case TextAlign::Left:
-        default:
-            break;
+        int width = 0;
+        atlas->glyphs.Measure(text, width);
+        pxX -= (align == TextAlign::Center) ? width * 0.5f : static_cast<float>(width);
     }
+    pxX = std::round(pxX);
+    pxY = std::round(pxY);
 
-    SDL_FRect dest = { pxX, pxY, entry->width, entry->height };
-    SDL_SetTextureColorMod(entry->texture, color.r, color.g, color.b);
-    SDL_SetTextureAlphaMod(entry->texture, color.a);
-    SDL_RenderTexture(m_renderer, entry->texture, nullptr, &dest);
-    SDL_SetTextureColorMod(entry->texture, 255, 255, 255);
-    SDL_SetTextureAlphaMod(entry->texture, 255);
+    // 每个字形一个贴图四边形，颜色写入顶点；同页字形连续合批
+    const SDL_FColor fc = color.ToSDLFColor();
+    const float invPage = 1.0f / static_cast<float>(atlas->glyphs.GetPageSize());
+    atlas->glyphs.Layout(text, [&](const GlyphAtlas::Glyph& glyph, int penX)
+    {
+        if (glyph.page < 0) return;
+        SDL_Texture* page = atlas->pages[static_cast<size_t>(glyph.page)];
+        if (!page) return;
+
+        const AtlasRect& r = glyph.rect;
+        const SDL_FRect dest = { pxX + static_cast<float>(penX), pxY,
+                                 static_cast<float>(r.w), static_cast<float>(r.h) };
+        PushTexturedQuad(m_batch, page, dest,
+                         r.x * invPage, r.y * invPage,
+                         (r.x + r.w) * invPage, (r.y + r.h) * invPage,
+                         0.0f, fc);
+    });
 }
 
 float Renderer::MeasureTextWidth(FontHandle fontHandle,
@@ -318,54 +488,32 @@ TextMetrics Renderer::MeasureText(FontHandle fontHandle,
 {
     if (!m_renderer || text.empty()) return {};
 
-    TTF_Font* font = ResourceManager::GetInstance().GetFont(fontHandle);
-    if (!font) return {};
-
-    const float targetPixelSize = normFontSize * static_cast<float>(GetScreenHeight());
-    const float originalSize    = TTF_GetFontSize(font);
-
-    if (std::abs(targetPixelSize - originalSize) > 0.5f)
-    {
-        TTF_SetFontSize(font, targetPixelSize);
-    }
-
-    int w = 0, h = 0;
-    std::string textStr(text);
-    TTF_GetStringSize(font, textStr.c_str(), 0, &w, &h);
-
-    if (std::abs(targetPixelSize - originalSize) > 0.5f)
-    {
-        TTF_SetFontSize(font, originalSize);
-    }
-
     const int screenW = GetScreenWidth();
     const int screenH = GetScreenHeight();
     if (screenW <= 0 || screenH <= 0) return {};
 
+    // 与 DrawText 使用同一图集，测量结果与实际绘制一致
+    FontAtlas* atlas = GetFontAtlas(fontHandle, ToPixelFontSize(normFontSize));
+    if (!atlas || !EnsureGlyphs(*atlas, text)) return {};
+
+    int w = 0;
+    atlas->glyphs.Measure(text, w);
+
     return {
         static_cast<float>(w) / static_cast<float>(screenW),
-        static_cast<float>(h) / static_cast<float>(screenH)
+        static_cast<float>(atlas->glyphs.GetLineHeight()) / static_cast<float>(screenH)
     };
 }
 
-Renderer::TextCacheEntry* Renderer::GetOrCreateTextCacheEntry(FontHandle fontHandle,
-                                                              std::string_view text,
-                                                              int pixelFontSize)
+Renderer::FontAtlas* Renderer::GetFontAtlas(FontHandle fontHandle, int pixelFontSize) const
 {
-    if (!m_renderer || text.empty())
-        return nullptr;
-
-    std::string key = std::to_string(fontHandle);
-    key.push_back('|');
-    key += std::to_string(pixelFontSize);
-    key.push_back('|');
-    key.append(text.data(), text.size());
+    const uint64_t key = (static_cast<uint64_t>(fontHandle) << 32) | static_cast<uint32_t>(pixelFontSize);
 
-    auto it = m_textCache.find(key);
-    if (it != m_textCache.end())
+    auto it = m_fontAtlases.find(key);
+    if (it != m_fontAtlases.end())
     {
-        it->second.lastUsed = ++m_textCacheUseCounter;
-        return &it->second;
+        it->second->lastUsed = ++m_fontAtlasUseCounter;
+        return it->second.get();
     }
 
     TTF_Font* font = ResourceManager::GetInstance().GetFont(fontHandle);
@@ -375,94 +523,122 @@ Renderer::TextCacheEntry* Renderer::GetOrCreateTextCacheEntry(FontHandle fontHan
         return nullptr;
     }
 
-    const float originalSize = TTF_GetFontSize(font);
-    const float targetPixelSize = static_cast<float>(pixelFontSize);
-    if (std::abs(targetPixelSize - originalSize) > 0.5f)
+    int lineHeight = 0;
     {
-        TTF_SetFontSize(font, targetPixelSize);
+        ScopedFontSize size(font, pixelFontSize);
+        lineHeight = TTF_GetFontHeight(font);
     }
 
-    SDL_Color white = { 255, 255, 255, 255 };
-    std::string textStr(text);
-    SDL_Surface* surface = TTF_RenderText_Blended(font, textStr.c_str(), 0, white);
-
-    if (std::abs(targetPixelSize - originalSize) > 0.5f)
+    // 超出上限时淘汰最久未用的图集（创建新图集时才扫描）
+    if (m_fontAtlases.size() >= MAX_FONT_ATLASES)
     {
-        TTF_SetFontSize(font, originalSize);
-    }
-
-    if (!surface)
-    {
-        LOG_WARN("TTF_RenderText_Blended 失败: {}", SDL_GetError());
-        return nullptr;
+        auto oldestIt = std::min_element(m_fontAtlases.begin(), m_fontAtlases.end(),
+            [](const auto& a, const auto& b) { return a.second->lastUsed < b.second->lastUsed; });
+        for (SDL_Texture* page : oldestIt->second->pages)
+        {
+            if (page) m_retiredTextures.push_back(page);
+        }
+        m_fontAtlases.erase(oldestIt);
     }
 
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
-    SDL_DestroySurface(surface);
-
-    if (!texture)
-    {
-        LOG_WARN("SDL_CreateTextureFromSurface 失败: {}", SDL_GetError());
-        return nullptr;
-    }
+    auto atlas = std::make_unique<FontAtlas>(fontHandle, pixelFontSize, lineHeight);
+    atlas->lastUsed = ++m_fontAtlasUseCounter;
+    return m_fontAtlases.emplace(key, std::move(atlas)).first->second.get();
+}
 
-    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+bool Renderer::EnsureGlyphs(FontAtlas& atlas, std::string_view text) const
+{
+    if (atlas.glyphs.IsCached(text)) return true;
 
-    float texW = 0.0f;
-    float texH = 0.0f;
-    SDL_GetTextureSize(texture, &texW, &texH);
+    TTF_Font* font = ResourceManager::GetInstance().GetFont(atlas.font);
+    if (!font) return false;
 
-    TrimTextCache();
+    ScopedFontSize size(font, atlas.pixelSize);
 
-    auto [insertedIt, inserted] = m_textCache.emplace(std::move(key), TextCacheEntry{
-        texture,
-        texW,
-        texH,
-        ++m_textCacheUseCounter
-    });
-    if (!inserted)
+    uint32_t previous = 0;
+    size_t pos = 0;
+    while (pos < text.size())
     {
-        SDL_DestroyTexture(texture);
-        insertedIt->second.lastUsed = ++m_textCacheUseCounter;
-    }
+        const uint32_t cp = NextCodepoint(text, pos);
+        if (!atlas.glyphs.Find(cp))
+            RasterizeGlyph(atlas, font, cp);
 
-    return &insertedIt->second;
+        int kerning = 0;
+        if (previous != 0 && !atlas.glyphs.FindKerning(previous, cp, kerning))
+        {
+            if (!TTF_GetGlyphKerning(font, previous, cp, &kerning))
+                kerning = 0;
+            atlas.glyphs.SetKerning(previous, cp, kerning);
+        }
+        previous = cp;
+    }
+    return true;
 }
 
-void Renderer::TrimTextCache()
+bool Renderer::RasterizeGlyph(FontAtlas& atlas, TTF_Font* font, uint32_t codepoint) const
 {
-    while (m_textCache.size() >= MAX_TEXT_CACHE_ENTRIES)
-    {
-        auto oldestIt = m_textCache.end();
-        uint64_t oldestUse = std::numeric_limits<uint64_t>::max();
+    int advance = 0;
+    if (!TTF_GetGlyphMetrics(font, codepoint, nullptr, nullptr, nullptr, nullptr, &advance))
+        advance = 0;
 
-        for (auto it = m_textCache.begin(); it != m_textCache.end(); ++it)
+    // 位图按“单字符字符串”渲染：左上角对齐笔位置与行顶，高度为行高
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface* surface = TTF_RenderGlyph_Blended(font, codepoint, white);
+    SDL_Surface* argb = surface ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ARGB8888) : nullptr;
+    if (surface) SDL_DestroySurface(surface);
+
+    bool newPage = false;
+    const GlyphAtlas::Glyph& glyph = atlas.glyphs.Insert(codepoint, advance,
+                                                         argb ? argb->w : 0,
+                                                         argb ? argb->h : 0,
+                                                         newPage);
+    if (newPage)
+    {
+        const int pageSize = atlas.glyphs.GetPageSize();
+        SDL_Texture* page = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888,
+                                              SDL_TEXTUREACCESS_STATIC, pageSize, pageSize);
+        if (page)
         {
-            if (it->second.lastUsed < oldestUse)
-            {
-                oldestUse = it->second.lastUsed;
-                oldestIt = it;
-            }
+            SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+            // 新页清为全透明（字形间的 padding 须为透明像素）
+            std::vector<uint32_t> transparent(static_cast<size_t>(pageSize) * pageSize, 0);
+            SDL_UpdateTexture(page, nullptr, transparent.data(), pageSize * 4);
         }
+        else
+        {
+            LOG_WARN("创建字形图集页失败: {}", SDL_GetError());
+        }
+        atlas.pages.push_back(page);
+    }
 
-        if (oldestIt == m_textCache.end())
-            break;
+    if (!argb) return false;
 
-        if (oldestIt->second.texture)
-            SDL_DestroyTexture(oldestIt->second.texture);
-        m_textCache.erase(oldestIt);
+    bool uploaded = false;
+    if (glyph.page >= 0)
+    {
+        SDL_Texture* page = atlas.pages[static_cast<size_t>(glyph.page)];
+        const SDL_Rect rect = { glyph.rect.x, glyph.rect.y, glyph.rect.w, glyph.rect.h };
+        uploaded = page && SDL_UpdateTexture(page, &rect, argb->pixels, argb->pitch);
     }
+    SDL_DestroySurface(argb);
+    return uploaded;
 }
 
-void Renderer::ClearTextCache()
+void Renderer::ClearFontAtlases()
 {
-    for (auto& [key, entry] : m_textCache)
+    for (auto& [key, atlas] : m_fontAtlases)
     {
-        if (entry.texture)
-            SDL_DestroyTexture(entry.texture);
+        for (SDL_Texture* page : atlas->pages)
+        {
+            if (page) SDL_DestroyTexture(page);
+        }
     }
-    m_textCache.clear();
-    m_textCacheUseCounter = 0;
+    m_fontAtlases.clear();
+    m_fontAtlasUseCounter = 0;
+
+    for (SDL_Texture* texture : m_retiredTextures)
+        SDL_DestroyTexture(texture);
+    m_retiredTextures.clear();
 }
 
 // ============================================================================
@@ -479,23 +655,8 @@ void Renderer::DrawSprite(TextureHandle texHandle,
     if (!tex || !m_renderer) return;
 
     SDL_FRect dstRect = dest.ToPixel(GetScreenWidth(), GetScreenHeight());
-    SDL_SetTextureColorMod(tex, tint.r, tint.g, tint.b);
-    SDL_SetTextureAlphaMod(tex, static_cast<uint8_t>(alpha * 255.0f));
-
-    if (rotation == 0.0f)
-    {
-        SDL_RenderTexture(m_renderer, tex, nullptr, &dstRect);
-    }
-    else
-    {
-        SDL_RenderTextureRotated(m_renderer, tex, nullptr, &dstRect,
-                                 static_cast<double>(rotation),
-                                 nullptr,
-                                 SDL_FLIP_NONE);
-    }
-    // 还原
-    SDL_SetTextureColorMod(tex, 255, 255, 255);
-    SDL_SetTextureAlphaMod(tex, 255);
+    const SDL_FColor fc = { tint.r / 255.0f, tint.g / 255.0f, tint.b / 255.0f, std::clamp(alpha, 0.0f, 1.0f) };
+    PushTexturedQuad(m_batch, tex, dstRect, 0.0f, 0.0f, 1.0f, 1.0f, rotation, fc);
 }
 
 void Renderer::DrawSpriteEx(TextureHandle texHandle,
@@ -508,75 +669,19 @@ void Renderer::DrawSpriteEx(TextureHandle texHandle,
     SDL_Texture* tex = ResourceManager::GetInstance().GetTexture(texHandle);
     if (!tex || !m_renderer) return;
 
-    float texW = 0.0f, texH = 0.0f;
-    SDL_GetTextureSize(tex, &texW, &texH);
-
-    SDL_FRect srcRect = {
-        src.x     * texW,
-        src.y     * texH,
-        src.width  * texW,
-        src.height * texH
-    };
     SDL_FRect dstRect = dest.ToPixel(GetScreenWidth(), GetScreenHeight());
+    const SDL_FColor fc = { tint.r / 255.0f, tint.g / 255.0f, tint.b / 255.0f, std::clamp(alpha, 0.0f, 1.0f) };
 
-    SDL_SetTextureColorMod(tex, tint.r, tint.g, tint.b);
-    SDL_SetTextureAlphaMod(tex, static_cast<uint8_t>(alpha * 255.0f));
-
-    if (rotation == 0.0f)
-    {
-        SDL_RenderTexture(m_renderer, tex, &srcRect, &dstRect);
-    }
-    else
-    {
-        SDL_RenderTextureRotated(m_renderer, tex, &srcRect, &dstRect,
-                                 static_cast<double>(rotation),
-                                 nullptr,
-                                 SDL_FLIP_NONE);
-    }
-    SDL_SetTextureColorMod(tex, 255, 255, 255);
-    SDL_SetTextureAlphaMod(tex, 255);
+    // src 已是归一化纹理坐标
+    PushTexturedQuad(m_batch, tex, dstRect,
+                     src.x, src.y, src.x + src.width, src.y + src.height,
+                     rotation, fc);
 }
 
 // ============================================================================
 // 几何图形
 // ============================================================================
 
-static constexpr float kPi = 3.14159265358979323846f;
-
-// 内部工具：构建三角扇形顶点（圆心 + 若干边缘顶点）
-static void BuildCircleGeometry(
-    float pxCX, float pxCY, float pxRadius,
-    int segments,
-    float angleStartRad, float angleEndRad,
-    const SDL_FColor& fcolor,
-    std::vector<SDL_Vertex>& verts,
-    std::vector<int>& indices)
-{
-    const float step = (angleEndRad - angleStartRad) / static_cast<float>(segments);
-
-    const size_t centerIdx = verts.size();
-    verts.push_back({ { pxCX, pxCY }, fcolor, { 0.5f, 0.5f } });
-
-    for (int i = 0; i <= segments; ++i)
-    {
-        const float angle = angleStartRad + step * static_cast<float>(i);
-        verts.push_back({
-            { pxCX + std::cos(angle) * pxRadius,
-              pxCY + std::sin(angle) * pxRadius },
-            fcolor,
-            { 0.5f + 0.5f * std::cos(angle),
-              0.5f + 0.5f * std::sin(angle) }
-        });
-
-        if (i > 0)
-        {
-            indices.push_back(static_cast<int>(centerIdx));
-            indices.push_back(static_cast<int>(centerIdx) + i);
-            indices.push_back(static_cast<int>(centerIdx) + i + 1);
-        }
-    }
-}
-
 void Renderer::DrawCircleFilled(float cx, float cy, float normRadius,
                                  Color color, int segments)
 {
@@ -588,18 +693,7 @@ void Renderer::DrawCircleFilled(float cx, float cy, float normRadius,
     const float pxCY = cy * sh;
     const float pxR  = normRadius * std::min(sw, sh);
 
-    const SDL_FColor fc = color.ToSDLFColor();
-
-    std::vector<SDL_Vertex> verts;
-    std::vector<int> indices;
-    verts.reserve(static_cast<size_t>(segments + 2));
-    indices.reserve(static_cast<size_t>(segments * 3));
-
-    BuildCircleGeometry(pxCX, pxCY, pxR, segments, 0.0f, kPi * 2.0f, fc, verts, indices);
-
-    SDL_RenderGeometry(m_renderer, nullptr,
-        verts.data(), static_cast<int>(verts.size()),
-        indices.data(), static_cast<int>(indices.size()));
+    PushFan(m_batch, pxCX, pxCY, pxR, segments, 0.0f, kPi * 2.0f, color.ToSDLFColor());
 }
 
 void Renderer::DrawCircleOutline(float cx, float cy, float normRadius,
@@ -614,36 +708,11 @@ void Renderer::DrawCircleOutline(float cx, float cy, float normRadius,
     const float pxR     = normRadius * std::min(sw, sh);
     const float pxThick = normThickness * std::min(sw, sh);
 
-    const SDL_FColor fc = color.ToSDLFColor();
     const float outerR = pxR + pxThick * 0.5f;
     const float innerR = pxR - pxThick * 0.5f;
 
     // 环形：外圈 & 内圈顶点，每段两个三角形
-    std::vector<SDL_Vertex> verts;
-    std::vector<int> indices;
-    const int n = segments;
-    verts.reserve(static_cast<size_t>((n + 1) * 2));
-    indices.reserve(static_cast<size_t>(n * 6));
-
-    for (int i = 0; i <= n; ++i)
-    {
-        const float angle = kPi * 2.0f * static_cast<float>(i) / static_cast<float>(n);
-        const float cosA = std::cos(angle);
-        const float sinA = std::sin(angle);
-        verts.push_back({ { pxCX + cosA * outerR, pxCY + sinA * outerR }, fc, { 0,0 } });
-        verts.push_back({ { pxCX + cosA * innerR, pxCY + sinA * innerR }, fc, { 0,0 } });
-
-        if (i > 0)
-        {
-            int bo = (i - 1) * 2;
-            indices.push_back(bo);     indices.push_back(bo + 1); indices.push_back(bo + 2);
-            indices.push_back(bo + 1); indices.push_back(bo + 3); indices.push_back(bo + 2);
-        }
-    }
-
-    SDL_RenderGeometry(m_renderer, nullptr,
-        verts.data(), static_cast<int>(verts.size()),
-        indices.data(), static_cast<int>(indices.size()));
+    PushRing(m_batch, pxCX, pxCY, outerR, innerR, segments, 0.0f, kPi * 2.0f, color.ToSDLFColor());
 }
 
 void Renderer::DrawLine(float x1, float y1, float x2, float y2,
@@ -669,16 +738,11 @@ void Renderer::DrawLine(float x1, float y1, float x2, float y2,
     const float ny =  dx / len * halfT;
 
     const SDL_FColor fc = color.ToSDLFColor();
-
-    SDL_Vertex verts[4] = {
-        { { px1 + nx, py1 + ny }, fc, { 0,0 } },
-        { { px1 - nx, py1 - ny }, fc, { 0,0 } },
-        { { px2 + nx, py2 + ny }, fc, { 0,0 } },
-        { { px2 - nx, py2 - ny }, fc, { 0,0 } }
-    };
-    int indices[] = { 0, 1, 2, 1, 3, 2 };
-
-    SDL_RenderGeometry(m_renderer, nullptr, verts, 4, indices, 6);
+    m_batch.AddQuad(nullptr,
+                    MakeVertex(px1 + nx, py1 + ny, fc),
+                    MakeVertex(px1 - nx, py1 - ny, fc),
+                    MakeVertex(px2 - nx, py2 - ny, fc),
+                    MakeVertex(px2 + nx, py2 + ny, fc));
 }
 
 void Renderer::DrawArc(float cx, float cy, float normRadius,
@@ -699,33 +763,7 @@ void Renderer::DrawArc(float cx, float cy, float normRadius,
     const float outerR = pxR + pxThick * 0.5f;
     const float innerR = pxR - pxThick * 0.5f;
 
-    const SDL_FColor fc = color.ToSDLFColor();
-
-    std::vector<SDL_Vertex> verts;
-    std::vector<int> indices;
-    verts.reserve(static_cast<size_t>((segments + 1) * 2));
-    indices.reserve(static_cast<size_t>(segments * 6));
-
-    const float step = (endRad - startRad) / static_cast<float>(segments);
-    for (int i = 0; i <= segments; ++i)
-    {
-        const float angle = startRad + step * static_cast<float>(i);
-        const float cosA = std::cos(angle);
-        const float sinA = std::sin(angle);
-        verts.push_back({ { pxCX + cosA * outerR, pxCY + sinA * outerR }, fc, { 0,0 } });
-        verts.push_back({ { pxCX + cosA * innerR, pxCY + sinA * innerR }, fc, { 0,0 } });
-
-        if (i > 0)
-        {
-            int bo = (i - 1) * 2;
-            indices.push_back(bo);     indices.push_back(bo + 1); indices.push_back(bo + 2);
-            indices.push_back(bo + 1); indices.push_back(bo + 3); indices.push_back(bo + 2);
-        }
-    }
-
-    SDL_RenderGeometry(m_renderer, nullptr,
-        verts.data(), static_cast<int>(verts.size()),
-        indices.data(), static_cast<int>(indices.size()));
+    PushRing(m_batch, pxCX, pxCY, outerR, innerR, segments, startRad, endRad, color.ToSDLFColor());
 }
 
 void Renderer::DrawRoundedRect(NormRect rect, float normCornerRadius,
@@ -749,16 +787,15 @@ void Renderer::DrawRoundedRect(NormRect rect, float normCornerRadius,
     if (filled)
     {
         // 三个填充矩形（水平中间 + 上/下带圆角的矩形通过三角扇补全）
-        SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b, color.a);
 
         // 中心矩形（水平延展，高度 = pxH - 2r）
         SDL_FRect mid = { pxX, pxY + r, pxW, pxH - 2.0f * r };
-        SDL_RenderFillRect(m_renderer, &mid);
+        PushRect(m_batch, mid, fc);
         // 上/下横条（宽 = pxW - 2r，高 = r）
         SDL_FRect top = { pxX + r, pxY,              pxW - 2.0f * r, r };
         SDL_FRect bot = { pxX + r, pxY + pxH - r,   pxW - 2.0f * r, r };
-        SDL_RenderFillRect(m_renderer, &top);
-        SDL_RenderFillRect(m_renderer, &bot);
+        PushRect(m_batch, top, fc);
+        PushRect(m_batch, bot, fc);
 
         // 四个角扇形
         struct CornerDef { float cx; float cy; float startDeg; };
@@ -774,13 +811,7 @@ void Renderer::DrawRoundedRect(NormRect rect, float normCornerRadius,
             const float startRad = c.startDeg * kPi / 180.0f;
             const float endRad   = startRad + kPi * 0.5f;
 
-            std::vector<SDL_Vertex> verts;
-            std::vector<int> indices;
-            BuildCircleGeometry(c.cx, c.cy, r, cornerSegments,
-                                startRad, endRad, fc, verts, indices);
-            SDL_RenderGeometry(m_renderer, nullptr,
-                verts.data(), static_cast<int>(verts.size()),
-                indices.data(), static_cast<int>(indices.size()));
+            PushFan(m_batch, c.cx, c.cy, r, cornerSegments, startRad, endRad, fc);
         }
     }
     else
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <SDL3/SDL.h>
+#include "geometry_batch.h"
+#include "glyph_atlas.h"
 #include "resource_manager.h"
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace sakura::core
 {
@@ -100,6 +104,8 @@ enum class BlendMode
 
 // ============================================================================
 // Renderer — SDL3 GPU 加速的 2D 渲染器
+// 所有图元经 GeometryBatch 合并：纹理 / 混合模式 / 渲染目标切换或帧末才提交一次
+// SDL_RenderGeometry。外部代码直接使用 SDL_Renderer 绘制前须先调用 Flush()。
 // ============================================================================
 class Renderer
 {
@@ -142,6 +148,8 @@ public:
     void DrawGradientRect(NormRect rect, Color colorTopLeft, Color colorTopRight, Color colorBottomLeft, Color colorBottomRight);
 
     // ── 文字渲染 ──────────────────────────────────────────────────────────────
+    // 字形按（字体, 像素字号）缓存于图集，仅首次出现时光栅化并上传；
+    // 之后文字以贴图四边形经批处理绘制，测量只累加缓存的度量
 
     // normFontSize: 字号相对屏幕高度的比例（0.03 = 屏幕高度的 3%）
     // normX, normY: 文字左上角/中心/右上角的归一化坐标（取决于 align）
@@ -207,8 +215,27 @@ public:
                          float normThickness = 0.002f);
 
     // ── 混合模式 ──────────────────────────────────────────────────────────────
+    // 与当前模式不同时先提交已累积的图元
     void SetBlendMode(BlendMode mode);
 
+    // ── 批处理 ────────────────────────────────────────────────────────────────
+
+    // 提交已累积的图元（外部直接调用 SDL 绘制前使用）
+    void Flush();
+
+    // 切换渲染目标（nullptr = 屏幕），切换前提交已累积的图元
+    bool SetRenderTarget(SDL_Texture* target);
+
+    // 关闭后每个图元单独提交（用于对比 draw call 数量）
+    void SetBatchingEnabled(bool enabled) { m_batch.SetEnabled(enabled); }
+    bool IsBatchingEnabled() const        { return m_batch.IsEnabled(); }
+
+    // 直接写入批次（像素坐标），用于粒子等大批量几何一次性生成顶点
+    GeometryBatch& GetGeometryBatch() { return m_batch; }
+
+    // 上一完整帧的统计（draw call 数、图元数、顶点数、各提交原因次数）
+    const BatchStats& GetFrameStats() const { return m_lastFrameStats; }
+
     // ── 屏幕震动 viewport 偏移 ────────────────────────────────────────────────
     // 每帧在 Clear() 之前调用，设置渲染偏移（单位：像素）
     // 正值 => 内容向右/下移；负值 => 向左/上移
@@ -222,6 +249,7 @@ public:
     int GetScreenHeight() const;
 
     // ── 原生访问器 ────────────────────────────────────────────────────────────
+    // 直接用原生指针绘制前须先调用 Flush()，以保持与批处理图元的先后顺序
     SDL_Renderer*  GetSDLRenderer() const { return m_renderer; }
 
     // 获取底层 GPU 设备（SDL 3.2+，可能为 nullptr）
@@ -230,26 +258,41 @@ public:
     bool IsValid() const { return m_renderer != nullptr; }
 
 private:
-    struct TextCacheEntry
+    // 单一（字体, 像素字号）的字形图集及其纹理页
+    struct FontAtlas
     {
-        SDL_Texture* texture = nullptr;
-        float width = 0.0f;
-        float height = 0.0f;
-        uint64_t lastUsed = 0;
+        FontAtlas(FontHandle font, int pixelSize, int lineHeight)
+            : font(font), pixelSize(pixelSize), glyphs(lineHeight) {}
+
+        FontHandle                font      = 0;
+        int                       pixelSize = 0;
+        GlyphAtlas                glyphs;
+        std::vector<SDL_Texture*> pages;
+        uint64_t                  lastUsed  = 0;
     };
 
-    TextCacheEntry* GetOrCreateTextCacheEntry(FontHandle fontHandle,
-                                              std::string_view text,
-                                              int pixelFontSize);
-    void TrimTextCache();
-    void ClearTextCache();
+    int        ToPixelFontSize(float normFontSize) const;
+    FontAtlas* GetFontAtlas(FontHandle fontHandle, int pixelFontSize) const;
+    // 光栅化 text 中尚未缓存的字形与字距（整串只切换一次字号）；失败返回 false
+    bool       EnsureGlyphs(FontAtlas& atlas, std::string_view text) const;
+    bool       RasterizeGlyph(FontAtlas& atlas, TTF_Font* font, uint32_t codepoint) const;
+    void       ClearFontAtlases();
 
-    static constexpr std::size_t MAX_TEXT_CACHE_ENTRIES = 256;
+    // 图集数量上限（字号动画会产生多个字号），超出时淘汰最久未用的
+    static constexpr std::size_t MAX_FONT_ATLASES = 24;
 
     SDL_Renderer* m_renderer = nullptr;
     SDL_Window*   m_window   = nullptr;
-    std::unordered_map<std::string, TextCacheEntry> m_textCache;
-    uint64_t m_textCacheUseCounter = 0;
+
+    // 帧级几何批处理（缓冲跨帧复用）
+    GeometryBatch m_batch;
+    BatchStats    m_lastFrameStats;
+
+    // 字形图集，键 = (FontHandle << 32) | 像素字号；测量（const）时也可能补齐字形
+    mutable std::unordered_map<uint64_t, std::unique_ptr<FontAtlas>> m_fontAtlases;
+    mutable uint64_t m_fontAtlasUseCounter = 0;
+    // 被淘汰图集的纹理页可能仍被未提交的图元引用，帧末提交后再销毁
+    mutable std::vector<SDL_Texture*> m_retiredTextures;
 
     // 屏幕震动用 viewport 偏移（像素）
     int m_shakeOffsetX = 0;
@@ -1,6 +1,7 @@
 // database.cpp — SQLite3 数据层实现
 
 #include "database.h"
+#include "game/pp_calculator.h"
 #include "utils/logger.h"
 
 #include <sqlite3.h>
@@ -10,13 +11,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
+#include <iterator>
 #include <sstream>
+#include <utility>
 
 namespace sakura::data
 {
 
 // ═════════════════════════════════════════════════════════════════════════════
-// 匿名命名空间 — SQL 语句常量
+// 匿名命名空间 — 表结构迁移与 SQL 语句常量
 // ═════════════════════════════════════════════════════════════════════════════
 
 namespace
@@ -39,7 +42,11 @@ std::string ReadEnvironmentVariable(const char* name)
 #endif
 }
 
-constexpr const char* SQL_CREATE_SCORES = R"sql(
+// ── 表结构迁移 ────────────────────────────────────────────────────────────────
+// 每个版本只追加，不修改已发布的版本；旧库（user_version = 0）的表已存在，
+// v1 使用 IF NOT EXISTS 保持幂等。
+
+constexpr const char* SQL_SCHEMA_V1 = R"sql(
 CREATE TABLE IF NOT EXISTS scores (
     id               INTEGER PRIMARY KEY AUTOINCREMENT,
     chart_id         TEXT    NOT NULL,
@@ -60,22 +67,282 @@ CREATE TABLE IF NOT EXISTS scores (
     played_at        INTEGER NOT NULL DEFAULT 0,
     hit_errors_json  TEXT    NOT NULL DEFAULT '[]'
 );
-)sql";
 
-constexpr const char* SQL_CREATE_STATISTICS = R"sql(
 CREATE TABLE IF NOT EXISTS statistics (
     key   TEXT    PRIMARY KEY NOT NULL,
     value REAL    NOT NULL DEFAULT 0.0
 );
-)sql";
 
-constexpr const char* SQL_CREATE_ACHIEVEMENTS = R"sql(
 CREATE TABLE IF NOT EXISTS achievements (
     id          TEXT    PRIMARY KEY NOT NULL,
     unlocked_at INTEGER NOT NULL DEFAULT 0
 );
 )sql";
 
+// v2：排行榜 / 最近成绩索引 + 每个 (chart_id, difficulty) 的最高分物化表。
+// best_scores.score_id 指向 scores.id；同分保留最早的一局，与 SaveScore 的更新规则一致。
+constexpr const char* SQL_SCHEMA_V2 = R"sql(
+CREATE INDEX IF NOT EXISTS idx_scores_chart_diff_score
+    ON scores (chart_id, difficulty, score DESC, id);
+
+CREATE INDEX IF NOT EXISTS idx_scores_played_at
+    ON scores (played_at DESC, id DESC);
+
+CREATE TABLE IF NOT EXISTS best_scores (
+    chart_id   TEXT    NOT NULL,
+    difficulty TEXT    NOT NULL,
+    score_id   INTEGER NOT NULL,
+    score      INTEGER NOT NULL,
+    PRIMARY KEY (chart_id, difficulty)
+) WITHOUT ROWID;
+
+INSERT OR REPLACE INTO best_scores (chart_id, difficulty, score_id, score)
+SELECT s.chart_id, s.difficulty, MIN(s.id), s.score
+FROM scores AS s
+WHERE s.score = (
+    SELECT MAX(m.score) FROM scores AS m
+    WHERE m.chart_id = s.chart_id AND m.difficulty = s.difficulty
+)
+GROUP BY s.chart_id, s.difficulty;
+)sql";
+
+// v3：单行的玩家聚合统计（计数、求和、最大值、评级分布），随 SaveScore 同事务 O(1) 更新，
+// 统计页只需读这一行。游玩次数 / 时长从 statistics 回填，以兼容成绩行与统计不一致的旧库。
+constexpr const char* SQL_SCHEMA_V3 = R"sql(
+CREATE TABLE IF NOT EXISTS player_aggregates (
+    id                INTEGER PRIMARY KEY CHECK (id = 1),
+    score_count       INTEGER NOT NULL DEFAULT 0,
+    play_count        INTEGER NOT NULL DEFAULT 0,
+    play_time_seconds REAL    NOT NULL DEFAULT 0.0,
+    accuracy_sum      REAL    NOT NULL DEFAULT 0.0,
+    max_score         INTEGER NOT NULL DEFAULT 0,
+    max_accuracy      REAL    NOT NULL DEFAULT 0.0,
+    max_combo         INTEGER NOT NULL DEFAULT 0,
+    notes_judged      INTEGER NOT NULL DEFAULT 0,
+    full_combo_count  INTEGER NOT NULL DEFAULT 0,
+    all_perfect_count INTEGER NOT NULL DEFAULT 0,
+    grade_ss          INTEGER NOT NULL DEFAULT 0,
+    grade_s           INTEGER NOT NULL DEFAULT 0,
+    grade_a           INTEGER NOT NULL DEFAULT 0,
+    grade_b           INTEGER NOT NULL DEFAULT 0,
+    grade_c           INTEGER NOT NULL DEFAULT 0,
+    grade_d           INTEGER NOT NULL DEFAULT 0
+);
+
+INSERT OR REPLACE INTO player_aggregates
+SELECT 1,
+       COUNT(*),
+       COALESCE((SELECT CAST(value AS INTEGER) FROM statistics WHERE key = 'total_play_count'), 0),
+       COALESCE((SELECT value FROM statistics WHERE key = 'total_play_time_seconds'), 0.0),
+       COALESCE(SUM(accuracy), 0.0),
+       COALESCE(MAX(score), 0),
+       COALESCE(MAX(accuracy), 0.0),
+       COALESCE(MAX(max_combo), 0),
+       COALESCE(SUM(perfect_count + great_count + good_count + bad_count + miss_count), 0),
+       COALESCE(SUM(is_full_combo = 1), 0),
+       COALESCE(SUM(is_all_perfect = 1), 0),
+       COALESCE(SUM(grade = 'SS'), 0),
+       COALESCE(SUM(grade = 'S'), 0),
+       COALESCE(SUM(grade = 'A'), 0),
+       COALESCE(SUM(grade = 'B'), 0),
+       COALESCE(SUM(grade = 'C'), 0),
+       COALESCE(SUM(grade NOT IN ('SS', 'S', 'A', 'B', 'C')), 0)
+FROM scores;
+)sql";
+
+// v4：best_scores 记录最高分那一局的 PP，PP 排名加载时不再逐条重算。
+// 旧行为 NULL，由 Initialize 用 PPCalculator 回填；调整 PP 公式时追加一个把 pp 置 NULL 的迁移即可。
+constexpr const char* SQL_SCHEMA_V4 = R"sql(
+ALTER TABLE best_scores ADD COLUMN pp REAL;
+)sql";
+
+// v5：逐音符判定偏差改存 zigzag + varint 编码的 BLOB（见 hit_error_codec.h），
+// ±63 ms 内每个偏差 1 字节，约为 JSON 文本的 1/3。
+// 旧行由 Initialize 转码并把 hit_errors_json 置为 '[]'；读取时 COALESCE 兼容尚未转码的行。
+constexpr const char* SQL_SCHEMA_V5 = R"sql(
+ALTER TABLE scores ADD COLUMN hit_errors BLOB;
+)sql";
+
+struct Migration
+{
+    int         version;
+    const char* description;
+    const char* sql;
+};
+
+constexpr Migration kMigrations[] = {
+    { 1, "初始表结构",                     SQL_SCHEMA_V1 },
+    { 2, "成绩索引与 best_scores 物化表",  SQL_SCHEMA_V2 },
+    { 3, "player_aggregates 聚合统计",     SQL_SCHEMA_V3 },
+    { 4, "best_scores 记录 PP",            SQL_SCHEMA_V4 },
+    { 5, "判定偏差二进制存储",             SQL_SCHEMA_V5 },
+};
+
+constexpr int kLatestSchemaVersion = kMigrations[std::size(kMigrations) - 1].version;
+
+// ── 语句 ──────────────────────────────────────────────────────────────────────
+// 预编译语句缓存以这些常量的地址为键，调用方不得传入临时字符串
+
+constexpr const char* SQL_BEGIN    = "BEGIN IMMEDIATE;";
+constexpr const char* SQL_COMMIT   = "COMMIT;";
+constexpr const char* SQL_ROLLBACK = "ROLLBACK;";
+
+// 批次事务内每个写入一个保存点，失败时只撤销该写入
+constexpr const char* SQL_SAVEPOINT             = "SAVEPOINT pending_write;";
+constexpr const char* SQL_RELEASE_SAVEPOINT     = "RELEASE pending_write;";
+constexpr const char* SQL_ROLLBACK_TO_SAVEPOINT = "ROLLBACK TO pending_write;";
+
+constexpr const char* SQL_INSERT_SCORE = R"sql(
+    INSERT INTO scores (
+        chart_id, chart_title, difficulty, difficulty_level,
+        score, accuracy, max_combo, grade,
+        perfect_count, great_count, good_count, bad_count, miss_count,
+        is_full_combo, is_all_perfect, played_at, hit_errors
+    ) VALUES (?,?,?,?, ?,?,?,?, ?,?,?,?,?, ?,?,?,?);
+)sql";
+
+// 仅当新成绩严格更高时替换，同分保留先达成的一局
+constexpr const char* SQL_UPSERT_BEST_SCORE = R"sql(
+    INSERT INTO best_scores (chart_id, difficulty, score_id, score, pp)
+    VALUES (?, ?, ?, ?, ?)
+    ON CONFLICT (chart_id, difficulty) DO UPDATE
+        SET score_id = excluded.score_id, score = excluded.score, pp = excluded.pp
+        WHERE excluded.score > best_scores.score;
+)sql";
+
+// 列顺序与 ScoreCol 一致，pp 追加在末尾（COL_PP）
+constexpr const char* SQL_SELECT_ALL_BEST_PLAYS = R"sql(
+    SELECT s.chart_id, s.chart_title, s.difficulty, s.difficulty_level,
+           s.score, s.accuracy, s.max_combo, s.grade,
+           s.perfect_count, s.great_count, s.good_count, s.bad_count, s.miss_count,
+           s.is_full_combo, s.is_all_perfect, s.played_at, COALESCE(s.hit_errors, s.hit_errors_json), b.pp
+    FROM best_scores AS b
+    JOIN scores AS s ON s.id = b.score_id;
+)sql";
+
+constexpr const char* SQL_SELECT_BEST_PP_MISSING = R"sql(
+    SELECT s.chart_id, s.chart_title, s.difficulty, s.difficulty_level,
+           s.score, s.accuracy, s.max_combo, s.grade,
+           s.perfect_count, s.great_count, s.good_count, s.bad_count, s.miss_count,
+           s.is_full_combo, s.is_all_perfect, s.played_at, COALESCE(s.hit_errors, s.hit_errors_json)
+    FROM best_scores AS b
+    JOIN scores AS s ON s.id = b.score_id
+    WHERE b.pp IS NULL;
+)sql";
+
+constexpr const char* SQL_UPDATE_BEST_PP =
+    "UPDATE best_scores SET pp = ? WHERE chart_id = ? AND difficulty = ?;";
+
+constexpr const char* SQL_SELECT_BEST_SCORE = R"sql(
+    SELECT s.chart_id, s.chart_title, s.difficulty, s.difficulty_level,
+           s.score, s.accuracy, s.max_combo, s.grade,
+           s.perfect_count, s.great_count, s.good_count, s.bad_count, s.miss_count,
+           s.is_full_combo, s.is_all_perfect, s.played_at, COALESCE(s.hit_errors, s.hit_errors_json)
+    FROM best_scores AS b
+    JOIN scores AS s ON s.id = b.score_id
+    WHERE b.chart_id = ? AND b.difficulty = ?;
+)sql";
+
+constexpr const char* SQL_SELECT_TOP_SCORES = R"sql(
+    SELECT chart_id, chart_title, difficulty, difficulty_level,
+           score, accuracy, max_combo, grade,
+           perfect_count, great_count, good_count, bad_count, miss_count,
+           is_full_combo, is_all_perfect, played_at, COALESCE(hit_errors, hit_errors_json)
+    FROM scores
+    WHERE chart_id = ? AND difficulty = ?
+    ORDER BY score DESC, id ASC
+    LIMIT ?;
+)sql";
+
+constexpr const char* SQL_SELECT_ALL_BEST_SCORES = R"sql(
+    SELECT s.chart_id, s.chart_title, s.difficulty, s.difficulty_level,
+           s.score, s.accuracy, s.max_combo, s.grade,
+           s.perfect_count, s.great_count, s.good_count, s.bad_count, s.miss_count,
+           s.is_full_combo, s.is_all_perfect, s.played_at, COALESCE(s.hit_errors, s.hit_errors_json)
+    FROM best_scores AS b
+    JOIN scores AS s ON s.id = b.score_id
+    ORDER BY s.difficulty_level DESC;
+)sql";
+
+constexpr const char* SQL_SELECT_RECENT_SCORES = R"sql(
+    SELECT chart_id, chart_title, difficulty, difficulty_level,
+           score, accuracy, max_combo, grade,
+           perfect_count, great_count, good_count, bad_count, miss_count,
+           is_full_combo, is_all_perfect, played_at, COALESCE(hit_errors, hit_errors_json)
+    FROM scores
+    ORDER BY played_at DESC, id DESC
+    LIMIT ?;
+)sql";
+
+constexpr const char* SQL_SELECT_HIT_ERRORS_MISSING =
+    "SELECT id, hit_errors_json FROM scores WHERE hit_errors IS NULL;";
+
+constexpr const char* SQL_UPDATE_HIT_ERRORS =
+    "UPDATE scores SET hit_errors = ?, hit_errors_json = '[]' WHERE id = ?;";
+
+// 走 idx_scores_chart_diff_score 回表，无需排序
+constexpr const char* SQL_SELECT_CHART_HIT_ERRORS = R"sql(
+    SELECT COALESCE(hit_errors, hit_errors_json)
+    FROM scores
+    WHERE chart_id = ? AND difficulty = ?;
+)sql";
+
+// 按索引顺序扫描，同一 (chart_id, difficulty) 的行相邻
+constexpr const char* SQL_SELECT_ALL_HIT_ERRORS = R"sql(
+    SELECT chart_id, difficulty, COALESCE(hit_errors, hit_errors_json)
+    FROM scores INDEXED BY idx_scores_chart_diff_score
+    ORDER BY chart_id, difficulty;
+)sql";
+
+constexpr const char* SQL_INCREMENT_STATISTIC = R"sql(
+    INSERT INTO statistics (key, value)
+    VALUES (?, ?)
+    ON CONFLICT(key) DO UPDATE SET value = value + excluded.value;
+)sql";
+
+constexpr const char* SQL_SELECT_STATISTIC = "SELECT value FROM statistics WHERE key = ?;";
+
+// ?4 为评级下标（SS=0 … D=5，与 GetGradeDistribution 一致）
+constexpr const char* SQL_UPDATE_AGGREGATES = R"sql(
+    UPDATE player_aggregates SET
+        score_count       = score_count + 1,
+        play_count        = play_count + 1,
+        play_time_seconds = play_time_seconds + ?1,
+        accuracy_sum      = accuracy_sum + ?2,
+        max_score         = MAX(max_score, ?3),
+        max_accuracy      = MAX(max_accuracy, ?2),
+        max_combo         = MAX(max_combo, ?5),
+        notes_judged      = notes_judged + ?6,
+        full_combo_count  = full_combo_count + ?7,
+        all_perfect_count = all_perfect_count + ?8,
+        grade_ss          = grade_ss + (?4 = 0),
+        grade_s           = grade_s  + (?4 = 1),
+        grade_a           = grade_a  + (?4 = 2),
+        grade_b           = grade_b  + (?4 = 3),
+        grade_c           = grade_c  + (?4 = 4),
+        grade_d           = grade_d  + (?4 = 5)
+    WHERE id = 1;
+)sql";
+
+constexpr const char* SQL_SELECT_AGGREGATES = R"sql(
+    SELECT score_count, play_count, play_time_seconds, accuracy_sum,
+           max_score, max_accuracy, max_combo, notes_judged,
+           full_combo_count, all_perfect_count,
+           grade_ss, grade_s, grade_a, grade_b, grade_c, grade_d
+    FROM player_aggregates
+    WHERE id = 1;
+)sql";
+
+// 已解锁则忽略（INSERT OR IGNORE）
+constexpr const char* SQL_INSERT_ACHIEVEMENT =
+    "INSERT OR IGNORE INTO achievements (id, unlocked_at) VALUES (?, ?);";
+
+constexpr const char* SQL_SELECT_ACHIEVEMENTS =
+    "SELECT id, unlocked_at FROM achievements ORDER BY unlocked_at ASC;";
+
+constexpr const char* SQL_COUNT_ACHIEVEMENT =
+    "SELECT COUNT(*) FROM achievements WHERE id = ?;";
+
 // 列索引常量（与 SELECT 顺序对应）
 enum ScoreCol
 {
@@ -95,7 +362,8 @@ enum ScoreCol
     COL_IS_FC            = 13,
     COL_IS_AP            = 14,
     COL_PLAYED_AT        = 15,
-    COL_HIT_ERRORS       = 16
+    COL_HIT_ERRORS       = 16,
+    COL_PP               = 17   // 仅 SQL_SELECT_ALL_BEST_PLAYS
 };
 
 // 将 Grade 枚举转换为字符串
@@ -112,6 +380,20 @@ const char* GradeToStr(sakura::game::Grade g)
     }
 }
 
+// 评级分布下标：SS=0, S=1, A=2, B=3, C=4, D=5
+int GradeToIndex(sakura::game::Grade g)
+{
+    switch (g)
+    {
+        case sakura::game::Grade::SS: return 0;
+        case sakura::game::Grade::S:  return 1;
+        case sakura::game::Grade::A:  return 2;
+        case sakura::game::Grade::B:  return 3;
+        case sakura::game::Grade::C:  return 4;
+        default:                      return 5;
+    }
+}
+
 // 将字符串转换为 Grade 枚举
 sakura::game::Grade StrToGrade(const char* s)
 {
@@ -124,16 +406,10 @@ sakura::game::Grade StrToGrade(const char* s)
     return sakura::game::Grade::D;
 }
 
-// 将 hit_errors vector 序列化为 JSON 字符串
-std::string HitErrorsToJson(const std::vector<int>& errors)
-{
-    nlohmann::json j = errors;
-    return j.dump();
-}
-
-// 将 JSON 字符串反序列化为 hit_errors vector
-std::vector<int> JsonToHitErrors(const std::string& json)
+// 将 JSON 字符串反序列化为 hit_errors vector（v5 之前的 hit_errors_json）
+std::vector<int> JsonToHitErrors(const char* json)
 {
+    if (!json) return {};
     try
     {
         auto j = nlohmann::json::parse(json);
@@ -145,6 +421,31 @@ std::vector<int> JsonToHitErrors(const std::string& json)
     }
 }
 
+// 判定偏差列：v5 起为编码后的 BLOB，尚未转码的旧行经 COALESCE 得到 JSON 文本
+std::vector<int> ReadHitErrorsColumn(sqlite3_stmt* stmt, int col)
+{
+    if (sqlite3_column_type(stmt, col) == SQLITE_TEXT)
+        return JsonToHitErrors(reinterpret_cast<const char*>(sqlite3_column_text(stmt, col)));
+
+    const auto* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, col));
+    return DecodeHitErrors(data, static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+}
+
+// 同上，但直接累计进 stats（BLOB 逐条解码，不构造 vector）
+void AccumulateHitErrorsColumn(sqlite3_stmt* stmt, int col, HitErrorStats& stats)
+{
+    if (sqlite3_column_type(stmt, col) == SQLITE_TEXT)
+    {
+        for (int err : ReadHitErrorsColumn(stmt, col))
+            stats.Add(err);
+        return;
+    }
+
+    const auto* data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, col));
+    if (!AccumulateHitErrors(data, static_cast<size_t>(sqlite3_column_bytes(stmt, col)), stats))
+        LOG_WARN("[Database] 判定偏差数据损坏，已跳过剩余部分");
+}
+
 // 获取当前 Unix 时间戳（秒）
 long long NowTimestamp()
 {
@@ -219,21 +520,34 @@ bool Database::Initialize(std::string_view dbPath)
     // 外键约束
     ExecSQL("PRAGMA foreign_keys=ON;");
 
-    if (!CreateTables())
+    if (!RunMigrations())
     {
-        LOG_ERROR("[Database] 建表失败");
+        LOG_ERROR("[Database] 表结构迁移失败");
         Shutdown();
         return false;
     }
+    BackfillBestScorePP();
+    BackfillHitErrors();
 
-    LOG_INFO("[Database] 数据库已打开: {}", m_path);
+    m_stopWriter = false;
+    m_writer = std::thread(&Database::WriterLoop, this);
+
+    LOG_INFO("[Database] 数据库已打开: {} (schema v{})", m_path, GetSchemaVersion());
     return true;
 }
 
 void Database::Shutdown()
 {
+    StopWriter();
+
     if (m_db)
     {
+        // 写入线程已退出；提交它停止前未覆盖到的写入
+        Flush();
+
+        std::lock_guard lock(m_connMutex);
+        // 未 finalize 的语句会让 sqlite3_close 返回 SQLITE_BUSY
+        FinalizeStatements();
         sqlite3_close(m_db);
         m_db = nullptr;
         LOG_INFO("[Database] 数据库已关闭");
@@ -241,14 +555,332 @@ void Database::Shutdown()
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// CreateTables / ExecSQL
+// 预编译语句缓存
+// ═════════════════════════════════════════════════════════════════════════════
+
+Database::ScopedStatement::~ScopedStatement()
+{
+    if (m_stmt)
+    {
+        sqlite3_reset(m_stmt);
+        sqlite3_clear_bindings(m_stmt);
+    }
+}
+
+Database::ScopedStatement Database::Prepare(const char* sql)
+{
+    if (!m_db) return ScopedStatement(nullptr);
+
+    auto it = m_statements.find(sql);
+    if (it != m_statements.end())
+        return ScopedStatement(it->second);
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v3(m_db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK)
+    {
+        LOG_ERROR("[Database] prepare 失败: {}", sqlite3_errmsg(m_db));
+        sqlite3_finalize(stmt);
+        return ScopedStatement(nullptr);
+    }
+
+    m_statements.emplace(sql, stmt);
+    return ScopedStatement(stmt);
+}
+
+void Database::FinalizeStatements()
+{
+    for (auto& [sql, stmt] : m_statements)
+        sqlite3_finalize(stmt);
+    m_statements.clear();
+}
+
+size_t Database::GetCachedStatementCount() const
+{
+    std::lock_guard lock(m_connMutex);
+    return m_statements.size();
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// 写入队列 — 入队 / 批次应用 / 提交 / 数据库线程
+// ═════════════════════════════════════════════════════════════════════════════
+
+std::future<bool> Database::Enqueue(std::function<bool()> apply)
+{
+    PendingWrite write;
+    write.apply = std::move(apply);
+    auto future = write.done.get_future();
+
+    if (!m_db)
+    {
+        write.done.set_value(false);
+        return future;
+    }
+
+    {
+        std::lock_guard lock(m_queueMutex);
+        m_pending.push_back(std::move(write));
+    }
+    m_queueCv.notify_one();
+    return future;
+}
+
+std::unique_lock<std::mutex> Database::LockForRead()
+{
+    std::unique_lock lock(m_connMutex);
+    CommitPendingLocked();
+    return lock;
+}
+
+void Database::ApplyPendingLocked()
+{
+    std::vector<PendingWrite> batch;
+    {
+        std::lock_guard lock(m_queueMutex);
+        batch.swap(m_pending);
+    }
+    if (batch.empty() || !m_db)
+    {
+        for (auto& write : batch)
+            write.done.set_value(false);
+        return;
+    }
+
+    if (!m_batchOpen)
+    {
+        m_batchOpen = BeginTransaction();
+        if (!m_batchOpen)
+            LOG_ERROR("[Database] 开启写入批次失败: {}", sqlite3_errmsg(m_db));
+    }
+
+    for (auto& write : batch)
+    {
+        if (m_batchOpen && ExecCached(SQL_SAVEPOINT))
+        {
+            write.applied = write.apply();
+            if (!write.applied)
+            {
+                LOG_ERROR("[Database] 写入失败，已撤销: {}", sqlite3_errmsg(m_db));
+                ExecCached(SQL_ROLLBACK_TO_SAVEPOINT);
+            }
+            ExecCached(SQL_RELEASE_SAVEPOINT);
+        }
+        m_applied.push_back(std::move(write));
+    }
+}
+
+void Database::CommitPendingLocked()
+{
+    ApplyPendingLocked();
+    if (m_applied.empty())
+        return;
+
+    bool committed = false;
+    if (m_batchOpen)
+    {
+        committed = CommitTransaction();
+        if (!committed)
+        {
+            LOG_ERROR("[Database] 提交写入批次失败: {}", sqlite3_errmsg(m_db));
+            RollbackTransaction();
+        }
+        else
+        {
+            ++m_committedBatches;
+        }
+        m_batchOpen = false;
+    }
+
+    bool allApplied = committed;
+    for (auto& write : m_applied)
+    {
+        write.done.set_value(committed && write.applied);
+        allApplied = allApplied && write.applied;
+    }
+    m_applied.clear();
+
+    if (!allApplied)
+        m_failedBatches.fetch_add(1, std::memory_order_release);
+}
+
+void Database::Flush()
+{
+    std::lock_guard lock(m_connMutex);
+    CommitPendingLocked();
+}
+
+long long Database::GetCommittedBatchCount() const
+{
+    std::lock_guard lock(m_connMutex);
+    return m_committedBatches;
+}
+
+long long Database::GetFailedBatchCount() const
+{
+    return m_failedBatches.load(std::memory_order_acquire);
+}
+
+void Database::WriterLoop()
+{
+    std::unique_lock lock(m_queueMutex);
+    while (!m_stopWriter)
+    {
+        m_queueCv.wait(lock, [this] { return m_stopWriter || !m_pending.empty(); });
+        if (m_stopWriter)
+            break;
+
+        // 攒批：结算场景通常在几毫秒内连续写入成绩、统计与成就
+        m_queueCv.wait_for(lock, WRITE_BATCH_WINDOW, [this] { return m_stopWriter; });
+
+        lock.unlock();
+        {
+            std::lock_guard conn(m_connMutex);
+            CommitPendingLocked();
+        }
+        lock.lock();
+    }
+}
+
+void Database::StopWriter()
+{
+    if (!m_writer.joinable())
+        return;
+
+    {
+        std::lock_guard lock(m_queueMutex);
+        m_stopWriter = true;
+    }
+    m_queueCv.notify_all();
+    m_writer.join();
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// RunMigrations / ExecSQL / 事务（Initialize 期间写入线程尚未启动）
 // ═════════════════════════════════════════════════════════════════════════════
 
-bool Database::CreateTables()
+int Database::GetSchemaVersion() const
+{
+    std::lock_guard lock(m_connMutex);
+    if (!m_db) return 0;
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(m_db, "PRAGMA user_version;", -1, &stmt, nullptr) != SQLITE_OK)
+        return 0;
+
+    int version = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+        version = sqlite3_column_int(stmt, 0);
+
+    sqlite3_finalize(stmt);
+    return version;
+}
+
+bool Database::RunMigrations()
+{
+    const int current = GetSchemaVersion();
+    if (current > kLatestSchemaVersion)
+    {
+        // 新版本程序写过的库：已知的表仍兼容，只追加新结构，继续使用
+        LOG_WARN("[Database] 数据库版本 v{} 高于程序支持的 v{}", current, kLatestSchemaVersion);
+        return true;
+    }
+
+    for (const auto& migration : kMigrations)
+    {
+        if (migration.version <= current)
+            continue;
+
+        const std::string setVersion =
+            "PRAGMA user_version = " + std::to_string(migration.version) + ";";
+
+        if (!ExecSQL("BEGIN IMMEDIATE;"))
+            return false;
+
+        if (!ExecSQL(migration.sql) || !ExecSQL(setVersion.c_str()))
+        {
+            ExecSQL("ROLLBACK;");
+            LOG_ERROR("[Database] 迁移 v{} ({}) 失败", migration.version, migration.description);
+            return false;
+        }
+
+        if (!ExecSQL("COMMIT;"))
+            return false;
+
+        LOG_INFO("[Database] 已迁移到 v{}: {}", migration.version, migration.description);
+    }
+    return true;
+}
+
+void Database::BackfillBestScorePP()
 {
-    return ExecSQL(SQL_CREATE_SCORES)
-        && ExecSQL(SQL_CREATE_STATISTICS)
-        && ExecSQL(SQL_CREATE_ACHIEVEMENTS);
+    std::lock_guard lock(m_connMutex);
+
+    std::vector<sakura::game::GameResult> missing;
+    if (auto stmt = Prepare(SQL_SELECT_BEST_PP_MISSING))
+    {
+        while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+            missing.push_back(RowToGameResult(stmt.Get()));
+    }
+    if (missing.empty() || !BeginTransaction())
+        return;
+
+    bool ok = true;
+    for (const auto& best : missing)
+    {
+        auto stmt = Prepare(SQL_UPDATE_BEST_PP);
+        if (!stmt) { ok = false; break; }
+
+        sqlite3_bind_double(stmt.Get(), 1, sakura::game::PPCalculator::CalculatePP(best, best.difficultyLevel));
+        sqlite3_bind_text  (stmt.Get(), 2, best.chartId.c_str(),    -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text  (stmt.Get(), 3, best.difficulty.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt.Get()) != SQLITE_DONE) { ok = false; break; }
+    }
+
+    if (ok && CommitTransaction())
+    {
+        LOG_INFO("[Database] 已回填 {} 条最高分的 PP", missing.size());
+        return;
+    }
+    LOG_ERROR("[Database] 回填 PP 失败: {}", sqlite3_errmsg(m_db));
+    RollbackTransaction();
+}
+
+void Database::BackfillHitErrors()
+{
+    std::lock_guard lock(m_connMutex);
+
+    std::vector<std::pair<long long, std::vector<uint8_t>>> missing;
+    if (auto stmt = Prepare(SQL_SELECT_HIT_ERRORS_MISSING))
+    {
+        while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        {
+            const auto* json = reinterpret_cast<const char*>(sqlite3_column_text(stmt.Get(), 1));
+            missing.emplace_back(sqlite3_column_int64(stmt.Get(), 0), EncodeHitErrors(JsonToHitErrors(json)));
+        }
+    }
+    if (missing.empty() || !BeginTransaction())
+        return;
+
+    bool ok = true;
+    for (const auto& [id, blob] : missing)
+    {
+        auto stmt = Prepare(SQL_UPDATE_HIT_ERRORS);
+        if (!stmt) { ok = false; break; }
+
+        if (blob.empty())
+            sqlite3_bind_zeroblob(stmt.Get(), 1, 0);
+        else
+            sqlite3_bind_blob(stmt.Get(), 1, blob.data(), static_cast<int>(blob.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(stmt.Get(), 2, id);
+        if (sqlite3_step(stmt.Get()) != SQLITE_DONE) { ok = false; break; }
+    }
+
+    if (ok && CommitTransaction())
+    {
+        LOG_INFO("[Database] 已转码 {} 条成绩的判定偏差", missing.size());
+        return;
+    }
+    LOG_ERROR("[Database] 转码判定偏差失败: {}", sqlite3_errmsg(m_db));
+    RollbackTransaction();
 }
 
 bool Database::ExecSQL(const char* sql) const
@@ -265,6 +897,30 @@ bool Database::ExecSQL(const char* sql) const
     return true;
 }
 
+bool Database::ExecCached(const char* sql)
+{
+    auto stmt = Prepare(sql);
+    return stmt && sqlite3_step(stmt.Get()) == SQLITE_DONE;
+}
+
+bool Database::BeginTransaction()
+{
+    return ExecCached(SQL_BEGIN);
+}
+
+bool Database::CommitTransaction()
+{
+    return ExecCached(SQL_COMMIT);
+}
+
+void Database::RollbackTransaction()
+{
+    if (sqlite3_get_autocommit(m_db))
+        return;   // 出错时 SQLite 可能已自动回滚
+    if (auto stmt = Prepare(SQL_ROLLBACK))
+        sqlite3_step(stmt.Get());
+}
+
 // ═════════════════════════════════════════════════════════════════════════════
 // RowToGameResult — 从 sqlite3_stmt 读取一行结果
 // 调用者保证列顺序与 ScoreCol 枚举对应
@@ -296,465 +952,369 @@ sakura::game::GameResult Database::RowToGameResult(sqlite3_stmt* stmt) const
     r.isFullCombo    = sqlite3_column_int(stmt, COL_IS_FC) != 0;
     r.isAllPerfect   = sqlite3_column_int(stmt, COL_IS_AP) != 0;
     r.playedAt       = sqlite3_column_int64(stmt, COL_PLAYED_AT);
-    r.hitErrors      = JsonToHitErrors(getStr(COL_HIT_ERRORS));
+    r.hitErrors      = ReadHitErrorsColumn(stmt, COL_HIT_ERRORS);
 
     return r;
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// SaveScore
+// SaveScore — 成绩、最高分、统计作为批次内的一个写入（同一保存点）
 // ═════════════════════════════════════════════════════════════════════════════
 
-bool Database::SaveScore(const sakura::game::GameResult& result)
+std::future<bool> Database::SaveScore(const sakura::game::GameResult& result)
 {
     if (!m_db)
-    {
         LOG_WARN("[Database] SaveScore: 数据库未打开");
-        return false;
-    }
 
-    const char* sql = R"sql(
-        INSERT INTO scores (
-            chart_id, chart_title, difficulty, difficulty_level,
-            score, accuracy, max_combo, grade,
-            perfect_count, great_count, good_count, bad_count, miss_count,
-            is_full_combo, is_all_perfect, played_at, hit_errors_json
-        ) VALUES (?,?,?,?, ?,?,?,?, ?,?,?,?,?, ?,?,?,?);
-    )sql";
+    sakura::game::GameResult copy = result;
+    if (copy.playedAt <= 0)
+        copy.playedAt = NowTimestamp();
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    return Enqueue([this, r = std::move(copy)] { return SaveScoreLocked(r); });
+}
+
+bool Database::SaveScoreLocked(const sakura::game::GameResult& result)
+{
+    const std::vector<uint8_t> hitErrors = EncodeHitErrors(result.hitErrors);
+
+    bool ok = false;
+    if (auto stmt = Prepare(SQL_INSERT_SCORE))
     {
-        LOG_ERROR("[Database] SaveScore prepare 失败: {}", sqlite3_errmsg(m_db));
-        return false;
+        sqlite3_stmt* s = stmt.Get();
+        sqlite3_bind_text (s,  1, result.chartId.c_str(),      -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text (s,  2, result.chartTitle.c_str(),   -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text (s,  3, result.difficulty.c_str(),   -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(s, 4, result.difficultyLevel);
+        sqlite3_bind_int  (s,  5, result.score);
+        sqlite3_bind_double(s, 6, result.accuracy);
+        sqlite3_bind_int  (s,  7, result.maxCombo);
+        sqlite3_bind_text (s,  8, GradeToStr(result.grade),    -1, SQLITE_STATIC);
+        sqlite3_bind_int  (s,  9, result.perfectCount);
+        sqlite3_bind_int  (s, 10, result.greatCount);
+        sqlite3_bind_int  (s, 11, result.goodCount);
+        sqlite3_bind_int  (s, 12, result.badCount);
+        sqlite3_bind_int  (s, 13, result.missCount);
+        sqlite3_bind_int  (s, 14, result.isFullCombo  ? 1 : 0);
+        sqlite3_bind_int  (s, 15, result.isAllPerfect ? 1 : 0);
+        sqlite3_bind_int64(s, 16, result.playedAt);
+        if (hitErrors.empty())
+            sqlite3_bind_zeroblob(s, 17, 0);   // 空 BLOB 而非 NULL（NULL 表示尚未转码）
+        else
+            sqlite3_bind_blob(s, 17, hitErrors.data(), static_cast<int>(hitErrors.size()), SQLITE_TRANSIENT);
+        ok = (sqlite3_step(s) == SQLITE_DONE);
     }
 
-    long long playedAt = result.playedAt > 0 ? result.playedAt : NowTimestamp();
-    std::string hitJson = HitErrorsToJson(result.hitErrors);
-
-    sqlite3_bind_text (stmt,  1, result.chartId.c_str(),      -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text (stmt,  2, result.chartTitle.c_str(),   -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text (stmt,  3, result.difficulty.c_str(),   -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 4, result.difficultyLevel);
-    sqlite3_bind_int  (stmt,  5, result.score);
-    sqlite3_bind_double(stmt, 6, result.accuracy);
-    sqlite3_bind_int  (stmt,  7, result.maxCombo);
-    sqlite3_bind_text (stmt,  8, GradeToStr(result.grade),    -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int  (stmt,  9, result.perfectCount);
-    sqlite3_bind_int  (stmt, 10, result.greatCount);
-    sqlite3_bind_int  (stmt, 11, result.goodCount);
-    sqlite3_bind_int  (stmt, 12, result.badCount);
-    sqlite3_bind_int  (stmt, 13, result.missCount);
-    sqlite3_bind_int  (stmt, 14, result.isFullCombo  ? 1 : 0);
-    sqlite3_bind_int  (stmt, 15, result.isAllPerfect ? 1 : 0);
-    sqlite3_bind_int64(stmt, 16, playedAt);
-    sqlite3_bind_text (stmt, 17, hitJson.c_str(),             -1, SQLITE_TRANSIENT);
-
-    bool ok = (sqlite3_step(stmt) == SQLITE_DONE);
-    if (!ok)
-        LOG_ERROR("[Database] SaveScore step 失败: {}", sqlite3_errmsg(m_db));
-    else
-        LOG_INFO("[Database] 已保存成绩: chart={} diff={} score={}",
-                 result.chartId, result.difficulty, result.score);
+    if (ok)
+    {
+        const long long scoreId = sqlite3_last_insert_rowid(m_db);
+        auto stmt = Prepare(SQL_UPSERT_BEST_SCORE);
+        ok = static_cast<bool>(stmt);
+        if (ok)
+        {
+            sqlite3_bind_text (stmt.Get(), 1, result.chartId.c_str(),    -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text (stmt.Get(), 2, result.difficulty.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt.Get(), 3, scoreId);
+            sqlite3_bind_int  (stmt.Get(), 4, result.score);
+            sqlite3_bind_double(stmt.Get(), 5,
+                sakura::game::PPCalculator::CalculatePP(result, result.difficultyLevel));
+            ok = (sqlite3_step(stmt.Get()) == SQLITE_DONE);
+        }
+    }
 
-    sqlite3_finalize(stmt);
+    if (ok)
+    {
+        auto stmt = Prepare(SQL_UPDATE_AGGREGATES);
+        ok = static_cast<bool>(stmt);
+        if (ok)
+        {
+            sqlite3_stmt* s = stmt.Get();
+            sqlite3_bind_double(s, 1, result.playTimeSeconds);
+            sqlite3_bind_double(s, 2, result.accuracy);
+            sqlite3_bind_int   (s, 3, result.score);
+            sqlite3_bind_int   (s, 4, GradeToIndex(result.grade));
+            sqlite3_bind_int   (s, 5, result.maxCombo);
+            sqlite3_bind_int64 (s, 6, static_cast<long long>(result.perfectCount) + result.greatCount
+                                      + result.goodCount + result.badCount + result.missCount);
+            sqlite3_bind_int   (s, 7, result.isFullCombo  ? 1 : 0);
+            sqlite3_bind_int   (s, 8, result.isAllPerfect ? 1 : 0);
+            ok = (sqlite3_step(s) == SQLITE_DONE) && sqlite3_changes(m_db) == 1;
+        }
+    }
 
     // 同步更新统计
-    IncrementStatistic("total_play_count",   1.0);
-    IncrementStatistic("total_play_time_seconds", result.playTimeSeconds);
+    ok = ok
+        && IncrementStatisticLocked("total_play_count",        1.0)
+        && IncrementStatisticLocked("total_play_time_seconds", result.playTimeSeconds);
 
-    return ok;
+    if (!ok)
+    {
+        LOG_ERROR("[Database] SaveScore 失败: {}", sqlite3_errmsg(m_db));
+        return false;
+    }
+
+    LOG_INFO("[Database] 已保存成绩: chart={} diff={} score={}",
+             result.chartId, result.difficulty, result.score);
+    return true;
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// GetBestScore
+// GetBestScore — best_scores 主键查找 + scores 主键回表
 // ═════════════════════════════════════════════════════════════════════════════
 
 std::optional<sakura::game::GameResult> Database::GetBestScore(
     const std::string& chartId,
-    const std::string& difficulty) const
+    const std::string& difficulty)
 {
-    if (!m_db) return std::nullopt;
-
-    const char* sql = R"sql(
-        SELECT chart_id, chart_title, difficulty, difficulty_level,
-               score, accuracy, max_combo, grade,
-               perfect_count, great_count, good_count, bad_count, miss_count,
-               is_full_combo, is_all_perfect, played_at, hit_errors_json
-        FROM scores
-        WHERE chart_id = ? AND difficulty = ?
-        ORDER BY score DESC
-        LIMIT 1;
-    )sql";
-
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-    {
-        LOG_ERROR("[Database] GetBestScore prepare 失败: {}", sqlite3_errmsg(m_db));
-        return std::nullopt;
-    }
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_BEST_SCORE);
+    if (!stmt) return std::nullopt;
 
-    sqlite3_bind_text(stmt, 1, chartId.c_str(),    -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, difficulty.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.Get(), 1, chartId.c_str(),    -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.Get(), 2, difficulty.c_str(), -1, SQLITE_TRANSIENT);
 
     std::optional<sakura::game::GameResult> result;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        result = RowToGameResult(stmt);
-
-    sqlite3_finalize(stmt);
+    if (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        result = RowToGameResult(stmt.Get());
     return result;
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// GetTopScores
+// GetTopScores — idx_scores_chart_diff_score 有序扫描，无需排序
 // ═════════════════════════════════════════════════════════════════════════════
 
 std::vector<sakura::game::GameResult> Database::GetTopScores(
     const std::string& chartId,
     const std::string& difficulty,
-    int limit) const
+    int limit)
 {
-    if (!m_db) return {};
-
-    const char* sql = R"sql(
-        SELECT chart_id, chart_title, difficulty, difficulty_level,
-               score, accuracy, max_combo, grade,
-               perfect_count, great_count, good_count, bad_count, miss_count,
-               is_full_combo, is_all_perfect, played_at, hit_errors_json
-        FROM scores
-        WHERE chart_id = ? AND difficulty = ?
-        ORDER BY score DESC
-        LIMIT ?;
-    )sql";
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_TOP_SCORES);
+    if (!stmt) return {};
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-    {
-        LOG_ERROR("[Database] GetTopScores prepare 失败: {}", sqlite3_errmsg(m_db));
-        return {};
-    }
-
-    sqlite3_bind_text(stmt, 1, chartId.c_str(),    -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, difficulty.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int (stmt, 3, limit);
+    sqlite3_bind_text(stmt.Get(), 1, chartId.c_str(),    -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.Get(), 2, difficulty.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int (stmt.Get(), 3, limit);
 
     std::vector<sakura::game::GameResult> results;
-    while (sqlite3_step(stmt) == SQLITE_ROW)
-        results.push_back(RowToGameResult(stmt));
-
-    sqlite3_finalize(stmt);
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        results.push_back(RowToGameResult(stmt.Get()));
     return results;
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// GetAllBestScores — 每个 (chart_id, difficulty) 只保留最高分
+// GetAllBestScores — 每个 (chart_id, difficulty) 只保留最高分（读 best_scores）
 // ═════════════════════════════════════════════════════════════════════════════
 
-std::vector<sakura::game::GameResult> Database::GetAllBestScores() const
+std::vector<sakura::game::GameResult> Database::GetAllBestScores()
 {
-    if (!m_db) return {};
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_ALL_BEST_SCORES);
+    if (!stmt) return {};
 
-    const char* sql = R"sql(
-        SELECT chart_id, chart_title, difficulty, difficulty_level,
-               score, accuracy, max_combo, grade,
-               perfect_count, great_count, good_count, bad_count, miss_count,
-               is_full_combo, is_all_perfect, played_at, hit_errors_json
-        FROM scores AS s1
-        WHERE score = (
-            SELECT MAX(score) FROM scores AS s2
-            WHERE s2.chart_id = s1.chart_id AND s2.difficulty = s1.difficulty
-        )
-        GROUP BY chart_id, difficulty
-        ORDER BY difficulty_level DESC;
-    )sql";
+    std::vector<sakura::game::GameResult> results;
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        results.push_back(RowToGameResult(stmt.Get()));
+    return results;
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+std::vector<BestPlayRecord> Database::GetAllBestPlays()
+{
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_ALL_BEST_PLAYS);
+    if (!stmt) return {};
+
+    std::vector<BestPlayRecord> plays;
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
     {
-        LOG_ERROR("[Database] GetAllBestScores prepare 失败: {}", sqlite3_errmsg(m_db));
-        return {};
+        BestPlayRecord play;
+        play.result = RowToGameResult(stmt.Get());
+        play.pp     = sqlite3_column_type(stmt.Get(), COL_PP) == SQLITE_NULL
+            ? sakura::game::PPCalculator::CalculatePP(play.result, play.result.difficultyLevel)
+            : sqlite3_column_double(stmt.Get(), COL_PP);
+        plays.push_back(std::move(play));
     }
-
-    std::vector<sakura::game::GameResult> results;
-    while (sqlite3_step(stmt) == SQLITE_ROW)
-        results.push_back(RowToGameResult(stmt));
-
-    sqlite3_finalize(stmt);
-    return results;
+    return plays;
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// IncrementStatistic / GetStatistic
+// GetHitErrorStats / GetAllHitErrorStats — 逐行流式累计判定偏差
 // ═════════════════════════════════════════════════════════════════════════════
 
-bool Database::IncrementStatistic(const std::string& key, double amount)
+HitErrorStats Database::GetHitErrorStats(
+    const std::string& chartId,
+    const std::string& difficulty)
 {
-    if (!m_db) return false;
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_CHART_HIT_ERRORS);
+    if (!stmt) return {};
 
-    const char* sql = R"sql(
-        INSERT INTO statistics (key, value)
-        VALUES (?, ?)
-        ON CONFLICT(key) DO UPDATE SET value = value + excluded.value;
-    )sql";
+    sqlite3_bind_text(stmt.Get(), 1, chartId.c_str(),    -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.Get(), 2, difficulty.c_str(), -1, SQLITE_TRANSIENT);
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    HitErrorStats stats;
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        AccumulateHitErrorsColumn(stmt.Get(), 0, stats);
+    return stats;
+}
+
+std::vector<ChartHitErrorStats> Database::GetAllHitErrorStats()
+{
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_ALL_HIT_ERRORS);
+    if (!stmt) return {};
+
+    std::vector<ChartHitErrorStats> charts;
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
     {
-        LOG_ERROR("[Database] IncrementStatistic prepare 失败: {}", sqlite3_errmsg(m_db));
-        return false;
+        const auto* chartId    = reinterpret_cast<const char*>(sqlite3_column_text(stmt.Get(), 0));
+        const auto* difficulty = reinterpret_cast<const char*>(sqlite3_column_text(stmt.Get(), 1));
+        if (!chartId)    chartId    = "";
+        if (!difficulty) difficulty = "";
+
+        if (charts.empty() || charts.back().chartId != chartId || charts.back().difficulty != difficulty)
+        {
+            ChartHitErrorStats entry;
+            entry.chartId    = chartId;
+            entry.difficulty = difficulty;
+            charts.push_back(std::move(entry));
+        }
+
+        ChartHitErrorStats& current = charts.back();
+        ++current.plays;
+        AccumulateHitErrorsColumn(stmt.Get(), 2, current.errors);
     }
+    return charts;
+}
 
-    sqlite3_bind_text  (stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 2, amount);
+// ═════════════════════════════════════════════════════════════════════════════
+// IncrementStatistic / GetStatistic
+// ═════════════════════════════════════════════════════════════════════════════
 
-    bool ok = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
-    return ok;
+std::future<bool> Database::IncrementStatistic(const std::string& key, double amount)
+{
+    return Enqueue([this, key, amount] { return IncrementStatisticLocked(key, amount); });
 }
 
-double Database::GetStatistic(const std::string& key) const
+bool Database::IncrementStatisticLocked(const std::string& key, double amount)
 {
-    if (!m_db) return 0.0;
+    auto stmt = Prepare(SQL_INCREMENT_STATISTIC);
+    if (!stmt) return false;
 
-    const char* sql = "SELECT value FROM statistics WHERE key = ?;";
+    sqlite3_bind_text  (stmt.Get(), 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_double(stmt.Get(), 2, amount);
+    return sqlite3_step(stmt.Get()) == SQLITE_DONE;
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0.0;
+double Database::GetStatistic(const std::string& key)
+{
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_STATISTIC);
+    if (!stmt) return 0.0;
 
-    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.Get(), 1, key.c_str(), -1, SQLITE_TRANSIENT);
 
     double val = 0.0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        val = sqlite3_column_double(stmt, 0);
-
-    sqlite3_finalize(stmt);
+    if (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        val = sqlite3_column_double(stmt.Get(), 0);
     return val;
 }
 
-long long Database::GetTotalPlayCount() const
+long long Database::GetTotalPlayCount()
 {
     return static_cast<long long>(GetStatistic("total_play_count"));
 }
 
-double Database::GetTotalPlayTimeSeconds() const
+double Database::GetTotalPlayTimeSeconds()
 {
     return GetStatistic("total_play_time_seconds");
 }
 
-int Database::GetHighestScore() const
+PlayerStatsSnapshot Database::GetStatsSnapshot()
 {
-    if (!m_db) return 0;
-
-    const char* sql = "SELECT COALESCE(MAX(score), 0) FROM scores;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0;
-
-    int value = 0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0);
-
-    sqlite3_finalize(stmt);
-    return value;
+    PlayerStatsSnapshot snapshot;
+
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_AGGREGATES);
+    if (!stmt || sqlite3_step(stmt.Get()) != SQLITE_ROW)
+        return snapshot;
+
+    sqlite3_stmt* s = stmt.Get();
+    snapshot.scoreCount      = sqlite3_column_int64 (s, 0);
+    snapshot.playCount       = sqlite3_column_int64 (s, 1);
+    snapshot.playTimeSeconds = sqlite3_column_double(s, 2);
+    snapshot.accuracySum     = sqlite3_column_double(s, 3);
+    snapshot.highestScore    = sqlite3_column_int   (s, 4);
+    snapshot.highestAccuracy = static_cast<float>(sqlite3_column_double(s, 5));
+    snapshot.highestCombo    = sqlite3_column_int   (s, 6);
+    snapshot.notesJudged     = sqlite3_column_int64 (s, 7);
+    snapshot.fullComboCount  = sqlite3_column_int   (s, 8);
+    snapshot.allPerfectCount = sqlite3_column_int   (s, 9);
+    for (int i = 0; i < 6; ++i)
+        snapshot.gradeDistribution[static_cast<size_t>(i)] = sqlite3_column_int(s, 10 + i);
+    return snapshot;
 }
 
-float Database::GetHighestAccuracy() const
+int Database::GetHighestScore()
 {
-    if (!m_db) return 0.0f;
-
-    const char* sql = "SELECT COALESCE(MAX(accuracy), 0.0) FROM scores;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0.0f;
-
-    float value = 0.0f;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = static_cast<float>(sqlite3_column_double(stmt, 0));
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetStatsSnapshot().highestScore;
 }
 
-int Database::GetHighestCombo() const
+float Database::GetHighestAccuracy()
 {
-    if (!m_db) return 0;
-
-    const char* sql = "SELECT COALESCE(MAX(max_combo), 0) FROM scores;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0;
-
-    int value = 0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0);
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetStatsSnapshot().highestAccuracy;
 }
 
-bool Database::HasAnyFullCombo() const
+int Database::GetHighestCombo()
 {
-    if (!m_db) return false;
-
-    const char* sql = "SELECT COUNT(*) FROM scores WHERE is_full_combo = 1;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return false;
-
-    bool value = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0) > 0;
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetStatsSnapshot().highestCombo;
 }
 
-bool Database::HasAnyAllPerfect() const
+bool Database::HasAnyFullCombo()
 {
-    if (!m_db) return false;
-
-    const char* sql = "SELECT COUNT(*) FROM scores WHERE is_all_perfect = 1;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return false;
-
-    bool value = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0) > 0;
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetFullComboCount() > 0;
 }
 
-double Database::GetAverageAccuracy() const
+bool Database::HasAnyAllPerfect()
 {
-    if (!m_db) return 0.0;
-
-    const char* sql = "SELECT COALESCE(AVG(accuracy), 0.0) FROM scores;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0.0;
-
-    double value = 0.0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_double(stmt, 0);
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetAllPerfectCount() > 0;
 }
 
-int Database::GetTotalNotesJudged() const
+double Database::GetAverageAccuracy()
 {
-    if (!m_db) return 0;
-
-    const char* sql = R"sql(
-        SELECT COALESCE(SUM(perfect_count + great_count + good_count + bad_count + miss_count), 0)
-        FROM scores;
-    )sql";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0;
-
-    int value = 0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0);
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetStatsSnapshot().AverageAccuracy();
 }
 
-int Database::GetFullComboCount() const
+int Database::GetTotalNotesJudged()
 {
-    if (!m_db) return 0;
-
-    const char* sql = "SELECT COUNT(*) FROM scores WHERE is_full_combo = 1;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0;
-
-    int value = 0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0);
-
-    sqlite3_finalize(stmt);
-    return value;
+    return static_cast<int>(GetStatsSnapshot().notesJudged);
 }
 
-int Database::GetAllPerfectCount() const
+int Database::GetFullComboCount()
 {
-    if (!m_db) return 0;
-
-    const char* sql = "SELECT COUNT(*) FROM scores WHERE is_all_perfect = 1;";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return 0;
-
-    int value = 0;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        value = sqlite3_column_int(stmt, 0);
-
-    sqlite3_finalize(stmt);
-    return value;
+    return GetStatsSnapshot().fullComboCount;
 }
 
-std::array<int, 6> Database::GetGradeDistribution() const
+int Database::GetAllPerfectCount()
 {
-    std::array<int, 6> counts = { 0, 0, 0, 0, 0, 0 };
-    if (!m_db) return counts;
-
-    const char* sql = R"sql(
-        SELECT grade, COUNT(*)
-        FROM scores
-        GROUP BY grade;
-    )sql";
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return counts;
-
-    while (sqlite3_step(stmt) == SQLITE_ROW)
-    {
-        const char* grade = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        int count = sqlite3_column_int(stmt, 1);
-
-        if (!grade) continue;
-        if (std::strcmp(grade, "SS") == 0) counts[0] = count;
-        else if (std::strcmp(grade, "S") == 0) counts[1] = count;
-        else if (std::strcmp(grade, "A") == 0) counts[2] = count;
-        else if (std::strcmp(grade, "B") == 0) counts[3] = count;
-        else if (std::strcmp(grade, "C") == 0) counts[4] = count;
-        else counts[5] = count;
-    }
-
-    sqlite3_finalize(stmt);
-    return counts;
+    return GetStatsSnapshot().allPerfectCount;
 }
 
-std::vector<sakura::game::GameResult> Database::GetRecentScores(int limit) const
+std::array<int, 6> Database::GetGradeDistribution()
 {
-    if (!m_db) return {};
-
-    const char* sql = R"sql(
-        SELECT chart_id, chart_title, difficulty, difficulty_level,
-               score, accuracy, max_combo, grade,
-               perfect_count, great_count, good_count, bad_count, miss_count,
-               is_full_combo, is_all_perfect, played_at, hit_errors_json
-        FROM scores
-        ORDER BY played_at DESC, id DESC
-        LIMIT ?;
-    )sql";
+    return GetStatsSnapshot().gradeDistribution;
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return {};
+std::vector<sakura::game::GameResult> Database::GetRecentScores(int limit)
+{
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_RECENT_SCORES);
+    if (!stmt) return {};
 
-    sqlite3_bind_int(stmt, 1, limit);
+    sqlite3_bind_int(stmt.Get(), 1, limit);
 
     std::vector<sakura::game::GameResult> results;
-    while (sqlite3_step(stmt) == SQLITE_ROW)
-        results.push_back(RowToGameResult(stmt));
-
-    sqlite3_finalize(stmt);
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
+        results.push_back(RowToGameResult(stmt.Get()));
     return results;
 }
 
@@ -762,75 +1322,54 @@ std::vector<sakura::game::GameResult> Database::GetRecentScores(int limit) const
 // SaveAchievement / GetAchievements / IsAchievementUnlocked
 // ═════════════════════════════════════════════════════════════════════════════
 
-bool Database::SaveAchievement(const std::string& id)
+std::future<bool> Database::SaveAchievement(const std::string& id)
 {
-    if (!m_db) return false;
-
-    // 已解锁则忽略（INSERT OR IGNORE）
-    const char* sql =
-        "INSERT OR IGNORE INTO achievements (id, unlocked_at) VALUES (?, ?);";
-
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    return Enqueue([this, id, unlockedAt = NowTimestamp()]
     {
-        LOG_ERROR("[Database] SaveAchievement prepare 失败: {}", sqlite3_errmsg(m_db));
-        return false;
-    }
+        return SaveAchievementLocked(id, unlockedAt);
+    });
+}
 
-    sqlite3_bind_text (stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int64(stmt, 2, NowTimestamp());
+bool Database::SaveAchievementLocked(const std::string& id, long long unlockedAt)
+{
+    auto stmt = Prepare(SQL_INSERT_ACHIEVEMENT);
+    if (!stmt) return false;
+
+    sqlite3_bind_text (stmt.Get(), 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt.Get(), 2, unlockedAt);
 
-    bool ok = (sqlite3_step(stmt) == SQLITE_DONE);
+    bool ok = (sqlite3_step(stmt.Get()) == SQLITE_DONE);
     if (ok)
         LOG_INFO("[Database] 解锁成就: {}", id);
-    sqlite3_finalize(stmt);
     return ok;
 }
 
-std::vector<AchievementRecord> Database::GetAchievements() const
+std::vector<AchievementRecord> Database::GetAchievements()
 {
-    if (!m_db) return {};
-
-    const char* sql =
-        "SELECT id, unlocked_at FROM achievements ORDER BY unlocked_at ASC;";
-
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return {};
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_SELECT_ACHIEVEMENTS);
+    if (!stmt) return {};
 
     std::vector<AchievementRecord> records;
-    while (sqlite3_step(stmt) == SQLITE_ROW)
+    while (sqlite3_step(stmt.Get()) == SQLITE_ROW)
     {
         AchievementRecord rec;
-        const char* s = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* s = reinterpret_cast<const char*>(sqlite3_column_text(stmt.Get(), 0));
         rec.id          = s ? s : "";
-        rec.unlockedAt  = sqlite3_column_int64(stmt, 1);
+        rec.unlockedAt  = sqlite3_column_int64(stmt.Get(), 1);
         records.push_back(std::move(rec));
     }
-
-    sqlite3_finalize(stmt);
     return records;
 }
 
-bool Database::IsAchievementUnlocked(const std::string& id) const
+bool Database::IsAchievementUnlocked(const std::string& id)
 {
-    if (!m_db) return false;
-
-    const char* sql =
-        "SELECT COUNT(*) FROM achievements WHERE id = ?;";
-
-    sqlite3_stmt* stmt = nullptr;
-    if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return false;
-
-    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    auto lock = LockForRead();
+    auto stmt = Prepare(SQL_COUNT_ACHIEVEMENT);
+    if (!stmt) return false;
 
-    bool found = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
-        found = sqlite3_column_int(stmt, 0) > 0;
-
-    sqlite3_finalize(stmt);
-    return found;
+    sqlite3_bind_text(stmt.Get(), 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    return sqlite3_step(stmt.Get()) == SQLITE_ROW && sqlite3_column_int(stmt.Get(), 0) > 0;
 }
 
 } // namespace sakura::data
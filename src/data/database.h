@@ -2,13 +2,35 @@
 
 // database.h — 本地 SQLite3 数据层
 // 提供成绩、统计、成就的持久化存储
+// 表结构由 PRAGMA user_version 记录版本，打开时按顺序执行未应用的迁移；
+// 逐音符判定偏差以紧凑二进制（hit_error_codec.h）存于 scores.hit_errors。
+// 预编译语句在连接存活期间缓存复用，best_scores 表（含该局 PP）与 player_aggregates
+// 聚合行随 SaveScore 同事务维护。
+//
+// 写入为 write-behind：SaveScore / IncrementStatistic / SaveAchievement 只入队并返回
+// future，数据库线程攒批后在一个事务内执行并提交（每批一次 WAL 同步）。
+// 读取与写入共用同一连接（互斥访问）；读取前先在调用线程上提交队列中的写入，
+// 因此读到的结果总是包含此前入队的写入（read-your-writes），且只会读到已提交的数据。
+// future 在所在批次提交后才就绪；Flush() 是同步屏障，Shutdown() 会先 Flush。
+// 写入失败（含整批提交失败回滚）时 GetFailedBatchCount() 递增，据成绩乐观更新的内存缓存
+// （成就度量、PP 排名）以此判断是否需要从数据库重新加载。
 
 #include "game/chart.h"
+#include "data/hit_error_codec.h"
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // 前向声明 sqlite3 句柄，避免污染全局命名空间
@@ -25,12 +47,52 @@ struct AchievementRecord
     long long   unlockedAt = 0;  // Unix 时间戳（秒）
 };
 
+// BestPlayRecord — 某谱面某难度的最高分及其 PP（best_scores.pp）
+struct BestPlayRecord
+{
+    sakura::game::GameResult result;
+    double                   pp = 0.0;
+};
+
+// ChartHitErrorStats — 某谱面某难度全部成绩的判定偏差汇总
+struct ChartHitErrorStats
+{
+    std::string   chartId;
+    std::string   difficulty;
+    int           plays = 0;
+    HitErrorStats errors;
+};
+
+// PlayerStatsSnapshot — player_aggregates 单行快照（统计页 / 成就检查）
+struct PlayerStatsSnapshot
+{
+    long long scoreCount      = 0;     // scores 行数
+    long long playCount       = 0;     // 游玩次数（含迁移前 statistics 的计数）
+    double    playTimeSeconds = 0.0;
+    double    accuracySum     = 0.0;
+    int       highestScore    = 0;
+    float     highestAccuracy = 0.0f;
+    int       highestCombo    = 0;
+    long long notesJudged     = 0;
+    int       fullComboCount  = 0;
+    int       allPerfectCount = 0;
+    std::array<int, 6> gradeDistribution = { 0, 0, 0, 0, 0, 0 };  // SS, S, A, B, C, D
+
+    double AverageAccuracy() const
+    {
+        return scoreCount > 0 ? accuracySum / static_cast<double>(scoreCount) : 0.0;
+    }
+};
+
 // ── Database ──────────────────────────────────────────────────────────────────
 // 单例。通过 Initialize() 开启数据库，Shutdown() 关闭。
 // 所有公有方法在未调用 Initialize() 时安全返回默认值/false。
 class Database
 {
 public:
+    // 首个写入入队后，数据库线程再等待这么久以便同一批收集更多写入
+    static constexpr std::chrono::milliseconds WRITE_BATCH_WINDOW{ 20 };
+
     static Database& GetInstance();
 
     // ── 生命周期 ──────────────────────────────────────────────────────────────
@@ -42,58 +104,88 @@ public:
 
     bool IsOpen() const { return m_db != nullptr; }
 
+    // 当前表结构版本（PRAGMA user_version）；未打开时返回 0
+    int GetSchemaVersion() const;
+
+    // 已缓存的预编译语句数量（调试 / 测试）
+    size_t GetCachedStatementCount() const;
+
+    // 同步屏障：在调用线程上应用并提交此前入队的全部写入，返回后对应 future 均已就绪
+    void Flush();
+
+    // 已提交的写入批次数（调试 / 测试）
+    long long GetCommittedBatchCount() const;
+
+    // 含未落盘写入的批次数（单个写入失败或整批提交失败）；可在任意线程读取
+    long long GetFailedBatchCount() const;
+
     // ── 成绩 ─────────────────────────────────────────────────────────────────
 
-    // 将一局游戏结果写入 scores 表
-    bool SaveScore(const sakura::game::GameResult& result);
+    // 将一局游戏结果写入 scores 表，并在同一事务内更新 best_scores 与游玩统计
+    // 异步：future 在所在批次提交后给出结果；未打开时立即返回 false
+    std::future<bool> SaveScore(const sakura::game::GameResult& result);
 
     // 返回某谱面某难度的最高分记录（无记录则返回空 optional）
     std::optional<sakura::game::GameResult> GetBestScore(
         const std::string& chartId,
-        const std::string& difficulty) const;
+        const std::string& difficulty);
 
     // 返回某谱面某难度排行榜（按 score 降序，最多 limit 条）
     std::vector<sakura::game::GameResult> GetTopScores(
         const std::string& chartId,
         const std::string& difficulty,
-        int limit = 10) const;
+        int limit = 10);
 
     // 返回所有曲目各难度最高分（用于全局 PP 计算）
-    std::vector<sakura::game::GameResult> GetAllBestScores() const;
+    std::vector<sakura::game::GameResult> GetAllBestScores();
+
+    // 同上，附带入库时计算好的 PP（顺序不定；用于增量 PP 排名的初始加载）
+    std::vector<BestPlayRecord> GetAllBestPlays();
+
+    // 某谱面某难度全部成绩的判定偏差均值 / UR（逐行从 BLOB 流式累计，不解码为 vector）
+    HitErrorStats GetHitErrorStats(
+        const std::string& chartId,
+        const std::string& difficulty);
+
+    // 同上，一次扫描得到每个 (chart_id, difficulty) 的汇总（按 chart_id, difficulty 排序）
+    std::vector<ChartHitErrorStats> GetAllHitErrorStats();
 
     // ── 统计 ─────────────────────────────────────────────────────────────────
 
-    // 将统计项 key 的值增加 amount（若不存在则从 0 开始）
-    bool   IncrementStatistic(const std::string& key, double amount = 1.0);
+    // 将统计项 key 的值增加 amount（若不存在则从 0 开始；异步，同 SaveScore）
+    std::future<bool> IncrementStatistic(const std::string& key, double amount = 1.0);
 
     // 读取统计项，不存在时返回 0.0
-    double GetStatistic(const std::string& key) const;
-
-    // 便捷接口
-    long long GetTotalPlayCount()       const;
-    double    GetTotalPlayTimeSeconds() const;
-    int       GetHighestScore()         const;
-    float     GetHighestAccuracy()      const;
-    int       GetHighestCombo()         const;
-    bool      HasAnyFullCombo()         const;
-    bool      HasAnyAllPerfect()        const;
-    double    GetAverageAccuracy()      const;
-    int       GetTotalNotesJudged()     const;
-    int       GetFullComboCount()       const;
-    int       GetAllPerfectCount()      const;
-    std::array<int, 6> GetGradeDistribution() const;
-    std::vector<sakura::game::GameResult> GetRecentScores(int limit = 20) const;
+    double GetStatistic(const std::string& key);
+
+    // 一次读取全部聚合统计（单行主键查找，与成绩数量无关）
+    PlayerStatsSnapshot GetStatsSnapshot();
+
+    // 便捷接口（聚合项均取自 GetStatsSnapshot）
+    long long GetTotalPlayCount();
+    double    GetTotalPlayTimeSeconds();
+    int       GetHighestScore();
+    float     GetHighestAccuracy();
+    int       GetHighestCombo();
+    bool      HasAnyFullCombo();
+    bool      HasAnyAllPerfect();
+    double    GetAverageAccuracy();
+    int       GetTotalNotesJudged();
+    int       GetFullComboCount();
+    int       GetAllPerfectCount();
+    std::array<int, 6> GetGradeDistribution();
+    std::vector<sakura::game::GameResult> GetRecentScores(int limit = 20);
 
     // ── 成就 ─────────────────────────────────────────────────────────────────
 
-    // 记录成就解锁（已存在则忽略，不覆盖时间戳）
-    bool SaveAchievement(const std::string& id);
+    // 记录成就解锁（已存在则忽略，不覆盖时间戳；解锁时间取入队时刻，异步，同 SaveScore）
+    std::future<bool> SaveAchievement(const std::string& id);
 
     // 返回所有已解锁成就列表（按解锁时间升序）
-    std::vector<AchievementRecord> GetAchievements() const;
+    std::vector<AchievementRecord> GetAchievements();
 
     // 检查某成就是否已解锁
-    bool IsAchievementUnlocked(const std::string& id) const;
+    bool IsAchievementUnlocked(const std::string& id);
 
     // 禁止拷贝与移动
     Database(const Database&)            = delete;
@@ -105,14 +197,88 @@ private:
     Database()  = default;
     ~Database() { Shutdown(); }
 
-    bool CreateTables();
+    // ── 预编译语句缓存 ────────────────────────────────────────────────────────
+    // 以 SQL 常量的地址为键（调用方只传入具名常量），首次使用时 prepare，
+    // 之后每次借出前已处于 reset 状态；ScopedStatement 析构时 reset 并清空绑定。
+    class ScopedStatement
+    {
+    public:
+        explicit ScopedStatement(sqlite3_stmt* stmt) : m_stmt(stmt) {}
+        ~ScopedStatement();
+
+        ScopedStatement(const ScopedStatement&)            = delete;
+        ScopedStatement& operator=(const ScopedStatement&) = delete;
+
+        sqlite3_stmt* Get() const { return m_stmt; }
+        explicit operator bool() const { return m_stmt != nullptr; }
+
+    private:
+        sqlite3_stmt* m_stmt = nullptr;
+    };
+
+    // prepare 失败时返回空语句并记录错误；调用方须持有 m_connMutex
+    ScopedStatement Prepare(const char* sql);
+    void FinalizeStatements();
+
+    // ── 写入队列 ──────────────────────────────────────────────────────────────
+    // apply 在持有 m_connMutex 且处于批次事务内时执行，各自包在 SAVEPOINT 中，
+    // 单个写入失败只回滚它自己。
+    struct PendingWrite
+    {
+        std::function<bool()> apply;
+        std::promise<bool>     done;
+        bool                   applied = false;
+    };
+
+    std::future<bool> Enqueue(std::function<bool()> apply);
+
+    // 读取入口：加连接锁并先提交队列中的写入（read-your-writes，只读已提交数据）
+    [[nodiscard]] std::unique_lock<std::mutex> LockForRead();
+
+    // 以下须持有 m_connMutex
+    void ApplyPendingLocked();     // 把队列中的写入执行到批次事务（必要时开启）
+    void CommitPendingLocked();    // 应用队列中的写入并提交批次，兑现 future
+
+    void WriterLoop();
+    void StopWriter();
+
+    bool SaveScoreLocked(const sakura::game::GameResult& result);
+    bool IncrementStatisticLocked(const std::string& key, double amount);
+    bool SaveAchievementLocked(const std::string& id, long long unlockedAt);
+
+    // 按版本顺序执行未应用的表结构迁移，每个迁移一个事务
+    bool RunMigrations();
+    // 为迁移前的最高分（best_scores.pp 为 NULL）计算 PP，一个事务
+    void BackfillBestScorePP();
+    // 把迁移前的 hit_errors_json 转码为 hit_errors BLOB，一个事务
+    void BackfillHitErrors();
     bool ExecSQL(const char* sql) const;
 
+    bool BeginTransaction();
+    bool CommitTransaction();
+    void RollbackTransaction();
+    bool ExecCached(const char* sql);
+
     // 将当前 sqlite3_stmt 行的各列读入 GameResult
     sakura::game::GameResult RowToGameResult(sqlite3_stmt* stmt) const;
 
     sqlite3*    m_db   = nullptr;
     std::string m_path;
+
+    // 连接、语句缓存与批次事务状态；读取线程与数据库线程共用
+    mutable std::mutex                              m_connMutex;
+    std::unordered_map<const char*, sqlite3_stmt*>  m_statements;
+    std::vector<PendingWrite>                       m_applied;     // 已执行、待提交
+    bool                                            m_batchOpen = false;
+    long long                                       m_committedBatches = 0;
+    std::atomic<long long>                          m_failedBatches{ 0 };
+
+    // 入队的写入（尚未执行）
+    std::mutex                      m_queueMutex;
+    std::condition_variable         m_queueCv;
+    std::vector<PendingWrite>       m_pending;
+    bool                            m_stopWriter = false;
+    std::thread                     m_writer;
 };
 
 } // namespace sakura::data
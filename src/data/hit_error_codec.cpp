@@ -0,0 +1,154 @@
+// hit_error_codec.cpp — 判定偏差 zigzag + varint 编解码实现
+
+#include "hit_error_codec.h"
+
+#include <cmath>
+
+namespace sakura::data
+{
+
+namespace
+{
+
+// int32 varint 最多 5 字节
+constexpr int MAX_VARINT_BYTES = 5;
+
+uint32_t ZigzagEncode(int value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int ZigzagDecode(uint32_t value)
+{
+    return static_cast<int>((value >> 1) ^ (~(value & 1u) + 1u));
+}
+
+} // anonymous namespace
+
+// ═════════════════════════════════════════════════════════════════════════════
+// HitErrorWriter
+// ═════════════════════════════════════════════════════════════════════════════
+
+void HitErrorWriter::Append(int errorMs)
+{
+    if (m_count++ == 0)
+        m_out.push_back(HIT_ERROR_FORMAT_VARINT);
+
+    uint32_t v = ZigzagEncode(errorMs);
+    while (v >= 0x80u)
+    {
+        m_out.push_back(static_cast<uint8_t>(v | 0x80u));
+        v >>= 7;
+    }
+    m_out.push_back(static_cast<uint8_t>(v));
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// HitErrorReader
+// ═════════════════════════════════════════════════════════════════════════════
+
+HitErrorReader::HitErrorReader(const uint8_t* data, size_t size)
+    : m_pos(data)
+    , m_end(data ? data + size : data)
+{
+    if (m_pos == m_end)
+        return;
+    if (*m_pos != HIT_ERROR_FORMAT_VARINT)
+    {
+        m_failed = true;
+        m_pos    = m_end;
+        return;
+    }
+    ++m_pos;
+}
+
+bool HitErrorReader::Next(int& errorMs)
+{
+    if (m_pos == m_end)
+        return false;
+
+    uint32_t v = 0;
+    for (int i = 0; i < MAX_VARINT_BYTES && m_pos != m_end; ++i)
+    {
+        const uint8_t byte = *m_pos++;
+        v |= static_cast<uint32_t>(byte & 0x7Fu) << (7 * i);
+        if ((byte & 0x80u) == 0)
+        {
+            errorMs = ZigzagDecode(v);
+            return true;
+        }
+    }
+
+    // 截断或超长的 varint
+    m_failed = true;
+    m_pos    = m_end;
+    return false;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// HitErrorStats
+// ═════════════════════════════════════════════════════════════════════════════
+
+double HitErrorStats::Mean() const
+{
+    return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+}
+
+double HitErrorStats::StandardDeviation() const
+{
+    if (count <= 0)
+        return 0.0;
+
+    // 直接算 n·Σx² − (Σx)² 会在 n·Σx² 超过 2^53 后因相减抵消丢失精度。
+    // 先在整数上平移到最接近均值的整数 q（余数 r = Σx − n·q，|r| ≤ n/2）：
+    //   Σ(x − q)² = Σx² − 2q·Σx + n·q²（精确），σ² = Σ(x − q)² / n − (r / n)²
+    // 偏差几乎全相同时 q 就是那个值，两项都与 σ² 同量级，相减不再放大误差。
+    long long q = sum / count;
+    long long r = sum - q * count;
+    if (2 * r > count)       { ++q; r -= count; }
+    else if (2 * r < -count) { --q; r += count; }
+    const long long centered = sumSquares - 2 * q * sum + q * q * count;
+
+    const double n        = static_cast<double>(count);
+    const double shift    = static_cast<double>(r) / n;
+    const double variance = static_cast<double>(centered) / n - shift * shift;
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+// ═════════════════════════════════════════════════════════════════════════════
+// 便捷接口
+// ═════════════════════════════════════════════════════════════════════════════
+
+std::vector<uint8_t> EncodeHitErrors(const std::vector<int>& errors)
+{
+    std::vector<uint8_t> out;
+    out.reserve(errors.empty() ? 0 : errors.size() + 8);
+
+    HitErrorWriter writer(out);
+    for (int err : errors)
+        writer.Append(err);
+    return out;
+}
+
+std::vector<int> DecodeHitErrors(const uint8_t* data, size_t size)
+{
+    std::vector<int> errors;
+    errors.reserve(size);   // 每个偏差至少 1 字节
+
+    HitErrorReader reader(data, size);
+    int err = 0;
+    while (reader.Next(err))
+        errors.push_back(err);
+    return errors;
+}
+
+bool AccumulateHitErrors(const uint8_t* data, size_t size, HitErrorStats& stats)
+{
+    HitErrorReader reader(data, size);
+    int err = 0;
+    while (reader.Next(err))
+        stats.Add(err);
+    return !reader.Failed();
+}
+
+} // namespace sakura::data
@@ -0,0 +1,94 @@
+#pragma once
+
+// hit_error_codec.h — 逐音符判定偏差（GameResult::hitErrors）的紧凑二进制编码
+//
+// 存于 scores.hit_errors（BLOB）。布局：
+//   [0]   格式标记 HIT_ERROR_FORMAT_VARINT
+//   [1..] 每个偏差一个 zigzag + LEB128 varint（|err| ≤ 63 ms 占 1 字节，≤ 8191 ms 占 2 字节）
+// 不记录条数，写入端可以逐条追加；空序列编码为空 BLOB（无格式标记）。
+// HitErrorReader 逐条解码，配合 HitErrorStats 可以直接从 BLOB 累计均值与 UR，不产生临时 vector。
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sakura::data
+{
+
+inline constexpr uint8_t HIT_ERROR_FORMAT_VARINT = 1;
+
+// ── 编码 ─────────────────────────────────────────────────────────────────────
+
+// 追加写入到调用方的缓冲区（首个偏差写入前补格式标记）
+class HitErrorWriter
+{
+public:
+    explicit HitErrorWriter(std::vector<uint8_t>& out) : m_out(out) {}
+
+    void   Append(int errorMs);
+    size_t Count() const { return m_count; }
+
+private:
+    std::vector<uint8_t>& m_out;
+    size_t                m_count = 0;
+};
+
+// ── 解码 ─────────────────────────────────────────────────────────────────────
+
+// 顺序读取；数据须在读取期间保持有效（例如 sqlite3_column_blob 在下一次 step 前有效）
+class HitErrorReader
+{
+public:
+    HitErrorReader(const uint8_t* data, size_t size);
+
+    // 读出下一个偏差；数据结束或损坏时返回 false（损坏时 Failed() 为真）
+    bool Next(int& errorMs);
+    bool Failed() const { return m_failed; }
+
+private:
+    const uint8_t* m_pos;
+    const uint8_t* m_end;
+    bool           m_failed = false;
+};
+
+// ── 统计 ─────────────────────────────────────────────────────────────────────
+
+// 偏差均值与 UR（Unstable Rate = 总体标准差 × 10）。
+// 和与平方和用整数累计，多局合并时累计值精确且与合并顺序无关；方差先在整数上按整数均值
+// 平移再转为浮点，偏差条数很大时也不会因相减抵消丢失精度。
+struct HitErrorStats
+{
+    long long count      = 0;
+    long long sum        = 0;
+    long long sumSquares = 0;
+
+    void Add(int errorMs)
+    {
+        ++count;
+        sum        += errorMs;
+        sumSquares += static_cast<long long>(errorMs) * errorMs;
+    }
+
+    void Merge(const HitErrorStats& other)
+    {
+        count      += other.count;
+        sum        += other.sum;
+        sumSquares += other.sumSquares;
+    }
+
+    double Mean() const;
+    double StandardDeviation() const;
+    double UnstableRate() const { return StandardDeviation() * 10.0; }
+};
+
+// ── 便捷接口 ─────────────────────────────────────────────────────────────────
+
+std::vector<uint8_t> EncodeHitErrors(const std::vector<int>& errors);
+
+// 损坏的数据返回已解出的前缀
+std::vector<int> DecodeHitErrors(const uint8_t* data, size_t size);
+
+// 把一段编码直接累计进 stats；数据损坏时返回 false（已读出的部分仍计入）
+bool AccumulateHitErrors(const uint8_t* data, size_t size, HitErrorStats& stats);
+
+} // namespace sakura::data
@@ -28,21 +28,8 @@ EditorPreview::EditorPreview(EditorCore& core)
 
 void EditorPreview::Start(int fromMs)
 {
-    // 拷贝谱面音符
-    m_kbNotes.clear();
-    const auto& src = m_core.GetChartData().keyboardNotes;
-    m_kbNotes.reserve(src.size());
-    for (const auto& n : src)
-    {
-        PreviewKbNote pn;
-        pn.note   = n;
-        pn.note.isJudged = false;
-        pn.note.result   = sakura::game::JudgeResult::None;
-        pn.hit    = false;
-        pn.missed = false;
-        pn.hitFlash = 0.0f;
-        m_kbNotes.push_back(std::move(pn));
-    }
+    // 重置运行时状态（谱面音符直接引用 EditorCore，不再逐个拷贝）
+    m_kbStates.assign(m_core.GetChartData().keyboardNotes.size(), PreviewNoteState{});
 
     m_startMs   = fromMs;
     m_currentMs = fromMs;
@@ -94,11 +81,14 @@ void EditorPreview::Update(float dt)
     }
 
     // 自动命中/错过 键盘音符
-    for (auto& pn : m_kbNotes)
+    const auto& notes = m_core.GetChartData().keyboardNotes;
+    const size_t count = std::min(notes.size(), m_kbStates.size());
+    for (size_t i = 0; i < count; ++i)
     {
+        auto& pn = m_kbStates[i];
         if (pn.hit || pn.missed) continue;
 
-        int diff = pn.note.time - m_currentMs;
+        int diff = notes[i].time - m_currentMs;
 
         // 自动命中
         if (std::abs(diff) <= static_cast<int>(AUTO_HIT_MS))
@@ -118,11 +108,11 @@ void EditorPreview::Update(float dt)
     }
 
     // 检查是否所有音符都结束且时间超过最后音符 +3s
-    if (!m_kbNotes.empty())
+    if (count > 0)
     {
         int lastTime = 0;
-        for (const auto& pn : m_kbNotes)
-            lastTime = std::max(lastTime, pn.note.time + std::max(0, pn.note.duration));
+        for (size_t i = 0; i < count; ++i)
+            lastTime = std::max(lastTime, notes[i].time + std::max(0, notes[i].duration));
 
         if (m_currentMs > lastTime + 3000)
         {
@@ -251,20 +241,24 @@ void EditorPreview::DrawNotes(sakura::core::Renderer& renderer)
 {
     constexpr float NOTE_H = 0.010f;  // 音符高度（归一化）
 
-    for (const auto& pn : m_kbNotes)
+    const auto& notes = m_core.GetChartData().keyboardNotes;
+    const size_t count = std::min(notes.size(), m_kbStates.size());
+    for (size_t i = 0; i < count; ++i)
     {
+        const auto& pn   = m_kbStates[i];
+        const auto& note = notes[i];
         if (pn.missed) continue;  // 错过不绘制
         if (pn.hit && pn.hitFlash <= 0.0f) continue;  // 命中且高亮退完
 
-        float y = TimeToY(pn.note.time);
+        float y = TimeToY(note.time);
         // 裁剪：只绘制屏幕内的音符（稍微放宽范围）
         if (y < AREA_Y - NOTE_H || y > AREA_Y + AREA_H + NOTE_H) continue;
 
-        float x = LaneToX(pn.note.lane);
+        float x = LaneToX(note.lane);
 
         // 颜色
         sakura::core::Color noteColor{ 80, 130, 255, 220 };
-        if (pn.note.type == sakura::game::NoteType::Hold)
+        if (note.type == sakura::game::NoteType::Hold)
             noteColor = { 80, 220, 120, 220 };
 
         if (pn.hit)
@@ -276,9 +270,9 @@ void EditorPreview::DrawNotes(sakura::core::Renderer& renderer)
         }
 
         // Hold：先画长条
-        if (pn.note.type == sakura::game::NoteType::Hold && pn.note.duration > 0)
+        if (note.type == sakura::game::NoteType::Hold && note.duration > 0)
         {
-            float yEnd = TimeToY(pn.note.time + pn.note.duration);
+            float yEnd = TimeToY(note.time + note.duration);
             if (yEnd < y)
             {
                 renderer.DrawFilledRect({ x + LANE_W * 0.15f, yEnd,
@@ -362,8 +356,8 @@ void EditorPreview::DrawHUD(sakura::core::Renderer& renderer)
 
     // 已命中/总数
     int hitCnt  = 0;
-    int totalCnt = static_cast<int>(m_kbNotes.size());
-    for (const auto& pn : m_kbNotes) if (pn.hit) ++hitCnt;
+    int totalCnt = static_cast<int>(m_kbStates.size());
+    for (const auto& pn : m_kbStates) if (pn.hit) ++hitCnt;
 
     std::string noteInfo = std::to_string(hitCnt) + " / " + std::to_string(totalCnt);
     renderer.DrawText(m_font, noteInfo,
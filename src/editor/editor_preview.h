@@ -15,9 +15,9 @@ namespace sakura::editor
 {
 
 // ── 预览中的键盘音符状态 ──────────────────────────────────────────────────────
-struct PreviewKbNote
+// 与 EditorCore 谱面数据中的 keyboardNotes 按下标平行；音符本身不拷贝
+struct PreviewNoteState
 {
-    sakura::game::KeyboardNote note;   // 副本
     bool  hit     = false;
     bool  missed  = false;
     float hitFlash = 0.0f;   // 命中时高亮计时（秒）
@@ -61,7 +61,7 @@ private:
     int   m_startMs   = 0;    // 预览起始时间
     int   m_currentMs = 0;    // 当前预览时间（ms，从音频同步）
 
-    std::vector<PreviewKbNote> m_kbNotes;  // 所有键盘音符的工作副本
+    std::vector<PreviewNoteState> m_kbStates;  // 键盘音符运行时状态（预览期间谱面不可编辑）
 
     // ── 布局常量 ──────────────────────────────────────────────────────────────
     static constexpr float AREA_X      = 0.42f;
@@ -1,6 +1,7 @@
 // editor_timeline.cpp — 键盘轨道编辑区渲染与交互
 
 #include "editor_timeline.h"
+#include "game/chart_binary.h"
 #include "utils/logger.h"
 
 #include <SDL3/SDL.h>
@@ -21,6 +22,11 @@ EditorTimeline::EditorTimeline(EditorCore& core)
 {
 }
 
+EditorTimeline::~EditorTimeline()
+{
+    CancelWaveformJob();
+}
+
 // ═════════════════════════════════════════════════════════════════════════════
 // 坐标转换
 // ═════════════════════════════════════════════════════════════════════════════
@@ -101,6 +107,13 @@ void EditorTimeline::Update(float /*dt*/)
         // 平滑追踪：每帧直接更新（因为是编辑器，精确度优先）
         m_scrollTimeMs = targetScroll;
     }
+
+    // 波形任务开始构建后取得金字塔（之后随解码进度逐步绘制）
+    if (!m_waveform && m_waveformJob)
+    {
+        std::lock_guard<std::mutex> lock(m_waveformJob->mutex);
+        m_waveform = m_waveformJob->pyramid;
+    }
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
@@ -622,66 +635,149 @@ void EditorTimeline::DrawHoldDragPreview(sakura::core::Renderer& renderer)
 
 void EditorTimeline::DrawWaveform(sakura::core::Renderer& renderer)
 {
-    if (m_waveform.empty()) return;
-
-    for (int i = 0; i < static_cast<int>(m_waveform.size()); ++i)
+    using sakura::audio::WaveformPyramid;
+    if (!m_waveform) return;
+
+    // 按当前缩放选层级：每桶至少占 WAVEFORM_PIXELS_PER_BUCKET 像素行，绘制量只与屏幕高度相关
+    const float rows = std::max(1.0f, AREA_H * static_cast<float>(renderer.GetScreenHeight())
+                                      / WAVEFORM_PIXELS_PER_BUCKET);
+    const size_t level    = WaveformPyramid::ChooseLevel(static_cast<double>(m_viewDurationMs) / rows);
+    const int    bucketMs = WaveformPyramid::GetBucketMs(level);
+    const size_t ready    = m_waveform->GetReadyCount(level);
+    const auto*  buckets  = m_waveform->GetLevel(level);
+
+    const int    firstMs = std::max(0, m_scrollTimeMs);
+    const size_t first   = static_cast<size_t>(firstMs / bucketMs);
+    const size_t last    = std::min(ready,
+        static_cast<size_t>(std::max(0, m_scrollTimeMs + m_viewDurationMs) / bucketMs) + 1);
+
+    // 以标尺中线为零点：外层为 min~max 包络，内层为 ±RMS
+    const float centerX = RULER_W * 0.5f;
+    const float halfW   = RULER_W * 0.45f;
+    const sakura::core::Color envelopeColor{ 60, 200, 100, 110 };
+    const sakura::core::Color rmsColor     { 110, 235, 150, 170 };
+
+    for (size_t i = first; i < last; ++i)
     {
-        int   timeMs = i * m_waveformWindowMs;
-        float y      = TimeToY(timeMs);
-        if (y < AREA_Y || y > 1.0f) continue;
-
-        float amplitude = m_waveform[i];  // 0.0 ~ 1.0
-        float barW      = RULER_W * 0.9f * amplitude;
-        if (barW < 0.0005f) continue;
-
-        renderer.DrawFilledRect(
-            { 0.002f, y - 0.003f, barW, 0.006f },
-            sakura::core::Color{ 60, 200, 100, 110 });
+        const auto& b  = buckets[i];
+        const int   t0 = static_cast<int>(i) * bucketMs;
+        const float yBottom = TimeToY(t0);
+        const float yTop    = TimeToY(t0 + bucketMs);
+        if (yBottom < AREA_Y || yTop > 1.0f) continue;
+        const float top = std::max(yTop, AREA_Y);
+        const float h   = std::max(yBottom - top, 0.0015f);
+
+        const float lo = static_cast<float>(b.min) / 127.0f;
+        const float hi = static_cast<float>(b.max) / 127.0f;
+        if (hi - lo < 0.004f) continue;
+        renderer.DrawFilledRect({ centerX + lo * halfW, top, (hi - lo) * halfW, h }, envelopeColor);
+
+        const float rms = static_cast<float>(b.rms) / 255.0f;
+        if (rms > 0.002f)
+            renderer.DrawFilledRect({ centerX - rms * halfW, top, 2.0f * rms * halfW, h }, rmsColor);
     }
 }
 
 // ═════════════════════════════════════════════════════════════════════════════
-// LoadWaveform — 使用 miniaudio 解码音频文件并计算波形数据
+// LoadWaveform — 后台解码音频并构建多分辨率波形金字塔（命中 .skw 缓存时直接读取）
 // ═════════════════════════════════════════════════════════════════════════════
 
 void EditorTimeline::LoadWaveform(const std::string& audioPath)
 {
-    m_waveform.clear();
+    // 同一音频（如切换难度）沿用已有波形 / 正在进行的任务
+    if (!audioPath.empty() && audioPath == m_waveformPath && (m_waveform || m_waveformJob))
+        return;
+
+    CancelWaveformJob();
+    m_waveform.reset();
+    m_waveformPath = audioPath;
     if (audioPath.empty()) return;
 
-    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, 44100);
+    auto job = std::make_shared<WaveformJob>();
+    job->audioPath   = audioPath;
+    m_waveformJob    = job;
+    m_waveformThread = std::thread([job] { RunWaveformJob(*job); });
+}
+
+void EditorTimeline::CancelWaveformJob()
+{
+    if (m_waveformJob) m_waveformJob->cancelled.store(true, std::memory_order_relaxed);
+    if (m_waveformThread.joinable()) m_waveformThread.join();
+    m_waveformJob.reset();
+}
+
+void EditorTimeline::RunWaveformJob(WaveformJob& job)
+{
+    using sakura::audio::WaveformPyramid;
+
+    const auto stamp = sakura::game::ChartBinary::StatSource(job.audioPath);
+    if (!stamp)
+    {
+        LOG_WARN("[EditorTimeline] 音频文件不存在: {}", job.audioPath);
+        return;
+    }
+
+    const std::string cachePath = WaveformPyramid::GetCachePath(job.audioPath);
+    if (auto cached = WaveformPyramid::Read(cachePath, *stamp))
+    {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.pyramid = std::move(cached);
+        return;
+    }
+
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 1, WaveformPyramid::SAMPLE_RATE);
     ma_decoder decoder;
-    if (ma_decoder_init_file(audioPath.c_str(), &config, &decoder) != MA_SUCCESS)
+    if (ma_decoder_init_file(job.audioPath.c_str(), &config, &decoder) != MA_SUCCESS)
     {
-        LOG_WARN("[EditorTimeline] 波形解码失败: {}", audioPath);
+        LOG_WARN("[EditorTimeline] 波形解码失败: {}", job.audioPath);
         return;
     }
 
-    const ma_uint64 windowSamples =
-        static_cast<ma_uint64>(44100) * static_cast<ma_uint64>(m_waveformWindowMs) / 1000;
+    // 已知总长度时预分配并立即发布，边解码边绘制；未知时先完整解码
+    ma_uint64 length = 0;
+    if (ma_decoder_get_length_in_pcm_frames(&decoder, &length) != MA_SUCCESS) length = 0;
 
-    std::vector<float> buf(static_cast<size_t>(windowSamples));
+    std::shared_ptr<WaveformPyramid> pyramid;
+    std::vector<float> pending;
+    if (length > 0)
+    {
+        pyramid = std::make_shared<WaveformPyramid>(static_cast<uint64_t>(length));
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.pyramid = pyramid;
+    }
 
-    while (true)
+    constexpr ma_uint64 CHUNK_FRAMES = 16384;
+    std::vector<float> buf(static_cast<size_t>(CHUNK_FRAMES));
+    while (!job.cancelled.load(std::memory_order_relaxed))
     {
         ma_uint64 framesRead = 0;
-        ma_result res = ma_decoder_read_pcm_frames(&decoder, buf.data(), windowSamples, &framesRead);
+        ma_result res = ma_decoder_read_pcm_frames(&decoder, buf.data(), CHUNK_FRAMES, &framesRead);
         if (framesRead == 0) break;
 
-        float peak = 0.0f;
-        for (ma_uint64 s = 0; s < framesRead; ++s)
-        {
-            float v = std::abs(buf[static_cast<size_t>(s)]);
-            if (v > peak) peak = v;
-        }
-        m_waveform.push_back(peak);
+        if (pyramid)
+            pyramid->Append(buf.data(), static_cast<size_t>(framesRead));
+        else
+            pending.insert(pending.end(), buf.begin(), buf.begin() + static_cast<ptrdiff_t>(framesRead));
 
         if (res != MA_SUCCESS) break;
     }
-
     ma_decoder_uninit(&decoder);
-    LOG_INFO("[EditorTimeline] 波形加载完成: {} 个窗口 ({}ms/窗)",
-             static_cast<int>(m_waveform.size()), m_waveformWindowMs);
+    if (job.cancelled.load(std::memory_order_relaxed)) return;
+
+    if (!pyramid)
+    {
+        pyramid = std::make_shared<WaveformPyramid>(pending.size());
+        pyramid->Append(pending.data(), pending.size());
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.pyramid = pyramid;
+    }
+    pyramid->Finish();
+
+    if (pyramid->Write(cachePath, *stamp))
+    {
+        LOG_INFO("[EditorTimeline] 波形金字塔已生成: {} ({} 个 1ms 桶)",
+                 cachePath, static_cast<int>(pyramid->GetReadyCount(0)));
+    }
 }
 
 } // namespace sakura::editor
@@ -3,11 +3,16 @@
 // editor_timeline.h — 谱面编辑器键盘轨道区域的渲染与交互
 // 区域：(0.0, 0.06, 0.40, 0.94)，时间轴向上流动（底部=早，顶部=晚）
 
+#include "audio/waveform_pyramid.h"
 #include "core/renderer.h"
 #include "core/resource_manager.h"
 #include "editor_core.h"
 
 #include <SDL3/SDL.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -21,7 +26,7 @@ class EditorTimeline
 {
 public:
     explicit EditorTimeline(EditorCore& core);
-    ~EditorTimeline() = default;
+    ~EditorTimeline();
 
     void SetFont(sakura::core::FontHandle font) { m_font = font; }
 
@@ -43,7 +48,8 @@ public:
 
     int GetScrollTimeMs() const { return m_scrollTimeMs; }
 
-    // 加载并解析音频波形数据（用于时间轴左侧波形可视化）
+    // 加载音频波形（用于时间轴左侧波形可视化）：优先读取同目录 .skw 缓存，
+    // 否则在后台线程解码并逐级构建波形金字塔，构建期间已完成的部分即可绘制
     void LoadWaveform(const std::string& audioPath);
 
     // ── 坐标转换 ──────────────────────────────────────────────────────────────
@@ -111,9 +117,25 @@ private:
     float m_holdDragCurrentY  = 0.0f; // 当前鼠标 Y（归一化）
 
     // ── 波形数据 ──────────────────────────────────────────────────────────────
-    // m_waveform[i] = 第 i 个窗口的峰值幅度（归一化到 0~1）
-    std::vector<float> m_waveform;
-    int m_waveformWindowMs = 20;  // 每个窗口覆盖 20ms 音频
+    // 后台任务：工作线程解码并构建金字塔，构建开始后立即交给主线程逐步绘制
+    struct WaveformJob
+    {
+        std::string       audioPath;
+        std::atomic<bool> cancelled{ false };
+        std::mutex        mutex;
+        std::shared_ptr<const sakura::audio::WaveformPyramid> pyramid;   // mutex 保护
+    };
+
+    std::shared_ptr<WaveformJob> m_waveformJob;
+    std::thread                  m_waveformThread;
+    std::shared_ptr<const sakura::audio::WaveformPyramid> m_waveform;
+    std::string                  m_waveformPath;
+
+    // 每个波形桶在屏幕上至少占的像素行数（决定绘制层级，使每帧绘制量与缩放无关）
+    static constexpr float WAVEFORM_PIXELS_PER_BUCKET = 2.0f;
+
+    void CancelWaveformJob();
+    static void RunWaveformJob(WaveformJob& job);
 
     sakura::core::FontHandle m_font = sakura::core::INVALID_HANDLE;
 
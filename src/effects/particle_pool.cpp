@@ -0,0 +1,324 @@
+// particle_pool.cpp — SoA 粒子存储、SIMD 积分与批量几何生成
+
+#include "particle_pool.h"
+#include "utils/simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace sakura::effects
+{
+
+using sakura::core::BatchVertex;
+using sakura::utils::simd::FloatV;
+
+namespace
+{
+
+constexpr float kDegToRad = std::numbers::pi_v<float> / 180.0f;
+
+// 樱花 / 花瓣形状参数（归一化，相对粒子半径）
+constexpr float kBlossomPetalRadiusRatio = 0.58f;
+constexpr float kBlossomPetalOffsetRatio = 0.68f;
+constexpr float kBlossomVerticalSquash   = 0.82f;
+constexpr float kBlossomCoreRadiusRatio  = 0.36f;
+constexpr float kPetalVerticalSquash     = 0.82f;
+constexpr int   kBlossomPetals           = 5;
+
+struct BlossomUnitOffset
+{
+    float x;
+    float y;
+};
+
+constexpr std::array<BlossomUnitOffset, kBlossomPetals> kBlossomPetalOffsets = {{
+    { 1.0000000f,  0.0000000f },
+    { 0.3090170f,  0.9510565f },
+    {-0.8090170f,  0.5877852f },
+    {-0.8090170f, -0.5877852f },
+    { 0.3090170f, -0.9510565f },
+}};
+
+// 单位圆周表（segments + 1 个点，首尾重合）
+template <int Segments>
+struct UnitCircle
+{
+    std::array<float, Segments + 1> cosTable{};
+    std::array<float, Segments + 1> sinTable{};
+
+    UnitCircle()
+    {
+        for (int i = 0; i <= Segments; ++i)
+        {
+            const float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / Segments;
+            cosTable[i] = std::cos(angle);
+            sinTable[i] = std::sin(angle);
+        }
+    }
+};
+
+template <int Segments>
+const UnitCircle<Segments>& GetUnitCircle()
+{
+    static const UnitCircle<Segments> table;
+    return table;
+}
+
+constexpr size_t FanVertices(int segments) { return static_cast<size_t>(segments) + 2; }
+constexpr size_t FanIndices(int segments)  { return static_cast<size_t>(segments) * 3; }
+
+struct FColor
+{
+    float r, g, b, a;
+};
+
+// 顺序写入一个预分配图元的三角扇
+struct FanWriter
+{
+    BatchVertex* vertex;
+    int*         index;
+    int          next;   // 下一个顶点的批次内绝对下标
+
+    template <int Segments>
+    void Fan(float cx, float cy, float radius, const FColor& c)
+    {
+        const auto& unit = GetUnitCircle<Segments>();
+        const int center = next;
+        *vertex++ = { cx, cy, c.r, c.g, c.b, c.a, 0.5f, 0.5f };
+        for (int k = 0; k <= Segments; ++k)
+        {
+            *vertex++ = { cx + unit.cosTable[k] * radius, cy + unit.sinTable[k] * radius,
+                          c.r, c.g, c.b, c.a, 0.0f, 0.0f };
+        }
+        for (int k = 0; k < Segments; ++k)
+        {
+            *index++ = center;
+            *index++ = center + k + 1;
+            *index++ = center + k + 2;
+        }
+        next += Segments + 2;
+    }
+};
+
+} // namespace
+
+// ── 存储 ──────────────────────────────────────────────────────────────────────
+
+ParticlePool::ParticlePool(size_t capacity)
+    : m_capacity(capacity)
+{
+    for (auto* arr : { &m_x, &m_y, &m_vx, &m_vy, &m_ax, &m_ay,
+                       &m_rotation, &m_rotSpeed, &m_life,
+                       &m_invMaxLife, &m_size, &m_sizeDelta })
+        arr->resize(capacity);
+    m_colorStart.resize(capacity);
+    m_colorEnd.resize(capacity);
+    m_kind.resize(capacity);
+}
+
+bool ParticlePool::Spawn(const ParticleSpawn& spawn)
+{
+    if (IsFull()) return false;
+
+    const size_t i = m_count++;
+    m_x[i]          = spawn.x;
+    m_y[i]          = spawn.y;
+    m_vx[i]         = spawn.vx;
+    m_vy[i]         = spawn.vy;
+    m_ax[i]         = spawn.ax;
+    m_ay[i]         = spawn.ay;
+    m_rotation[i]   = spawn.rotation;
+    m_rotSpeed[i]   = spawn.rotSpeed;
+    m_life[i]       = spawn.life;
+    m_invMaxLife[i] = spawn.life > 0.0f ? 1.0f / spawn.life : 0.0f;
+    m_size[i]       = spawn.size;
+    m_sizeDelta[i]  = spawn.sizeEnd - spawn.size;
+    m_colorStart[i] = spawn.colorStart;
+    m_colorEnd[i]   = spawn.colorEnd;
+    m_kind[i]       = spawn.kind;
+    ++m_kindCounts[static_cast<size_t>(spawn.kind)];
+    return true;
+}
+
+void ParticlePool::RemoveAt(size_t index)
+{
+    --m_kindCounts[static_cast<size_t>(m_kind[index])];
+
+    const size_t last = --m_count;
+    if (index == last) return;
+
+    m_x[index]          = m_x[last];
+    m_y[index]          = m_y[last];
+    m_vx[index]         = m_vx[last];
+    m_vy[index]         = m_vy[last];
+    m_ax[index]         = m_ax[last];
+    m_ay[index]         = m_ay[last];
+    m_rotation[index]   = m_rotation[last];
+    m_rotSpeed[index]   = m_rotSpeed[last];
+    m_life[index]       = m_life[last];
+    m_invMaxLife[index] = m_invMaxLife[last];
+    m_size[index]       = m_size[last];
+    m_sizeDelta[index]  = m_sizeDelta[last];
+    m_colorStart[index] = m_colorStart[last];
+    m_colorEnd[index]   = m_colorEnd[last];
+    m_kind[index]       = m_kind[last];
+}
+
+void ParticlePool::Clear()
+{
+    m_count = 0;
+    m_kindCounts.fill(0);
+}
+
+// ── 模拟 ──────────────────────────────────────────────────────────────────────
+
+void ParticlePool::Update(float dt)
+{
+    const size_t n = m_count;
+    float* x   = m_x.data();
+    float* y   = m_y.data();
+    float* vx  = m_vx.data();
+    float* vy  = m_vy.data();
+    float* rot = m_rotation.data();
+    float* life = m_life.data();
+    const float* ax  = m_ax.data();
+    const float* ay  = m_ay.data();
+    const float* rsp = m_rotSpeed.data();
+
+    // 半隐式欧拉：先更新速度，再用新速度推进位置
+    const FloatV dtv(dt);
+    size_t i = 0;
+    for (; i + FloatV::Width <= n; i += FloatV::Width)
+    {
+        (FloatV::Load(life + i) - dtv).Store(life + i);
+
+        const FloatV nvx = FloatV::Load(vx + i) + FloatV::Load(ax + i) * dtv;
+        const FloatV nvy = FloatV::Load(vy + i) + FloatV::Load(ay + i) * dtv;
+        nvx.Store(vx + i);
+        nvy.Store(vy + i);
+        (FloatV::Load(x + i) + nvx * dtv).Store(x + i);
+        (FloatV::Load(y + i) + nvy * dtv).Store(y + i);
+        (FloatV::Load(rot + i) + FloatV::Load(rsp + i) * dtv).Store(rot + i);
+    }
+    for (; i < n; ++i)
+    {
+        life[i] -= dt;
+        vx[i]   += ax[i] * dt;
+        vy[i]   += ay[i] * dt;
+        x[i]    += vx[i] * dt;
+        y[i]    += vy[i] * dt;
+        rot[i]  += rsp[i] * dt;
+    }
+
+    // 移除死亡粒子：末尾粒子填入空位后需重新检查同一下标
+    for (size_t k = 0; k < m_count;)
+    {
+        if (m_life[k] <= 0.0f)
+            RemoveAt(k);
+        else
+            ++k;
+    }
+}
+
+// ── 几何 ──────────────────────────────────────────────────────────────────────
+
+void ParticlePool::GetGeometrySize(ParticleKind kind, size_t& vertices, size_t& indices)
+{
+    switch (kind)
+    {
+        case ParticleKind::Petal:
+            vertices = FanVertices(PETAL_SEGMENTS) * 2;
+            indices  = FanIndices(PETAL_SEGMENTS) * 2;
+            break;
+        case ParticleKind::Blossom:
+            vertices = FanVertices(PETAL_SEGMENTS) * kBlossomPetals + FanVertices(CIRCLE_SEGMENTS);
+            indices  = FanIndices(PETAL_SEGMENTS) * kBlossomPetals + FanIndices(CIRCLE_SEGMENTS);
+            break;
+        case ParticleKind::Circle:
+        default:
+            vertices = FanVertices(CIRCLE_SEGMENTS);
+            indices  = FanIndices(CIRCLE_SEGMENTS);
+            break;
+    }
+}
+
+void ParticlePool::AppendGeometry(sakura::core::GeometryBatch& batch, float screenW, float screenH) const
+{
+    if (m_count == 0) return;
+
+    size_t totalVertices = 0;
+    size_t totalIndices  = 0;
+    for (size_t k = 0; k < static_cast<size_t>(ParticleKind::Count); ++k)
+    {
+        size_t v = 0, idx = 0;
+        GetGeometrySize(static_cast<ParticleKind>(k), v, idx);
+        totalVertices += v * m_kindCounts[k];
+        totalIndices  += idx * m_kindCounts[k];
+    }
+
+    auto prim = batch.Add(nullptr, totalVertices, totalIndices);
+    FanWriter out{ prim.vertices, prim.indices, prim.baseVertex };
+
+    const float minDim = std::min(screenW, screenH);
+    constexpr float inv255 = 1.0f / 255.0f;
+
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        const float t  = std::clamp(1.0f - m_life[i] * m_invMaxLife[i], 0.0f, 1.0f);   // 0=刚出生, 1=即死
+        const float sz = m_size[i] + m_sizeDelta[i] * t;
+        const ParticleRgba& c0 = m_colorStart[i];
+        const ParticleRgba& c1 = m_colorEnd[i];
+        const FColor col = {
+            (c0.r + (c1.r - c0.r) * t) * inv255,
+            (c0.g + (c1.g - c0.g) * t) * inv255,
+            (c0.b + (c1.b - c0.b) * t) * inv255,
+            (c0.a + (c1.a - c0.a) * t) * inv255,
+        };
+        const float px = m_x[i];
+        const float py = m_y[i];
+
+        switch (m_kind[i])
+        {
+            case ParticleKind::Blossom:
+            {
+                const float petalR = sz * kBlossomPetalRadiusRatio * minDim;
+                const float offset = sz * kBlossomPetalOffsetRatio;
+                const float rad = m_rotation[i] * kDegToRad;
+                const float baseCos = std::cos(rad);
+                const float baseSin = std::sin(rad);
+                for (const auto& unit : kBlossomPetalOffsets)
+                {
+                    const float rotatedX = baseCos * unit.x - baseSin * unit.y;
+                    const float rotatedY = baseSin * unit.x + baseCos * unit.y;
+                    out.Fan<PETAL_SEGMENTS>((px + rotatedX * offset) * screenW,
+                                            (py + rotatedY * offset * kBlossomVerticalSquash) * screenH,
+                                            petalR, col);
+                }
+                const FColor core = { 1.0f, 240.0f * inv255, 200.0f * inv255, col.a };
+                out.Fan<CIRCLE_SEGMENTS>(px * screenW, py * screenH,
+                                         sz * kBlossomCoreRadiusRatio * minDim, core);
+                break;
+            }
+            case ParticleKind::Petal:
+            {
+                const float rad = m_rotation[i] * kDegToRad;
+                const float dirX = std::cos(rad);
+                const float dirY = std::sin(rad) * kPetalVerticalSquash;
+                out.Fan<PETAL_SEGMENTS>((px + dirX * sz * 0.45f) * screenW,
+                                        (py + dirY * sz * 0.45f) * screenH,
+                                        sz * 0.62f * minDim, col);
+                out.Fan<PETAL_SEGMENTS>((px - dirX * sz * 0.18f) * screenW,
+                                        (py - dirY * sz * 0.18f) * screenH,
+                                        sz * 0.46f * minDim, col);
+                break;
+            }
+            case ParticleKind::Circle:
+            default:
+                out.Fan<CIRCLE_SEGMENTS>(px * screenW, py * screenH, sz * minDim, col);
+                break;
+        }
+    }
+}
+
+} // namespace sakura::effects
@@ -0,0 +1,113 @@
+#pragma once
+
+// particle_pool.h — 粒子存储与模拟核心（SoA，与 SDL 解耦，可单元测试）
+// 每个属性一条连续数组，存活粒子始终位于 [0, count) 的稠密区间：
+//   - 发射直接追加到末尾（O(1)，无需扫描空槽）
+//   - 死亡时用末尾粒子覆盖（swap-remove），不留空洞
+//   - 积分循环按 simd::FloatV 宽度分块处理，只遍历存活粒子
+// 渲染时把全部粒子一次性写入 GeometryBatch 的单个图元（像素坐标、纯色三角扇），
+// 圆周顶点取自预计算的单位圆表，逐段不再调用三角函数。
+// 粒子为加色混合，绘制顺序与结果无关，因此 swap-remove 打乱顺序不影响画面。
+
+#include "core/geometry_batch.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sakura::effects
+{
+
+enum class ParticleKind : uint8_t
+{
+    Circle,    // 单个圆
+    Petal,     // 两圆叠成的花瓣
+    Blossom,   // 五瓣樱花 + 花心
+    Count
+};
+
+struct ParticleRgba
+{
+    uint8_t r = 255;
+    uint8_t g = 255;
+    uint8_t b = 255;
+    uint8_t a = 255;
+};
+
+// 单个粒子的初始状态（全归一化，相对屏幕比例）
+struct ParticleSpawn
+{
+    float x        = 0.0f;
+    float y        = 0.0f;
+    float vx       = 0.0f;   // 归一化/s
+    float vy       = 0.0f;
+    float ax       = 0.0f;   // 归一化/s²
+    float ay       = 0.0f;
+    float size     = 0.01f;  // 半径（相对短边）
+    float sizeEnd  = 0.005f;
+    float rotation = 0.0f;   // 度
+    float rotSpeed = 0.0f;   // 度/s
+    float life     = 1.0f;   // 秒
+    ParticleKind kind = ParticleKind::Circle;
+    ParticleRgba colorStart;
+    ParticleRgba colorEnd{ 255, 255, 255, 0 };
+};
+
+class ParticlePool
+{
+public:
+    static constexpr int CIRCLE_SEGMENTS = 8;
+    static constexpr int PETAL_SEGMENTS  = 10;
+
+    // 各属性数组一次性分配 capacity 个元素，运行期间不再分配
+    explicit ParticlePool(size_t capacity);
+
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetCount() const    { return m_count; }
+    bool   IsFull() const      { return m_count >= m_capacity; }
+
+    // 追加一个粒子；池满返回 false
+    bool Spawn(const ParticleSpawn& spawn);
+
+    // 积分一步并移除寿命耗尽的粒子
+    void Update(float dt);
+
+    void Clear();
+
+    // 把全部存活粒子作为一个纯色图元写入 batch（像素坐标）
+    void AppendGeometry(sakura::core::GeometryBatch& batch, float screenW, float screenH) const;
+
+    // 单个粒子对应的顶点 / 索引数
+    static void GetGeometrySize(ParticleKind kind, size_t& vertices, size_t& indices);
+
+    // ── 只读访问（测试 / 调试）────────────────────────────────────────────────
+    const float* GetX() const        { return m_x.data(); }
+    const float* GetY() const        { return m_y.data(); }
+    const float* GetVX() const       { return m_vx.data(); }
+    const float* GetVY() const       { return m_vy.data(); }
+    const float* GetRotation() const { return m_rotation.data(); }
+    const float* GetLife() const     { return m_life.data(); }
+    size_t GetKindCount(ParticleKind kind) const { return m_kindCounts[static_cast<size_t>(kind)]; }
+
+private:
+    void RemoveAt(size_t index);
+
+    size_t m_capacity = 0;
+    size_t m_count    = 0;
+
+    // 积分用（SIMD 连续访问）
+    std::vector<float> m_x, m_y, m_vx, m_vy, m_ax, m_ay;
+    std::vector<float> m_rotation, m_rotSpeed, m_life;
+    // 渲染用
+    std::vector<float>        m_invMaxLife;   // 1 / 初始寿命
+    std::vector<float>        m_size;
+    std::vector<float>        m_sizeDelta;    // sizeEnd - size
+    std::vector<ParticleRgba> m_colorStart;
+    std::vector<ParticleRgba> m_colorEnd;
+    std::vector<ParticleKind> m_kind;
+
+    std::array<size_t, static_cast<size_t>(ParticleKind::Count)> m_kindCounts{};
+};
+
+} // namespace sakura::effects
@@ -3,8 +3,6 @@
 
 #include <array>
 #include <algorithm>
-#include <cmath>
-#include <numbers>
 #include <random>
 
 namespace sakura::effects
@@ -14,21 +12,7 @@ namespace sakura::effects
 // 随机数生成器（模块内静态）
 // ============================================================================
 static std::mt19937 s_rng{ std::random_device{}() };
-static constexpr float kDegToRad = std::numbers::pi_v<float> / 180.0f;
 static constexpr float kBlossomProbability = 0.30f;
-struct BlossomUnitOffset
-{
-    float x;
-    float y;
-};
-
-static constexpr std::array<BlossomUnitOffset, 5> kBlossomPetalOffsets = {{
-    { 1.0000000f,  0.0000000f },
-    { 0.3090170f,  0.9510565f },
-    {-0.8090170f,  0.5877852f },
-    {-0.8090170f, -0.5877852f },
-    { 0.3090170f, -0.9510565f },
-}};
 
 static float RandFloat(float lo, float hi)
 {
@@ -237,73 +221,29 @@ ParticleConfig JudgeSpark(sakura::core::Color color)
 
 } // namespace ParticlePresets
 
-static void DrawSakuraBlossom(sakura::core::Renderer& renderer, const Particle& p,
-                              float sz, const sakura::core::Color& col)
-{
-    static constexpr float kBlossomPetalRadiusRatio = 0.58f;
-    static constexpr float kBlossomPetalOffsetRatio = 0.68f;
-    static constexpr float kBlossomVerticalSquash = 0.82f;
-    static constexpr float kBlossomCoreRadiusRatio = 0.36f;
-    const float petalR = sz * kBlossomPetalRadiusRatio;
-    const float offset = sz * kBlossomPetalOffsetRatio;
-    const float baseRad = p.rotation * kDegToRad;
-    const float baseCos = std::cos(baseRad);
-    const float baseSin = std::sin(baseRad);
-    for (const auto& unit : kBlossomPetalOffsets)
-    {
-        const float rotatedX = baseCos * unit.x - baseSin * unit.y;
-        const float rotatedY = baseSin * unit.x + baseCos * unit.y;
-        renderer.DrawCircleFilled(p.x + rotatedX * offset,
-                                  p.y + rotatedY * offset * kBlossomVerticalSquash,
-                                  petalR, col, 10);
-    }
-    renderer.DrawCircleFilled(p.x, p.y, sz * kBlossomCoreRadiusRatio,
-                              { 255, 240, 200, col.a }, 8);
-}
-
-static void DrawSakuraPetal(sakura::core::Renderer& renderer, const Particle& p,
-                            float sz, const sakura::core::Color& col)
-{
-    static constexpr float kPetalVerticalSquash = 0.82f;
-    const float rad = p.rotation * kDegToRad;
-    const float dirX = std::cos(rad);
-    const float dirY = std::sin(rad) * kPetalVerticalSquash;
-    renderer.DrawCircleFilled(p.x + dirX * sz * 0.45f,
-                              p.y + dirY * sz * 0.45f,
-                              sz * 0.62f, col, 10);
-    renderer.DrawCircleFilled(p.x - dirX * sz * 0.18f,
-                              p.y - dirY * sz * 0.18f,
-                              sz * 0.46f, col, 10);
-}
-
 // ============================================================================
 // ParticleSystem 实现
 // ============================================================================
 
-ParticleSystem::ParticleSystem()
+ParticleSystem::ParticleSystem(int capacity)
+    : m_pool(static_cast<size_t>(std::clamp(capacity, 0, MAX_PARTICLES)))
 {
-    // 全部初始化为非活跃
-    for (auto& p : m_pool)
-        p.active = false;
     for (auto& e : m_emitters)
         e.active = false;
 }
 
 // ── 内部辅助 ─────────────────────────────────────────────────────────────────
 
-Particle* ParticleSystem::AllocParticle()
+static ParticleRgba ToRgba(const sakura::core::Color& c)
 {
-    for (auto& p : m_pool)
-    {
-        if (!p.active)
-            return &p;
-    }
-    return nullptr;   // 池已满
+    return { c.r, c.g, c.b, c.a };
 }
 
-void ParticleSystem::InitParticle(Particle& p, float x, float y,
-                                   const ParticleConfig& cfg)
+bool ParticleSystem::SpawnParticle(float x, float y, const ParticleConfig& cfg)
 {
+    if (m_pool.IsFull()) return false;
+
+    ParticleSpawn p;
     p.x          = x + RandFloat(-cfg.spreadX * 0.5f, cfg.spreadX * 0.5f);
     p.y          = y + RandFloat(-cfg.spreadY * 0.5f, cfg.spreadY * 0.5f);
     p.vx         = RandFloat(cfg.vxMin, cfg.vxMax);
@@ -317,27 +257,17 @@ void ParticleSystem::InitParticle(Particle& p, float x, float y,
     p.size       = sz;
     p.sizeEnd    = sz * cfg.sizeEndMult;
 
-    p.maxLife    = RandFloat(cfg.lifeMin, cfg.lifeMax);
-    p.life       = p.maxLife;
-    p.shapeSeed  = RandFloat(0.0f, 1.0f);
-    p.shape      = cfg.shape;
+    p.life       = RandFloat(cfg.lifeMin, cfg.lifeMax);
 
-    p.colorStart = cfg.colorStart;
-    p.colorEnd   = cfg.colorEnd;
-    p.active     = true;
-}
+    // 樱花混合：按随机种子在整朵樱花与单片花瓣之间选择
+    if (cfg.shape == ParticleShape::SakuraMix)
+        p.kind = RandFloat(0.0f, 1.0f) < kBlossomProbability ? ParticleKind::Blossom : ParticleKind::Petal;
+    else
+        p.kind = ParticleKind::Circle;
 
-sakura::core::Color ParticleSystem::LerpColor(const sakura::core::Color& a,
-                                               const sakura::core::Color& b,
-                                               float t)
-{
-    t = std::clamp(t, 0.0f, 1.0f);
-    return {
-        static_cast<uint8_t>(a.r + (b.r - a.r) * t),
-        static_cast<uint8_t>(a.g + (b.g - a.g) * t),
-        static_cast<uint8_t>(a.b + (b.b - a.b) * t),
-        static_cast<uint8_t>(a.a + (b.a - a.a) * t),
-    };
+    p.colorStart = ToRgba(cfg.colorStart);
+    p.colorEnd   = ToRgba(cfg.colorEnd);
+    return m_pool.Spawn(p);
 }
 
 // ── 公开 API ─────────────────────────────────────────────────────────────────
@@ -346,9 +276,7 @@ void ParticleSystem::Emit(float x, float y, int count, const ParticleConfig& cfg
 {
     for (int i = 0; i < count; ++i)
     {
-        Particle* p = AllocParticle();
-        if (!p) break;   // 池已满，停止
-        InitParticle(*p, x, y, cfg);
+        if (!SpawnParticle(x, y, cfg)) break;   // 池已满，停止
     }
 }
 
@@ -391,68 +319,26 @@ void ParticleSystem::Update(float dt)
         while (em.accumulator >= interval)
         {
             em.accumulator -= interval;
-            Particle* p = AllocParticle();
-            if (!p) break;
-            InitParticle(*p, em.x, em.y, em.cfg);
+            if (!SpawnParticle(em.x, em.y, em.cfg)) break;
         }
     }
 
-    // 更新所有粒子
-    m_activeCount = 0;
-    for (auto& p : m_pool)
-    {
-        if (!p.active) continue;
-
-        p.life -= dt;
-        if (p.life <= 0.0f)
-        {
-            p.active = false;
-            continue;
-        }
-
-        p.vx += p.ax * dt;
-        p.vy += p.ay * dt;
-        p.x  += p.vx * dt;
-        p.y  += p.vy * dt;
-        p.rotation += p.rotSpeed * dt;
-
-        ++m_activeCount;
-    }
+    // 积分并移除死亡粒子（只遍历存活区间）
+    m_pool.Update(dt);
 }
 
 void ParticleSystem::Render(sakura::core::Renderer& renderer)
 {
     renderer.SetBlendMode(sakura::core::BlendMode::Additive);
-
-    for (const auto& p : m_pool)
-    {
-        if (!p.active) continue;
-
-        float t = 1.0f - (p.life / p.maxLife);   // 0=刚出生, 1=即死
-        sakura::core::Color col = LerpColor(p.colorStart, p.colorEnd, t);
-        float sz = p.size + (p.sizeEnd - p.size) * t;
-
-        if (p.shape == ParticleShape::SakuraMix)
-        {
-            if (p.shapeSeed < kBlossomProbability)
-                DrawSakuraBlossom(renderer, p, sz, col);
-            else
-                DrawSakuraPetal(renderer, p, sz, col);
-        }
-        else
-        {
-            renderer.DrawCircleFilled(p.x, p.y, sz, col, 8);
-        }
-    }
-
+    m_pool.AppendGeometry(renderer.GetGeometryBatch(),
+                          static_cast<float>(renderer.GetScreenWidth()),
+                          static_cast<float>(renderer.GetScreenHeight()));
     renderer.SetBlendMode(sakura::core::BlendMode::Alpha);
 }
 
 void ParticleSystem::Clear()
 {
-    for (auto& p : m_pool)
-        p.active = false;
-    m_activeCount = 0;
+    m_pool.Clear();
 }
 
 } // namespace sakura::effects
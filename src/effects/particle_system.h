@@ -1,13 +1,15 @@
 #pragma once
 
 // particle_system.h — 粒子系统（归一化坐标）
-// 提供通用对象池 + 预设粒子配置，用于命中爆炸、樱花飘落、里程碑特效等。
+// 提供发射器 + 预设粒子配置，用于命中爆炸、樱花飘落、里程碑特效等。
+// 存储与模拟由 ParticlePool（SoA、稠密存活区间、SIMD 积分）负责，
+// 渲染时全部粒子作为一个图元写入 Renderer 的几何批次。
 
 #include "core/renderer.h"
+#include "effects/particle_pool.h"
 
 #include <array>
 #include <cstdint>
-#include <functional>
 
 namespace sakura::effects
 {
@@ -18,30 +20,6 @@ enum class ParticleShape : uint8_t
     SakuraMix
 };
 
-// ============================================================================
-// Particle — 单个粒子的运行时状态（全归一化，相对屏幕比例）
-// ============================================================================
-struct Particle
-{
-    float x         = 0.0f;   // 位置 x（归一化）
-    float y         = 0.0f;   // 位置 y（归一化）
-    float vx        = 0.0f;   // 速度 x（归一化/s）
-    float vy        = 0.0f;   // 速度 y（归一化/s）
-    float ax        = 0.0f;   // 加速度 x（归一化/s²）
-    float ay        = 0.0f;   // 加速度 y（归一化/s²）
-    float size      = 0.01f;  // 半径（归一化，相对短边）
-    float sizeEnd   = 0.005f; // 结束时半径
-    float rotation  = 0.0f;   // 当前旋转角度（度）
-    float rotSpeed  = 0.0f;   // 旋转速度（度/s）
-    float life      = 1.0f;   // 剩余生命（秒）
-    float maxLife   = 1.0f;   // 最大生命（秒）
-    float shapeSeed = 0.0f;   // 形状随机种子（0~1）
-    ParticleShape shape = ParticleShape::Circle;
-    sakura::core::Color colorStart   = sakura::core::Color::White;
-    sakura::core::Color colorEnd     = sakura::core::Color{255, 255, 255, 0};
-    bool  active    = false;
-};
-
 // ============================================================================
 // ParticleConfig — 发射配置（描述一次发射的外观与物理属性）
 // ============================================================================
@@ -124,15 +102,17 @@ struct ContinuousEmitter
 };
 
 // ============================================================================
-// ParticleSystem — 粒子系统主类（对象池）
+// ParticleSystem — 粒子系统主类
 // ============================================================================
 class ParticleSystem
 {
 public:
-    static constexpr int MAX_PARTICLES   = 2000;
-    static constexpr int MAX_EMITTERS    = 16;
+    static constexpr int DEFAULT_CAPACITY = 2000;
+    static constexpr int MAX_PARTICLES    = 50000;   // 单个系统容量上限
+    static constexpr int MAX_EMITTERS     = 16;
 
-    ParticleSystem();
+    // capacity 个粒子的存储在构造时一次性分配（超过 MAX_PARTICLES 时截断）
+    explicit ParticleSystem(int capacity = DEFAULT_CAPACITY);
 
     // ── 发射 ─────────────────────────────────────────────────────────────────
 
@@ -155,23 +135,15 @@ public:
     void Clear();   // 清除所有活跃粒子
 
     // 获取当前活跃粒子数
-    int GetActiveCount() const { return m_activeCount; }
+    int GetActiveCount() const { return static_cast<int>(m_pool.GetCount()); }
+    int GetCapacity() const    { return static_cast<int>(m_pool.GetCapacity()); }
 
 private:
-    std::array<Particle, MAX_PARTICLES>         m_pool;
+    ParticlePool                                m_pool;
     std::array<ContinuousEmitter, MAX_EMITTERS> m_emitters;
-    int m_activeCount = 0;
-
-    // 分配一个空闲粒子槽（返回指针，无槽则 nullptr）
-    Particle* AllocParticle();
-
-    // 用配置初始化一个粒子
-    void InitParticle(Particle& p, float x, float y, const ParticleConfig& cfg);
 
-    // 线性插值颜色
-    static sakura::core::Color LerpColor(const sakura::core::Color& a,
-                                          const sakura::core::Color& b,
-                                          float t);
+    // 按配置随机生成一个粒子并加入池（池满返回 false）
+    bool SpawnParticle(float x, float y, const ParticleConfig& cfg);
 };
 
 } // namespace sakura::effects
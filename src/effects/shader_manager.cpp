@@ -12,15 +12,16 @@ namespace sakura::effects
 // 生命周期
 // ============================================================================
 
-bool ShaderManager::Initialize(SDL_Renderer* renderer, int screenW, int screenH)
+bool ShaderManager::Initialize(sakura::core::Renderer& renderer, int screenW, int screenH)
 {
-    if (!renderer)
+    if (!renderer.GetSDLRenderer())
     {
         LOG_ERROR("ShaderManager::Initialize: renderer 为 nullptr");
         return false;
     }
 
-    m_renderer = renderer;
+    m_owner    = &renderer;
+    m_renderer = renderer.GetSDLRenderer();
 
     // 从 Config 读取效果开关
     auto& cfg = sakura::core::Config::GetInstance();
@@ -65,6 +66,7 @@ void ShaderManager::Shutdown()
         m_offscreen = nullptr;
     }
     m_renderer = nullptr;
+    m_owner    = nullptr;
 }
 
 // ============================================================================
@@ -75,7 +77,7 @@ bool ShaderManager::BeginCapture()
 {
     if (!m_renderer || !m_offscreen) return false;
 
-    if (!SDL_SetRenderTarget(m_renderer, m_offscreen))
+    if (!m_owner->SetRenderTarget(m_offscreen))
     {
         LOG_WARN("ShaderManager::BeginCapture: 设置渲染目标失败 — {}", SDL_GetError());
         return false;
@@ -88,7 +90,7 @@ SDL_Texture* ShaderManager::EndCapture()
     if (!m_renderer) return nullptr;
 
     // 恢复到默认渲染目标（屏幕）
-    SDL_SetRenderTarget(m_renderer, nullptr);
+    m_owner->SetRenderTarget(nullptr);
     return m_offscreen;
 }
 
@@ -127,6 +129,7 @@ void ShaderManager::BlitFull(SDL_Texture* tex,
 void ShaderManager::DrawBlurred(SDL_Texture* tex, float intensity)
 {
     if (!tex || !m_renderer) return;
+    m_owner->Flush();
 
     intensity = std::clamp(intensity, 0.0f, 1.0f);
     float maxOffset = intensity * 12.0f;   // 最大偏移像素
@@ -159,6 +162,7 @@ void ShaderManager::DrawBlurred(SDL_Texture* tex, float intensity)
 void ShaderManager::DrawVignette(float intensity)
 {
     if (!m_renderer) return;
+    m_owner->Flush();
 
     intensity = std::clamp(intensity, 0.0f, 1.0f);
 
@@ -227,6 +231,7 @@ void ShaderManager::DrawVignette(float intensity)
 void ShaderManager::DrawChromaticAberration(SDL_Texture* tex, float intensity)
 {
     if (!tex || !m_renderer) return;
+    m_owner->Flush();
 
     intensity = std::clamp(intensity, 0.0f, 1.0f);
     int ofs = static_cast<int>(intensity * 8.0f);
@@ -263,6 +268,7 @@ void ShaderManager::DrawChromaticAberration(SDL_Texture* tex, float intensity)
 void ShaderManager::DrawColorCorrection(sakura::core::Color tint, float alpha)
 {
     if (!m_renderer) return;
+    m_owner->Flush();
 
     SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
     SDL_SetRenderDrawColor(m_renderer, tint.r, tint.g, tint.b,
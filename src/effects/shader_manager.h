@@ -47,7 +47,8 @@ public:
     // ── 生命周期 ──────────────────────────────────────────────────────────────
 
     // 初始化，获取 SDL_Renderer 指针并创建 offscreen 纹理
-    bool Initialize(SDL_Renderer* renderer, int screenW, int screenH);
+    // 各效果直接调用 SDL 绘制，绘制前先提交 renderer 中已批处理的图元以保持先后顺序
+    bool Initialize(sakura::core::Renderer& renderer, int screenW, int screenH);
 
     // 屏幕尺寸变化时重建 offscreen 纹理
     void OnResize(int newW, int newH);
@@ -95,6 +96,7 @@ public:
 private:
     ShaderManager() = default;
 
+    sakura::core::Renderer* m_owner = nullptr;
     SDL_Renderer* m_renderer  = nullptr;
     SDL_Texture*  m_offscreen = nullptr;   // 全屏 offscreen 缓冲
     int           m_width     = 0;
@@ -3,15 +3,16 @@
 #include "achievement_manager.h"
 
 #include "data/database.h"
-#include "game/chart_loader.h"
+#include "game/chart_library.h"
 #include "utils/logger.h"
 
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <fstream>
-#include <unordered_set>
+#include <limits>
 
 using json = nlohmann::json;
 
@@ -54,6 +55,72 @@ T SafeGet(const json& object, const char* key, T defaultValue)
     return defaultValue;
 }
 
+struct MetricName
+{
+    const char*       name;
+    AchievementMetric metric;
+};
+
+constexpr MetricName kMetricNames[] = {
+    { "play_count",          AchievementMetric::PlayCount         },
+    { "full_combo_count",    AchievementMetric::FullComboCount    },
+    { "all_perfect_count",   AchievementMetric::AllPerfectCount   },
+    { "highest_combo",       AchievementMetric::HighestCombo      },
+    { "highest_accuracy",    AchievementMetric::HighestAccuracy   },
+    { "highest_score",       AchievementMetric::HighestScore      },
+    { "charts_played",       AchievementMetric::ChartsPlayed      },
+    { "difficulties_s_rank", AchievementMetric::DifficultiesSRank },
+};
+
+AchievementMetric ParseMetric(std::string_view name)
+{
+    for (const auto& entry : kMetricNames)
+        if (name == entry.name)
+            return entry.metric;
+    return AchievementMetric::None;
+}
+
+// 没有 "metric" 字段的旧定义按 id 推断
+void InferLegacyMetric(AchievementDefinition& definition)
+{
+    const std::string& id = definition.id;
+    if (id == "first_play" || id.starts_with("play_"))
+        definition.metric = AchievementMetric::PlayCount;
+    else if (id == "first_fc")
+        definition.metric = AchievementMetric::FullComboCount;
+    else if (id == "first_ap")
+        definition.metric = AchievementMetric::AllPerfectCount;
+    else if (id.starts_with("combo_"))
+        definition.metric = AchievementMetric::HighestCombo;
+    else if (id == "accuracy_99")
+        definition.metric = AchievementMetric::HighestAccuracy;
+    else if (id == "score_999k")
+        definition.metric = AchievementMetric::HighestScore;
+    else if (id == "all_charts")
+        definition.metric = AchievementMetric::ChartsPlayed;
+    else if (id == "all_s")
+        definition.metric = AchievementMetric::DifficultiesSRank;
+
+    if (id == "first_play" || id == "first_fc" || id == "first_ap")
+        definition.target = 1;
+    if (id == "all_charts" || id == "all_s")
+        definition.targetIsLibrary = true;
+}
+
+std::string BestKey(const std::string& chartId, const std::string& difficulty)
+{
+    std::string key;
+    key.reserve(chartId.size() + difficulty.size() + 1);
+    key.append(chartId).append(1, '\n').append(difficulty);
+    return key;
+}
+
+long long NowTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 } // namespace
 
 AchievementManager& AchievementManager::GetInstance()
@@ -91,7 +158,23 @@ bool AchievementManager::LoadAchievements(std::string_view path)
             definition.id          = SafeGet<std::string>(item, "id", "");
             definition.title       = SafeGet<std::string>(item, "title", definition.id);
             definition.description = SafeGet<std::string>(item, "description", "");
-            definition.target      = std::max(1, SafeGet<int>(item, "target", 1));
+
+            if (item.contains("target") && item["target"].is_string())
+                definition.targetIsLibrary = item["target"].get<std::string>() == "library";
+            else
+                definition.target = std::max(1, SafeGet<int>(item, "target", 1));
+
+            if (item.contains("metric"))
+            {
+                const std::string metric = SafeGet<std::string>(item, "metric", "");
+                definition.metric = ParseMetric(metric);
+                if (definition.metric == AchievementMetric::None)
+                    LOG_WARN("[AchievementManager] 成就 '{}' 的度量 '{}' 无法识别", definition.id, metric);
+            }
+            else
+            {
+                InferLegacyMetric(definition);
+            }
 
             if (!definition.id.empty())
                 definitions.push_back(std::move(definition));
@@ -107,7 +190,43 @@ bool AchievementManager::LoadAchievements(std::string_view path)
     m_definitions = std::move(definitions);
     m_loadedPath  = std::string(path);
     m_loaded      = true;
+
+    // 先记下失败批次数再读取：读取期间才失败的写入会在下次检查时触发重新加载
+    m_failedBatches = sakura::data::Database::GetInstance().GetFailedBatchCount();
     RefreshUnlockedCache();
+    LoadMetrics();
+
+    for (auto& locked : m_lockedByMetric)
+        locked.clear();
+    for (size_t i = 0; i < m_definitions.size(); ++i)
+    {
+        const auto& definition = m_definitions[i];
+        if (definition.metric != AchievementMetric::None && !m_unlockedAt.contains(definition.id))
+            m_lockedByMetric[static_cast<size_t>(definition.metric)].push_back(i);
+    }
+
+    // 谱面库总量：订阅默认根目录的变更；首次 GetCharts 会触发一次通知（内容无变化时不会）
+    auto& library = ChartLibrary::GetInstance();
+    if (m_libraryListener == 0)
+    {
+        m_libraryListener = library.Subscribe(ChartLibrary::DEFAULT_ROOT, [this](const ChartLibrary::ChartList& charts)
+        {
+            ChartsChangedEvent event;
+            event.chartCount = static_cast<int>(charts.size());
+            for (const auto& chart : charts)
+                event.difficultyCount += static_cast<int>(chart.difficulties.size());
+            OnEvent(event);
+        });
+    }
+
+    const auto charts = library.GetCharts();
+    m_libraryCharts       = static_cast<int>(charts->size());
+    m_libraryDifficulties = 0;
+    for (const auto& chart : *charts)
+        m_libraryDifficulties += static_cast<int>(chart.difficulties.size());
+
+    for (size_t m = 0; m < METRIC_COUNT; ++m)
+        SortLocked(static_cast<AchievementMetric>(m));
 
     LOG_INFO("[AchievementManager] 已加载 {} 个成就定义", m_definitions.size());
     return true;
@@ -115,33 +234,96 @@ bool AchievementManager::LoadAchievements(std::string_view path)
 
 std::vector<AchievementProgress> AchievementManager::CheckAndUnlock(const GameResult& result)
 {
-    if (!m_loaded && !LoadAchievements())
+    // 此前有写入未能落盘（成绩或成就被回滚）时，缓存的度量与解锁状态不再可信，整体重新加载
+    const bool stale = m_loaded
+        && m_failedBatches != sakura::data::Database::GetInstance().GetFailedBatchCount();
+    if (!m_loaded || stale)
+    {
+        // 从数据库加载的度量已包含刚入队的这局，直接复查全部度量
+        if (!(stale ? LoadAchievements(m_loadedPath) : LoadAchievements()))
+            return {};
+
+        std::vector<AchievementMetric> all;
+        for (size_t m = 0; m < METRIC_COUNT; ++m)
+            all.push_back(static_cast<AchievementMetric>(m));
+        return Evaluate(all);
+    }
+
+    return OnEvent(ScoreSavedEvent{ result });
+}
+
+std::vector<AchievementProgress> AchievementManager::OnEvent(const ScoreSavedEvent& event)
+{
+    if (!m_loaded)
         return {};
 
-    (void)result;
-    RefreshUnlockedCache();
+    const GameResult& result = event.result;
+    std::vector<AchievementMetric> changed;
 
-    auto& database = sakura::data::Database::GetInstance();
-    std::vector<AchievementProgress> unlocked;
+    auto raise = [&](AchievementMetric metric, long long value)
+    {
+        long long& current = m_metrics[static_cast<size_t>(metric)];
+        if (value > current)
+        {
+            current = value;
+            changed.push_back(metric);
+        }
+    };
+    auto add = [&](AchievementMetric metric, long long amount)
+    {
+        if (amount == 0)
+            return;
+        m_metrics[static_cast<size_t>(metric)] += amount;
+        changed.push_back(metric);
+    };
 
-    for (const auto& definition : m_definitions)
+    add(AchievementMetric::PlayCount,       1);
+    add(AchievementMetric::FullComboCount,  result.isFullCombo  ? 1 : 0);
+    add(AchievementMetric::AllPerfectCount, result.isAllPerfect ? 1 : 0);
+    raise(AchievementMetric::HighestCombo,    result.maxCombo);
+    raise(AchievementMetric::HighestAccuracy, static_cast<long long>(std::floor(result.accuracy)));
+    raise(AchievementMetric::HighestScore,    result.score);
+
+    // 与 best_scores 相同的替换规则：仅当分数严格更高时替换，同分保留先达成的一局
+    const bool sRank = IsGradeAtLeast(result.grade, Grade::S);
+    auto [it, inserted] = m_bestScores.try_emplace(BestKey(result.chartId, result.difficulty),
+                                                   BestEntry{ result.score, sRank });
+    if (inserted)
     {
-        if (m_unlockedAt.contains(definition.id))
-            continue;
+        add(AchievementMetric::DifficultiesSRank, sRank ? 1 : 0);
+        if (m_playedCharts.insert(result.chartId).second)
+            add(AchievementMetric::ChartsPlayed, 1);
+    }
+    else if (result.score > it->second.score)
+    {
+        add(AchievementMetric::DifficultiesSRank, (sRank ? 1 : 0) - (it->second.sRank ? 1 : 0));
+        it->second = BestEntry{ result.score, sRank };
+    }
+
+    return Evaluate(changed);
+}
 
-        AchievementProgress progress = BuildProgress(definition);
-        if (!progress.unlocked && progress.current >= progress.target)
+std::vector<AchievementProgress> AchievementManager::OnEvent(const ChartsChangedEvent& event)
+{
+    if (!m_loaded)
+        return {};
+
+    m_libraryCharts       = event.chartCount;
+    m_libraryDifficulties = event.difficultyCount;
+
+    std::vector<AchievementMetric> changed;
+    for (size_t m = 0; m < METRIC_COUNT; ++m)
+    {
+        const auto metric = static_cast<AchievementMetric>(m);
+        const auto& locked = m_lockedByMetric[m];
+        if (std::any_of(locked.begin(), locked.end(),
+                [&](size_t index) { return m_definitions[index].targetIsLibrary; }))
         {
-            if (database.SaveAchievement(definition.id))
-            {
-                RefreshUnlockedCache();
-                progress = BuildProgress(definition);
-                unlocked.push_back(std::move(progress));
-            }
+            SortLocked(metric);
+            changed.push_back(metric);
         }
     }
-
-    return unlocked;
+    return Evaluate(changed);
 }
 
 std::vector<AchievementProgress> AchievementManager::GetAll() const
@@ -160,9 +342,8 @@ std::vector<AchievementProgress> AchievementManager::GetUnlocked() const
     std::vector<AchievementProgress> progress;
     for (const auto& definition : m_definitions)
     {
-        auto item = BuildProgress(definition);
-        if (item.unlocked)
-            progress.push_back(std::move(item));
+        if (m_unlockedAt.contains(definition.id))
+            progress.push_back(BuildProgress(definition));
     }
     return progress;
 }
@@ -178,11 +359,64 @@ std::optional<AchievementProgress> AchievementManager::GetProgress(std::string_v
     return BuildProgress(*it);
 }
 
+std::vector<AchievementProgress> AchievementManager::Evaluate(const std::vector<AchievementMetric>& metrics)
+{
+    std::vector<AchievementProgress> unlocked;
+
+    auto& database = sakura::data::Database::GetInstance();
+    if (!database.IsOpen())
+        return unlocked;
+
+    for (const AchievementMetric metric : metrics)
+    {
+        auto& locked = m_lockedByMetric[static_cast<size_t>(metric)];
+        const long long value = Metric(metric);
+
+        // 按阈值升序，只需检查到第一个未达成的
+        size_t reached = 0;
+        while (reached < locked.size() && value >= EffectiveTarget(m_definitions[locked[reached]]))
+            ++reached;
+
+        for (size_t k = 0; k < reached; ++k)
+        {
+            const auto& definition = m_definitions[locked[k]];
+
+            // 写入由数据库线程提交，之后的读取已能看到这条解锁记录
+            database.SaveAchievement(definition.id);
+            m_unlockedAt.emplace(definition.id, NowTimestamp());
+            unlocked.push_back(BuildProgress(definition));
+        }
+        locked.erase(locked.begin(), locked.begin() + static_cast<std::ptrdiff_t>(reached));
+    }
+
+    return unlocked;
+}
+
+void AchievementManager::SortLocked(AchievementMetric metric)
+{
+    auto& locked = m_lockedByMetric[static_cast<size_t>(metric)];
+    std::stable_sort(locked.begin(), locked.end(), [this](size_t a, size_t b)
+    {
+        return EffectiveTarget(m_definitions[a]) < EffectiveTarget(m_definitions[b]);
+    });
+}
+
+int AchievementManager::EffectiveTarget(const AchievementDefinition& definition) const
+{
+    if (!definition.targetIsLibrary)
+        return definition.target;
+
+    const int total = definition.metric == AchievementMetric::ChartsPlayed
+        ? m_libraryCharts
+        : m_libraryDifficulties;
+    return std::max(1, total);
+}
+
 AchievementProgress AchievementManager::BuildProgress(const AchievementDefinition& definition) const
 {
     AchievementProgress progress;
     progress.definition = definition;
-    progress.target     = definition.target;
+    progress.target     = EffectiveTarget(definition);
 
     auto unlockedIt = m_unlockedAt.find(definition.id);
     if (unlockedIt != m_unlockedAt.end())
@@ -191,51 +425,8 @@ AchievementProgress AchievementManager::BuildProgress(const AchievementDefinitio
         progress.unlockedAt = unlockedIt->second;
     }
 
-    const auto& database = sakura::data::Database::GetInstance();
-    const auto bestScores = database.GetAllBestScores();
-
-    if (definition.id == "first_play")
-    {
-        progress.current = static_cast<int>(database.GetTotalPlayCount() > 0 ? 1 : 0);
-    }
-    else if (definition.id == "first_fc")
-    {
-        progress.current = database.HasAnyFullCombo() ? 1 : 0;
-    }
-    else if (definition.id == "first_ap")
-    {
-        progress.current = database.HasAnyAllPerfect() ? 1 : 0;
-    }
-    else if (definition.id == "combo_100" || definition.id == "combo_500" || definition.id == "combo_1000")
-    {
-        progress.current = database.GetHighestCombo();
-    }
-    else if (definition.id == "play_10" || definition.id == "play_50" || definition.id == "play_100")
-    {
-        progress.current = static_cast<int>(database.GetTotalPlayCount());
-    }
-    else if (definition.id == "all_charts")
-    {
-        std::unordered_set<std::string> playedCharts;
-        for (const auto& score : bestScores)
-            playedCharts.insert(score.chartId);
-        progress.current = static_cast<int>(playedCharts.size());
-        progress.target  = std::max(1, CountTotalChartFolders());
-    }
-    else if (definition.id == "all_s")
-    {
-        progress.current = static_cast<int>(std::count_if(bestScores.begin(), bestScores.end(),
-            [](const GameResult& score) { return IsGradeAtLeast(score.grade, Grade::S); }));
-        progress.target  = std::max(1, CountTotalChartDifficulties());
-    }
-    else if (definition.id == "accuracy_99")
-    {
-        progress.current = static_cast<int>(std::floor(database.GetHighestAccuracy()));
-    }
-    else if (definition.id == "score_999k")
-    {
-        progress.current = database.GetHighestScore();
-    }
+    if (definition.metric != AchievementMetric::None)
+        progress.current = static_cast<int>(std::min<long long>(Metric(definition.metric), std::numeric_limits<int>::max()));
 
     if (progress.unlocked)
         progress.current = std::max(progress.current, progress.target);
@@ -247,6 +438,35 @@ AchievementProgress AchievementManager::BuildProgress(const AchievementDefinitio
     return progress;
 }
 
+void AchievementManager::LoadMetrics()
+{
+    auto&      database = sakura::data::Database::GetInstance();
+    const auto snapshot = database.GetStatsSnapshot();
+
+    m_metrics.fill(0);
+    m_metrics[static_cast<size_t>(AchievementMetric::PlayCount)]       = snapshot.playCount;
+    m_metrics[static_cast<size_t>(AchievementMetric::FullComboCount)]  = snapshot.fullComboCount;
+    m_metrics[static_cast<size_t>(AchievementMetric::AllPerfectCount)] = snapshot.allPerfectCount;
+    m_metrics[static_cast<size_t>(AchievementMetric::HighestCombo)]    = snapshot.highestCombo;
+    m_metrics[static_cast<size_t>(AchievementMetric::HighestAccuracy)] =
+        static_cast<long long>(std::floor(snapshot.highestAccuracy));
+    m_metrics[static_cast<size_t>(AchievementMetric::HighestScore)]    = snapshot.highestScore;
+
+    m_bestScores.clear();
+    m_playedCharts.clear();
+    long long sRankCount = 0;
+    for (const auto& score : database.GetAllBestScores())
+    {
+        const bool sRank = IsGradeAtLeast(score.grade, Grade::S);
+        m_bestScores[BestKey(score.chartId, score.difficulty)] = BestEntry{ score.score, sRank };
+        m_playedCharts.insert(score.chartId);
+        sRankCount += sRank ? 1 : 0;
+    }
+    m_metrics[static_cast<size_t>(AchievementMetric::ChartsPlayed)]      =
+        static_cast<long long>(m_playedCharts.size());
+    m_metrics[static_cast<size_t>(AchievementMetric::DifficultiesSRank)] = sRankCount;
+}
+
 void AchievementManager::RefreshUnlockedCache()
 {
     m_unlockedAt.clear();
@@ -254,19 +474,4 @@ void AchievementManager::RefreshUnlockedCache()
         m_unlockedAt.emplace(record.id, record.unlockedAt);
 }
 
-int AchievementManager::CountTotalChartFolders() const
-{
-    ChartLoader loader;
-    return static_cast<int>(loader.ScanCharts("resources/charts").size());
-}
-
-int AchievementManager::CountTotalChartDifficulties() const
-{
-    ChartLoader loader;
-    int total = 0;
-    for (const auto& chart : loader.ScanCharts("resources/charts"))
-        total += static_cast<int>(chart.difficulties.size());
-    return total;
-}
-
-} // namespace sakura::game
\ No newline at end of file
+} // namespace sakura::game
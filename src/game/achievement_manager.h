@@ -1,24 +1,50 @@
 #pragma once
 
 // achievement_manager.h — 成就系统管理器
+//
+// achievements.json 中的每条成就编译为（度量, 阈值）；同一度量下未解锁的成就按阈值升序排列。
+// 度量的当前值常驻内存：LoadAchievements 时从数据库的 player_aggregates 与 best_scores
+// 读取一次，之后只由事件（成绩保存 / 谱面库变化）增量更新，并且只复查数值变化了的度量。
 
 #include "chart.h"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace sakura::game
 {
 
+// 成就条件所依据的度量（achievements.json 的 "metric" 字段）
+enum class AchievementMetric : uint8_t
+{
+    None,               // 未识别：永不解锁
+    PlayCount,          // "play_count"          累计游玩次数
+    FullComboCount,     // "full_combo_count"    Full Combo 局数
+    AllPerfectCount,    // "all_perfect_count"   All Perfect 局数
+    HighestCombo,       // "highest_combo"       单局最高连击
+    HighestAccuracy,    // "highest_accuracy"    单局最高准确率（向下取整的百分数）
+    HighestScore,       // "highest_score"       单局最高分
+    ChartsPlayed,       // "charts_played"       有成绩的谱面数
+    DifficultiesSRank,  // "difficulties_s_rank" 最高分评级达到 S 及以上的谱面难度数
+    Count
+};
+
 struct AchievementDefinition
 {
-    std::string id;
-    std::string title;
-    std::string description;
-    int         target = 1;
+    std::string       id;
+    std::string       title;
+    std::string       description;
+    int               target = 1;
+    AchievementMetric metric = AchievementMetric::None;
+    // "target": "library" — 阈值取谱面库总量（charts_played 为谱面数，其余为难度数）
+    bool              targetIsLibrary = false;
 };
 
 struct AchievementProgress
@@ -31,30 +57,79 @@ struct AchievementProgress
     float                 progress   = 0.0f;
 };
 
+// ── 事件 ──────────────────────────────────────────────────────────────────────
+
+// 一局成绩已交给 Database::SaveScore
+struct ScoreSavedEvent
+{
+    const GameResult& result;
+};
+
+// 默认谱面根目录的内容发生变化（ChartLibrary 变更通知）
+struct ChartsChangedEvent
+{
+    int chartCount      = 0;
+    int difficultyCount = 0;
+};
+
 class AchievementManager
 {
 public:
     static AchievementManager& GetInstance();
 
+    // 加载定义并从数据库重建度量（切换数据库后需重新调用）
     bool LoadAchievements(std::string_view path = "config/achievements.json");
+
+    // 成绩入库后调用：派发 ScoreSavedEvent，返回本次新解锁的成就。
+    // 数据库有写入失败（Database::GetFailedBatchCount 变化）时改为从数据库重新加载后复查
     std::vector<AchievementProgress> CheckAndUnlock(const GameResult& result);
 
+    // 事件入口：更新度量并复查变化了的度量，返回新解锁的成就
+    std::vector<AchievementProgress> OnEvent(const ScoreSavedEvent& event);
+    std::vector<AchievementProgress> OnEvent(const ChartsChangedEvent& event);
+
     std::vector<AchievementProgress> GetAll() const;
     std::vector<AchievementProgress> GetUnlocked() const;
     std::optional<AchievementProgress> GetProgress(std::string_view id) const;
 
 private:
+    static constexpr size_t METRIC_COUNT = static_cast<size_t>(AchievementMetric::Count);
+
     AchievementManager() = default;
 
+    // best_scores 的内存镜像：每个 (chart_id, difficulty) 的最高分及其评级是否达到 S
+    struct BestEntry
+    {
+        int  score = 0;
+        bool sRank = false;
+    };
+
+    void LoadMetrics();
+    void RefreshUnlockedCache();
+    void SortLocked(AchievementMetric metric);
+
+    long long Metric(AchievementMetric metric) const { return m_metrics[static_cast<size_t>(metric)]; }
+    int       EffectiveTarget(const AchievementDefinition& definition) const;
+
+    // 复查给定度量下的未解锁成就，达到阈值的写入数据库并返回
+    std::vector<AchievementProgress> Evaluate(const std::vector<AchievementMetric>& metrics);
+
     AchievementProgress BuildProgress(const AchievementDefinition& definition) const;
-    void                RefreshUnlockedCache();
-    int                 CountTotalChartFolders() const;
-    int                 CountTotalChartDifficulties() const;
-
-    std::vector<AchievementDefinition>         m_definitions;
-    std::unordered_map<std::string, long long> m_unlockedAt;
-    std::string                                m_loadedPath;
-    bool                                       m_loaded = false;
+
+    std::vector<AchievementDefinition>               m_definitions;
+    std::array<std::vector<size_t>, METRIC_COUNT>    m_lockedByMetric;  // m_definitions 下标
+    std::unordered_map<std::string, long long>       m_unlockedAt;
+
+    std::array<long long, METRIC_COUNT>              m_metrics{};
+    std::unordered_map<std::string, BestEntry>       m_bestScores;      // 键：chartId + '\n' + difficulty
+    std::unordered_set<std::string>                  m_playedCharts;
+    int                                              m_libraryCharts       = 0;
+    int                                              m_libraryDifficulties = 0;
+    uint32_t                                         m_libraryListener     = 0;
+    long long                                        m_failedBatches       = 0;  // 加载时的 Database 失败批次数
+
+    std::string                                      m_loadedPath;
+    bool                                             m_loaded = false;
 };
 
-} // namespace sakura::game
\ No newline at end of file
+} // namespace sakura::game
@@ -0,0 +1,379 @@
+// chart_binary.cpp — 预编译谱面格式（.skc）实现
+
+#include "chart_binary.h"
+#include "utils/logger.h"
+#include "utils/mapped_file.h"
+
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace sakura::game
+{
+
+static_assert(std::endian::native == std::endian::little,
+              ".skc 以小端定长记录存储，当前仅支持小端平台");
+
+namespace
+{
+
+constexpr char SKC_MAGIC[4] = { 'S', 'K', 'C', '\0' };
+
+// ── 磁盘记录（定长、无指针，可直接 memcpy）─────────────────────────────────
+
+struct SkcHeader
+{
+    char     magic[4];
+    uint32_t formatVersion;
+    int32_t  chartVersion;
+    uint32_t reserved;
+    int64_t  sourceMtime;
+    uint64_t sourceSize;
+    uint64_t sourceHash;
+    uint32_t timingCount;
+    uint32_t svCount;
+    uint32_t keyboardCount;
+    uint32_t mouseCount;
+    uint32_t pathPointCount;
+    uint32_t stringBytes;
+};
+static_assert(sizeof(SkcHeader) == 64);
+
+struct SkcTimingPoint
+{
+    int32_t time;
+    float   bpm;
+    int32_t numerator;
+    int32_t denominator;
+};
+static_assert(sizeof(SkcTimingPoint) == 16);
+
+struct SkcSVPoint
+{
+    int32_t  time;
+    float    speed;
+    uint32_t easingOffset;   // 字符串池偏移
+    uint32_t easingLength;
+};
+static_assert(sizeof(SkcSVPoint) == 16);
+
+struct SkcKeyboardNote
+{
+    int32_t time;
+    int32_t lane;
+    int32_t type;
+    int32_t duration;
+};
+static_assert(sizeof(SkcKeyboardNote) == 16);
+
+struct SkcMouseNote
+{
+    int32_t  time;
+    float    x;
+    float    y;
+    int32_t  type;
+    int32_t  sliderDuration;
+    uint32_t pathOffset;     // 路径点池中的起始索引
+    uint32_t pathCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(SkcMouseNote) == 32);
+
+struct SkcPathPoint
+{
+    float x;
+    float y;
+};
+static_assert(sizeof(SkcPathPoint) == 8);
+
+template<typename T>
+void AppendRecord(std::vector<uint8_t>& buffer, const T& record)
+{
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&record);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T ReadRecord(const uint8_t* src)
+{
+    T record;
+    std::memcpy(&record, src, sizeof(T));
+    return record;
+}
+
+bool IsValidNoteType(int32_t type)
+{
+    return type >= static_cast<int32_t>(NoteType::Tap)
+        && type <= static_cast<int32_t>(NoteType::Slider);
+}
+
+bool ParseHeader(const uint8_t* data, size_t size, SkcHeader& header)
+{
+    if (size < sizeof(SkcHeader)) return false;
+    header = ReadRecord<SkcHeader>(data);
+    if (std::memcmp(header.magic, SKC_MAGIC, sizeof(SKC_MAGIC)) != 0) return false;
+    if (header.formatVersion != ChartBinary::FORMAT_VERSION) return false;
+    return true;
+}
+
+// 头部声明的各段总长度必须与文件大小完全一致（防截断 / 写入中途崩溃）
+uint64_t ExpectedFileSize(const SkcHeader& header)
+{
+    return sizeof(SkcHeader)
+         + uint64_t{ header.timingCount }    * sizeof(SkcTimingPoint)
+         + uint64_t{ header.svCount }        * sizeof(SkcSVPoint)
+         + uint64_t{ header.keyboardCount }  * sizeof(SkcKeyboardNote)
+         + uint64_t{ header.mouseCount }     * sizeof(SkcMouseNote)
+         + uint64_t{ header.pathPointCount } * sizeof(SkcPathPoint)
+         + uint64_t{ header.stringBytes };
+}
+
+} // namespace
+
+// ── 路径 / 指纹 ───────────────────────────────────────────────────────────────
+
+std::string ChartBinary::GetCachePath(const std::string& chartJsonPath)
+{
+    fs::path path(chartJsonPath);
+    path.replace_extension(".skc");
+    return path.string();
+}
+
+uint64_t ChartBinary::HashBytes(std::string_view bytes)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : bytes)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::optional<ChartSourceStamp> ChartBinary::StatSource(const std::string& chartJsonPath)
+{
+    std::error_code ec;
+    const auto size  = fs::file_size(chartJsonPath, ec);
+    if (ec) return std::nullopt;
+    const auto mtime = fs::last_write_time(chartJsonPath, ec);
+    if (ec) return std::nullopt;
+
+    ChartSourceStamp stamp;
+    stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    stamp.size  = static_cast<uint64_t>(size);
+    return stamp;
+}
+
+std::optional<ChartSourceStamp> ChartBinary::ReadStamp(const std::string& skcPath)
+{
+    std::ifstream file(skcPath, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    uint8_t raw[sizeof(SkcHeader)];
+    if (!file.read(reinterpret_cast<char*>(raw), sizeof(raw))) return std::nullopt;
+
+    SkcHeader header;
+    if (!ParseHeader(raw, sizeof(raw), header)) return std::nullopt;
+
+    ChartSourceStamp stamp;
+    stamp.mtime = header.sourceMtime;
+    stamp.size  = header.sourceSize;
+    stamp.hash  = header.sourceHash;
+    return stamp;
+}
+
+// ── Read ──────────────────────────────────────────────────────────────────────
+
+std::optional<ChartData> ChartBinary::Read(const std::string& skcPath)
+{
+    sakura::utils::MappedFile mapped;
+    if (!mapped.Open(skcPath)) return std::nullopt;
+
+    const uint8_t* data = mapped.Data();
+    const size_t   size = mapped.Size();
+
+    SkcHeader header;
+    if (!ParseHeader(data, size, header)) return std::nullopt;
+    if (ExpectedFileSize(header) != size)
+    {
+        LOG_WARN("谱面缓存大小不符，视为损坏: {}", skcPath);
+        return std::nullopt;
+    }
+
+    const uint8_t* cursor     = data + sizeof(SkcHeader);
+    const uint8_t* timingSec  = cursor;
+    const uint8_t* svSec      = timingSec + header.timingCount   * sizeof(SkcTimingPoint);
+    const uint8_t* kbSec      = svSec     + header.svCount       * sizeof(SkcSVPoint);
+    const uint8_t* mouseSec   = kbSec     + header.keyboardCount * sizeof(SkcKeyboardNote);
+    const uint8_t* pathSec    = mouseSec  + header.mouseCount    * sizeof(SkcMouseNote);
+    const char*    stringPool = reinterpret_cast<const char*>(pathSec + header.pathPointCount * sizeof(SkcPathPoint));
+
+    ChartData chart;
+    chart.version = header.chartVersion;
+
+    chart.timingPoints.resize(header.timingCount);
+    for (uint32_t i = 0; i < header.timingCount; ++i)
+    {
+        const auto rec = ReadRecord<SkcTimingPoint>(timingSec + i * sizeof(SkcTimingPoint));
+        auto& tp = chart.timingPoints[i];
+        tp.time               = rec.time;
+        tp.bpm                = rec.bpm;
+        tp.timeSigNumerator   = rec.numerator;
+        tp.timeSigDenominator = rec.denominator;
+    }
+
+    chart.svPoints.resize(header.svCount);
+    for (uint32_t i = 0; i < header.svCount; ++i)
+    {
+        const auto rec = ReadRecord<SkcSVPoint>(svSec + i * sizeof(SkcSVPoint));
+        if (uint64_t{ rec.easingOffset } + rec.easingLength > header.stringBytes)
+            return std::nullopt;
+        auto& sv = chart.svPoints[i];
+        sv.time   = rec.time;
+        sv.speed  = rec.speed;
+        sv.easing.assign(stringPool + rec.easingOffset, rec.easingLength);
+    }
+
+    chart.keyboardNotes.resize(header.keyboardCount);
+    for (uint32_t i = 0; i < header.keyboardCount; ++i)
+    {
+        const auto rec = ReadRecord<SkcKeyboardNote>(kbSec + i * sizeof(SkcKeyboardNote));
+        if (!IsValidNoteType(rec.type)) return std::nullopt;
+        auto& note = chart.keyboardNotes[i];
+        note.time     = rec.time;
+        note.lane     = rec.lane;
+        note.type     = static_cast<NoteType>(rec.type);
+        note.duration = rec.duration;
+    }
+
+    chart.mouseNotes.resize(header.mouseCount);
+    for (uint32_t i = 0; i < header.mouseCount; ++i)
+    {
+        const auto rec = ReadRecord<SkcMouseNote>(mouseSec + i * sizeof(SkcMouseNote));
+        if (!IsValidNoteType(rec.type)) return std::nullopt;
+        if (uint64_t{ rec.pathOffset } + rec.pathCount > header.pathPointCount)
+            return std::nullopt;
+
+        auto& note = chart.mouseNotes[i];
+        note.time           = rec.time;
+        note.x              = rec.x;
+        note.y              = rec.y;
+        note.type           = static_cast<NoteType>(rec.type);
+        note.sliderDuration = rec.sliderDuration;
+        note.sliderPath.reserve(rec.pathCount);
+        for (uint32_t p = 0; p < rec.pathCount; ++p)
+        {
+            const auto pt = ReadRecord<SkcPathPoint>(
+                pathSec + (uint64_t{ rec.pathOffset } + p) * sizeof(SkcPathPoint));
+            note.sliderPath.emplace_back(pt.x, pt.y);
+        }
+    }
+
+    return chart;
+}
+
+// ── Write ─────────────────────────────────────────────────────────────────────
+
+bool ChartBinary::Write(const std::string& skcPath, const ChartData& data, const ChartSourceStamp& stamp)
+{
+    // 字符串池（easing 名称去重）
+    std::string stringPool;
+    std::unordered_map<std::string, uint32_t> stringOffsets;
+    auto internString = [&](const std::string& s) -> uint32_t
+    {
+        auto [it, inserted] = stringOffsets.try_emplace(s, static_cast<uint32_t>(stringPool.size()));
+        if (inserted) stringPool += s;
+        return it->second;
+    };
+
+    size_t pathPointCount = 0;
+    for (const auto& note : data.mouseNotes)
+        pathPointCount += note.sliderPath.size();
+
+    SkcHeader header{};
+    std::memcpy(header.magic, SKC_MAGIC, sizeof(SKC_MAGIC));
+    header.formatVersion  = FORMAT_VERSION;
+    header.chartVersion   = data.version;
+    header.sourceMtime    = stamp.mtime;
+    header.sourceSize     = stamp.size;
+    header.sourceHash     = stamp.hash;
+    header.timingCount    = static_cast<uint32_t>(data.timingPoints.size());
+    header.svCount        = static_cast<uint32_t>(data.svPoints.size());
+    header.keyboardCount  = static_cast<uint32_t>(data.keyboardNotes.size());
+    header.mouseCount     = static_cast<uint32_t>(data.mouseNotes.size());
+    header.pathPointCount = static_cast<uint32_t>(pathPointCount);
+
+    std::vector<uint8_t> body;
+    body.reserve(header.timingCount * sizeof(SkcTimingPoint)
+               + header.svCount * sizeof(SkcSVPoint)
+               + header.keyboardCount * sizeof(SkcKeyboardNote)
+               + header.mouseCount * sizeof(SkcMouseNote)
+               + pathPointCount * sizeof(SkcPathPoint));
+
+    for (const auto& tp : data.timingPoints)
+        AppendRecord(body, SkcTimingPoint{ tp.time, tp.bpm, tp.timeSigNumerator, tp.timeSigDenominator });
+
+    for (const auto& sv : data.svPoints)
+    {
+        const uint32_t offset = internString(sv.easing);
+        AppendRecord(body, SkcSVPoint{ sv.time, sv.speed, offset, static_cast<uint32_t>(sv.easing.size()) });
+    }
+
+    for (const auto& note : data.keyboardNotes)
+        AppendRecord(body, SkcKeyboardNote{ note.time, note.lane, static_cast<int32_t>(note.type), note.duration });
+
+    uint32_t pathOffset = 0;
+    for (const auto& note : data.mouseNotes)
+    {
+        const auto count = static_cast<uint32_t>(note.sliderPath.size());
+        AppendRecord(body, SkcMouseNote{ note.time, note.x, note.y, static_cast<int32_t>(note.type),
+                                         note.sliderDuration, pathOffset, count, 0 });
+        pathOffset += count;
+    }
+
+    for (const auto& note : data.mouseNotes)
+        for (const auto& [px, py] : note.sliderPath)
+            AppendRecord(body, SkcPathPoint{ px, py });
+
+    header.stringBytes = static_cast<uint32_t>(stringPool.size());
+
+    // 先写临时文件再替换，避免并发读取到写了一半的缓存
+    const std::string tmpPath = skcPath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARN("无法写入谱面缓存: {}", tmpPath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+        file.write(stringPool.data(), static_cast<std::streamsize>(stringPool.size()));
+        if (!file)
+        {
+            LOG_WARN("写入谱面缓存失败: {}", tmpPath);
+            file.close();
+            std::error_code ec;
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, skcPath, ec);
+    if (ec)
+    {
+        LOG_WARN("替换谱面缓存失败 [{}]: {}", skcPath, ec.message());
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace sakura::game
@@ -0,0 +1,59 @@
+#pragma once
+
+// chart_binary.h — 预编译谱面格式（.skc）
+// 将 {difficulty}.json 解析、排序后的 ChartData 以定长记录写入旁路缓存文件，
+// 加载时 mmap 后直接构建 ChartData，跳过 JSON 解析与排序。
+//
+// 文件布局（小端）：
+//   SkcHeader（64 字节）
+//   TimingPoint 记录 × timingCount
+//   SVPoint     记录 × svCount
+//   KeyboardNote 记录 × keyboardCount
+//   MouseNote   记录 × mouseCount
+//   Slider 路径点 × pathPointCount
+//   字符串池（SV easing 名称）
+
+#include "chart.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sakura::game
+{
+
+// 源 JSON 文件指纹：mtime + size 用于快速比对，hash 用于 mtime 变化但内容未变时复用缓存
+struct ChartSourceStamp
+{
+    int64_t  mtime = 0;     // std::filesystem::last_write_time 的原始计数
+    uint64_t size  = 0;     // 文件字节数
+    uint64_t hash  = 0;     // FNV-1a 64 内容哈希
+};
+
+class ChartBinary
+{
+public:
+    // 格式版本：记录布局变化时递增，旧缓存会被自动重建
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // 谱面 JSON 对应的缓存路径（同目录、同名、扩展名 .skc）
+    static std::string GetCachePath(const std::string& chartJsonPath);
+
+    // FNV-1a 64 内容哈希
+    static uint64_t HashBytes(std::string_view bytes);
+
+    // 读取源文件的 mtime/size（不计算 hash）；文件不存在返回 nullopt
+    static std::optional<ChartSourceStamp> StatSource(const std::string& chartJsonPath);
+
+    // 读取缓存头部中的源指纹；文件缺失、损坏或版本不符返回 nullopt
+    static std::optional<ChartSourceStamp> ReadStamp(const std::string& skcPath);
+
+    // mmap 读取缓存并构建 ChartData；校验失败返回 nullopt
+    static std::optional<ChartData> Read(const std::string& skcPath);
+
+    // 写入缓存（先写临时文件再原子替换），失败时返回 false 并 LOG_WARN
+    static bool Write(const std::string& skcPath, const ChartData& data, const ChartSourceStamp& stamp);
+};
+
+} // namespace sakura::game
@@ -0,0 +1,641 @@
+// chart_json_stream.cpp — 谱面数据 JSON 流式解析实现
+
+#include "chart_json_stream.h"
+#include "utils/logger.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace sakura::game
+{
+
+namespace
+{
+
+// ── 解析上下文 ────────────────────────────────────────────────────────────────
+
+// 容器栈帧类型
+enum class Frame : uint8_t
+{
+    Root,           // 顶层对象
+    Section,        // timing_points / sv_points / keyboard_notes / mouse_notes 数组
+    Element,        // 上述数组中的单个对象
+    TimeSignature,  // "time_signature": [n, d]
+    SliderPath,     // "slider_path": [[x, y], ...]
+    SliderPoint,    // slider_path 中的单个 [x, y]
+    Skip            // 需要忽略的子树
+};
+
+enum class Section : uint8_t
+{
+    None,
+    Version,        // 顶层 "version"（非数组字段）
+    TimingPoints,
+    SvPoints,
+    KeyboardNotes,
+    MouseNotes
+};
+
+enum class Field : uint8_t
+{
+    None,
+    Time,
+    Bpm,
+    Numerator,
+    Denominator,
+    TimeSignature,
+    Speed,
+    Easing,
+    Lane,
+    Type,
+    Duration,
+    X,
+    Y,
+    SliderDuration,
+    SliderPath
+};
+
+Section RootKeyToSection(const std::string& key)
+{
+    if (key == "version")        return Section::Version;
+    if (key == "timing_points")  return Section::TimingPoints;
+    if (key == "sv_points")      return Section::SvPoints;
+    if (key == "keyboard_notes") return Section::KeyboardNotes;
+    if (key == "mouse_notes")    return Section::MouseNotes;
+    return Section::None;
+}
+
+Field ElementKeyToField(Section section, const std::string& key)
+{
+    if (key == "time") return Field::Time;
+
+    switch (section)
+    {
+    case Section::TimingPoints:
+        if (key == "bpm")            return Field::Bpm;
+        if (key == "time_signature") return Field::TimeSignature;
+        if (key == "numerator")      return Field::Numerator;
+        if (key == "denominator")    return Field::Denominator;
+        break;
+    case Section::SvPoints:
+        if (key == "speed")  return Field::Speed;
+        if (key == "easing") return Field::Easing;
+        break;
+    case Section::KeyboardNotes:
+        if (key == "lane")     return Field::Lane;
+        if (key == "type")     return Field::Type;
+        if (key == "duration") return Field::Duration;
+        break;
+    case Section::MouseNotes:
+        if (key == "x")               return Field::X;
+        if (key == "y")               return Field::Y;
+        if (key == "type")            return Field::Type;
+        if (key == "slider_duration") return Field::SliderDuration;
+        if (key == "slider_path")     return Field::SliderPath;
+        break;
+    default:
+        break;
+    }
+    return Field::None;
+}
+
+const char* FieldName(Field field)
+{
+    switch (field)
+    {
+    case Field::Time:           return "time";
+    case Field::Bpm:            return "bpm";
+    case Field::Numerator:      return "numerator";
+    case Field::Denominator:    return "denominator";
+    case Field::TimeSignature:  return "time_signature";
+    case Field::Speed:          return "speed";
+    case Field::Easing:         return "easing";
+    case Field::Lane:           return "lane";
+    case Field::Type:           return "type";
+    case Field::Duration:       return "duration";
+    case Field::X:              return "x";
+    case Field::Y:              return "y";
+    case Field::SliderDuration: return "slider_duration";
+    case Field::SliderPath:     return "slider_path";
+    default:                    return "";
+    }
+}
+
+// 单个 SAX 标量事件（或以 Container 表示的对象/数组值）
+struct Scalar
+{
+    enum class Kind : uint8_t { Null, Number, String, Container };
+
+    Kind               kind   = Kind::Null;
+    double             number = 0.0;
+    const std::string* text   = nullptr;
+};
+
+// ── SAX 处理器 ────────────────────────────────────────────────────────────────
+
+class ChartSaxHandler
+{
+public:
+    explicit ChartSaxHandler(const std::string& sourcePath)
+        : m_sourcePath(sourcePath)
+    {
+        m_stack.reserve(8);
+    }
+
+    ChartData&       Data()       { return m_data; }
+    const std::string& ErrorMessage() const { return m_error; }
+
+    // 各数组是否已按 time 升序（非严格）
+    bool TimingSorted()   const { return m_timingOrder.sorted; }
+    bool SvSorted()       const { return m_svOrder.sorted; }
+    bool KeyboardSorted() const { return m_keyboardOrder.sorted; }
+    bool MouseSorted()    const { return m_mouseOrder.sorted; }
+
+    // ── nlohmann SAX 接口 ────────────────────────────────────────────────────
+
+    bool null()                                        { OnScalar({ Scalar::Kind::Null }); return true; }
+    bool boolean(bool val)                             { OnScalar({ Scalar::Kind::Number, val ? 1.0 : 0.0 }); return true; }
+    bool number_integer(json::number_integer_t val)    { OnScalar({ Scalar::Kind::Number, static_cast<double>(val) }); return true; }
+    bool number_unsigned(json::number_unsigned_t val)  { OnScalar({ Scalar::Kind::Number, static_cast<double>(val) }); return true; }
+    bool number_float(json::number_float_t val, const json::string_t&) { OnScalar({ Scalar::Kind::Number, val }); return true; }
+    bool string(json::string_t& val)                   { OnScalar({ Scalar::Kind::String, 0.0, &val }); return true; }
+    bool binary(json::binary_t&)                       { OnScalar({ Scalar::Kind::Container }); return true; }
+
+    bool start_object(std::size_t)
+    {
+        if (m_stack.empty())
+        {
+            m_stack.push_back(Frame::Root);
+            return true;
+        }
+
+        switch (m_stack.back())
+        {
+        case Frame::Root:
+            OnRootValue(Scalar{ Scalar::Kind::Container });
+            break;
+        case Frame::Section:
+            BeginElement();
+            m_stack.push_back(Frame::Element);
+            return true;
+        case Frame::Element:
+            AssignField(Scalar{ Scalar::Kind::Container });
+            break;
+        case Frame::TimeSignature:
+            PushTimeSignatureValue(Scalar{ Scalar::Kind::Container });
+            break;
+        case Frame::SliderPoint:
+            PushSliderPointValue(Scalar{ Scalar::Kind::Container });
+            break;
+        default:
+            break;
+        }
+        m_stack.push_back(Frame::Skip);
+        return true;
+    }
+
+    bool end_object()
+    {
+        const Frame frame = m_stack.back();
+        m_stack.pop_back();
+        if (frame == Frame::Element)
+            EndElement();
+        return true;
+    }
+
+    bool start_array(std::size_t)
+    {
+        if (m_stack.empty())
+        {
+            m_stack.push_back(Frame::Skip);
+            return true;
+        }
+
+        switch (m_stack.back())
+        {
+        case Frame::Root:
+            if (m_rootKey == Section::TimingPoints || m_rootKey == Section::SvPoints
+                || m_rootKey == Section::KeyboardNotes || m_rootKey == Section::MouseNotes)
+            {
+                ResetSection(m_rootKey);
+                m_section = m_rootKey;
+                m_stack.push_back(Frame::Section);
+                return true;
+            }
+            OnRootValue(Scalar{ Scalar::Kind::Container });
+            break;
+        case Frame::Section:
+            // 非对象元素：与 DOM 行为一致，按全默认值的元素处理
+            BeginElement();
+            EndElement();
+            break;
+        case Frame::Element:
+            if (m_field == Field::TimeSignature)
+            {
+                m_tsCount   = 0;
+                m_tsNumeric = true;
+                m_stack.push_back(Frame::TimeSignature);
+                return true;
+            }
+            if (m_field == Field::SliderPath)
+            {
+                m_mouse.sliderPath.clear();
+                m_stack.push_back(Frame::SliderPath);
+                return true;
+            }
+            AssignField(Scalar{ Scalar::Kind::Container });
+            break;
+        case Frame::TimeSignature:
+            PushTimeSignatureValue(Scalar{ Scalar::Kind::Container });
+            break;
+        case Frame::SliderPath:
+            m_pointCount   = 0;
+            m_pointNumeric = true;
+            m_stack.push_back(Frame::SliderPoint);
+            return true;
+        case Frame::SliderPoint:
+            PushSliderPointValue(Scalar{ Scalar::Kind::Container });
+            break;
+        default:
+            break;
+        }
+        m_stack.push_back(Frame::Skip);
+        return true;
+    }
+
+    bool end_array()
+    {
+        const Frame frame = m_stack.back();
+        m_stack.pop_back();
+        if (frame == Frame::SliderPoint && m_pointCount >= 2 && m_pointNumeric)
+            m_mouse.sliderPath.emplace_back(m_point[0], m_point[1]);
+        else if (frame == Frame::Section)
+            m_section = Section::None;
+        return true;
+    }
+
+    bool key(json::string_t& val)
+    {
+        if (m_stack.empty()) return true;
+
+        if (m_stack.back() == Frame::Root)
+            m_rootKey = RootKeyToSection(val);
+        else if (m_stack.back() == Frame::Element)
+            m_field = ElementKeyToField(m_section, val);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex)
+    {
+        m_error = ex.what();
+        return false;
+    }
+
+private:
+    struct OrderTracker
+    {
+        bool sorted   = true;
+        int  lastTime = 0;
+        bool any      = false;
+
+        void Push(int time)
+        {
+            if (any && time < lastTime)
+                sorted = false;
+            lastTime = time;
+            any      = true;
+        }
+    };
+
+    // ── 标量分发 ──────────────────────────────────────────────────────────────
+
+    void OnScalar(const Scalar& value)
+    {
+        if (m_stack.empty()) return;
+
+        switch (m_stack.back())
+        {
+        case Frame::Root:          OnRootValue(value); break;
+        case Frame::Section:       BeginElement(); EndElement(); break;
+        case Frame::Element:       AssignField(value); break;
+        case Frame::TimeSignature: PushTimeSignatureValue(value); break;
+        case Frame::SliderPoint:   PushSliderPointValue(value); break;
+        default: break;
+        }
+    }
+
+    // 顶层非数组值：version 赋值；同名 section 被非数组值覆盖时清空（与 DOM 的"后者覆盖"一致）
+    void OnRootValue(const Scalar& value)
+    {
+        if (m_rootKey == Section::Version)
+            AssignInt(m_data.version, value, 1, "version");
+        else if (m_rootKey != Section::None)
+            ResetSection(m_rootKey);
+    }
+
+    void ResetSection(Section section)
+    {
+        switch (section)
+        {
+        case Section::TimingPoints:  m_data.timingPoints.clear();  m_timingOrder   = {}; break;
+        case Section::SvPoints:      m_data.svPoints.clear();      m_svOrder       = {}; break;
+        case Section::KeyboardNotes: m_data.keyboardNotes.clear(); m_keyboardOrder = {}; break;
+        case Section::MouseNotes:    m_data.mouseNotes.clear();    m_mouseOrder    = {}; break;
+        default: break;
+        }
+    }
+
+    // ── 元素生命周期 ──────────────────────────────────────────────────────────
+
+    void BeginElement()
+    {
+        m_field = Field::None;
+        switch (m_section)
+        {
+        case Section::TimingPoints:
+            m_timing      = TimingPoint{};
+            m_numerator   = 4;
+            m_denominator = 4;
+            m_tsCount     = 0;
+            m_tsNumeric   = true;
+            break;
+        case Section::SvPoints:
+            m_sv = SVPoint{};
+            break;
+        case Section::KeyboardNotes:
+            m_keyboard = KeyboardNote{};
+            m_rawType.assign("tap");
+            break;
+        case Section::MouseNotes:
+            m_mouse = MouseNote{};
+            m_rawType.assign("circle");
+            break;
+        default:
+            break;
+        }
+    }
+
+    void EndElement()
+    {
+        switch (m_section)
+        {
+        case Section::TimingPoints:
+            if (m_tsCount >= 2 && m_tsNumeric)
+            {
+                m_timing.timeSigNumerator   = m_tsValues[0];
+                m_timing.timeSigDenominator = m_tsValues[1];
+            }
+            else
+            {
+                m_timing.timeSigNumerator   = m_numerator;
+                m_timing.timeSigDenominator = m_denominator;
+            }
+            m_timingOrder.Push(m_timing.time);
+            m_data.timingPoints.push_back(m_timing);
+            break;
+
+        case Section::SvPoints:
+            m_svOrder.Push(m_sv.time);
+            m_data.svPoints.push_back(std::move(m_sv));
+            break;
+
+        case Section::KeyboardNotes:
+            m_keyboard.type = ChartJsonStream::ParseNoteType(m_rawType);
+            if (m_rawType == "drag")
+            {
+                LOG_WARN("谱面 '{}' 在 time={} lane={} 仍使用已移除的 Drag 音符类型，将按 Hold 兼容加载",
+                    m_sourcePath, m_keyboard.time, m_keyboard.lane);
+            }
+            m_keyboardOrder.Push(m_keyboard.time);
+            m_data.keyboardNotes.push_back(m_keyboard);
+            break;
+
+        case Section::MouseNotes:
+            m_mouse.type = ChartJsonStream::ParseNoteType(m_rawType);
+            m_mouseOrder.Push(m_mouse.time);
+            m_data.mouseNotes.push_back(std::move(m_mouse));
+            break;
+
+        default:
+            break;
+        }
+        m_field = Field::None;
+    }
+
+    // ── 字段赋值 ──────────────────────────────────────────────────────────────
+
+    void AssignField(const Scalar& value)
+    {
+        const char* name = FieldName(m_field);
+        switch (m_section)
+        {
+        case Section::TimingPoints:
+            switch (m_field)
+            {
+            case Field::Time:          AssignInt(m_timing.time, value, 0, name); break;
+            case Field::Bpm:           AssignFloat(m_timing.bpm, value, 120.0f, name); break;
+            case Field::Numerator:     AssignInt(m_numerator, value, 4, name); break;
+            case Field::Denominator:   AssignInt(m_denominator, value, 4, name); break;
+            case Field::TimeSignature: m_tsCount = 0; break;   // 非数组：回退到 numerator/denominator
+            default: break;
+            }
+            break;
+
+        case Section::SvPoints:
+            switch (m_field)
+            {
+            case Field::Time:   AssignInt(m_sv.time, value, 0, name); break;
+            case Field::Speed:  AssignFloat(m_sv.speed, value, 1.0f, name); break;
+            case Field::Easing: AssignString(m_sv.easing, value, "linear", name); break;
+            default: break;
+            }
+            break;
+
+        case Section::KeyboardNotes:
+            switch (m_field)
+            {
+            case Field::Time:     AssignInt(m_keyboard.time, value, 0, name); break;
+            case Field::Lane:     AssignInt(m_keyboard.lane, value, 0, name); break;
+            case Field::Duration: AssignInt(m_keyboard.duration, value, 0, name); break;
+            case Field::Type:     AssignString(m_rawType, value, "tap", name); break;
+            default: break;
+            }
+            break;
+
+        case Section::MouseNotes:
+            switch (m_field)
+            {
+            case Field::Time:           AssignInt(m_mouse.time, value, 0, name); break;
+            case Field::X:              AssignFloat(m_mouse.x, value, 0.5f, name); break;
+            case Field::Y:              AssignFloat(m_mouse.y, value, 0.5f, name); break;
+            case Field::SliderDuration: AssignInt(m_mouse.sliderDuration, value, 0, name); break;
+            case Field::Type:           AssignString(m_rawType, value, "circle", name); break;
+            case Field::SliderPath:     m_mouse.sliderPath.clear(); break;
+            default: break;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void PushTimeSignatureValue(const Scalar& value)
+    {
+        if (m_tsCount < 2)
+        {
+            if (value.kind == Scalar::Kind::Number)
+                m_tsValues[m_tsCount] = static_cast<int>(value.number);
+            else
+                m_tsNumeric = false;
+        }
+        ++m_tsCount;
+    }
+
+    void PushSliderPointValue(const Scalar& value)
+    {
+        if (m_pointCount < 2)
+        {
+            if (value.kind == Scalar::Kind::Number)
+                m_point[m_pointCount] = static_cast<float>(value.number);
+            else
+                m_pointNumeric = false;
+        }
+        ++m_pointCount;
+    }
+
+    static void WarnType(const char* key)
+    {
+        LOG_WARN("JSON 字段 '{}' 类型错误，使用默认值", key);
+    }
+
+    static void AssignInt(int& out, const Scalar& value, int defaultVal, const char* key)
+    {
+        if (value.kind == Scalar::Kind::Number)
+        {
+            out = static_cast<int>(value.number);
+            return;
+        }
+        if (value.kind != Scalar::Kind::Null)
+            WarnType(key);
+        out = defaultVal;
+    }
+
+    static void AssignFloat(float& out, const Scalar& value, float defaultVal, const char* key)
+    {
+        if (value.kind == Scalar::Kind::Number)
+        {
+            out = static_cast<float>(value.number);
+            return;
+        }
+        if (value.kind != Scalar::Kind::Null)
+            WarnType(key);
+        out = defaultVal;
+    }
+
+    static void AssignString(std::string& out, const Scalar& value, const char* defaultVal, const char* key)
+    {
+        if (value.kind == Scalar::Kind::String)
+        {
+            out.assign(*value.text);
+            return;
+        }
+        if (value.kind != Scalar::Kind::Null)
+            WarnType(key);
+        out.assign(defaultVal);
+    }
+
+    const std::string& m_sourcePath;
+    ChartData          m_data;
+    std::string        m_error;
+
+    std::vector<Frame> m_stack;
+    Section            m_rootKey = Section::None;
+    Section            m_section = Section::None;
+    Field              m_field   = Field::None;
+
+    OrderTracker m_timingOrder;
+    OrderTracker m_svOrder;
+    OrderTracker m_keyboardOrder;
+    OrderTracker m_mouseOrder;
+
+    // 当前元素的工作副本
+    TimingPoint  m_timing;
+    int          m_numerator   = 4;
+    int          m_denominator = 4;
+    int          m_tsValues[2] = { 4, 4 };
+    int          m_tsCount     = 0;
+    bool         m_tsNumeric   = true;
+
+    SVPoint      m_sv;
+    KeyboardNote m_keyboard;
+    MouseNote    m_mouse;
+    std::string  m_rawType;
+
+    float        m_point[2]     = { 0.0f, 0.0f };
+    int          m_pointCount   = 0;
+    bool         m_pointNumeric = true;
+};
+
+} // namespace
+
+// ── ParseNoteType ─────────────────────────────────────────────────────────────
+
+NoteType ChartJsonStream::ParseNoteType(std::string_view typeStr)
+{
+    if (typeStr == "tap")    return NoteType::Tap;
+    if (typeStr == "hold")   return NoteType::Hold;
+    if (typeStr == "drag")   return NoteType::Hold;
+    if (typeStr == "circle") return NoteType::Circle;
+    if (typeStr == "slider") return NoteType::Slider;
+
+    LOG_WARN("未知音符类型: '{}', 默认为 Tap", typeStr);
+    return NoteType::Tap;
+}
+
+// ── Parse ─────────────────────────────────────────────────────────────────────
+
+std::optional<ChartData> ChartJsonStream::Parse(std::string_view text, const std::string& sourcePath)
+{
+    ChartSaxHandler handler(sourcePath);
+    if (!json::sax_parse(text.data(), text.data() + text.size(), &handler))
+    {
+        LOG_ERROR("谱面数据解析失败 [{}]: {}", sourcePath, handler.ErrorMessage());
+        return std::nullopt;
+    }
+
+    ChartData& data = handler.Data();
+
+    // 若无时间点则添加默认
+    if (data.timingPoints.empty())
+    {
+        data.timingPoints.push_back({ 0, 120.0f, 4, 4 });
+    }
+
+    // ── 按时间排序（已有序的数组直接跳过）────────────────────────────────────
+
+    if (!handler.TimingSorted())
+        std::sort(data.timingPoints.begin(), data.timingPoints.end(),
+                  [](const TimingPoint& a, const TimingPoint& b) { return a.time < b.time; });
+
+    if (!handler.SvSorted())
+        std::sort(data.svPoints.begin(), data.svPoints.end(),
+                  [](const SVPoint& a, const SVPoint& b) { return a.time < b.time; });
+
+    if (!handler.KeyboardSorted())
+        std::sort(data.keyboardNotes.begin(), data.keyboardNotes.end(),
+                  [](const KeyboardNote& a, const KeyboardNote& b) { return a.time < b.time; });
+
+    if (!handler.MouseSorted())
+        std::sort(data.mouseNotes.begin(), data.mouseNotes.end(),
+                  [](const MouseNote& a, const MouseNote& b) { return a.time < b.time; });
+
+    return std::move(data);
+}
+
+} // namespace sakura::game
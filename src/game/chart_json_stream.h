@@ -0,0 +1,33 @@
+#pragma once
+
+// chart_json_stream.h — 谱面数据 JSON 流式解析（SAX）
+// 基于 nlohmann::json::sax_parse 单遍扫描 {difficulty}.json，直接填充 ChartData，
+// 不构建 JSON DOM；各数组已按 time 升序时跳过排序。
+//
+// 容错规则与旧 DOM 解析一致：
+//   - 字段缺失或为 null → 使用默认值
+//   - 字段类型错误 → LOG_WARN 并使用默认值
+//   - 同名字段重复出现 → 以最后一次为准
+//   - 未知字段 / 嵌套结构 → 跳过
+
+#include "chart.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sakura::game
+{
+
+class ChartJsonStream
+{
+public:
+    // 解析谱面数据文本；JSON 语法错误返回 nullopt 并 LOG_ERROR
+    // sourcePath 仅用于日志
+    static std::optional<ChartData> Parse(std::string_view text, const std::string& sourcePath);
+
+    // 音符类型字符串 → NoteType（"drag" 兼容为 Hold，未知类型 LOG_WARN 后按 Tap）
+    static NoteType ParseNoteType(std::string_view typeStr);
+};
+
+} // namespace sakura::game
@@ -0,0 +1,401 @@
+// chart_library.cpp — 谱面库实现
+
+#include "chart_library.h"
+#include "chart_loader.h"
+#include "utils/logger.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+using json   = nlohmann::json;
+
+namespace sakura::game
+{
+
+namespace
+{
+
+// 索引格式版本：ChartInfo 字段变化时递增，旧索引整体丢弃
+constexpr int INDEX_VERSION = 1;
+
+std::string NormalizeRoot(const std::string& rootDir)
+{
+    std::string root = fs::path(rootDir).lexically_normal().generic_string();
+    while (root.size() > 1 && root.back() == '/')
+        root.pop_back();
+    return root;
+}
+
+json ChartInfoToJson(const ChartInfo& info)
+{
+    json j;
+    j["version"]         = info.version;
+    j["id"]              = info.id;
+    j["title"]           = info.title;
+    j["artist"]          = info.artist;
+    j["charter"]         = info.charter;
+    j["source"]          = info.source;
+    j["tags"]            = info.tags;
+    j["music_file"]      = info.musicFile;
+    j["cover_file"]      = info.coverFile;
+    j["background_file"] = info.backgroundFile;
+    j["preview_time"]    = info.previewTime;
+    j["bpm"]             = info.bpm;
+    j["offset"]          = info.offset;
+    j["folder_path"]     = info.folderPath;
+
+    json diffs = json::array();
+    for (const auto& d : info.difficulties)
+    {
+        diffs.push_back({
+            { "name",             d.name },
+            { "level",            d.level },
+            { "chart_file",       d.chartFile },
+            { "note_count",       d.noteCount },
+            { "hold_count",       d.holdCount },
+            { "mouse_note_count", d.mouseNoteCount },
+        });
+    }
+    j["difficulties"] = std::move(diffs);
+    return j;
+}
+
+ChartInfo ChartInfoFromJson(const json& j)
+{
+    ChartInfo info;
+    info.version        = j.value("version", 2);
+    info.id             = j.value("id", std::string());
+    info.title          = j.value("title", std::string());
+    info.artist         = j.value("artist", std::string());
+    info.charter        = j.value("charter", std::string());
+    info.source         = j.value("source", std::string());
+    info.tags           = j.value("tags", std::vector<std::string>());
+    info.musicFile      = j.value("music_file", std::string());
+    info.coverFile      = j.value("cover_file", std::string());
+    info.backgroundFile = j.value("background_file", std::string());
+    info.previewTime    = j.value("preview_time", 0);
+    info.bpm            = j.value("bpm", 120.0f);
+    info.offset         = j.value("offset", 0);
+    info.folderPath     = j.value("folder_path", std::string());
+
+    if (j.contains("difficulties") && j["difficulties"].is_array())
+    {
+        for (const auto& d : j["difficulties"])
+        {
+            DifficultyInfo di;
+            di.name           = d.value("name", std::string("Normal"));
+            di.level          = d.value("level", 5.0f);
+            di.chartFile      = d.value("chart_file", std::string());
+            di.noteCount      = d.value("note_count", 0);
+            di.holdCount      = d.value("hold_count", 0);
+            di.mouseNoteCount = d.value("mouse_note_count", 0);
+            info.difficulties.push_back(std::move(di));
+        }
+    }
+    return info;
+}
+
+} // namespace
+
+// ── GetInstance ───────────────────────────────────────────────────────────────
+
+ChartLibrary& ChartLibrary::GetInstance()
+{
+    static ChartLibrary s_instance;
+    return s_instance;
+}
+
+// ── 配置 ──────────────────────────────────────────────────────────────────────
+
+void ChartLibrary::SetIndexPath(std::string indexPath)
+{
+    std::lock_guard lock(m_mutex);
+    m_indexPath   = std::move(indexPath);
+    m_indexLoaded = false;
+    m_index.clear();
+    m_roots.clear();
+}
+
+void ChartLibrary::Clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_indexLoaded = false;
+    m_index.clear();
+    m_roots.clear();
+    m_lastStats = {};
+}
+
+ChartScanStats ChartLibrary::GetLastScanStats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_lastStats;
+}
+
+// ── 变更通知 ──────────────────────────────────────────────────────────────────
+
+ChartLibrary::ListenerId ChartLibrary::Subscribe(const std::string& rootDir, ChangeListener listener)
+{
+    std::lock_guard lock(m_mutex);
+    const ListenerId id = m_nextListenerId++;
+    m_listeners.push_back(Listener{ id, NormalizeRoot(rootDir), std::move(listener) });
+    return id;
+}
+
+void ChartLibrary::Unsubscribe(ListenerId id)
+{
+    std::lock_guard lock(m_mutex);
+    std::erase_if(m_listeners, [id](const Listener& listener) { return listener.id == id; });
+}
+
+// ── GetCharts ─────────────────────────────────────────────────────────────────
+
+std::shared_ptr<const ChartLibrary::ChartList> ChartLibrary::GetCharts(const std::string& rootDir)
+{
+    // 只 stat 的遍历代价很低，每次都做，磁盘上的变化不需要调用方另行通知
+    return Refresh(rootDir);
+}
+
+// ── Refresh ───────────────────────────────────────────────────────────────────
+
+std::shared_ptr<const ChartLibrary::ChartList> ChartLibrary::Refresh(const std::string& rootDir)
+{
+    std::unique_lock lock(m_mutex);
+
+    const std::string root = NormalizeRoot(rootDir);
+    if (!m_indexLoaded)
+        LoadIndexLocked();
+
+    ChartScanStats stats;
+
+    // ── 1. 遍历目录，收集 info.json 及其 mtime/size（只 stat，不解析）──────
+    std::vector<ScannedFile> found;
+
+    std::error_code ec;
+    if (fs::is_directory(root, ec))
+    {
+        for (auto it = fs::recursive_directory_iterator(root, ec);
+             !ec && it != fs::recursive_directory_iterator();
+             it.increment(ec))
+        {
+            std::error_code entryEc;
+            if (!it->is_regular_file(entryEc)) continue;
+            if (it->path().filename() != "info.json") continue;
+
+            ScannedFile f;
+            f.path  = it->path().lexically_normal().generic_string();
+            f.size  = static_cast<uint64_t>(it->file_size(entryEc));
+            f.mtime = static_cast<int64_t>(it->last_write_time(entryEc).time_since_epoch().count());
+            if (entryEc) continue;
+            found.push_back(std::move(f));
+        }
+        if (ec)
+            LOG_WARN("[ChartLibrary] 遍历谱面目录出错 '{}': {}", root, ec.message());
+    }
+    else
+    {
+        LOG_WARN("[ChartLibrary] 谱面根目录不存在: {}", root);
+    }
+    stats.discovered = static_cast<int>(found.size());
+
+    // ── 2. 与索引比对，筛出新增 / 变化的条目 ─────────────────────────────────
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < found.size(); ++i)
+    {
+        auto it = m_index.find(found[i].path);
+        if (it != m_index.end() && it->second.mtime == found[i].mtime && it->second.size == found[i].size)
+            ++stats.reused;
+        else
+            pending.push_back(i);
+    }
+
+    // ── 3. 线程池并行解析 ────────────────────────────────────────────────────
+    std::vector<std::optional<ChartInfo>> parsed(pending.size());
+    if (!pending.empty())
+    {
+        const size_t hw = std::max(1u, std::thread::hardware_concurrency());
+        const size_t workerCount = std::min(hw, pending.size());
+        std::atomic<size_t> next{ 0 };
+
+        auto worker = [&]()
+        {
+            ChartLoader loader;
+            for (size_t k = next.fetch_add(1); k < pending.size(); k = next.fetch_add(1))
+                parsed[k] = loader.LoadChartInfo(found[pending[k]].path);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workerCount - 1);
+        for (size_t t = 1; t < workerCount; ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    for (size_t k = 0; k < pending.size(); ++k)
+    {
+        const auto& f = found[pending[k]];
+        if (parsed[k])
+        {
+            m_index[f.path] = IndexEntry{ f.mtime, f.size, std::move(*parsed[k]) };
+            ++stats.parsed;
+        }
+        else
+        {
+            m_index.erase(f.path);
+            ++stats.failed;
+        }
+    }
+
+    // ── 4. 移除已从磁盘消失的条目（仅限本根目录）────────────────────────────
+    std::unordered_set<std::string> present;
+    present.reserve(found.size());
+    for (const auto& f : found)
+        present.insert(f.path);
+
+    const std::string prefix = root + "/";
+    for (auto it = m_index.begin(); it != m_index.end(); )
+    {
+        if (it->first.compare(0, prefix.size(), prefix) == 0 && !present.contains(it->first))
+        {
+            it = m_index.erase(it);
+            ++stats.removed;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (stats.parsed > 0 || stats.removed > 0 || stats.failed > 0)
+        SaveIndexLocked();
+
+    // ── 5. 内容有变时按遍历顺序组装新快照，否则沿用上一份 ────────────────────
+    // 索引条目只由解析对应 mtime/size 的文件得到，文件列表（含 mtime/size）不变则快照内容不变；
+    // 解析失败的文件不进索引，每次都会重试，因此 failed > 0 时总是重建
+    auto& state = m_roots[root];
+    const bool changed = !state.charts || stats.failed > 0 || state.files != found;
+    if (changed)
+    {
+        auto charts = std::make_shared<ChartList>();
+        charts->reserve(found.size());
+        for (const auto& f : found)
+        {
+            auto it = m_index.find(f.path);
+            if (it != m_index.end())
+                charts->push_back(it->second.info);
+        }
+        state.charts = std::move(charts);
+        state.files  = std::move(found);
+    }
+    m_lastStats = stats;
+
+    if (changed)
+        LOG_INFO("[ChartLibrary] 扫描 '{}': {} 个谱面（解析 {}，复用 {}，移除 {}，失败 {}）",
+                 root, stats.discovered, stats.parsed, stats.reused, stats.removed, stats.failed);
+    else
+        LOG_DEBUG("[ChartLibrary] 扫描 '{}': {} 个谱面，无变化", root, stats.discovered);
+
+    auto snapshot = state.charts;
+    if (!changed)
+        return snapshot;
+
+    std::vector<ChangeListener> callbacks;
+    for (const auto& listener : m_listeners)
+        if (listener.root == root && listener.callback)
+            callbacks.push_back(listener.callback);
+    lock.unlock();
+
+    for (const auto& callback : callbacks)
+        callback(*snapshot);
+    return snapshot;
+}
+
+// ── 索引持久化 ────────────────────────────────────────────────────────────────
+
+void ChartLibrary::LoadIndexLocked()
+{
+    m_indexLoaded = true;
+    m_index.clear();
+    if (m_indexPath.empty())
+        return;
+
+    std::ifstream file(m_indexPath);
+    if (!file.is_open())
+        return;
+
+    try
+    {
+        json j;
+        file >> j;
+        if (j.value("version", 0) != INDEX_VERSION || !j.contains("entries") || !j["entries"].is_array())
+        {
+            LOG_INFO("[ChartLibrary] 索引版本不符，将全量重建: {}", m_indexPath);
+            return;
+        }
+        for (const auto& e : j["entries"])
+        {
+            IndexEntry entry;
+            entry.mtime = e.value("mtime", int64_t{ 0 });
+            entry.size  = e.value("size", uint64_t{ 0 });
+            entry.info  = ChartInfoFromJson(e.value("info", json::object()));
+            m_index[e.value("path", std::string())] = std::move(entry);
+        }
+        LOG_DEBUG("[ChartLibrary] 已加载索引 {} 条: {}", m_index.size(), m_indexPath);
+    }
+    catch (const json::exception& e)
+    {
+        LOG_WARN("[ChartLibrary] 索引文件损坏，将全量重建 [{}]: {}", m_indexPath, e.what());
+        m_index.clear();
+    }
+}
+
+void ChartLibrary::SaveIndexLocked() const
+{
+    if (m_indexPath.empty())
+        return;
+
+    json entries = json::array();
+    for (const auto& [path, entry] : m_index)
+    {
+        entries.push_back({
+            { "path",  path },
+            { "mtime", entry.mtime },
+            { "size",  entry.size },
+            { "info",  ChartInfoToJson(entry.info) },
+        });
+    }
+
+    json j;
+    j["version"] = INDEX_VERSION;
+    j["entries"] = std::move(entries);
+
+    std::error_code ec;
+    const fs::path indexPath(m_indexPath);
+    if (indexPath.has_parent_path())
+        fs::create_directories(indexPath.parent_path(), ec);
+
+    const std::string tmpPath = m_indexPath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            LOG_WARN("[ChartLibrary] 无法写入索引: {}", tmpPath);
+            return;
+        }
+        file << j.dump();
+    }
+    fs::rename(tmpPath, m_indexPath, ec);
+    if (ec)
+        LOG_WARN("[ChartLibrary] 替换索引文件失败 [{}]: {}", m_indexPath, ec.message());
+}
+
+} // namespace sakura::game
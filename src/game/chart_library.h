@@ -0,0 +1,121 @@
+#pragma once
+
+// chart_library.h — 谱面库（全局共享的 ChartInfo 列表 + 持久化增量索引）
+//
+// 所有场景通过 ChartLibrary::GetInstance().GetCharts() 共享同一份 ChartInfo 快照，
+// 不再各自调用 ChartLoader::ScanCharts。
+// 每次 GetCharts 都遍历目录并 stat 各 info.json（不读文件内容），仅对 mtime/size 与索引
+// 记录不一致（新增或修改）的文件夹重新解析，解析任务分发到工作线程池；索引以 JSON 形式持久化在数据库同目录下
+// （索引路径为空时仅做进程内缓存）。
+
+#include "chart.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sakura::game
+{
+
+// 一次扫描的统计信息（用于日志与测试）
+struct ChartScanStats
+{
+    int discovered = 0;   // 找到的 info.json 数量
+    int parsed     = 0;   // 新增或变化、重新解析的数量
+    int reused     = 0;   // 命中索引、直接复用的数量
+    int removed    = 0;   // 索引中已不存在于磁盘的数量
+    int failed     = 0;   // 解析失败的数量
+};
+
+class ChartLibrary
+{
+public:
+    using ChartList = std::vector<ChartInfo>;
+
+    static constexpr const char* DEFAULT_ROOT       = "resources/charts";
+    static constexpr const char* INDEX_FILE_NAME    = "chart_index.json";
+
+    static ChartLibrary& GetInstance();
+
+    // 设置索引文件路径（App 初始化时设为数据库同目录的 INDEX_FILE_NAME）；会清空内存状态
+    void SetIndexPath(std::string indexPath);
+    const std::string& GetIndexPath() const { return m_indexPath; }
+
+    // 返回 rootDir 下的共享谱面列表快照（即 Refresh）。
+    // 每次调用都做一遍只 stat 的增量扫描，运行期间在磁盘上新增 / 修改 / 删除的谱面随即可见；
+    // 内容无变化时返回与上次相同的快照指针。
+    std::shared_ptr<const ChartList> GetCharts(const std::string& rootDir = DEFAULT_ROOT);
+
+    // 执行增量扫描并返回快照
+    std::shared_ptr<const ChartList> Refresh(const std::string& rootDir = DEFAULT_ROOT);
+
+    // 清空内存快照与索引缓存（下次访问时从索引文件重新加载）
+    void Clear();
+
+    ChartScanStats GetLastScanStats() const;
+
+    // ── 变更通知 ──────────────────────────────────────────────────────────────
+
+    // rootDir 的快照首次建立或内容有变（新增 / 修改 / 删除）时回调新快照；
+    // 回调在执行扫描的线程上、释放内部锁之后调用，可以再次调用 GetCharts
+    using ChangeListener = std::function<void(const ChartList& charts)>;
+    using ListenerId     = uint32_t;
+
+    ListenerId Subscribe(const std::string& rootDir, ChangeListener listener);
+    void       Unsubscribe(ListenerId id);
+
+    ChartLibrary(const ChartLibrary&)            = delete;
+    ChartLibrary& operator=(const ChartLibrary&) = delete;
+
+private:
+    ChartLibrary() = default;
+
+    // 索引条目：以 info.json 路径为键
+    struct IndexEntry
+    {
+        int64_t   mtime = 0;
+        uint64_t  size  = 0;
+        ChartInfo info;
+    };
+
+    // 一次遍历找到的 info.json（只 stat 得到的信息）
+    struct ScannedFile
+    {
+        std::string path;
+        int64_t     mtime = 0;
+        uint64_t    size  = 0;
+
+        bool operator==(const ScannedFile&) const = default;
+    };
+
+    struct RootState
+    {
+        std::shared_ptr<const ChartList> charts;
+        std::vector<ScannedFile>         files;   // charts 由这些文件构建（遍历顺序）
+    };
+
+    struct Listener
+    {
+        ListenerId     id = 0;
+        std::string    root;    // 已规范化
+        ChangeListener callback;
+    };
+
+    void LoadIndexLocked();
+    void SaveIndexLocked() const;
+
+    mutable std::mutex                          m_mutex;
+    std::string                                 m_indexPath;
+    bool                                        m_indexLoaded = false;
+    std::unordered_map<std::string, IndexEntry> m_index;
+    std::unordered_map<std::string, RootState>  m_roots;
+    ChartScanStats                              m_lastStats;
+    std::vector<Listener>                       m_listeners;
+    ListenerId                                  m_nextListenerId = 1;
+};
+
+} // namespace sakura::game
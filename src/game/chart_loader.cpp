@@ -1,12 +1,13 @@
 // chart_loader.cpp — 谱面加载器实现
 
 #include "chart_loader.h"
+#include "chart_binary.h"
+#include "chart_json_stream.h"
 #include "utils/logger.h"
 
 #include <nlohmann/json.hpp>
 #include <filesystem>
 #include <fstream>
-#include <algorithm>
 
 namespace fs = std::filesystem;
 using json   = nlohmann::json;
@@ -37,20 +38,6 @@ static T SafeGet(const json& j, const std::string& key, T defaultVal)
     return defaultVal;
 }
 
-// ── NoteType 字符串解析 ───────────────────────────────────────────────────────
-
-NoteType ChartLoader::ParseNoteType(const std::string& typeStr) const
-{
-    if (typeStr == "tap")    return NoteType::Tap;
-    if (typeStr == "hold")   return NoteType::Hold;
-    if (typeStr == "drag")   return NoteType::Hold;
-    if (typeStr == "circle") return NoteType::Circle;
-    if (typeStr == "slider") return NoteType::Slider;
-
-    LOG_WARN("未知音符类型: '{}', 默认为 Tap", typeStr);
-    return NoteType::Tap;
-}
-
 // ── LoadChartInfo ─────────────────────────────────────────────────────────────
 
 std::optional<ChartInfo> ChartLoader::LoadChartInfo(const std::string& infoJsonPath)
@@ -152,154 +139,110 @@ std::optional<ChartInfo> ChartLoader::LoadChartInfo(const std::string& infoJsonP
     return info;
 }
 
+// ── 文件读取 ──────────────────────────────────────────────────────────────────
+
+static bool ReadWholeFile(const std::string& path, std::string& out)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    file.seekg(0, std::ios::end);
+    const auto size = file.tellg();
+    if (size < 0) return false;
+    file.seekg(0, std::ios::beg);
+
+    out.resize(static_cast<size_t>(size));
+    if (size > 0)
+        file.read(out.data(), size);
+    return static_cast<bool>(file) || file.eof();
+}
+
 // ── LoadChartData ─────────────────────────────────────────────────────────────
 
 std::optional<ChartData> ChartLoader::LoadChartData(const std::string& chartJsonPath)
 {
-    if (!fs::exists(chartJsonPath))
-    {
-        LOG_ERROR("谱面数据文件不存在: {}", chartJsonPath);
-        return std::nullopt;
-    }
+    if (!m_useBinaryCache)
+        return LoadChartDataFromJson(chartJsonPath);
 
-    std::ifstream file(chartJsonPath);
-    if (!file.is_open())
+    auto sourceStamp = ChartBinary::StatSource(chartJsonPath);
+    if (!sourceStamp)
     {
-        LOG_ERROR("无法打开谱面数据文件: {}", chartJsonPath);
-        return std::nullopt;
-    }
-
-    json j;
-    try
-    {
-        file >> j;
-    }
-    catch (const json::parse_error& e)
-    {
-        LOG_ERROR("谱面数据解析失败 [{}]: {}", chartJsonPath, e.what());
+        LOG_ERROR("谱面数据文件不存在: {}", chartJsonPath);
         return std::nullopt;
     }
 
-    ChartData data;
-    data.version = SafeGet<int>(j, "version", 1);
+    const std::string cachePath = ChartBinary::GetCachePath(chartJsonPath);
+    const auto cachedStamp = ChartBinary::ReadStamp(cachePath);
 
-    // ── 时间点 ──────────────────────────────────────────────────────────────
-
-    if (j.contains("timing_points") && j["timing_points"].is_array())
+    // 快速路径：mtime + size 一致，直接 mmap 缓存
+    if (cachedStamp && cachedStamp->mtime == sourceStamp->mtime && cachedStamp->size == sourceStamp->size)
     {
-        for (const auto& tp : j["timing_points"])
+        if (auto cached = ChartBinary::Read(cachePath))
         {
-            TimingPoint point;
-            point.time = SafeGet<int>(tp, "time", 0);
-            point.bpm  = SafeGet<float>(tp, "bpm", 120.0f);
-
-            // 支持 "time_signature": [4, 4] 数组格式
-            if (tp.contains("time_signature") && tp["time_signature"].is_array()
-                && tp["time_signature"].size() >= 2)
-            {
-                point.timeSigNumerator   = tp["time_signature"][0].get<int>();
-                point.timeSigDenominator = tp["time_signature"][1].get<int>();
-            }
-            else
-            {
-                point.timeSigNumerator   = SafeGet<int>(tp, "numerator",   4);
-                point.timeSigDenominator = SafeGet<int>(tp, "denominator", 4);
-            }
-            data.timingPoints.push_back(std::move(point));
+            LOG_DEBUG("从缓存加载谱面数据: {}", cachePath);
+            return cached;
         }
     }
 
-    // 若无时间点则添加默认
-    if (data.timingPoints.empty())
+    std::string text;
+    if (!ReadWholeFile(chartJsonPath, text))
     {
-        data.timingPoints.push_back({ 0, 120.0f, 4, 4 });
+        LOG_ERROR("无法打开谱面数据文件: {}", chartJsonPath);
+        return std::nullopt;
     }
+    sourceStamp->hash = ChartBinary::HashBytes(text);
 
-    // ── SV 点 ────────────────────────────────────────────────────────────────
-
-    if (j.contains("sv_points") && j["sv_points"].is_array())
+    // mtime 变化但内容未变（如 git checkout / 复制）：复用缓存，仅刷新头部指纹
+    if (cachedStamp && cachedStamp->size == sourceStamp->size && cachedStamp->hash == sourceStamp->hash)
     {
-        for (const auto& sv : j["sv_points"])
+        if (auto cached = ChartBinary::Read(cachePath))
         {
-            SVPoint point;
-            point.time   = SafeGet<int>(sv, "time", 0);
-            point.speed  = SafeGet<float>(sv, "speed", 1.0f);
-            point.easing = SafeGet<std::string>(sv, "easing", "linear");
-            data.svPoints.push_back(std::move(point));
+            ChartBinary::Write(cachePath, *cached, *sourceStamp);
+            return cached;
         }
     }
 
-    // ── 键盘音符 ─────────────────────────────────────────────────────────────
-
-    if (j.contains("keyboard_notes") && j["keyboard_notes"].is_array())
+    auto data = ParseChartJson(text, chartJsonPath);
+    if (data)
     {
-        for (const auto& n : j["keyboard_notes"])
-        {
-            KeyboardNote note;
-            const std::string rawType = SafeGet<std::string>(n, "type", "tap");
-            note.time       = SafeGet<int>(n, "time", 0);
-            note.lane       = SafeGet<int>(n, "lane", 0);
-            note.type       = ParseNoteType(rawType);
-            note.duration   = SafeGet<int>(n, "duration", 0);
-            if (rawType == "drag")
-            {
-                LOG_WARN("谱面 '{}' 在 time={} lane={} 仍使用已移除的 Drag 音符类型，将按 Hold 兼容加载",
-                    chartJsonPath, note.time, note.lane);
-            }
-            data.keyboardNotes.push_back(std::move(note));
-        }
+        if (ChartBinary::Write(cachePath, *data, *sourceStamp))
+            LOG_DEBUG("已重建谱面缓存: {}", cachePath);
     }
+    return data;
+}
 
-    // ── 鼠标音符 ─────────────────────────────────────────────────────────────
-
-    if (j.contains("mouse_notes") && j["mouse_notes"].is_array())
+std::optional<ChartData> ChartLoader::LoadChartDataFromJson(const std::string& chartJsonPath)
+{
+    if (!fs::exists(chartJsonPath))
     {
-        for (const auto& n : j["mouse_notes"])
-        {
-            MouseNote note;
-            note.time            = SafeGet<int>(n, "time", 0);
-            note.x               = SafeGet<float>(n, "x", 0.5f);
-            note.y               = SafeGet<float>(n, "y", 0.5f);
-            note.type            = ParseNoteType(SafeGet<std::string>(n, "type", "circle"));
-            note.sliderDuration  = SafeGet<int>(n, "slider_duration", 0);
-
-            // Slider 路径
-            if (n.contains("slider_path") && n["slider_path"].is_array())
-            {
-                for (const auto& pt : n["slider_path"])
-                {
-                    if (pt.is_array() && pt.size() >= 2)
-                    {
-                        float px = pt[0].get<float>();
-                        float py = pt[1].get<float>();
-                        note.sliderPath.emplace_back(px, py);
-                    }
-                }
-            }
-
-            data.mouseNotes.push_back(std::move(note));
-        }
+        LOG_ERROR("谱面数据文件不存在: {}", chartJsonPath);
+        return std::nullopt;
     }
 
-    // ── 按时间排序 ────────────────────────────────────────────────────────────
-
-    std::sort(data.timingPoints.begin(), data.timingPoints.end(),
-              [](const TimingPoint& a, const TimingPoint& b) { return a.time < b.time; });
+    std::string text;
+    if (!ReadWholeFile(chartJsonPath, text))
+    {
+        LOG_ERROR("无法打开谱面数据文件: {}", chartJsonPath);
+        return std::nullopt;
+    }
 
-    std::sort(data.svPoints.begin(), data.svPoints.end(),
-              [](const SVPoint& a, const SVPoint& b) { return a.time < b.time; });
+    return ParseChartJson(text, chartJsonPath);
+}
 
-    std::sort(data.keyboardNotes.begin(), data.keyboardNotes.end(),
-              [](const KeyboardNote& a, const KeyboardNote& b) { return a.time < b.time; });
+// ── ParseChartJson ────────────────────────────────────────────────────────────
 
-    std::sort(data.mouseNotes.begin(), data.mouseNotes.end(),
-              [](const MouseNote& a, const MouseNote& b) { return a.time < b.time; });
+std::optional<ChartData> ChartLoader::ParseChartJson(const std::string& text,
+                                                     const std::string& chartJsonPath) const
+{
+    auto data = ChartJsonStream::Parse(text, chartJsonPath);
+    if (!data)
+        return std::nullopt;
 
     LOG_INFO("加载谱面数据成功: 键盘音符={}, 鼠标音符={}, 时间点={}, SV点={}",
-             data.keyboardNotes.size(),
-             data.mouseNotes.size(),
-             data.timingPoints.size(),
-             data.svPoints.size());
+             data->keyboardNotes.size(),
+             data->mouseNotes.size(),
+             data->timingPoints.size(),
+             data->svPoints.size());
 
     return data;
 }
@@ -24,8 +24,17 @@ public:
     std::optional<ChartInfo>  LoadChartInfo(const std::string& infoJsonPath);
 
     // 加载谱面数据（{difficulty}.json）
+    // 优先 mmap 同目录的 .skc 预编译缓存；缓存缺失、损坏或 JSON 已变化时
+    // 回退解析 JSON 并重建缓存（见 chart_binary.h）
     std::optional<ChartData>  LoadChartData(const std::string& chartJsonPath);
 
+    // 始终解析 JSON，不读写 .skc 缓存
+    std::optional<ChartData>  LoadChartDataFromJson(const std::string& chartJsonPath);
+
+    // 是否启用 .skc 缓存（默认启用）
+    void SetBinaryCacheEnabled(bool enabled) { m_useBinaryCache = enabled; }
+    bool IsBinaryCacheEnabled() const        { return m_useBinaryCache; }
+
     // ── 目录扫描 ──────────────────────────────────────────────────────────────
 
     // 递归扫描 rootDir 中所有含 info.json 的子目录，返回 ChartInfo 列表
@@ -38,8 +47,10 @@ public:
     bool ValidateChartData(const ChartData& data) const;
 
 private:
-    // 解析 NoteType 字符串
-    NoteType ParseNoteType(const std::string& typeStr) const;
+    // 从已读入内存的 JSON 文本流式构建 ChartData（不建 DOM，见 chart_json_stream.h）
+    std::optional<ChartData> ParseChartJson(const std::string& text, const std::string& sourcePath) const;
+
+    bool m_useBinaryCache = true;
 };
 
 } // namespace sakura::game
@@ -6,7 +6,10 @@
 #include "core/config.h"
 #include "utils/logger.h"
 
+#include <SDL3/SDL.h>
+
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
 
 namespace sakura::game
@@ -39,6 +42,11 @@ bool GameState::Start(const ChartInfo& chartInfo, int difficultyIndex)
         return false;
     }
     m_chartData = std::move(*chartData);
+    ResetNoteStates();
+
+    // 预计算 SV 滚动位置积分表与键盘音符的滚动位置
+    m_scrollMap.Build(m_chartData.svPoints);
+    m_kbScroll = m_scrollMap.ComputeNotePositions(m_chartData.keyboardNotes);
 
     if (!loader.ValidateChartData(m_chartData))
     {
@@ -46,8 +54,7 @@ bool GameState::Start(const ChartInfo& chartInfo, int difficultyIndex)
     }
 
     // 读取 Config 全局偏移
-    m_globalOffset = sakura::core::Config::GetInstance()
-        .Get<int>(std::string(sakura::core::ConfigKeys::kAudioOffset), 0);
+    m_globalOffset = sakura::core::Config::GetInstance().GetSnapshot().audioOffsetMs;
 
     // 音乐文件路径
     std::string musicPath = chartInfo.folderPath + "/" + chartInfo.musicFile;
@@ -70,8 +77,11 @@ bool GameState::Start(const ChartInfo& chartInfo, int difficultyIndex)
     m_msActiveEnd   = 0;
 
     // 重置时间
-    m_currentTimeMs  = 0;
     m_playbackStartMs = 0;
+    m_clockSpeed      = sakura::audio::AudioManager::GetInstance().GetPlaybackSpeed();
+    m_clock.SetSpeed(0.0, m_clockSpeed);
+    m_clock.Reset(0.0);
+    SyncClock();
     m_musicStarted   = false;
     m_countdownTimer = COUNTDOWN_DURATION;
     m_phase          = GamePhase::Countdown;
@@ -129,35 +139,19 @@ void GameState::Update(float dt)
                 }
             }
 
-            m_phase          = GamePhase::Playing;
-            m_currentTimeMs  = m_playbackStartMs;
+            // 歌曲时钟从起播位置开始计时，之后由音频游标采样校正
+            m_clock.Seek(HostTimeUs(), static_cast<double>(m_playbackStartMs) * 1000.0);
+            m_clock.Resume(HostTimeUs());
+            m_phase = GamePhase::Playing;
+            SyncClock();
         }
         break;
     }
 
     case GamePhase::Playing:
     {
-        auto& audio = sakura::audio::AudioManager::GetInstance();
-
-        if (m_musicStarted && audio.IsPlaying())
-        {
-            // 基于音乐播放位置同步（避免累加 dt 的误差）
-            double musicPos = audio.GetMusicPosition();
-            // 应用 chart offset + 全局 offset
-            int offsetMs = m_chartInfo.offset + m_globalOffset;
-            m_currentTimeMs = static_cast<int>(musicPos * 1000.0) - offsetMs;
-        }
-        else if (m_musicStarted && !audio.IsPlaying() && !audio.IsPaused())
-        {
-            // 音乐自然结束
-            double musicPos = audio.GetMusicPosition();
-            m_currentTimeMs = static_cast<int>(musicPos * 1000.0);
-        }
-        else if (!m_musicStarted)
-        {
-            // 无音乐模式：使用 dt 累加
-            m_currentTimeMs += static_cast<int>(dt * 1000.0f);
-        }
+        // 音乐播放中：音频游标作为采样输入；音乐结束或无音乐模式下时钟按主机时间自由运行
+        SyncClock();
 
         // 更新活跃音符窗口
         UpdateActiveWindows();
@@ -183,6 +177,7 @@ void GameState::Pause()
     if (m_phase != GamePhase::Playing) return;
 
     m_phase = GamePhase::Paused;
+    m_clock.Pause(HostTimeUs());
     if (m_musicStarted)
     {
         sakura::audio::AudioManager::GetInstance().PauseMusic();
@@ -194,8 +189,11 @@ void GameState::Resume()
 {
     if (m_phase != GamePhase::Paused) return;
 
-    m_playbackStartMs = std::max(0, m_currentTimeMs - RESUME_REWIND_MS);
-    m_currentTimeMs   = m_playbackStartMs;
+    // 回退位置以音乐时间计（不含 offset），与 SetMusicPosition 一致
+    const int musicMs = static_cast<int>(m_clock.GetTimeUs(HostTimeUs()) / 1000.0);
+    m_playbackStartMs = std::max(0, musicMs - RESUME_REWIND_MS);
+    m_clock.Reset(static_cast<double>(m_playbackStartMs) * 1000.0);
+    SyncClock();
     m_countdownTimer  = COUNTDOWN_DURATION;
     m_phase           = GamePhase::Countdown;
 
@@ -219,24 +217,12 @@ void GameState::Reset()
     auto& audio = sakura::audio::AudioManager::GetInstance();
     audio.StopMusic();
 
-    // 重置所有音符的判定状态
-    for (auto& note : m_chartData.keyboardNotes)
-    {
-        note.isJudged  = false;
-        note.result    = JudgeResult::None;
-        note.renderY   = 0.0f;
-        note.alpha     = 1.0f;
-    }
-    for (auto& note : m_chartData.mouseNotes)
-    {
-        note.isJudged      = false;
-        note.result        = JudgeResult::None;
-        note.approachScale = 2.0f;
-        note.alpha         = 1.0f;
-    }
+    // 重置所有音符的判定状态（状态数组整体覆写，不触碰谱面数据）
+    ResetNoteStates();
 
-    m_currentTimeMs  = 0;
     m_playbackStartMs = 0;
+    m_clock.Reset(0.0);
+    SyncClock();
     m_musicStarted   = false;
     m_countdownTimer = COUNTDOWN_DURATION;
     m_phase          = GamePhase::Countdown;
@@ -244,7 +230,74 @@ void GameState::Reset()
     m_kbActiveEnd    = 0;
     m_msActiveBegin  = 0;
     m_msActiveEnd    = 0;
-    m_forcedMissCount = 0;
+}
+
+void GameState::ResetNoteStates()
+{
+    m_kbStates.assign(m_chartData.keyboardNotes.size(), NoteState{});
+    m_msStates.assign(m_chartData.mouseNotes.size(), NoteState{});
+}
+
+// ── 歌曲时钟 ──────────────────────────────────────────────────────────────────
+
+double GameState::HostTimeUs()
+{
+    return static_cast<double>(SDL_GetTicksNS()) / 1000.0;
+}
+
+double GameState::GetOffsetUs() const
+{
+    return static_cast<double>(m_chartInfo.offset + m_globalOffset) * 1000.0;
+}
+
+void GameState::SyncClock()
+{
+    const double host = HostTimeUs();
+
+    if (m_clock.IsRunning())
+    {
+        auto& audio = sakura::audio::AudioManager::GetInstance();
+
+        // SetPlaybackSpeed 改变后以当前时间为锚点切换斜率
+        const float speed = audio.GetPlaybackSpeed();
+        if (speed != m_clockSpeed)
+        {
+            m_clockSpeed = speed;
+            m_clock.SetSpeed(host, speed);
+        }
+
+        if (m_musicStarted && audio.IsPlaying())
+            m_clock.AddSample(host, audio.GetMusicPosition() * 1000000.0);
+    }
+
+    m_currentTimeUs = m_clock.GetTimeUs(host) - GetOffsetUs();
+    m_currentTimeMs = static_cast<int>(std::floor(m_currentTimeUs / 1000.0));
+}
+
+double GameState::GetClockSlope() const
+{
+    if (m_phase != GamePhase::Playing || !m_clock.IsRunning()) return 0.0;
+    return m_clock.GetSlope();
+}
+
+double GameState::SampleRenderTimeUs() const
+{
+    if (m_phase != GamePhase::Playing) return m_currentTimeUs;
+    return std::max(m_currentTimeUs, m_clock.GetTimeUs(HostTimeUs()) - GetOffsetUs());
+}
+
+double GameState::EventTimeToGameMs(uint64_t timestampNs) const
+{
+    if (timestampNs == 0 || m_phase != GamePhase::Playing)
+        return GetCurrentTimeMsPrecise();
+
+    // 事件不可能晚于当前时刻；时间戳异常（时基不一致）时退回当前时间
+    const double hostUs = static_cast<double>(timestampNs) / 1000.0;
+    const double nowUs  = HostTimeUs();
+    if (hostUs > nowUs || nowUs - hostUs > MAX_EVENT_AGE_US)
+        return GetCurrentTimeMsPrecise();
+
+    return (m_clock.ProjectUs(hostUs) - GetOffsetUs()) / 1000.0;
 }
 
 // ── GetProgress ───────────────────────────────────────────────────────────────
@@ -265,34 +318,35 @@ int GameState::GetCountdownNumber() const
 
 // ── GetActiveKeyboardNotes ────────────────────────────────────────────────────
 
-std::span<KeyboardNote> GameState::GetActiveKeyboardNotes()
+std::span<const KeyboardNote> GameState::GetActiveKeyboardNotes() const
 {
     if (m_kbActiveBegin >= m_kbActiveEnd || m_chartData.keyboardNotes.empty())
         return {};
-    return std::span<KeyboardNote>(
+    return std::span<const KeyboardNote>(
         m_chartData.keyboardNotes.data() + m_kbActiveBegin,
         m_kbActiveEnd - m_kbActiveBegin
     );
 }
 
-std::span<const KeyboardNote> GameState::GetActiveKeyboardNotes() const
+std::span<const NoteScrollPos> GameState::GetActiveKeyboardScroll() const
 {
-    if (m_kbActiveBegin >= m_kbActiveEnd || m_chartData.keyboardNotes.empty())
+    if (m_kbActiveBegin >= m_kbActiveEnd || m_kbScroll.empty())
         return {};
-    return std::span<const KeyboardNote>(
-        m_chartData.keyboardNotes.data() + m_kbActiveBegin,
-        m_kbActiveEnd - m_kbActiveBegin
-    );
+    return std::span<const NoteScrollPos>(m_kbScroll.data() + m_kbActiveBegin, m_kbActiveEnd - m_kbActiveBegin);
 }
 
-std::span<MouseNote> GameState::GetActiveMouseNotes()
+std::span<NoteState> GameState::GetActiveKeyboardStates()
 {
-    if (m_msActiveBegin >= m_msActiveEnd || m_chartData.mouseNotes.empty())
+    if (m_kbActiveBegin >= m_kbActiveEnd || m_kbStates.empty())
         return {};
-    return std::span<MouseNote>(
-        m_chartData.mouseNotes.data() + m_msActiveBegin,
-        m_msActiveEnd - m_msActiveBegin
-    );
+    return std::span<NoteState>(m_kbStates.data() + m_kbActiveBegin, m_kbActiveEnd - m_kbActiveBegin);
+}
+
+std::span<const NoteState> GameState::GetActiveKeyboardStates() const
+{
+    if (m_kbActiveBegin >= m_kbActiveEnd || m_kbStates.empty())
+        return {};
+    return std::span<const NoteState>(m_kbStates.data() + m_kbActiveBegin, m_kbActiveEnd - m_kbActiveBegin);
 }
 
 std::span<const MouseNote> GameState::GetActiveMouseNotes() const
@@ -305,23 +359,25 @@ std::span<const MouseNote> GameState::GetActiveMouseNotes() const
     );
 }
 
-// ── GetCurrentSVSpeed ─────────────────────────────────────────────────────────
+std::span<NoteState> GameState::GetActiveMouseStates()
+{
+    if (m_msActiveBegin >= m_msActiveEnd || m_msStates.empty())
+        return {};
+    return std::span<NoteState>(m_msStates.data() + m_msActiveBegin, m_msActiveEnd - m_msActiveBegin);
+}
 
-float GameState::GetCurrentSVSpeed(int timeMs) const
+std::span<const NoteState> GameState::GetActiveMouseStates() const
 {
-    if (m_chartData.svPoints.empty()) return 1.0f;
+    if (m_msActiveBegin >= m_msActiveEnd || m_msStates.empty())
+        return {};
+    return std::span<const NoteState>(m_msStates.data() + m_msActiveBegin, m_msActiveEnd - m_msActiveBegin);
+}
 
-    // 二分查找最后一个 time <= timeMs 的 SV 点
-    auto it = std::upper_bound(
-        m_chartData.svPoints.begin(),
-        m_chartData.svPoints.end(),
-        timeMs,
-        [](int t, const SVPoint& sv) { return t < sv.time; }
-    );
+// ── GetCurrentSVSpeed ─────────────────────────────────────────────────────────
 
-    if (it == m_chartData.svPoints.begin()) return 1.0f;
-    --it;
-    return it->speed;
+float GameState::GetCurrentSVSpeed(int timeMs) const
+{
+    return m_scrollMap.SpeedAt(timeMs);
 }
 
 // ── GetCurrentBPM ─────────────────────────────────────────────────────────────
@@ -367,7 +423,7 @@ void GameState::UpdateActiveWindows()
 
     // ── 键盘音符 ──────────────────────────────────────────────────────────────
     {
-        auto& notes = m_chartData.keyboardNotes;
+        const auto& notes = m_chartData.keyboardNotes;
         const size_t n = notes.size();
 
         // 移动起始索引：跳过已超出后边界（time + duration < windowStart）的音符
@@ -375,7 +431,7 @@ void GameState::UpdateActiveWindows()
         {
             const auto& note = notes[m_kbActiveBegin];
             int noteEnd = note.time + std::max(note.duration, 0);
-            if (noteEnd < windowStart && note.isJudged)
+            if (noteEnd < windowStart && m_kbStates[m_kbActiveBegin].isJudged)
                 ++m_kbActiveBegin;
             else
                 break;
@@ -389,14 +445,14 @@ void GameState::UpdateActiveWindows()
 
     // ── 鼠标音符 ──────────────────────────────────────────────────────────────
     {
-        auto& notes = m_chartData.mouseNotes;
+        const auto& notes = m_chartData.mouseNotes;
         const size_t n = notes.size();
 
         while (m_msActiveBegin < n)
         {
             const auto& note = notes[m_msActiveBegin];
             int noteEnd = note.time + std::max(note.sliderDuration, 0);
-            if (noteEnd < windowStart && note.isJudged)
+            if (noteEnd < windowStart && m_msStates[m_msActiveBegin].isJudged)
                 ++m_msActiveBegin;
             else
                 break;
@@ -417,31 +473,21 @@ void GameState::CheckFinished()
     bool musicEnded = !m_musicStarted
                    || (!audio.IsPlaying() && !audio.IsPaused());
 
-    // 若音乐已结束，将所有仍未判定的音符强制判为 Miss
-    // （防止末尾 miss 窗口内的音符阻塞游戏结束流程）
+    // 若音乐已结束，将显示副本中仍未判定的音符标为 Miss
+    // （计分由 JudgeSession::Finish 完成，这里只保证结束画面状态一致）
     if (musicEnded)
     {
-        m_forcedMissCount = 0;
-        for (auto& n : m_chartData.keyboardNotes)
+        for (auto& state : m_kbStates)
         {
-            if (!n.isJudged)
-            {
-                n.isJudged = true;
-                n.result   = JudgeResult::Miss;
-                ++m_forcedMissCount;
-            }
+            if (state.isJudged) continue;
+            state.isJudged = true;
+            state.result   = JudgeResult::Miss;
         }
-        for (auto& n : m_chartData.mouseNotes)
+        for (auto& state : m_msStates)
         {
-            if (!n.isJudged)
-            {
-                n.isJudged = true;
-                n.result   = JudgeResult::Miss;
-                ++m_forcedMissCount;
-                // Slider 头部未被点击时，拐点也算强制 Miss
-                if (n.type == NoteType::Slider)
-                    m_forcedMissCount += static_cast<int>(n.sliderPath.size());
-            }
+            if (state.isJudged) continue;
+            state.isJudged = true;
+            state.result   = JudgeResult::Miss;
         }
 
         m_phase = GamePhase::Finished;
@@ -449,18 +495,8 @@ void GameState::CheckFinished()
         return;
     }
 
-    // 音乐仍在播放，检查是否所有音符都已判定
-    for (const auto& n : m_chartData.keyboardNotes)
-    {
-        if (!n.isJudged) return;
-    }
-    for (const auto& n : m_chartData.mouseNotes)
-    {
-        if (!n.isJudged) return;
-    }
-
-    // 所有音符已判定，等待音乐结束（通常是 AP 跑完）
-    // 实际上这里 musicEnded 已经是 false，留空让下帧再判断
+    // 音乐仍在播放：即使所有音符都已判定（通常是 AP 跑完）也等待音乐结束，
+    // 因此这里无需逐个检查音符状态
 }
 
 } // namespace sakura::game
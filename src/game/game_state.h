@@ -5,8 +5,12 @@
 
 #include "chart.h"
 #include "note.h"
+#include "song_clock.h"
+#include "sv_scroll.h"
+#include <cstdint>
 #include <span>
 #include <string>
+#include <vector>
 
 namespace sakura::game
 {
@@ -56,9 +60,29 @@ public:
     bool      IsFinished()     const { return m_phase == GamePhase::Finished; }
     bool      IsInCountdown()  const { return m_phase == GamePhase::Countdown; }
 
-    // 当前游戏时间（毫秒，基于音乐播放位置 + Config offset）
+    // 当前游戏时间（毫秒，基于音乐播放位置 + Config offset），取整自 GetCurrentTimeUs()
     int GetCurrentTime() const { return m_currentTimeMs; }
 
+    // 当前游戏时间（微秒，亚毫秒精度）：本次 Update 时由 SongClock 平滑得到，供判定与计分
+    double GetCurrentTimeUs() const { return m_currentTimeUs; }
+    double GetCurrentTimeMsPrecise() const { return m_currentTimeUs / 1000.0; }
+
+    // 渲染用游戏时间（微秒）：在调用时刻重新采样歌曲时钟，
+    // 渲染帧率高于固定更新频率时音符位置依然连续；保证不早于 GetCurrentTimeUs()
+    double SampleRenderTimeUs() const;
+
+    // 把 SDL 事件时间戳（SDL_GetTicksNS 时基，纳秒）映射为游戏时间（毫秒，亚毫秒精度）。
+    // 输入在事件循环中到达、在固定步长更新中消费，直接用更新时刻判定会晚最多一帧；
+    // 非 Playing 阶段或时间戳为 0 时返回当前游戏时间
+    double EventTimeToGameMs(uint64_t timestampNs) const;
+
+    // 主机单调时间（微秒）：SDL_GetTicksNS（SDL3 中由 SDL_GetPerformanceCounter 换算），
+    // 与 SDL 事件时间戳同一时基；判定线程据此外推游戏时间
+    static double HostTimeUs();
+
+    // 游戏时间相对主机时间的推进速率（SongClock 拟合斜率），非 Playing 阶段为 0
+    double GetClockSlope() const;
+
     // 歌曲进度（0.0~1.0）
     float GetProgress() const;
 
@@ -70,23 +94,41 @@ public:
 
     // ── 音符访问 ──────────────────────────────────────────────────────────────
 
+    // 音符数据（谱面列，只读）与运行时状态（NoteState，可写）按下标平行存放：
+    // GetKeyboardNotes()[i] 的判定状态为 GetKeyboardStates()[i]。
+
     // 当前窗口内的活跃键盘音符（time-500ms ~ time+2000ms）
-    // 返回 span 指向内部数据，不拷贝
-    std::span<KeyboardNote>       GetActiveKeyboardNotes();
+    // 返回 span 指向内部数据，不拷贝；对应状态为 GetActiveKeyboardStates()，
+    // 在完整数组中的起始下标为 GetActiveKeyboardBegin()
     std::span<const KeyboardNote> GetActiveKeyboardNotes() const;
+    std::span<NoteState>          GetActiveKeyboardStates();
+    std::span<const NoteState>    GetActiveKeyboardStates() const;
+    size_t                        GetActiveKeyboardBegin() const { return m_kbActiveBegin; }
+    // 活跃键盘音符的滚动位置缓存（与 GetActiveKeyboardNotes() 一一对应）
+    std::span<const NoteScrollPos> GetActiveKeyboardScroll() const;
 
-    std::span<MouseNote>          GetActiveMouseNotes();
     std::span<const MouseNote>    GetActiveMouseNotes() const;
-
-    // 完整音符数据（供 judge 系统使用）
-    std::vector<KeyboardNote>&    GetKeyboardNotes()        { return m_chartData.keyboardNotes; }
-    std::vector<MouseNote>&       GetMouseNotes()           { return m_chartData.mouseNotes; }
+    std::span<NoteState>          GetActiveMouseStates();
+    std::span<const NoteState>    GetActiveMouseStates() const;
+    size_t                        GetActiveMouseBegin() const { return m_msActiveBegin; }
+
+    // 完整音符数据与状态。判定由 JudgeSession 完成（权威状态在其内部），
+    // 这里的 NoteState 是显示副本：场景按 JudgeEvent 更新，渲染据此淡出已判定音符
+    const std::vector<KeyboardNote>& GetKeyboardNotes()  const { return m_chartData.keyboardNotes; }
+    const std::vector<MouseNote>&    GetMouseNotes()     const { return m_chartData.mouseNotes; }
+    std::vector<NoteState>&          GetKeyboardStates()       { return m_kbStates; }
+    std::vector<NoteState>&          GetMouseStates()          { return m_msStates; }
+    const std::vector<NoteState>&    GetKeyboardStates() const { return m_kbStates; }
+    const std::vector<NoteState>&    GetMouseStates()    const { return m_msStates; }
 
     // ── SV / BPM 查询 ─────────────────────────────────────────────────────────
 
-    // 当前 SV 速度倍率（1.0 = 正常）
+    // 当前 SV 速度倍率（1.0 = 正常，含缓动）
     float GetCurrentSVSpeed(int timeMs) const;
 
+    // SV 滚动位置积分表（加载时预计算）：音符距判定线 = pos(noteTime) - PositionAt(now)
+    const ScrollMap& GetScrollMap() const { return m_scrollMap; }
+
     // 当前 BPM
     float GetCurrentBPM(int timeMs) const;
 
@@ -99,14 +141,6 @@ public:
     // 当前难度总音符数（键盘 + 鼠标）
     int GetTotalNoteCount() const;
 
-    // 取走并清零 CheckFinished 强制 miss 的数量（供 SceneGame 同步计分）
-    int TakeForcedMisses()
-    {
-        int n = m_forcedMissCount;
-        m_forcedMissCount = 0;
-        return n;
-    }
-
 private:
     // 更新活跃音符窗口（二分查找）
     void UpdateActiveWindows();
@@ -114,18 +148,34 @@ private:
     // 检查游戏是否已完成（Update 内部调用，非 const）
     void CheckFinished();
 
+    // 将全部音符状态整体恢复为初始值（开局 / 重试）
+    void ResetNoteStates();
+
     // ── 状态 ──────────────────────────────────────────────────────────────────
     GamePhase   m_phase            = GamePhase::Idle;
     int         m_currentTimeMs    = 0;       // 当前游戏时间（毫秒）
+    double      m_currentTimeUs    = 0.0;     // 当前游戏时间（微秒）
     int         m_globalOffset     = 0;       // Config 中的全局偏移（毫秒）
     int         m_playbackStartMs  = 0;       // 本次倒计时结束后的音乐起播时间（毫秒）
     float       m_countdownTimer   = 3.0f;    // 倒计时剩余（秒）
     bool        m_musicStarted     = false;   // 音乐是否已开始
-    int         m_forcedMissCount  = 0;       // CheckFinished 强制 miss 的音符数
+
+    // ── 歌曲时钟 ──────────────────────────────────────────────────────────────
+    SongClock   m_clock;                      // 音乐位置（微秒，不含 offset）
+    float       m_clockSpeed       = 1.0f;    // 已通知 m_clock 的播放速度
+
+    // 用 SongClock 推进游戏时间（Playing 阶段每次 Update 调用）
+    void SyncClock();
+    // 当前偏移（谱面 offset + 全局 offset，微秒）
+    double GetOffsetUs() const;
 
     // ── 谱面数据 ──────────────────────────────────────────────────────────────
     ChartInfo   m_chartInfo;
-    ChartData   m_chartData;
+    ChartData   m_chartData;                  // 加载后只读
+    std::vector<NoteState> m_kbStates;        // 与 keyboardNotes 平行
+    std::vector<NoteState> m_msStates;        // 与 mouseNotes 平行
+    ScrollMap   m_scrollMap;                  // 由 svPoints 预计算
+    std::vector<NoteScrollPos> m_kbScroll;    // 与 keyboardNotes 平行
     int         m_difficultyIndex  = 0;
     double      m_musicDuration    = 0.0;     // 音乐总时长（秒）
 
@@ -143,6 +193,8 @@ private:
     // 倒计时总时长
     static constexpr float COUNTDOWN_DURATION = 3.0f;
     static constexpr int   RESUME_REWIND_MS   = 3000;
+    // 事件时间戳最多回溯 250ms（超出视为时基异常，按当前时间判定）
+    static constexpr double MAX_EVENT_AGE_US  = 250000.0;
 };
 
 } // namespace sakura::game
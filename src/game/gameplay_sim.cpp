@@ -0,0 +1,267 @@
+// gameplay_sim.cpp — 无界面确定性对局模拟实现
+
+#include "gameplay_sim.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+
+namespace sakura::game
+{
+
+namespace
+{
+
+// 确定性伪随机（LCG），保证同一 seed 在任意平台生成相同谱面 / 脚本
+struct Lcg
+{
+    uint32_t state;
+    uint32_t Next()
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+    // [0, 1)
+    double Uniform() { return static_cast<double>(Next() & 0xFFFFFFu) / 16777216.0; }
+    uint32_t Below(uint32_t n) { return Next() % n; }
+};
+
+double Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) return 0.0;
+    const size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+} // namespace
+
+// ── GenerateSyntheticChart ────────────────────────────────────────────────────
+
+ChartData GenerateSyntheticChart(const SyntheticChartOptions& options)
+{
+    ChartData chart;
+    chart.timingPoints.push_back(TimingPoint{ 0, 150.0f, 4, 4 });
+
+    const float  mouseRatio  = std::clamp(options.mouseRatio, 0.0f, 1.0f);
+    const size_t mouseTarget = static_cast<size_t>(static_cast<double>(options.noteCount) * mouseRatio);
+    const size_t kbTarget    = options.noteCount - mouseTarget;
+    const int    step        = std::max(1, options.rowStepMs);
+    Lcg rng{ options.seed };
+
+    // ── 键盘：每行 1~2 个音符，同一轨道上前一个音符（含 Hold 尾）结束 80ms 后才可再放 ──
+    constexpr int LANES = 4;
+    std::array<int, LANES> laneFreeAt{};
+    laneFreeAt.fill(0);
+    chart.keyboardNotes.reserve(kbTarget);
+    int time = 1000;
+    while (chart.keyboardNotes.size() < kbTarget)
+    {
+        const int perRow = (rng.Below(6) == 0) ? 2 : 1;
+        int lane = static_cast<int>(rng.Below(LANES));
+        for (int k = 0; k < perRow && chart.keyboardNotes.size() < kbTarget; ++k)
+        {
+            int tries = 0;
+            while (laneFreeAt[lane] > time && tries < LANES)
+            {
+                lane = (lane + 1) % LANES;
+                ++tries;
+            }
+            if (tries == LANES) break;
+
+            KeyboardNote n;
+            n.time = time;
+            n.lane = lane;
+            if (rng.Below(8) == 0)
+            {
+                n.type     = NoteType::Hold;
+                n.duration = 200 + static_cast<int>(rng.Below(5)) * 100;
+            }
+            chart.keyboardNotes.push_back(n);
+            laneFreeAt[lane] = time + n.duration + 80;
+            lane = (lane + 1 + static_cast<int>(rng.Below(LANES - 1))) % LANES;
+        }
+        time += step;
+    }
+
+    // ── 鼠标：均匀铺满键盘音符的时间跨度，Slider 在下一个鼠标音符前结束 ──────
+    if (mouseTarget > 0)
+    {
+        const int span      = std::max(time - 1000, step * static_cast<int>(mouseTarget));
+        const int mouseStep = std::max(60, span / static_cast<int>(mouseTarget));
+        chart.mouseNotes.reserve(mouseTarget);
+        for (size_t i = 0; i < mouseTarget; ++i)
+        {
+            MouseNote n;
+            n.time = 1000 + static_cast<int>(i) * mouseStep;
+            n.x    = 0.1f + 0.8f * static_cast<float>(rng.Uniform());
+            n.y    = 0.1f + 0.8f * static_cast<float>(rng.Uniform());
+            if (mouseStep >= 160 && rng.Below(3) == 0)
+            {
+                n.type           = NoteType::Slider;
+                n.sliderDuration = mouseStep - 60;
+                const int points = 2 + static_cast<int>(rng.Below(3));
+                for (int p = 0; p < points; ++p)
+                {
+                    n.sliderPath.emplace_back(0.1f + 0.8f * static_cast<float>(rng.Uniform()),
+                                              0.1f + 0.8f * static_cast<float>(rng.Uniform()));
+                }
+            }
+            chart.mouseNotes.push_back(std::move(n));
+        }
+    }
+    return chart;
+}
+
+// ── BuildAutoplayScript ───────────────────────────────────────────────────────
+
+std::vector<JudgeInput> BuildAutoplayScript(const ChartData& chart, double jitterMs, uint32_t seed)
+{
+    Lcg rng{ seed };
+    auto jitter = [&rng, jitterMs] {
+        return jitterMs > 0.0 ? (rng.Uniform() * 2.0 - 1.0) * jitterMs : 0.0;
+    };
+
+    std::vector<JudgeInput> script;
+    script.reserve(chart.keyboardNotes.size() * 2 + chart.mouseNotes.size() * 4);
+
+    for (const auto& note : chart.keyboardNotes)
+    {
+        JudgeInput down;
+        down.kind   = JudgeInput::Kind::KeyDown;
+        down.lane   = note.lane;
+        down.timeMs = note.time + jitter();
+        script.push_back(down);
+
+        // Tap 短按 30ms；Hold 按到末端
+        JudgeInput up = down;
+        up.kind   = JudgeInput::Kind::KeyUp;
+        up.timeMs = note.type == NoteType::Hold
+            ? static_cast<double>(note.time + note.duration)
+            : down.timeMs + 30.0;
+        script.push_back(up);
+    }
+
+    for (const auto& note : chart.mouseNotes)
+    {
+        const double hit = note.time + jitter();
+
+        JudgeInput move;
+        move.kind      = JudgeInput::Kind::MouseState;
+        move.x         = note.x;
+        move.y         = note.y;
+        move.mouseDown = true;
+        move.timeMs    = hit;
+        script.push_back(move);
+
+        JudgeInput click = move;
+        click.kind = JudgeInput::Kind::MouseDown;
+        script.push_back(click);
+
+        // 拐点时刻与 Judge::UpdateSliderTracking 的计算方式一致
+        const int points = static_cast<int>(note.sliderPath.size());
+        for (int k = 0; k < points; ++k)
+        {
+            const int wpTime = note.time + static_cast<int>(
+                static_cast<float>(k + 1) / static_cast<float>(points)
+                * static_cast<float>(note.sliderDuration));
+            JudgeInput wp = move;
+            wp.x      = note.sliderPath[static_cast<size_t>(k)].first;
+            wp.y      = note.sliderPath[static_cast<size_t>(k)].second;
+            wp.timeMs = wpTime;
+            script.push_back(wp);
+        }
+
+        JudgeInput release = move;
+        release.mouseDown = false;
+        release.timeMs    = (points > 0 ? note.time + note.sliderDuration : hit) + 30.0;
+        script.push_back(release);
+    }
+
+    std::stable_sort(script.begin(), script.end(),
+        [](const JudgeInput& a, const JudgeInput& b) { return a.timeMs < b.timeMs; });
+    return script;
+}
+
+// ── GameplaySimulator ─────────────────────────────────────────────────────────
+
+GameplaySimulator::GameplaySimulator(const ChartData& chart, const Judge& judge)
+{
+    m_session.Start(chart.keyboardNotes, chart.mouseNotes, judge);
+
+    bool any = false;
+    for (const auto& n : chart.keyboardNotes)
+    {
+        m_firstNoteMs   = any ? std::min(m_firstNoteMs, n.time) : n.time;
+        m_lastNoteEndMs = any ? std::max(m_lastNoteEndMs, n.time + n.duration) : n.time + n.duration;
+        any = true;
+    }
+    for (const auto& n : chart.mouseNotes)
+    {
+        m_firstNoteMs   = any ? std::min(m_firstNoteMs, n.time) : n.time;
+        m_lastNoteEndMs = any ? std::max(m_lastNoteEndMs, n.time + n.sliderDuration)
+                              : n.time + n.sliderDuration;
+        any = true;
+    }
+}
+
+SimulationReport GameplaySimulator::Run(std::span<const JudgeInput> script,
+                                        const SimulationOptions& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    m_session.Reset();
+
+    const double periodMs = 1000.0 / std::max(1.0, options.tickRateHz);
+    const double startMs  = m_firstNoteMs - options.leadInMs;
+    const double endMs    = m_lastNoteEndMs + options.leadOutMs;
+    const size_t ticks    = static_cast<size_t>(std::ceil((endMs - startMs) / periodMs)) + 1;
+
+    SimulationReport report;
+    std::vector<double> tickNs;
+    tickNs.reserve(ticks);
+
+    const uint64_t allocBefore = options.allocationCounter ? options.allocationCounter() : 0;
+    const auto     wallStart   = Clock::now();
+
+    size_t nextInput = 0;
+    for (size_t i = 0; i < ticks; ++i)
+    {
+        const double now = startMs + static_cast<double>(i) * periodMs;
+        const auto   t0  = Clock::now();
+
+        while (nextInput < script.size() && script[nextInput].timeMs <= now)
+            m_session.HandleInput(script[nextInput++]);
+        m_session.Tick(now);
+        report.events += m_session.GetEvents().size();
+        m_session.ClearEvents();
+
+        const auto t1 = Clock::now();
+        tickNs.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+
+    report.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - wallStart).count();
+    report.allocations = options.allocationCounter ? options.allocationCounter() - allocBefore : 0;
+
+    m_session.Finish();
+
+    report.ticks       = ticks;
+    report.inputs      = nextInput;
+    report.simulatedMs = static_cast<double>(ticks - 1) * periodMs;
+    report.allocationsPerTick = static_cast<double>(report.allocations) / static_cast<double>(ticks);
+
+    double sum = 0.0;
+    for (double ns : tickNs) sum += ns;
+    report.tickNsMean = sum / static_cast<double>(ticks);
+    std::sort(tickNs.begin(), tickNs.end());
+    report.tickNsP50 = Percentile(tickNs, 0.50);
+    report.tickNsP90 = Percentile(tickNs, 0.90);
+    report.tickNsP99 = Percentile(tickNs, 0.99);
+    report.tickNsMax = tickNs.back();
+
+    report.result = m_session.GetScore().GetResult(
+        "synthetic", "Synthetic", "Simulation", 0, 0.0f, report.simulatedMs / 1000.0);
+    return report;
+}
+
+} // namespace sakura::game
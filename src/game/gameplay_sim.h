@@ -0,0 +1,93 @@
+#pragma once
+
+// gameplay_sim.h — 无界面确定性对局模拟（不依赖 SDL / 音频 / 窗口）
+// 以虚拟时钟按任意 tick 频率推进 JudgeSession（Judge + ScoreCalculator 的判定核心），
+// 输入来自脚本（JudgeInput 序列）或由谱面生成的自动演奏脚本。
+// 报告每 tick 开销分位数、每 tick 堆分配次数与最终 GameResult，供基准与回归测试使用。
+// GameState 负责音乐播放与歌曲时钟（依赖 SDL / miniaudio），这里由虚拟时钟代替。
+
+#include "chart.h"
+#include "judge.h"
+#include "judge_session.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace sakura::game
+{
+
+// ── 合成谱面 ──────────────────────────────────────────────────────────────────
+
+struct SyntheticChartOptions
+{
+    size_t   noteCount  = 10000;   // 键盘 + 鼠标音符总数
+    float    mouseRatio = 0.2f;    // 鼠标音符占比
+    int      rowStepMs  = 50;      // 键盘音符行间隔（毫秒）
+    uint32_t seed       = 1;
+};
+
+// 生成按时间升序的合成谱面：键盘 Tap / Hold（含双押，同轨道不重叠）+ 鼠标 Circle / Slider
+ChartData GenerateSyntheticChart(const SyntheticChartOptions& options);
+
+// ── 输入脚本 ──────────────────────────────────────────────────────────────────
+
+// 自动演奏：每个音符在 time + 偏差处按下（偏差在 ±jitterMs 内伪随机，0 = 全部正点），
+// Hold 按到末端松开，Slider 在各拐点时刻把鼠标移到拐点。返回按 timeMs 升序的输入序列
+std::vector<JudgeInput> BuildAutoplayScript(const ChartData& chart,
+                                            double jitterMs = 0.0, uint32_t seed = 1);
+
+// ── 模拟 ──────────────────────────────────────────────────────────────────────
+
+struct SimulationOptions
+{
+    double tickRateHz = 1000.0;   // 虚拟时钟 tick 频率
+    double leadInMs   = 1000.0;   // 首个音符前的起始余量
+    double leadOutMs  = 1000.0;   // 最后一个音符结束后的余量
+    // 可选：返回进程累计堆分配次数（基准程序替换全局 operator new 后提供）
+    std::function<uint64_t()> allocationCounter;
+};
+
+struct SimulationReport
+{
+    GameResult result;
+    size_t     ticks          = 0;
+    size_t     inputs         = 0;
+    size_t     events         = 0;
+    // 每 tick 开销（纳秒，含本 tick 到期输入的处理）
+    double     tickNsMean     = 0.0;
+    double     tickNsP50      = 0.0;
+    double     tickNsP90      = 0.0;
+    double     tickNsP99      = 0.0;
+    double     tickNsMax      = 0.0;
+    // 主循环内的堆分配（未提供 allocationCounter 时为 0）
+    uint64_t   allocations    = 0;
+    double     allocationsPerTick = 0.0;
+    double     wallMs         = 0.0;   // 整个主循环的实际耗时
+    double     simulatedMs    = 0.0;   // 虚拟时钟跨度
+};
+
+class GameplaySimulator
+{
+public:
+    // chart 须在模拟器生命周期内保持有效
+    explicit GameplaySimulator(const ChartData& chart, const Judge& judge = Judge{});
+
+    // 从头运行一局：script 须按 timeMs 升序；结束时调用 JudgeSession::Finish 结算
+    SimulationReport Run(std::span<const JudgeInput> script, const SimulationOptions& options = {});
+
+    const JudgeSession& GetSession() const { return m_session; }
+
+    // 谱面时间范围（毫秒）：首个音符时间 / 最后一个音符（含 Hold、Slider 时长）结束时间
+    int GetFirstNoteMs() const { return m_firstNoteMs; }
+    int GetLastNoteEndMs() const { return m_lastNoteEndMs; }
+
+private:
+    JudgeSession     m_session;
+    int              m_firstNoteMs   = 0;
+    int              m_lastNoteEndMs = 0;
+};
+
+} // namespace sakura::game
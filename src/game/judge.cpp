@@ -18,8 +18,7 @@ static constexpr float MOUSE_HIT_TOLERANCE = 0.06f;
 void Judge::Initialize()
 {
     // 从 Config 读取判定偏移（±5ms 微调）
-    int offset = sakura::core::Config::GetInstance()
-        .Get<int>("game.judge_offset", 0);
+    int offset = sakura::core::Config::GetInstance().GetSnapshot().judgeOffsetMs;
 
     // 确保偏移在合理范围内（-5ms ~ +5ms）
     offset = std::max(-5, std::min(5, offset));
@@ -38,7 +37,7 @@ void Judge::Initialize()
 
 // ── GetResultByTimeDiff ───────────────────────────────────────────────────────
 
-JudgeResult Judge::GetResultByTimeDiff(int absDiffMs) const
+JudgeResult Judge::GetResultByTimeDiff(double absDiffMs) const
 {
     if (absDiffMs <= m_windows.perfect) return JudgeResult::Perfect;
     if (absDiffMs <= m_windows.great)   return JudgeResult::Great;
@@ -49,12 +48,12 @@ JudgeResult Judge::GetResultByTimeDiff(int absDiffMs) const
 
 // ── JudgeKeyboardNote ─────────────────────────────────────────────────────────
 
-JudgeResult Judge::JudgeKeyboardNote(KeyboardNote& note, int hitTimeMs)
+JudgeResult Judge::JudgeKeyboardNote(const KeyboardNote& note, NoteState& state, double hitTimeMs)
 {
-    if (note.isJudged) return JudgeResult::None;
+    if (state.isJudged) return JudgeResult::None;
 
-    int diff    = hitTimeMs - note.time;
-    int absDiff = std::abs(diff);
+    double diff    = hitTimeMs - note.time;
+    double absDiff = std::abs(diff);
 
     // 只接受在 Miss 窗口内的按下（太早不判定）
     if (diff < -m_windows.miss) return JudgeResult::None;
@@ -64,8 +63,8 @@ JudgeResult Judge::JudgeKeyboardNote(KeyboardNote& note, int hitTimeMs)
     // Tap 音符：直接标记判定完成
     if (note.type == NoteType::Tap || note.type == NoteType::Circle)
     {
-        note.isJudged = true;
-        note.result   = result;
+        state.isJudged = true;
+        state.result   = result;
     }
     // Hold：只判定头部（后续由 UpdateHoldTick 处理）
     // 调用方需要据此创建 HoldState
@@ -77,20 +76,21 @@ JudgeResult Judge::JudgeKeyboardNote(KeyboardNote& note, int hitTimeMs)
 
 // ── JudgeMouseNote ────────────────────────────────────────────────────────────
 
-JudgeResult Judge::JudgeMouseNote(MouseNote& note, int hitTimeMs, float hitX, float hitY)
+JudgeResult Judge::JudgeMouseNote(const MouseNote& note, NoteState& state,
+                                  double hitTimeMs, float hitX, float hitY)
 {
-    if (note.isJudged) return JudgeResult::None;
+    if (state.isJudged) return JudgeResult::None;
 
     // 时间判定
-    int diff    = hitTimeMs - note.time;
-    int absDiff = std::abs(diff);
+    double diff    = hitTimeMs - note.time;
+    double absDiff = std::abs(diff);
     if (diff < -m_windows.miss) return JudgeResult::None;
 
     JudgeResult timeResult = GetResultByTimeDiff(absDiff);
     if (timeResult == JudgeResult::Miss)
     {
-        note.isJudged = true;
-        note.result   = JudgeResult::Miss;
+        state.isJudged = true;
+        state.result   = JudgeResult::Miss;
         return JudgeResult::Miss;
     }
 
@@ -108,8 +108,8 @@ JudgeResult Judge::JudgeMouseNote(MouseNote& note, int hitTimeMs, float hitX, fl
     // Circle：直接完成
     if (note.type == NoteType::Circle)
     {
-        note.isJudged = true;
-        note.result   = timeResult;
+        state.isJudged = true;
+        state.result   = timeResult;
     }
     // Slider：头部判定（路径跟踪由 UpdateSliderTracking 处理）
 
@@ -125,20 +125,22 @@ float Judge::GetMouseHitTolerance(const MouseNote& note)
 
 // ── CheckMisses ───────────────────────────────────────────────────────────────
 
-int Judge::CheckMisses(std::vector<KeyboardNote>& notes, int currentTimeMs)
+int Judge::CheckMisses(std::span<const KeyboardNote> notes, std::span<NoteState> states, int currentTimeMs)
 {
     int missCount = 0;
+    const size_t count = std::min(notes.size(), states.size());
 
-    for (auto& note : notes)
+    for (size_t i = 0; i < count; ++i)
     {
-        if (note.isJudged) continue;
+        auto& state = states[i];
+        if (state.isJudged) continue;
 
         // Hold 音符头部超时检查
-        int diff = currentTimeMs - note.time;
+        int diff = currentTimeMs - notes[i].time;
         if (diff > m_windows.miss)
         {
-            note.isJudged = true;
-            note.result   = JudgeResult::Miss;
+            state.isJudged = true;
+            state.result   = JudgeResult::Miss;
             ++missCount;
         }
     }
@@ -146,18 +148,22 @@ int Judge::CheckMisses(std::vector<KeyboardNote>& notes, int currentTimeMs)
     return missCount;
 }
 
-int Judge::CheckMouseMisses(std::vector<MouseNote>& notes, int currentTimeMs)
+int Judge::CheckMouseMisses(std::span<const MouseNote> notes, std::span<NoteState> states, int currentTimeMs)
 {
     int missCount = 0;
-    for (auto& note : notes)
+    const size_t count = std::min(notes.size(), states.size());
+
+    for (size_t i = 0; i < count; ++i)
     {
-        if (note.isJudged) continue;
+        auto& state = states[i];
+        if (state.isJudged) continue;
 
+        const auto& note = notes[i];
         int diff = currentTimeMs - note.time;
         if (diff > m_windows.miss)
         {
-            note.isJudged = true;
-            note.result   = JudgeResult::Miss;
+            state.isJudged = true;
+            state.result   = JudgeResult::Miss;
             ++missCount;
             // Slider 头部未被点击：拐点同样算作 Miss
             if (note.type == NoteType::Slider)
@@ -167,6 +173,58 @@ int Judge::CheckMouseMisses(std::vector<MouseNote>& notes, int currentTimeMs)
     return missCount;
 }
 
+// ── SweepMisses ───────────────────────────────────────────────────────────────
+
+int Judge::SweepMisses(std::span<const KeyboardNote> notes, std::span<NoteState> states,
+                       int currentTimeMs, MissCursor& cursor,
+                       std::vector<uint32_t>* missed) const
+{
+    int missCount = 0;
+    const size_t count = std::min(notes.size(), states.size());
+
+    for (; cursor.next < count; ++cursor.next)
+    {
+        const size_t i = cursor.next;
+        if (currentTimeMs - notes[i].time <= m_windows.miss) break;
+
+        auto& state = states[i];
+        if (state.isJudged) continue;
+
+        state.isJudged = true;
+        state.result   = JudgeResult::Miss;
+        ++missCount;
+        if (missed) missed->push_back(static_cast<uint32_t>(i));
+    }
+    return missCount;
+}
+
+int Judge::SweepMouseMisses(std::span<const MouseNote> notes, std::span<NoteState> states,
+                            int currentTimeMs, MissCursor& cursor,
+                            std::vector<uint32_t>* missed) const
+{
+    int missCount = 0;
+    const size_t count = std::min(notes.size(), states.size());
+
+    for (; cursor.next < count; ++cursor.next)
+    {
+        const size_t i = cursor.next;
+        const auto& note = notes[i];
+        if (currentTimeMs - note.time <= m_windows.miss) break;
+
+        auto& state = states[i];
+        if (state.isJudged) continue;
+
+        state.isJudged = true;
+        state.result   = JudgeResult::Miss;
+        ++missCount;
+        // Slider 头部未被点击：拐点同样算作 Miss
+        if (note.type == NoteType::Slider)
+            missCount += static_cast<int>(note.sliderPath.size());
+        if (missed) missed->push_back(static_cast<uint32_t>(i));
+    }
+    return missCount;
+}
+
 // ── UpdateHoldTick ────────────────────────────────────────────────────────────
 //
 // 新逻辑（无 tick）：
@@ -347,4 +405,9 @@ int Judge::GetHitError(int noteTime, int hitTime)
     return noteTime - hitTime;
 }
 
+double Judge::GetHitError(int noteTime, double hitTimeMs)
+{
+    return static_cast<double>(noteTime) - hitTimeMs;
+}
+
 } // namespace sakura::game
@@ -4,6 +4,8 @@
 // 处理所有类型音符的判定逻辑
 
 #include "note.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <span>
 
@@ -38,6 +40,16 @@ struct HoldState
     // 注意：无 tick 系统，UpdateHoldTick 负责最终判定
 };
 
+// ── 增量 Miss 扫描游标 ────────────────────────────────────────────────────────
+
+// 每条音符流（键盘 / 鼠标）一个游标，指向下一个 Miss 期限尚未越过的音符。
+// 音符按 time 升序，期限 = time + miss 窗口同样单调，因此全谱面只需一个游标，
+// 不必按轨道拆分；开局 / 重试时与 NoteState 一同归零。
+struct MissCursor
+{
+    size_t next = 0;
+};
+
 // ── Slider 判定状态 ───────────────────────────────────────────────────────────
 
 struct SliderState
@@ -72,13 +84,14 @@ public:
 
     // ── 普通按键判定 ──────────────────────────────────────────────────────────
 
-    // 键盘音符判定（Tap/Hold 头部）
-    // hitTimeMs: 玩家按下时刻（游戏时间，毫秒）
-    JudgeResult JudgeKeyboardNote(KeyboardNote& note, int hitTimeMs);
+    // 键盘音符判定（Tap/Hold 头部）；判定结果写入 state，note 只读
+    // hitTimeMs: 玩家按下时刻（游戏时间，毫秒，可带小数：来自 SongClock 的亚毫秒时间）
+    JudgeResult JudgeKeyboardNote(const KeyboardNote& note, NoteState& state, double hitTimeMs);
 
     // 鼠标音符判定（Circle/Slider头部）
     // hitX, hitY: 鼠标点击位置（鼠标区域内的归一化坐标 0~1）
-    JudgeResult JudgeMouseNote(MouseNote& note, int hitTimeMs, float hitX, float hitY);
+    JudgeResult JudgeMouseNote(const MouseNote& note, NoteState& state,
+                               double hitTimeMs, float hitX, float hitY);
 
     // 获取鼠标音符头部点击容差（鼠标区域内归一化距离）
     static float GetMouseHitTolerance(const MouseNote& note);
@@ -86,10 +99,23 @@ public:
     // ── 自动 Miss 检测 ────────────────────────────────────────────────────────
 
     // 检查并标记所有超时未判定的键盘音符为 Miss
+    // notes 与 states 按下标平行（长度须一致），只写 states
     // currentTimeMs: 当前游戏时间
     // 返回本次新增 Miss 数量
-    int CheckMisses(std::vector<KeyboardNote>& notes, int currentTimeMs);
-    int CheckMouseMisses(std::vector<MouseNote>& notes, int currentTimeMs);
+    // 全量扫描，适用于小数组或未排序数据；游戏内每帧请使用 SweepMisses
+    int CheckMisses(std::span<const KeyboardNote> notes, std::span<NoteState> states, int currentTimeMs);
+    int CheckMouseMisses(std::span<const MouseNote> notes, std::span<NoteState> states, int currentTimeMs);
+
+    // 增量扫描：仅检查游标之后、Miss 期限已越过的音符，游标随之前进，
+    // 每帧开销只与本帧新越过期限的音符数有关，与谱面长度无关。
+    // notes 须按 time 升序；新 Miss 音符的下标追加到 missed（可为 nullptr），
+    // 供场景按轨道 / 位置显示判定闪现。返回值含义与 CheckMisses 相同。
+    int SweepMisses(std::span<const KeyboardNote> notes, std::span<NoteState> states,
+                    int currentTimeMs, MissCursor& cursor,
+                    std::vector<uint32_t>* missed = nullptr) const;
+    int SweepMouseMisses(std::span<const MouseNote> notes, std::span<NoteState> states,
+                         int currentTimeMs, MissCursor& cursor,
+                         std::vector<uint32_t>* missed = nullptr) const;
 
     // ── Hold 持续判定 ─────────────────────────────────────────────────────────
 
@@ -121,12 +147,14 @@ public:
     // ── 偏差计算 ──────────────────────────────────────────────────────────────
 
     // 返回判定偏差（毫秒）：正值 = 偏早，负值 = 偏晚
-    static int GetHitError(int noteTime, int hitTime);
+    static int    GetHitError(int noteTime, int hitTime);
+    // 亚毫秒版本（hitTimeMs 来自 GameState::GetCurrentTimeMsPrecise）
+    static double GetHitError(int noteTime, double hitTimeMs);
 
     // ── 工具 ──────────────────────────────────────────────────────────────────
 
     // 根据时间差（绝对值毫秒）返回判定结果
-    JudgeResult GetResultByTimeDiff(int absDiffMs) const;
+    JudgeResult GetResultByTimeDiff(double absDiffMs) const;
 
 private:
     JudgeWindows m_windows;
@@ -0,0 +1,89 @@
+// judge_queue.cpp — 按轨道索引的待判定队列实现
+
+#include "judge_queue.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace sakura::game
+{
+
+// ── Build / Reset ─────────────────────────────────────────────────────────────
+
+void LaneJudgeQueue::Build(std::span<const KeyboardNote> notes)
+{
+    int laneCount = 0;
+    for (const auto& note : notes)
+        laneCount = std::max(laneCount, note.lane + 1);
+
+    m_lanes.assign(static_cast<size_t>(laneCount), {});
+    m_cursors.assign(static_cast<size_t>(laneCount), 0);
+
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        if (notes[i].lane < 0) continue;
+        m_lanes[static_cast<size_t>(notes[i].lane)].push_back(static_cast<uint32_t>(i));
+    }
+}
+
+void LaneJudgeQueue::Reset()
+{
+    std::fill(m_cursors.begin(), m_cursors.end(), 0);
+}
+
+// ── FindNearest ───────────────────────────────────────────────────────────────
+//
+// 游标只跨过已判定的音符，判定状态在一局内不会回退，因此游标单调前进，
+// 每个音符最多被跨过一次。游标之后按时间升序扫描，一旦 note.time - timeMs
+// 不小于当前最佳距离即可停止（后面的音符只会更远）。
+//
+int LaneJudgeQueue::FindNearest(int lane, int timeMs, int maxAheadMs,
+                                std::span<const KeyboardNote> notes,
+                                std::span<const NoteState> states)
+{
+    if (lane < 0 || lane >= GetLaneCount()) return -1;
+
+    const auto& queue  = m_lanes[static_cast<size_t>(lane)];
+    size_t&     cursor = m_cursors[static_cast<size_t>(lane)];
+
+    while (cursor < queue.size() && states[queue[cursor]].isJudged)
+        ++cursor;
+
+    const int latestTime = timeMs + maxAheadMs;
+    int bestIdx  = -1;
+    int bestDist = INT_MAX;
+
+    for (size_t k = cursor; k < queue.size(); ++k)
+    {
+        const uint32_t idx  = queue[k];
+        const auto&    note = notes[idx];
+        if (note.time > latestTime)        break;
+        if (note.time - timeMs >= bestDist) break;
+        if (states[idx].isJudged)          continue;
+
+        int dist = std::abs(note.time - timeMs);
+        if (dist < bestDist)
+        {
+            bestDist = dist;
+            bestIdx  = static_cast<int>(idx);
+        }
+    }
+    return bestIdx;
+}
+
+// ── 查询 ──────────────────────────────────────────────────────────────────────
+
+size_t LaneJudgeQueue::GetLaneSize(int lane) const
+{
+    if (lane < 0 || lane >= GetLaneCount()) return 0;
+    return m_lanes[static_cast<size_t>(lane)].size();
+}
+
+size_t LaneJudgeQueue::GetLaneCursor(int lane) const
+{
+    if (lane < 0 || lane >= GetLaneCount()) return 0;
+    return m_cursors[static_cast<size_t>(lane)];
+}
+
+} // namespace sakura::game
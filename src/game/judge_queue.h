@@ -0,0 +1,45 @@
+#pragma once
+
+// judge_queue.h — 按轨道索引的待判定队列
+// 开局时把键盘音符按轨道拆成各自的下标队列（保持时间升序），每条轨道维护一个游标：
+// 游标之前的音符均已判定，按键时只需从游标向后查看少量音符即可找到最近的未判定音符，
+// 不再扫描整个活跃窗口。返回值是 ChartData::keyboardNotes 中的全局下标，
+// 整局内保持不变，可直接写入 HoldState::noteIndex。
+
+#include "note.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sakura::game
+{
+
+class LaneJudgeQueue
+{
+public:
+    // 按轨道拆分音符下标；notes 须按 time 升序（ChartLoader 已保证）。
+    // lane < 0 的音符不进入任何队列（与旧逻辑一致：永远无法被按键命中）
+    void Build(std::span<const KeyboardNote> notes);
+
+    // 游标归零（重试时状态数组整体重置后调用）
+    void Reset();
+
+    // 查找 lane 上距 timeMs 最近的未判定音符，只考虑 time <= timeMs + maxAheadMs 的音符；
+    // 距离相同时取较早的音符。找不到返回 -1。
+    // notes / states 与 Build 时的音符数组按下标平行。
+    int FindNearest(int lane, int timeMs, int maxAheadMs,
+                    std::span<const KeyboardNote> notes,
+                    std::span<const NoteState> states);
+
+    int    GetLaneCount() const { return static_cast<int>(m_lanes.size()); }
+    size_t GetLaneSize(int lane) const;
+    // lane 上第一个可能未判定音符在队列中的位置（测试 / 调试用）
+    size_t GetLaneCursor(int lane) const;
+
+private:
+    std::vector<std::vector<uint32_t>> m_lanes;    // 每条轨道的音符全局下标（时间升序）
+    std::vector<size_t>                m_cursors;  // 每条轨道的首个未判定位置
+};
+
+} // namespace sakura::game
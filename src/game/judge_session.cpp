@@ -0,0 +1,465 @@
+// judge_session.cpp — 单局判定核心实现
+
+#include "judge_session.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+namespace sakura::game
+{
+
+namespace
+{
+
+// 将判定结果映射为点击选 note 时的优先级：值越小表示时间判定越好。
+int JudgePriority(JudgeResult result)
+{
+    switch (result)
+    {
+    case JudgeResult::Perfect: return 0;
+    case JudgeResult::Great:   return 1;
+    case JudgeResult::Good:    return 2;
+    case JudgeResult::Bad:     return 3;
+    case JudgeResult::Miss:    return 4;
+    default:                   return 5;
+    }
+}
+
+} // namespace
+
+// ── Start / Reset ─────────────────────────────────────────────────────────────
+
+void JudgeSession::Start(std::span<const KeyboardNote> kbNotes,
+                         std::span<const MouseNote>    msNotes,
+                         const Judge& judge)
+{
+    m_kbNotes = kbNotes;
+    m_msNotes = msNotes;
+    m_judge   = judge;
+    m_kbLaneQueue.Build(kbNotes);
+    Reset();
+}
+
+void JudgeSession::Reset()
+{
+    m_kbStates.assign(m_kbNotes.size(), NoteState{});
+    m_msStates.assign(m_msNotes.size(), NoteState{});
+    m_kbLaneQueue.Reset();
+    m_kbMissCursor = {};
+    m_msMissCursor = {};
+    m_holdStates.clear();
+    m_sliderStates.clear();
+
+    const size_t lanes = static_cast<size_t>(m_kbLaneQueue.GetLaneCount());
+    m_laneDownMs.assign(lanes, -DBL_MAX);
+    m_laneUpMs.assign(lanes, -DBL_MAX);
+    m_mouseX = m_mouseY = 0.0f;
+    m_mouseDown  = false;
+    m_lastTickMs = 0.0;
+    m_events.clear();
+
+    // 总判定数：键盘音符各 1 次；鼠标音符头部 1 次，Slider 每个拐点再各 1 次
+    int total = static_cast<int>(m_kbNotes.size());
+    for (const auto& n : m_msNotes)
+    {
+        ++total;
+        if (n.type == NoteType::Slider)
+            total += static_cast<int>(n.sliderPath.size());
+    }
+    m_score.Initialize(total);
+}
+
+// ── Emit ──────────────────────────────────────────────────────────────────────
+
+void JudgeSession::Emit(JudgeEvent ev, int judgements)
+{
+    if (judgements > 0)
+    {
+        m_score.OnJudge(ev.result, ev.hitErrorMs);
+        // Slider 头部超时：未走的拐点一并计为 Miss
+        for (int i = 1; i < judgements; ++i)
+            m_score.OnJudge(JudgeResult::Miss, 0);
+    }
+    ev.score    = m_score.GetScore();
+    ev.combo    = m_score.GetCombo();
+    ev.accuracy = m_score.GetAccuracy();
+    m_events.push_back(ev);
+}
+
+// ── HandleInput ───────────────────────────────────────────────────────────────
+
+void JudgeSession::HandleInput(const JudgeInput& input)
+{
+    switch (input.kind)
+    {
+    case JudgeInput::Kind::KeyDown:   OnKeyDown(input.lane, input.timeMs); break;
+    case JudgeInput::Kind::KeyUp:     OnKeyUp(input.lane, input.timeMs);   break;
+    case JudgeInput::Kind::MouseDown: OnMouseDown(input.x, input.y, input.timeMs); break;
+    case JudgeInput::Kind::MouseState:
+        m_mouseX    = input.x;
+        m_mouseY    = input.y;
+        m_mouseDown = input.mouseDown;
+        break;
+    default:
+        break;
+    }
+}
+
+void JudgeSession::OnKeyDown(int lane, double timeMs)
+{
+    if (lane < 0 || lane >= m_kbLaneQueue.GetLaneCount()) return;
+    auto& downMs = m_laneDownMs[static_cast<size_t>(lane)];
+    downMs = std::max(downMs, timeMs);
+
+    // 按轨道队列取最近的未判定音符（游标推进，均摊 O(1)）
+    const int now     = static_cast<int>(std::floor(timeMs));
+    const int bestIdx = m_kbLaneQueue.FindNearest(lane, now, CANDIDATE_AHEAD_MS,
+                                                  m_kbNotes, m_kbStates);
+    if (bestIdx < 0) return;
+
+    const auto& note   = m_kbNotes[static_cast<size_t>(bestIdx)];
+    auto&       state  = m_kbStates[static_cast<size_t>(bestIdx)];
+    const auto  result = m_judge.JudgeKeyboardNote(note, state, timeMs);
+    if (result == JudgeResult::None) return;
+
+    if (note.type == NoteType::Hold && result != JudgeResult::Miss)
+    {
+        // 立即标记 isJudged=true（防 Miss 扫描误判），result 留 None 等 Hold 结束
+        state.isJudged = true;
+        state.result   = JudgeResult::None;
+
+        HoldState hs;
+        hs.noteIndex      = bestIdx;
+        hs.isHeld         = true;
+        hs.headJudged     = true;
+        hs.headResult     = result;
+        hs.lastHeldTimeMs = now;
+        m_holdStates.push_back(hs);
+    }
+
+    JudgeEvent ev;
+    ev.kind       = JudgeEventKind::Hit;
+    ev.result     = result;
+    ev.noteResult = state.result;
+    ev.isKeyboard = true;
+    ev.lane       = note.lane;
+    ev.noteIndex  = static_cast<uint32_t>(bestIdx);
+    ev.timeMs     = timeMs;
+    ev.hitErrorMs = Judge::GetHitError(note.time, timeMs);
+    Emit(ev);
+}
+
+void JudgeSession::OnKeyUp(int lane, double timeMs)
+{
+    if (lane < 0 || lane >= m_kbLaneQueue.GetLaneCount()) return;
+    auto& upMs = m_laneUpMs[static_cast<size_t>(lane)];
+    upMs = std::max(upMs, timeMs);
+    if (IsLaneHeld(static_cast<size_t>(lane))) return;   // 之后又按下过（乱序到达）
+
+    // 该轨道上进行中的 Hold 记录松开时刻
+    const int releaseMs = static_cast<int>(std::floor(timeMs));
+    for (auto& hs : m_holdStates)
+    {
+        if (m_kbNotes[static_cast<size_t>(hs.noteIndex)].lane == lane && hs.isHeld)
+        {
+            hs.isHeld        = false;
+            hs.releaseTimeMs = releaseMs;
+        }
+    }
+}
+
+void JudgeSession::OnMouseDown(float x, float y, double timeMs)
+{
+    // 超出鼠标区域
+    if (x < 0.0f || x > 1.0f || y < 0.0f || y > 1.0f) return;
+
+    const int now  = static_cast<int>(std::floor(timeMs));
+    const int miss = m_judge.GetWindows().miss;
+
+    // 优先选取时间判定最好、其次空间距离最近的未判定音符
+    // （鼠标区音符分布在二维空间，空间优先比时间优先更准确）。
+    // Miss 游标之前的音符均已判定，从游标开始扫描到 time > now + miss 为止
+    int   bestIdx      = -1;
+    int   bestPriority = INT_MAX;
+    float bestDist     = FLT_MAX;
+    int   bestTDist    = INT_MAX;
+    for (size_t i = m_msMissCursor.next; i < m_msNotes.size(); ++i)
+    {
+        const auto& n = m_msNotes[i];
+        if (n.time - now > miss) break;
+        if (m_msStates[i].isJudged) continue;
+
+        // 排除已经彻底过期的音符，避免点击被已经 Miss 的音符抢走
+        const int timeDiff = now - n.time;
+        if (timeDiff > miss) continue;
+
+        const float dx   = x - n.x;
+        const float dy   = y - n.y;
+        const float dist = std::sqrt(dx * dx + dy * dy);
+        if (dist > Judge::GetMouseHitTolerance(n)) continue;
+
+        const int absT     = std::abs(timeDiff);
+        const int priority = JudgePriority(m_judge.GetResultByTimeDiff(absT));
+
+        // 仅在点击真正落入音符头部范围后再比较优先级：
+        // 先取时间判定更好的目标，再用空间距离/时间差打破平局。
+        if (priority < bestPriority ||
+            (priority == bestPriority &&
+             (dist < bestDist - 1e-4f ||
+              (dist < bestDist + 1e-4f && absT < bestTDist))))
+        {
+            bestPriority = priority;
+            bestDist     = dist;
+            bestTDist    = absT;
+            bestIdx      = static_cast<int>(i);
+        }
+    }
+    if (bestIdx < 0) return;
+
+    const auto& note   = m_msNotes[static_cast<size_t>(bestIdx)];
+    auto&       state  = m_msStates[static_cast<size_t>(bestIdx)];
+    const auto  result = m_judge.JudgeMouseNote(note, state, timeMs, x, y);
+
+    // None 表示点击未命中音符（距离过远或时间太早），不产生任何反馈
+    if (result == JudgeResult::None) return;
+
+    if (note.type == NoteType::Slider && result != JudgeResult::Miss)
+    {
+        // 标记音符已判定（防止 Miss 扫描在 Slider 进行中误判），
+        // result 暂置 None，所有拐点判定完毕后填入终判结果
+        state.isJudged = true;
+        state.result   = JudgeResult::None;
+
+        SliderState ss;
+        ss.noteIndex  = bestIdx;
+        ss.headJudged = true;
+        ss.headResult = result;
+        m_sliderStates.push_back(ss);
+    }
+
+    JudgeEvent ev;
+    ev.kind       = JudgeEventKind::Hit;
+    ev.result     = result;
+    ev.noteResult = state.result;
+    ev.isKeyboard = false;
+    ev.x          = note.x;
+    ev.y          = note.y;
+    ev.noteIndex  = static_cast<uint32_t>(bestIdx);
+    ev.timeMs     = timeMs;
+    ev.hitErrorMs = Judge::GetHitError(note.time, timeMs);
+    Emit(ev);
+}
+
+// ── Tick ──────────────────────────────────────────────────────────────────────
+
+void JudgeSession::Tick(double nowMs, double inputMs)
+{
+    m_lastTickMs  = nowMs;
+    const int now = static_cast<int>(std::floor(nowMs));
+
+    // 依赖“此前没有按下 / 松开”的判定不越过输入水位
+    const double judgedMs = std::min(nowMs, inputMs);
+    const int    judged   = static_cast<int>(std::floor(judgedMs));
+
+    // ── 自动 Miss（增量游标，只处理刚越过 Miss 期限的音符）────────────────────
+    m_missedKb.clear();
+    m_missedMs.clear();
+    m_judge.SweepMisses(m_kbNotes, m_kbStates, judged, m_kbMissCursor, &m_missedKb);
+    m_judge.SweepMouseMisses(m_msNotes, m_msStates, judged, m_msMissCursor, &m_missedMs);
+
+    for (uint32_t idx : m_missedKb)
+    {
+        JudgeEvent ev;
+        ev.kind       = JudgeEventKind::Miss;
+        ev.result     = JudgeResult::Miss;
+        ev.noteResult = JudgeResult::Miss;
+        ev.isKeyboard = true;
+        ev.lane       = m_kbNotes[idx].lane;
+        ev.noteIndex  = idx;
+        ev.timeMs     = judgedMs;
+        Emit(ev);
+    }
+    for (uint32_t idx : m_missedMs)
+    {
+        const auto& note = m_msNotes[idx];
+        JudgeEvent ev;
+        ev.kind       = JudgeEventKind::Miss;
+        ev.result     = JudgeResult::Miss;
+        ev.noteResult = JudgeResult::Miss;
+        ev.isKeyboard = false;
+        ev.x          = note.x;
+        ev.y          = note.y;
+        ev.noteIndex  = idx;
+        ev.timeMs     = judgedMs;
+        const int waypoints = note.type == NoteType::Slider
+            ? static_cast<int>(note.sliderPath.size()) : 0;
+        Emit(ev, 1 + waypoints);
+    }
+
+    UpdateHolds(judged);
+    UpdateSliders(now);
+}
+
+// ── Hold 持续判定 ─────────────────────────────────────────────────────────────
+
+void JudgeSession::UpdateHolds(int now)
+{
+    for (auto it = m_holdStates.begin(); it != m_holdStates.end(); )
+    {
+        auto&       hs   = *it;
+        const auto& note = m_kbNotes[static_cast<size_t>(hs.noteIndex)];
+        const size_t lane = static_cast<size_t>(note.lane);
+
+        // 按键短断触滤波：短时间掉键不立即视为松开
+        if (IsLaneHeld(lane))
+        {
+            hs.isHeld         = true;
+            hs.lastHeldTimeMs = now;
+            hs.releaseTimeMs  = -1;
+        }
+        else
+        {
+            // 优先使用松开事件的真实时刻，Tick 时刻只作兜底
+            if (hs.releaseTimeMs < 0)
+                hs.releaseTimeMs = (m_laneUpMs[lane] > -DBL_MAX)
+                    ? static_cast<int>(std::floor(m_laneUpMs[lane])) : now;
+
+            const bool withinGapTolerance = (hs.lastHeldTimeMs >= 0) &&
+                (now - hs.lastHeldTimeMs <= HoldState::INPUT_GAP_TOLERANCE_MS);
+            hs.isHeld = withinGapTolerance;
+            if (withinGapTolerance)
+                hs.releaseTimeMs = -1;
+        }
+
+        const auto tickResult = m_judge.UpdateHoldTick(hs, note, now);
+        if (tickResult != JudgeResult::None)
+        {
+            // 写入终判结果（覆盖占位的 None）
+            m_kbStates[static_cast<size_t>(hs.noteIndex)].result = tickResult;
+
+            JudgeEvent ev;
+            ev.kind       = JudgeEventKind::HoldEnd;
+            ev.result     = tickResult;
+            ev.noteResult = tickResult;
+            ev.isKeyboard = true;
+            ev.lane       = note.lane;
+            ev.noteIndex  = static_cast<uint32_t>(hs.noteIndex);
+            ev.timeMs     = now;
+            Emit(ev);
+        }
+
+        // finalized 置位后移除（由 UpdateHoldTick 内部设置）
+        if (hs.finalized)
+            it = m_holdStates.erase(it);
+        else
+            ++it;
+    }
+}
+
+// ── Slider 路径追踪 ───────────────────────────────────────────────────────────
+
+void JudgeSession::UpdateSliders(int now)
+{
+    for (auto it = m_sliderStates.begin(); it != m_sliderStates.end(); )
+    {
+        auto&       ss   = *it;
+        const auto& note = m_msNotes[static_cast<size_t>(ss.noteIndex)];
+
+        if (m_mouseDown)
+            ss.lastDownTimeMs = now;
+        const bool filteredMouseDown = m_mouseDown ||
+            (ss.lastDownTimeMs >= 0 &&
+             now - ss.lastDownTimeMs <= SliderState::INPUT_GAP_TOLERANCE_MS);
+
+        const auto sResult = m_judge.UpdateSliderTracking(
+            ss, note, now, m_mouseX, m_mouseY, filteredMouseDown);
+
+        // 拐点判定：UpdateSliderTracking 判定后已 ++nextWaypointIndex，减 1 还原
+        if (sResult != JudgeResult::None)
+        {
+            const int judgedIdx = ss.nextWaypointIndex - 1;
+            JudgeEvent ev;
+            ev.kind       = JudgeEventKind::SliderTick;
+            ev.result     = sResult;
+            ev.noteResult = JudgeResult::None;
+            ev.isKeyboard = false;
+            ev.noteIndex  = static_cast<uint32_t>(ss.noteIndex);
+            ev.waypoint   = judgedIdx;
+            ev.timeMs     = now;
+            if (judgedIdx >= 0 && judgedIdx < static_cast<int>(note.sliderPath.size()))
+            {
+                ev.x = note.sliderPath[static_cast<size_t>(judgedIdx)].first;
+                ev.y = note.sliderPath[static_cast<size_t>(judgedIdx)].second;
+            }
+            Emit(ev);
+        }
+
+        // 所有拐点判定完毕 → 填入终判结果，移除状态
+        if (ss.finalized)
+        {
+            auto& state  = m_msStates[static_cast<size_t>(ss.noteIndex)];
+            state.result = ss.isMissed ? JudgeResult::Miss : ss.headResult;
+
+            JudgeEvent ev;
+            ev.kind       = JudgeEventKind::SliderEnd;
+            ev.noteResult = state.result;
+            ev.isKeyboard = false;
+            ev.x          = note.x;
+            ev.y          = note.y;
+            ev.noteIndex  = static_cast<uint32_t>(ss.noteIndex);
+            ev.timeMs     = now;
+            Emit(ev, 0);
+            it = m_sliderStates.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+// ── Finish ────────────────────────────────────────────────────────────────────
+
+void JudgeSession::Finish()
+{
+    // 音乐结束时 Slider 可能仍在进行中：未完成的拐点计为 Miss
+    for (const auto& ss : m_sliderStates)
+    {
+        const auto& note = m_msNotes[static_cast<size_t>(ss.noteIndex)];
+        const int remaining = static_cast<int>(note.sliderPath.size()) - ss.nextWaypointIndex;
+        for (int i = 0; i < remaining; ++i)
+            m_score.OnJudge(JudgeResult::Miss, 0);
+    }
+    m_sliderStates.clear();
+    m_holdStates.clear();
+
+    // 仍未判定的音符强制判为 Miss（Miss 游标之前的音符均已判定）
+    for (size_t i = m_kbMissCursor.next; i < m_kbStates.size(); ++i)
+    {
+        auto& state = m_kbStates[i];
+        if (state.isJudged) continue;
+        state.isJudged = true;
+        state.result   = JudgeResult::Miss;
+        m_score.OnJudge(JudgeResult::Miss, 0);
+    }
+    for (size_t i = m_msMissCursor.next; i < m_msStates.size(); ++i)
+    {
+        auto& state = m_msStates[i];
+        if (state.isJudged) continue;
+        state.isJudged = true;
+        state.result   = JudgeResult::Miss;
+        m_score.OnJudge(JudgeResult::Miss, 0);
+        // Slider 头部未被点击时，拐点也算强制 Miss
+        const auto& n = m_msNotes[i];
+        if (n.type == NoteType::Slider)
+            for (size_t w = 0; w < n.sliderPath.size(); ++w)
+                m_score.OnJudge(JudgeResult::Miss, 0);
+    }
+    m_kbMissCursor.next = m_kbStates.size();
+    m_msMissCursor.next = m_msStates.size();
+}
+
+} // namespace sakura::game
@@ -0,0 +1,161 @@
+#pragma once
+
+// judge_session.h — 单局判定核心（不依赖 SDL）
+// 把原先散落在 SceneGame::OnUpdate 中的按键 / 点击判定、增量 Miss 扫描、
+// Hold 持续判定、Slider 路径追踪与计分收拢到一处，自身持有权威的 NoteState 数组。
+// 输入以 JudgeInput（已映射到游戏时间的按下 / 松开 / 鼠标状态）喂入，
+// 每次判定产生一条 JudgeEvent 追加到事件列表，由调用方取走：
+//   - 同步模式：SceneGame 在主线程直接调用，取走事件后立即处理
+//   - 线程模式：JudgeThread 以约 1kHz 调用，事件经无锁队列交给主线程
+// 场景据事件更新显示用 NoteState、判定闪现、粒子与音效；分数以事件携带的快照显示。
+
+#include "chart.h"
+#include "judge.h"
+#include "judge_queue.h"
+#include "note.h"
+#include "score.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace sakura::game
+{
+
+// ── 判定输入 ──────────────────────────────────────────────────────────────────
+
+struct JudgeInput
+{
+    enum class Kind : uint8_t
+    {
+        KeyDown,     // 轨道按下（lane, timeMs）
+        KeyUp,       // 轨道松开（lane, timeMs）
+        MouseDown,   // 左键点击（x, y 为鼠标区归一化坐标）
+        MouseState,  // 鼠标位置 + 左键是否按住（Slider 追踪用，每帧一次）
+        Clock        // 歌曲时钟同步（仅 JudgeThread 使用，见 judge_thread.h）
+    };
+
+    Kind   kind      = Kind::KeyDown;
+    bool   mouseDown = false;  // MouseState: 左键按住；Clock: 是否处于 Playing
+    int    lane      = -1;
+    float  x         = 0.0f;
+    float  y         = 0.0f;
+    double timeMs    = 0.0;    // 输入发生的游戏时间（毫秒，亚毫秒精度）
+    double hostUs    = 0.0;    // Clock: 采样时的主机时间（微秒）
+    double inputUs   = 0.0;    // Clock: 主线程已泵取输入截至的主机时间（微秒，输入水位）
+    double slope     = 0.0;    // Clock: 歌曲时间 / 主机时间速率（0 = 冻结）
+};
+
+// ── 判定事件 ──────────────────────────────────────────────────────────────────
+
+enum class JudgeEventKind : uint8_t
+{
+    Hit,          // 按键 / 点击判定（Tap、Circle，或 Hold / Slider 头部）
+    HoldEnd,      // Hold 终判
+    SliderTick,   // Slider 拐点判定
+    SliderEnd,    // Slider 所有拐点判定完毕（只更新状态，无反馈）
+    Miss          // 超时自动 Miss
+};
+
+struct JudgeEvent
+{
+    JudgeEventKind kind       = JudgeEventKind::Hit;
+    JudgeResult    result     = JudgeResult::None;  // 反馈用判定（None = 不显示闪现）
+    JudgeResult    noteResult = JudgeResult::None;  // 事件后该音符的 NoteState::result
+    bool           isKeyboard = true;
+    int            lane       = -1;                 // 键盘音符轨道
+    float          x          = 0.0f;               // 鼠标区归一化坐标（音符 / 拐点位置）
+    float          y          = 0.0f;
+    uint32_t       noteIndex  = 0;                  // GetKeyboardNotes / GetMouseNotes 下标
+    int            waypoint   = -1;                 // SliderTick: 刚判定的拐点索引
+    double         timeMs     = 0.0;                // 产生判定的游戏时间
+    double         hitErrorMs = 0.0;                // 偏差（仅 Hit 有效）
+
+    // 本次判定计入后的计分快照（HUD 直接显示，无需跨线程读取 ScoreCalculator）
+    int   score    = 0;
+    int   combo    = 0;
+    float accuracy = 0.0f;
+};
+
+// ── JudgeSession ──────────────────────────────────────────────────────────────
+
+class JudgeSession
+{
+public:
+    // 开局：notes 须在整局内保持有效（指向 GameState 的谱面数据）
+    void Start(std::span<const KeyboardNote> kbNotes,
+               std::span<const MouseNote>    msNotes,
+               const Judge& judge);
+
+    // 状态恢复为开局（重试）
+    void Reset();
+
+    // 处理一条输入（按下 / 点击立即以 input.timeMs 判定）
+    void HandleInput(const JudgeInput& input);
+
+    // 推进到 nowMs：增量 Miss 扫描 → Hold 持续判定 → Slider 追踪
+    void Tick(double nowMs) { Tick(nowMs, nowMs); }
+
+    // 同上，但自动 Miss 与 Hold 判定只推进到 min(nowMs, inputMs)：
+    // inputMs 之后的按下 / 松开可能尚未送达，不能据此判 Miss 或结束 Hold
+    void Tick(double nowMs, double inputMs);
+
+    // 结算：未判定音符与进行中 Slider 的剩余拐点全部计为 Miss（只计分，不产生事件）
+    void Finish();
+
+    // 本次调用以来产生的事件（按产生顺序）；调用方处理后 ClearEvents
+    const std::vector<JudgeEvent>& GetEvents() const { return m_events; }
+    void ClearEvents() { m_events.clear(); }
+
+    const ScoreCalculator&        GetScore()          const { return m_score; }
+    const std::vector<NoteState>& GetKeyboardStates() const { return m_kbStates; }
+    const std::vector<NoteState>& GetMouseStates()    const { return m_msStates; }
+    const Judge&                  GetJudge()          const { return m_judge; }
+    double                        GetLastTickMs()     const { return m_lastTickMs; }
+
+    // 按键候选向前查看的范围（与 GameState 活跃窗口提前量一致）
+    static constexpr int CANDIDATE_AHEAD_MS = 2000;
+
+private:
+    void OnKeyDown(int lane, double timeMs);
+    void OnKeyUp(int lane, double timeMs);
+    void OnMouseDown(float x, float y, double timeMs);
+    void UpdateHolds(int now);
+    void UpdateSliders(int now);
+
+    // 计分并追加事件（填入计分快照）
+    void Emit(JudgeEvent ev, int judgements = 1);
+
+    std::span<const KeyboardNote> m_kbNotes;
+    std::span<const MouseNote>    m_msNotes;
+    std::vector<NoteState>        m_kbStates;
+    std::vector<NoteState>        m_msStates;
+
+    Judge           m_judge;
+    ScoreCalculator m_score;
+    LaneJudgeQueue  m_kbLaneQueue;
+    MissCursor      m_kbMissCursor;
+    MissCursor      m_msMissCursor;
+
+    std::vector<HoldState>   m_holdStates;
+    std::vector<SliderState> m_sliderStates;
+    std::vector<uint32_t>    m_missedKb;   // 复用容量，避免每次 Tick 分配
+    std::vector<uint32_t>    m_missedMs;
+
+    // 各轨道最近一次按下 / 松开的游戏时间。按时间而不是到达顺序判断是否按住：
+    // 场景在事件回调里转发松开、在固定步长里转发按下，同帧内可能先到松开
+    std::vector<double> m_laneDownMs;
+    std::vector<double> m_laneUpMs;
+    bool IsLaneHeld(size_t lane) const { return m_laneDownMs[lane] > m_laneUpMs[lane]; }
+
+    // 最近一次 MouseState
+    float m_mouseX    = 0.0f;
+    float m_mouseY    = 0.0f;
+    bool  m_mouseDown = false;
+
+    double m_lastTickMs = 0.0;
+
+    std::vector<JudgeEvent> m_events;
+};
+
+} // namespace sakura::game
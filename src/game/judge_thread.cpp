@@ -0,0 +1,150 @@
+// judge_thread.cpp — 独立判定线程实现
+
+#include "judge_thread.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace sakura::game
+{
+
+// ── Start / Stop ──────────────────────────────────────────────────────────────
+
+void JudgeThread::Start(JudgeSession& session, HostClock hostClock)
+{
+    Stop();
+    m_session   = &session;
+    m_hostClock = std::move(hostClock);
+    m_backlog.clear();
+    m_playing      = false;
+    m_floorMs      = 0.0;
+    m_inputFloorMs = 0.0;
+    m_tickCount.store(0, std::memory_order_relaxed);
+    m_maxTickGapUs.store(0.0, std::memory_order_relaxed);
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread([this] { Run(); });
+}
+
+void JudgeThread::Stop()
+{
+    if (!m_thread.joinable()) return;
+    m_stop.store(true, std::memory_order_release);
+    m_thread.join();
+
+    // 线程已退出：此处由主线程独占，残留输入丢弃，积压事件尽量交付
+    JudgeInput dropped;
+    while (m_inputs.TryPop(dropped)) {}
+    Publish();
+}
+
+// ── 主线程接口 ────────────────────────────────────────────────────────────────
+
+void JudgeThread::PushInput(const JudgeInput& input)
+{
+    while (!m_inputs.TryPush(input))
+    {
+        if (!m_thread.joinable()) return;
+        std::this_thread::yield();
+    }
+}
+
+void JudgeThread::SyncClock(double hostUs, double gameMs, double slope, bool playing,
+                            double inputHostUs)
+{
+    JudgeInput in;
+    in.kind      = JudgeInput::Kind::Clock;
+    in.mouseDown = playing;
+    in.hostUs    = hostUs;
+    in.inputUs   = inputHostUs;
+    in.timeMs    = gameMs;
+    in.slope     = slope;
+    PushInput(in);
+}
+
+// ── 线程主循环 ────────────────────────────────────────────────────────────────
+
+void JudgeThread::Publish()
+{
+    // 先交付积压事件，保持顺序
+    size_t sent = 0;
+    while (sent < m_backlog.size() && m_events.TryPush(m_backlog[sent]))
+        ++sent;
+    m_backlog.erase(m_backlog.begin(), m_backlog.begin() + static_cast<std::ptrdiff_t>(sent));
+
+    for (const auto& ev : m_session->GetEvents())
+    {
+        if (!m_backlog.empty() || !m_events.TryPush(ev))
+            m_backlog.push_back(ev);
+    }
+    m_session->ClearEvents();
+}
+
+void JudgeThread::Run()
+{
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::microseconds(1000000 / TICK_HZ);
+    auto   next       = Clock::now();
+    double lastTickUs = -1.0;
+
+    while (!m_stop.load(std::memory_order_acquire))
+    {
+        // ── 输入：时钟同步立即生效，按键 / 点击按到达顺序判定 ─────────────────
+        JudgeInput in;
+        while (m_inputs.TryPop(in))
+        {
+            if (in.kind == JudgeInput::Kind::Clock)
+            {
+                if (in.mouseDown && !m_playing)
+                {
+                    // 新一段播放（开局 / 暂停恢复后可能回退）
+                    m_floorMs      = in.timeMs;
+                    m_inputFloorMs = in.timeMs;
+                }
+                m_playing     = in.mouseDown;
+                m_syncHostUs  = in.hostUs;
+                m_syncGameMs  = in.timeMs;
+                m_syncSlope   = in.slope;
+                m_syncInputUs = in.inputUs;
+            }
+            else if (m_playing)
+            {
+                m_session->HandleInput(in);
+            }
+        }
+
+        // ── Tick：按最近一次同步外推当前游戏时间，Miss / Hold 以输入水位为上限 ──
+        if (m_playing)
+        {
+            const double hostUs = m_hostClock();
+            const double nowMs  = std::max(m_floorMs,
+                m_syncGameMs + m_syncSlope * (hostUs - m_syncHostUs) / 1000.0);
+            const double inputMs = std::max(m_inputFloorMs,
+                m_syncGameMs + m_syncSlope * (m_syncInputUs - m_syncHostUs) / 1000.0);
+            m_floorMs      = nowMs;
+            m_inputFloorMs = inputMs;
+            m_session->Tick(nowMs, inputMs);
+
+            if (lastTickUs >= 0.0 &&
+                hostUs - lastTickUs > m_maxTickGapUs.load(std::memory_order_relaxed))
+                m_maxTickGapUs.store(hostUs - lastTickUs, std::memory_order_relaxed);
+            lastTickUs = hostUs;
+            m_tickCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            lastTickUs = -1.0;
+        }
+
+        Publish();
+
+        // 固定节拍；落后超过一个周期（被系统调度挤占）时重新对齐而不是补跑
+        next += period;
+        const auto now = Clock::now();
+        if (next < now)
+            next = now;
+        else
+            std::this_thread::sleep_until(next);
+    }
+}
+
+} // namespace sakura::game
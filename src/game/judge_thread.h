@@ -0,0 +1,111 @@
+#pragma once
+
+// judge_thread.h — 独立判定线程（可选，Config "gameplay.judge_thread"）
+// 以约 1kHz 驱动 JudgeSession，渲染帧卡顿不再推迟自动 Miss、Hold 终判与 Slider 拐点判定。
+//
+// 数据流（两条单生产者 / 单消费者无锁队列）：
+//   主线程 ──JudgeInput──▶ 判定线程   按键 / 点击（已带事件时间戳映射的游戏时间）、
+//                                     每帧鼠标状态、歌曲时钟同步（Clock）
+//   判定线程 ──JudgeEvent──▶ 主线程   判定结果 + 计分快照，主线程据此显示闪现 / 粒子 / 音效
+//
+// SDL 事件只能在主线程泵取，因此按键仍由主线程转发；它们携带 SDL 事件时间戳换算的
+// 判定时刻，主线程卡顿只推迟反馈而不改变偏差。判定线程的“当前时间”由最近一次 Clock
+// 同步（主机时间, 游戏时间, 斜率）外推，不依赖主线程按时更新。
+// Clock 同时携带输入水位（主线程已泵取事件截至的主机时间）：自动 Miss 与 Hold 终判只推进到
+// 水位，卡顿期间发生、尚未送达的按键因此不会被提前判 Miss；Slider 追踪仍按外推时间推进。
+// 运行期间 JudgeSession 归判定线程独占；Stop() 之后主线程才可读取其计分与状态。
+
+#include "judge_session.h"
+#include "utils/spsc_ring.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace sakura::game
+{
+
+class JudgeThread
+{
+public:
+    static constexpr int    TICK_HZ         = 1000;
+    static constexpr size_t INPUT_CAPACITY  = 1024;
+    static constexpr size_t EVENT_CAPACITY  = 4096;
+
+    // 主机单调时间（微秒），须与 Clock 同步中的 hostUs 同一时基
+    using HostClock = std::function<double()>;
+
+    JudgeThread() = default;
+    ~JudgeThread() { Stop(); }
+
+    JudgeThread(const JudgeThread&)            = delete;
+    JudgeThread& operator=(const JudgeThread&) = delete;
+
+    // 启动线程；session 在 Stop() 前不得被其他线程访问
+    void Start(JudgeSession& session, HostClock hostClock);
+
+    // 停止并等待线程退出（未处理的输入丢弃，已产生的事件仍可 DrainEvents 取走）
+    void Stop();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // ── 主线程：生产输入 ──────────────────────────────────────────────────────
+
+    // 队列满时让出时间片重试（判定线程每毫秒清空一次，正常情况下不会发生）
+    void PushInput(const JudgeInput& input);
+
+    // 同步歌曲时钟：hostUs 时刻游戏时间为 gameMs，此后按 slope 推进；playing=false 时冻结。
+    // inputHostUs：主线程已泵取事件截至的主机时间，须在转发完这些事件之后再调用
+    void SyncClock(double hostUs, double gameMs, double slope, bool playing, double inputHostUs);
+
+    // ── 主线程：消费事件 ──────────────────────────────────────────────────────
+
+    // 依次取出全部已发布事件，返回取出数量
+    template <typename Fn>
+    size_t DrainEvents(Fn&& fn)
+    {
+        size_t n = 0;
+        JudgeEvent ev;
+        while (m_events.TryPop(ev))
+        {
+            fn(ev);
+            ++n;
+        }
+        return n;
+    }
+
+    // ── 统计（任意线程）──────────────────────────────────────────────────────
+
+    uint64_t GetTickCount()     const { return m_tickCount.load(std::memory_order_relaxed); }
+    // 相邻两次 Tick 的最大主机时间间隔（微秒），用于确认渲染卡顿没有拖慢判定
+    double   GetMaxTickGapUs()  const { return m_maxTickGapUs.load(std::memory_order_relaxed); }
+
+private:
+    void Run();
+    void Publish();
+
+    JudgeSession* m_session = nullptr;
+    HostClock     m_hostClock;
+
+    utils::SpscRing<JudgeInput, INPUT_CAPACITY> m_inputs;
+    utils::SpscRing<JudgeEvent, EVENT_CAPACITY> m_events;
+
+    // 以下仅判定线程访问
+    std::vector<JudgeEvent> m_backlog;    // 事件队列满（主线程长时间卡顿）时暂存，不丢弃
+    bool   m_playing      = false;
+    double m_syncHostUs   = 0.0;
+    double m_syncGameMs   = 0.0;
+    double m_syncSlope    = 0.0;
+    double m_syncInputUs  = 0.0;
+    double m_floorMs      = 0.0;          // 同一段播放内的输出下限（保证单调）
+    double m_inputFloorMs = 0.0;          // 输入水位对应的游戏时间（同样单调）
+
+    std::thread         m_thread;
+    std::atomic<bool>   m_stop{ false };
+    std::atomic<uint64_t> m_tickCount{ 0 };
+    std::atomic<double>   m_maxTickGapUs{ 0.0 };
+};
+
+} // namespace sakura::game
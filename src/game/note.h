@@ -2,6 +2,7 @@
 
 // note.h — 游戏音符相关数据结构与枚举
 
+#include <cstdint>
 #include <vector>
 #include <utility>
 
@@ -20,7 +21,7 @@ enum class NoteType
 };
 
 // 判定结果
-enum class JudgeResult
+enum class JudgeResult : uint8_t
 {
     Perfect,    // 完美
     Great,      // 好
@@ -42,6 +43,7 @@ enum class Grade
 };
 
 // ── 键盘端音符 ────────────────────────────────────────────────────────────────
+// 音符结构体只保存谱面数据，加载后只读；每局的判定状态见下方 NoteState。
 
 struct KeyboardNote
 {
@@ -49,12 +51,6 @@ struct KeyboardNote
     int        lane        = 0;              // 轨道索引（0~3）
     NoteType   type        = NoteType::Tap;  // 音符类型
     int        duration    = 0;              // Hold 持续时长（毫秒），Tap=0
-
-    // 运行时状态（不参与序列化）
-    bool       isJudged    = false;
-    JudgeResult result     = JudgeResult::None;
-    float      renderY     = 0.0f;           // 归一化渲染 Y 坐标
-    float      alpha       = 1.0f;           // 透明度（判定后淡出）
 };
 
 // ── 鼠标端音符 ────────────────────────────────────────────────────────────────
@@ -67,12 +63,19 @@ struct MouseNote
     NoteType   type              = NoteType::Circle; // 音符类型
     int        sliderDuration    = 0;                // Slider 持续时长（毫秒）
     std::vector<std::pair<float, float>> sliderPath; // Slider 路径节点（归一化坐标）
+};
 
-    // 运行时状态（不参与序列化）
-    bool       isJudged          = false;
-    JudgeResult result           = JudgeResult::None;
-    float      approachScale     = 2.0f;             // 接近圈缩放（2.0→1.0）
-    float      alpha             = 1.0f;             // 透明度
+// ── 音符运行时状态 ────────────────────────────────────────────────────────────
+// 与 ChartData::keyboardNotes / mouseNotes 按下标一一对应的平行数组元素，
+// 由 GameState 等持有；开局 / 重试时整体重置，不参与序列化。
+// 接近圈缩放、渲染 Y 等可由时间直接算出的量不再缓存。
+
+struct NoteState
+{
+    bool        isJudged = false;              // 已判定（Hold/Slider 头部命中后即置位，防止自动 Miss）
+    JudgeResult result   = JudgeResult::None;  // 终判结果（Hold/Slider 进行中为 None）
+    float       alpha    = 1.0f;               // 渲染透明度（判定后淡出）
 };
+static_assert(sizeof(NoteState) == 8, "NoteState 应保持紧凑，便于整块清零与顺序扫描");
 
 } // namespace sakura::game
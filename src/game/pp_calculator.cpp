@@ -2,6 +2,8 @@
 
 #include "pp_calculator.h"
 
+#include "data/database.h"
+
 #include <algorithm>
 #include <cmath>
 
@@ -20,6 +22,20 @@ constexpr double kFullComboBonus = 1.05;
 constexpr double kAllPerfectBonus = 1.10;
 constexpr double kAccuracyThreshold = 0.99;
 constexpr double kHighAccuracyBonus = 1.02;
+
+std::string BestKey(const GameResult& result)
+{
+    std::string key;
+    key.reserve(result.chartId.size() + result.difficulty.size() + 1);
+    key.append(result.chartId).append(1, '\n').append(result.difficulty);
+    return key;
+}
+}
+
+PPCalculator& PPCalculator::GetInstance()
+{
+    static PPCalculator instance;
+    return instance;
 }
 
 double PPCalculator::CalculatePP(const GameResult& result, float level)
@@ -44,32 +60,238 @@ double PPCalculator::CalculatePP(const GameResult& result, float level)
 
 void PPCalculator::RecalculateTotal(const std::vector<GameResult>& bestScores)
 {
-    m_bestPlays.clear();
-    m_bestPlays.reserve(bestScores.size());
+    Clear();
+    m_nodes.reserve(bestScores.size());
+    EnsureWeights(bestScores.size());
 
     for (const auto& score : bestScores)
-        m_bestPlays.push_back({ score, CalculatePP(score, score.difficultyLevel) });
+        Insert({ score, CalculatePP(score, score.difficultyLevel) }, BestKey(score));
+
+    m_loaded          = true;
+    m_dbFailedBatches = -1;
+}
+
+bool PPCalculator::LoadFromDatabase()
+{
+    auto& database = sakura::data::Database::GetInstance();
+    if (!database.IsOpen())
+        return false;
+
+    // 先记下失败批次数再读取：读取期间才失败的写入会在下次检查时触发重新加载
+    const long long failedBatches = database.GetFailedBatchCount();
+    auto plays = database.GetAllBestPlays();
+
+    Clear();
+    m_nodes.reserve(plays.size());
+    EnsureWeights(plays.size());
+
+    for (auto& play : plays)
+    {
+        std::string key = BestKey(play.result);
+        Insert({ std::move(play.result), play.pp }, std::move(key));
+    }
+
+    m_loaded          = true;
+    m_dbFailedBatches = failedBatches;
+    return true;
+}
 
-    std::sort(m_bestPlays.begin(), m_bestPlays.end(),
-        [](const PPPlay& lhs, const PPPlay& rhs)
-        {
-            if (lhs.pp != rhs.pp)
-                return lhs.pp > rhs.pp;
-            return lhs.result.score > rhs.result.score;
-        });
+bool PPCalculator::IsLoaded() const
+{
+    return m_loaded
+        && (m_dbFailedBatches < 0
+            || m_dbFailedBatches == sakura::data::Database::GetInstance().GetFailedBatchCount());
+}
+
+bool PPCalculator::SubmitBest(const GameResult& result)
+{
+    if (!m_loaded)
+        return false;
+
+    // 有写入未能落盘：排名里可能有已回滚的成绩，整体从数据库重建（已包含本局）
+    if (!IsLoaded())
+    {
+        LoadFromDatabase();
+        return false;
+    }
+
+    std::string key = BestKey(result);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        if (result.score <= m_nodes[static_cast<size_t>(it->second)].play.result.score)
+            return false;
+        Erase(it->second);
+    }
+
+    Insert({ result, CalculatePP(result, result.difficultyLevel) }, std::move(key));
+    return true;
+}
 
-    m_totalPP = 0.0;
-    for (std::size_t index = 0; index < m_bestPlays.size(); ++index)
-        m_totalPP += m_bestPlays[index].pp * std::pow(0.95, static_cast<double>(index));
+double PPCalculator::GetTotalPP() const
+{
+    return m_root == NIL ? 0.0 : m_nodes[static_cast<size_t>(m_root)].weighted;
 }
 
 std::vector<PPPlay> PPCalculator::GetBestPlays(int limit) const
 {
-    if (limit <= 0 || m_bestPlays.empty())
+    if (limit <= 0 || m_root == NIL)
         return {};
 
-    const std::size_t count = std::min<std::size_t>(static_cast<std::size_t>(limit), m_bestPlays.size());
-    return std::vector<PPPlay>(m_bestPlays.begin(), m_bestPlays.begin() + count);
+    std::vector<PPPlay> plays;
+    plays.reserve(std::min<size_t>(static_cast<size_t>(limit), GetRankedCount()));
+    CollectInOrder(m_root, static_cast<size_t>(limit), plays);
+    return plays;
+}
+
+// ── treap ─────────────────────────────────────────────────────────────────────
+
+void PPCalculator::Clear()
+{
+    m_nodes.clear();
+    m_free.clear();
+    m_index.clear();
+    m_root = NIL;
+}
+
+void PPCalculator::Insert(PPPlay play, std::string key)
+{
+    EnsureWeights(GetRankedCount() + 1);
+
+    int32_t id;
+    if (!m_free.empty())
+    {
+        id = m_free.back();
+        m_free.pop_back();
+    }
+    else
+    {
+        id = static_cast<int32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    // xorshift32
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node& node    = m_nodes[static_cast<size_t>(id)];
+    node          = Node{};
+    node.play     = std::move(play);
+    node.key      = std::move(key);
+    node.priority = m_seed;
+    Pull(id);
+
+    m_index[node.key] = id;
+
+    int32_t left = NIL, right = NIL;
+    Split(m_root, [&](int32_t other) { return Before(other, id); }, left, right);
+    m_root = Merge(Merge(left, id), right);
+}
+
+void PPCalculator::Erase(int32_t id)
+{
+    int32_t left = NIL, rest = NIL, middle = NIL, right = NIL;
+    Split(m_root, [&](int32_t other) { return Before(other, id); }, left, rest);
+    Split(rest,   [&](int32_t other) { return !Before(id, other); }, middle, right);
+    m_root = Merge(left, right);
+
+    Node& node = m_nodes[static_cast<size_t>(id)];
+    auto it = m_index.find(node.key);
+    if (it != m_index.end() && it->second == id)
+        m_index.erase(it);
+    node = Node{};
+    m_free.push_back(id);
+}
+
+bool PPCalculator::Before(int32_t a, int32_t b) const
+{
+    const Node& lhs = m_nodes[static_cast<size_t>(a)];
+    const Node& rhs = m_nodes[static_cast<size_t>(b)];
+    if (lhs.play.pp != rhs.play.pp)
+        return lhs.play.pp > rhs.play.pp;
+    if (lhs.play.result.score != rhs.play.result.score)
+        return lhs.play.result.score > rhs.play.result.score;
+    if (lhs.key != rhs.key)
+        return lhs.key < rhs.key;
+    return a < b;
+}
+
+void PPCalculator::Pull(int32_t id)
+{
+    Node& node = m_nodes[static_cast<size_t>(id)];
+    const Node* left  = node.left  == NIL ? nullptr : &m_nodes[static_cast<size_t>(node.left)];
+    const Node* right = node.right == NIL ? nullptr : &m_nodes[static_cast<size_t>(node.right)];
+
+    const uint32_t leftSize = left ? left->size : 0;
+    node.size     = 1 + leftSize + (right ? right->size : 0);
+    node.weighted = (left ? left->weighted : 0.0)
+        + node.play.pp * m_weights[leftSize]
+        + (right ? m_weights[leftSize + 1] * right->weighted : 0.0);
+}
+
+int32_t PPCalculator::Merge(int32_t a, int32_t b)
+{
+    if (a == NIL) return b;
+    if (b == NIL) return a;
+
+    if (m_nodes[static_cast<size_t>(a)].priority > m_nodes[static_cast<size_t>(b)].priority)
+    {
+        const int32_t merged = Merge(m_nodes[static_cast<size_t>(a)].right, b);
+        m_nodes[static_cast<size_t>(a)].right = merged;
+        Pull(a);
+        return a;
+    }
+
+    const int32_t merged = Merge(a, m_nodes[static_cast<size_t>(b)].left);
+    m_nodes[static_cast<size_t>(b)].left = merged;
+    Pull(b);
+    return b;
+}
+
+template <typename Pred>
+void PPCalculator::Split(int32_t t, Pred&& goesLeft, int32_t& left, int32_t& right)
+{
+    if (t == NIL)
+    {
+        left = right = NIL;
+        return;
+    }
+
+    if (goesLeft(t))
+    {
+        int32_t rest = NIL;
+        Split(m_nodes[static_cast<size_t>(t)].right, goesLeft, rest, right);
+        m_nodes[static_cast<size_t>(t)].right = rest;
+        left = t;
+    }
+    else
+    {
+        int32_t rest = NIL;
+        Split(m_nodes[static_cast<size_t>(t)].left, goesLeft, left, rest);
+        m_nodes[static_cast<size_t>(t)].left = rest;
+        right = t;
+    }
+    Pull(t);
+}
+
+void PPCalculator::EnsureWeights(size_t count)
+{
+    // 逐项 std::pow，与按名次直接求幂的结果逐位一致
+    while (m_weights.size() <= count)
+        m_weights.push_back(std::pow(WEIGHT_DECAY, static_cast<double>(m_weights.size())));
+}
+
+void PPCalculator::CollectInOrder(int32_t id, size_t limit, std::vector<PPPlay>& out) const
+{
+    if (id == NIL || out.size() >= limit)
+        return;
+
+    const Node& node = m_nodes[static_cast<size_t>(id)];
+    CollectInOrder(node.left, limit, out);
+    if (out.size() < limit)
+        out.push_back(node.play);
+    CollectInOrder(node.right, limit, out);
 }
 
-} // namespace sakura::game
\ No newline at end of file
+} // namespace sakura::game
@@ -1,9 +1,18 @@
 #pragma once
 
 // pp_calculator.h — Performance Point 计算器
+//
+// 总 PP = Σ pp_i · 0.95^i（各谱面难度最高分的 PP 按降序排名）。
+// 排名保存在按 (pp 降序, score 降序, 谱面键) 排序的 treap 中，每个节点缓存子树大小与
+// 子树内按局部名次加权的 PP 和，权重 0.95^i 查预计算表；新的最高分到来时删旧插新，
+// O(log n) 更新总 PP，不再整体重算与排序。
 
 #include "chart.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace sakura::game
@@ -18,15 +27,70 @@ struct PPPlay
 class PPCalculator
 {
 public:
+    static constexpr double WEIGHT_DECAY = 0.95;
+
+    // 玩家本人的 PP 排名（统计页与结算页共享）
+    static PPCalculator& GetInstance();
+
     static double CalculatePP(const GameResult& result, float level);
 
+    // 用全部最高分重建排名（逐条计算 PP）
     void RecalculateTotal(const std::vector<GameResult>& bestScores);
-    double GetTotalPP() const { return m_totalPP; }
+
+    // 从数据库 best_scores 重建排名（使用入库时计算好的 PP）
+    bool LoadFromDatabase();
+    // 已加载，且（若来自数据库）此后没有写入失败（Database::GetFailedBatchCount 未变）
+    bool IsLoaded() const;
+
+    // 成绩入库后调用：分数严格高于该谱面难度当前最高分时替换（与 best_scores 规则一致），
+    // 返回是否替换。尚未加载 / 重建时忽略（之后加载会从数据库读到这一局）；
+    // 数据库有写入失败时改为从数据库重新加载并返回 false
+    bool SubmitBest(const GameResult& result);
+
+    double GetTotalPP() const;
+    size_t GetRankedCount() const { return m_root == NIL ? 0 : m_nodes[static_cast<size_t>(m_root)].size; }
     std::vector<PPPlay> GetBestPlays(int limit = 20) const;
 
 private:
-    std::vector<PPPlay> m_bestPlays;
-    double              m_totalPP = 0.0;
+    static constexpr int32_t NIL = -1;
+
+    struct Node
+    {
+        PPPlay      play;
+        std::string key;            // chartId + '\n' + difficulty
+        uint32_t    priority = 0;
+        int32_t     left     = NIL;
+        int32_t     right    = NIL;
+        uint32_t    size     = 1;
+        double      weighted = 0.0; // Σ 子树内第 j 名的 pp · 0.95^j（j 从 0 起）
+    };
+
+    void Clear();
+    void Insert(PPPlay play, std::string key);
+    void Erase(int32_t node);
+
+    // 严格序：a 排在 b 之前（pp、score 都相同时依次比较谱面键与节点下标）
+    bool Before(int32_t a, int32_t b) const;
+
+    void    Pull(int32_t node);
+    int32_t Merge(int32_t a, int32_t b);
+    // 把 t 按 goesLeft(node) 拆成前后两段（goesLeft 在排名序上单调：前段为真）
+    template <typename Pred>
+    void    Split(int32_t t, Pred&& goesLeft, int32_t& left, int32_t& right);
+
+    // 保证权重表覆盖 0 … count
+    void    EnsureWeights(size_t count);
+
+    void    CollectInOrder(int32_t node, size_t limit, std::vector<PPPlay>& out) const;
+
+    std::vector<Node>                        m_nodes;
+    std::vector<int32_t>                     m_free;
+    std::unordered_map<std::string, int32_t> m_index;    // 谱面键 → 节点
+    std::vector<double>                      m_weights;  // 0.95^i
+    int32_t                                  m_root = NIL;
+    uint32_t                                 m_seed = 0x9E3779B9u;
+    bool                                     m_loaded = false;
+    long long                                m_dbFailedBatches = -1;  // 加载时的失败批次数；-1 表示非数据库来源
 };
 
-} // namespace sakura::game
\ No newline at end of file
+} // namespace sakura::game
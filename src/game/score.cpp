@@ -4,6 +4,7 @@
 #include "utils/logger.h"
 
 #include <algorithm>
+#include <cmath>
 #include <ctime>
 
 namespace sakura::game
@@ -33,12 +34,12 @@ void ScoreCalculator::Initialize(int totalNoteCount)
 
 // ── OnJudge ───────────────────────────────────────────────────────────────────
 
-void ScoreCalculator::OnJudge(JudgeResult result, int hitError)
+void ScoreCalculator::OnJudge(JudgeResult result, double hitErrorMs)
 {
     // 记录偏差（仅记录实际命中的音符，Miss 不记录）
     if (result != JudgeResult::None && result != JudgeResult::Miss)
     {
-        m_hitErrors.push_back(hitError);
+        m_hitErrors.push_back(static_cast<int>(std::lround(hitErrorMs)));
     }
 
     // 确定本次判定的得分比例和准确率权重
@@ -27,8 +27,8 @@ public:
 
     // 每次产生判定时调用
     // result: 判定结果
-    // hitError: 偏差（毫秒，可选，用于偏差图）
-    void OnJudge(JudgeResult result, int hitError = 0);
+    // hitErrorMs: 偏差（毫秒，可带小数，可选，用于偏差图）；记录时四舍五入到整毫秒
+    void OnJudge(JudgeResult result, double hitErrorMs = 0.0);
 
     // ── 查询 ──────────────────────────────────────────────────────────────────
 
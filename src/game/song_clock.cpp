@@ -0,0 +1,171 @@
+// song_clock.cpp — 亚毫秒级歌曲时钟实现
+
+#include "song_clock.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sakura::game
+{
+
+// ── 状态控制 ──────────────────────────────────────────────────────────────────
+
+void SongClock::Reset(double songUs)
+{
+    m_running     = false;
+    m_stoppedUs   = songUs;
+    m_floorUs     = songUs;
+    m_slope       = m_speed;
+    m_sampleHead  = 0;
+    m_sampleCount = 0;
+    m_lastAudioUs = -1.0;
+    m_driftUs     = 0.0;
+}
+
+void SongClock::Resume(double hostUs)
+{
+    if (m_running) return;
+    Anchor(hostUs, m_stoppedUs);
+    m_running = true;
+}
+
+void SongClock::Pause(double hostUs)
+{
+    if (!m_running) return;
+    m_stoppedUs = GetTimeUs(hostUs);
+    m_running   = false;
+    Reset(m_stoppedUs);
+}
+
+void SongClock::Seek(double hostUs, double songUs)
+{
+    if (m_running)
+        Anchor(hostUs, songUs);
+    else
+        Reset(songUs);
+}
+
+void SongClock::SetSpeed(double hostUs, double speed)
+{
+    if (!(speed > 0.0)) return;
+    if (m_running)
+    {
+        const double now = GetTimeUs(hostUs);
+        m_speed = speed;
+        Anchor(hostUs, now);
+    }
+    else
+    {
+        m_speed = speed;
+        m_slope = speed;
+    }
+}
+
+void SongClock::Anchor(double hostUs, double songUs)
+{
+    m_anchorHostUs = hostUs;
+    m_anchorSongUs = songUs;
+    m_slope        = m_speed;
+    m_floorUs      = songUs;
+    m_sampleHead   = 0;
+    m_sampleCount  = 0;
+    m_lastAudioUs  = -1.0;
+    m_driftUs      = 0.0;
+}
+
+// ── AddSample ─────────────────────────────────────────────────────────────────
+
+void SongClock::AddSample(double hostUs, double audioUs)
+{
+    if (!m_running) return;
+    // 游标未前进（同一混音周期内的重复读数）不携带新信息
+    if (audioUs == m_lastAudioUs) return;
+    m_lastAudioUs = audioUs;
+
+    const double deviation = audioUs - LineAt(hostUs);
+    if (std::abs(deviation) > SNAP_THRESHOLD_US)
+    {
+        // 音频卡顿恢复 / 外部 seek：历史采样已失效，直接对齐到游标
+        Anchor(hostUs, audioUs);
+        m_lastAudioUs = audioUs;
+    }
+    else
+    {
+        // 旧直线在此刻的输出作为下限，新直线略微回退时保持平台而不倒退
+        m_floorUs = std::max(m_floorUs, GetTimeUs(hostUs));
+    }
+
+    m_samples[m_sampleHead] = { hostUs, audioUs };
+    m_sampleHead = (m_sampleHead + 1) % MAX_SAMPLES;
+    m_sampleCount = std::min(m_sampleCount + 1, MAX_SAMPLES);
+
+    Refit();
+    m_driftUs = audioUs - LineAt(hostUs);
+}
+
+// ── Refit ─────────────────────────────────────────────────────────────────────
+//
+// 最小二乘拟合 audio = a + b·host。主机时间以最早采样为原点，避免大数相减丢精度。
+// 采样不足或跨度太短时斜率固定为播放速度，仅用均值确定截距。
+//
+void SongClock::Refit()
+{
+    if (m_sampleCount == 0) return;
+
+    const size_t first = (m_sampleHead + MAX_SAMPLES - m_sampleCount) % MAX_SAMPLES;
+    const double origin = m_samples[first].hostUs;
+
+    double sumX = 0.0, sumY = 0.0;
+    double minX = 0.0, maxX = 0.0;
+    for (size_t k = 0; k < m_sampleCount; ++k)
+    {
+        const auto& s = m_samples[(first + k) % MAX_SAMPLES];
+        const double x = s.hostUs - origin;
+        sumX += x;
+        sumY += s.audioUs;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+    }
+    const double n     = static_cast<double>(m_sampleCount);
+    const double meanX = sumX / n;
+    const double meanY = sumY / n;
+
+    double slope = m_speed;
+    if (m_sampleCount >= MIN_FIT_SAMPLES && maxX - minX >= MIN_FIT_SPAN_US)
+    {
+        double sxx = 0.0, sxy = 0.0;
+        for (size_t k = 0; k < m_sampleCount; ++k)
+        {
+            const auto& s = m_samples[(first + k) % MAX_SAMPLES];
+            const double dx = s.hostUs - origin - meanX;
+            sxx += dx * dx;
+            sxy += dx * (s.audioUs - meanY);
+        }
+        if (sxx > 0.0)
+        {
+            const double lo = m_speed * (1.0 - MAX_SLOPE_DEVIATION);
+            const double hi = m_speed * (1.0 + MAX_SLOPE_DEVIATION);
+            slope = std::clamp(sxy / sxx, lo, hi);
+        }
+    }
+
+    m_slope        = slope;
+    m_anchorHostUs = origin + meanX;
+    m_anchorSongUs = meanY;
+}
+
+// ── GetTimeUs ─────────────────────────────────────────────────────────────────
+
+double SongClock::GetTimeUs(double hostUs) const
+{
+    if (!m_running) return m_stoppedUs;
+    return std::max(LineAt(hostUs), m_floorUs);
+}
+
+double SongClock::ProjectUs(double hostUs) const
+{
+    if (!m_running) return m_stoppedUs;
+    return LineAt(hostUs);
+}
+
+} // namespace sakura::game
@@ -0,0 +1,84 @@
+#pragma once
+
+// song_clock.h — 亚毫秒级歌曲时钟
+// 音频播放游标只在每个混音周期（10~20ms）更新一次，直接使用会让游戏时间阶梯式跳变。
+// SongClock 把每次观测到的游标变化与主机高精度时间（SDL_GetPerformanceCounter 换算的微秒）
+// 组成采样点，对最近一段采样做线性回归，得到“歌曲时间 = 截距 + 斜率 × 主机时间”的拟合直线：
+//   - 斜率反映实际播放速率（含声卡时钟漂移），限制在 SetSpeed 速度的 ±5% 内
+//   - 游标与拟合直线的偏差超过 SNAP_THRESHOLD_US（卡顿 / 外部 seek）时丢弃历史直接对齐
+//   - 拟合直线更新时保证输出不回退：同一段播放内返回值单调不减
+// 暂停 / Seek / 变速由调用方显式通知。本类不依赖 SDL，主机时间由调用方传入。
+
+#include <array>
+#include <cstddef>
+
+namespace sakura::game
+{
+
+class SongClock
+{
+public:
+    static constexpr size_t MAX_SAMPLES         = 64;        // 回归窗口采样数
+    static constexpr size_t MIN_FIT_SAMPLES     = 8;         // 少于此数时斜率固定为播放速度
+    static constexpr double MIN_FIT_SPAN_US     = 100000.0;  // 回归所需的最短主机时间跨度
+    static constexpr double MAX_SLOPE_DEVIATION = 0.05;      // 斜率相对播放速度的最大偏离
+    static constexpr double SNAP_THRESHOLD_US   = 50000.0;   // 超过此偏差视为跳变，直接对齐
+
+    // 停止并把时间设为 songUs（未运行时 GetTimeUs 恒返回该值）
+    void Reset(double songUs = 0.0);
+
+    // 从当前时间开始运行 / 暂停（暂停期间时间冻结）
+    void Resume(double hostUs);
+    void Pause(double hostUs);
+
+    // 跳转到 songUs；运行中从 hostUs 起继续计时
+    void Seek(double hostUs, double songUs);
+
+    // 播放速度变化（1.0 = 原速）：以当前时间为锚点改变斜率并清空采样
+    void SetSpeed(double hostUs, double speed);
+
+    // 提交一次音频游标观测（audioUs = 音频报告的播放位置，微秒）
+    // 游标与上次相同（尚未进入下一个混音周期）时忽略
+    void AddSample(double hostUs, double audioUs);
+
+    // hostUs 时刻的歌曲时间（微秒）
+    double GetTimeUs(double hostUs) const;
+
+    // 按当前拟合直线换算任意主机时刻（不做单调钳制），
+    // 用于把过去发生的输入事件时间戳映射到歌曲时间；未运行时返回冻结时间
+    double ProjectUs(double hostUs) const;
+
+    bool   IsRunning()  const { return m_running; }
+    double GetSpeed()   const { return m_speed; }
+    double GetSlope()   const { return m_slope; }
+    // 最近一次游标观测相对拟合直线的偏差（微秒，正 = 音频超前）
+    double GetDriftUs() const { return m_driftUs; }
+    size_t GetSampleCount() const { return m_sampleCount; }
+
+private:
+    struct Sample
+    {
+        double hostUs  = 0.0;
+        double audioUs = 0.0;
+    };
+
+    double LineAt(double hostUs) const { return m_anchorSongUs + m_slope * (hostUs - m_anchorHostUs); }
+    void   Anchor(double hostUs, double songUs);
+    void   Refit();
+
+    std::array<Sample, MAX_SAMPLES> m_samples{};
+    size_t m_sampleHead  = 0;   // 下一个写入位置（环形）
+    size_t m_sampleCount = 0;
+
+    bool   m_running      = false;
+    double m_speed        = 1.0;
+    double m_slope        = 1.0;
+    double m_anchorHostUs = 0.0;   // 拟合直线经过 (m_anchorHostUs, m_anchorSongUs)
+    double m_anchorSongUs = 0.0;
+    double m_floorUs      = 0.0;   // 输出下限（保证单调）
+    double m_stoppedUs    = 0.0;   // 未运行时的冻结时间
+    double m_lastAudioUs  = -1.0;
+    double m_driftUs      = 0.0;
+};
+
+} // namespace sakura::game
@@ -0,0 +1,139 @@
+// sv_scroll.cpp — SV 滚动位置积分表实现
+
+#include "sv_scroll.h"
+#include "utils/easing.h"
+
+#include <algorithm>
+
+namespace sakura::game
+{
+
+namespace
+{
+
+using EasingFunc = float (*)(float);
+
+// 返回 nullptr 表示 step（保持当前速度）
+EasingFunc ResolveEasing(std::string_view name)
+{
+    using namespace sakura::utils;
+    if (name == "step" || name == "none" || name == "constant") return nullptr;
+    if (name == "ease_in")            return &EaseInQuad;
+    if (name == "ease_out")           return &EaseOutQuad;
+    if (name == "ease_in_out")        return &EaseInOutQuad;
+    if (name == "ease_in_cubic")      return &EaseInCubic;
+    if (name == "ease_out_cubic")     return &EaseOutCubic;
+    if (name == "ease_in_out_cubic")  return &EaseInOutCubic;
+    if (name == "ease_in_sine")       return &EaseInSine;
+    if (name == "ease_out_sine")      return &EaseOutSine;
+    if (name == "ease_in_out_sine")   return &EaseInOutSine;
+    return &EaseLinear;
+}
+
+} // namespace
+
+// ── Build ─────────────────────────────────────────────────────────────────────
+
+void ScrollMap::Build(std::span<const SVPoint> points)
+{
+    m_knots.clear();
+    if (points.empty()) return;
+
+    // 第一个 SV 点之前按 1.0 倍速：pos(time_0) = time_0
+    double position = points.front().time;
+    auto push = [this, &position](double time, double speed, double slope) {
+        if (!m_knots.empty())
+        {
+            const auto&  k  = m_knots.back();
+            const double dt = time - k.time;
+            position = k.position + k.speed * dt + 0.5 * k.slope * dt * dt;
+        }
+        m_knots.push_back({ time, position, speed, slope });
+    };
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const auto&  p     = points[i];
+        const double speed = std::max(0.0f, p.speed);
+        if (i + 1 == points.size() || points[i + 1].time <= p.time)
+        {
+            // 最后一个点，或与下一点同时刻（后者覆盖）：恒速
+            push(p.time, speed, 0.0);
+            continue;
+        }
+
+        const double t0     = p.time;
+        const double t1     = points[i + 1].time;
+        const double target = std::max(0.0f, points[i + 1].speed);
+        const auto   easing = ResolveEasing(p.easing);
+
+        if (!easing || target == speed)
+        {
+            push(t0, speed, 0.0);
+        }
+        else if (easing == &sakura::utils::EaseLinear)
+        {
+            push(t0, speed, (target - speed) / (t1 - t0));
+        }
+        else
+        {
+            // 缓动曲线按子区间分段线性逼近
+            const int    n    = EASING_SUBDIVISIONS;
+            const double step = (t1 - t0) / n;
+            double from = speed;
+            for (int k = 0; k < n; ++k)
+            {
+                const float  u  = static_cast<float>(k + 1) / static_cast<float>(n);
+                const double to = std::max(0.0, static_cast<double>(
+                    sakura::utils::ApplyEasing(easing, u, static_cast<float>(speed),
+                                               static_cast<float>(target))));
+                push(t0 + k * step, from, (to - from) / step);
+                from = to;
+            }
+        }
+    }
+}
+
+// ── 查询 ──────────────────────────────────────────────────────────────────────
+
+const ScrollMap::Knot* ScrollMap::FindKnot(double timeMs) const
+{
+    auto it = std::upper_bound(m_knots.begin(), m_knots.end(), timeMs,
+        [](double t, const Knot& k) { return t < k.time; });
+    if (it == m_knots.begin()) return nullptr;
+    return &*(it - 1);
+}
+
+double ScrollMap::PositionAt(double timeMs) const
+{
+    const Knot* k = FindKnot(timeMs);
+    if (!k)
+    {
+        // 第一个 SV 点之前（或无 SV）：1.0 倍速
+        return m_knots.empty() ? timeMs
+                               : m_knots.front().position - (m_knots.front().time - timeMs);
+    }
+    const double dt = timeMs - k->time;
+    return k->position + k->speed * dt + 0.5 * k->slope * dt * dt;
+}
+
+std::vector<NoteScrollPos> ScrollMap::ComputeNotePositions(std::span<const KeyboardNote> notes) const
+{
+    std::vector<NoteScrollPos> out;
+    out.reserve(notes.size());
+    for (const auto& n : notes)
+    {
+        const double head = PositionAt(n.time);
+        out.push_back({ head, n.duration > 0 ? PositionAt(n.time + n.duration) : head });
+    }
+    return out;
+}
+
+float ScrollMap::SpeedAt(double timeMs) const
+{
+    const Knot* k = FindKnot(timeMs);
+    if (!k) return 1.0f;
+    return static_cast<float>(k->speed + k->slope * (timeMs - k->time));
+}
+
+} // namespace sakura::game
@@ -0,0 +1,67 @@
+#pragma once
+
+// sv_scroll.h — SV 滚动位置积分表（谱面加载时预计算）
+// 滚动位置 pos(t) = ∫ speed(τ) dτ（单位：毫秒 × SV 倍率），无 SV 时 pos(t) = t。
+// 音符到判定线的距离 = pos(noteTime) - pos(now)，可正确处理两者之间的所有 SV 变化。
+//
+// SV 语义：
+//   · 第一个 SV 点之前速度为 1.0，最后一个 SV 点之后保持其速度；
+//   · SVPoint[i].easing 描述区间 [time_i, time_{i+1}) 内速度从 speed_i 过渡到 speed_{i+1} 的曲线
+//     （linear / ease_in / ease_out / ease_in_out / *_cubic / *_sine）；
+//     "step"（或 "none" / "constant"）表示保持 speed_i，到下一点瞬变；未知名称按 linear 处理。
+// 内部把每段切成若干子区间，子区间内速度线性、位置二次，查询为一次二分查找。
+
+#include "chart.h"
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace sakura::game
+{
+
+// 键盘音符头 / 尾（Hold 末端，Tap 与头相同）的滚动位置
+struct NoteScrollPos
+{
+    double head = 0.0;
+    double tail = 0.0;
+};
+
+class ScrollMap
+{
+public:
+    // 缓动段细分数（线性段与 step 段无需细分）
+    static constexpr int EASING_SUBDIVISIONS = 32;
+
+    // 按 SV 点（time 升序）重建积分表
+    void Build(std::span<const SVPoint> points);
+
+    // 滚动位置（毫秒 × 倍率），单调不减（要求 speed >= 0）
+    double PositionAt(double timeMs) const;
+
+    // 瞬时 SV 倍率（含缓动）
+    float SpeedAt(double timeMs) const;
+
+    // 批量计算音符滚动位置（与 notes 一一对应，谱面加载时调用一次并缓存）
+    std::vector<NoteScrollPos> ComputeNotePositions(std::span<const KeyboardNote> notes) const;
+
+    bool   IsIdentity()   const { return m_knots.empty(); }
+    size_t GetKnotCount() const { return m_knots.size(); }
+
+private:
+    // 节点：[time, 下一节点 time) 内 speed(t) = speed + slope * (t - time)
+    struct Knot
+    {
+        double time;
+        double position;
+        double speed;
+        double slope;
+    };
+
+    // 返回最后一个 time <= timeMs 的节点（不存在返回 nullptr）
+    const Knot* FindKnot(double timeMs) const;
+
+    std::vector<Knot> m_knots;
+};
+
+} // namespace sakura::game
@@ -546,6 +546,7 @@ bool SceneChartWizard::CreateChartFiles(const std::string& folderPath,
         LOG_INFO("[SceneChartWizard] 写入难度文件: {}", chartPath);
     }
 
+    // 新谱面由下一次 ChartLibrary::GetCharts 的增量扫描发现
     return true;
 }
 
@@ -29,20 +29,6 @@ namespace sakura::scene
 namespace
 {
 
-// 将判定结果映射为点击选 note 时的优先级：值越小表示时间判定越好。
-int JudgePriority(sakura::game::JudgeResult result)
-{
-    switch (result)
-    {
-    case sakura::game::JudgeResult::Perfect: return 0;
-    case sakura::game::JudgeResult::Great:   return 1;
-    case sakura::game::JudgeResult::Good:    return 2;
-    case sakura::game::JudgeResult::Bad:     return 3;
-    case sakura::game::JudgeResult::Miss:    return 4;
-    default:                                  return 5;
-    }
-}
-
 sakura::core::Color ToCoreColor(const sakura::game::GuidanceColor& color)
 {
     return { color.r, color.g, color.b, color.a };
@@ -66,13 +52,15 @@ void SceneGame::OnEnter()
     LOG_INFO("[SceneGame] 开始游戏: {} [diff={}]",
              m_chartInfo.title, m_difficultyIndex);
 
+    m_config = sakura::core::Config::GetInstance().GetSnapshot();
+
     auto& rm = sakura::core::ResourceManager::GetInstance();
     m_fontHUD   = rm.GetDefaultFontHandle();
     m_fontSmall = rm.GetDefaultFontHandle();
 
     // 背景系统初始化
     {
-        float bgDim = sakura::core::Config::GetInstance().Get("background_dimming", 0.5f);
+        float bgDim = m_config.backgroundDim;
         m_useDefaultBg = true;
         if (!m_chartInfo.backgroundFile.empty())
         {
@@ -89,18 +77,9 @@ void SceneGame::OnEnter()
         }
     }
 
-    // 从 Config 读取键位绑定
-    {
-        auto& cfg = sakura::core::Config::GetInstance();
-        m_laneKeys[0] = static_cast<SDL_Scancode>(
-            cfg.Get<int>("input.key_lane_0", SDL_SCANCODE_A));
-        m_laneKeys[1] = static_cast<SDL_Scancode>(
-            cfg.Get<int>("input.key_lane_1", SDL_SCANCODE_S));
-        m_laneKeys[2] = static_cast<SDL_Scancode>(
-            cfg.Get<int>("input.key_lane_2", SDL_SCANCODE_D));
-        m_laneKeys[3] = static_cast<SDL_Scancode>(
-            cfg.Get<int>("input.key_lane_3", SDL_SCANCODE_F));
-    }
+    // 从配置快照读取键位绑定
+    for (int i = 0; i < LANE_COUNT; ++i)
+        m_laneKeys[i] = static_cast<SDL_Scancode>(m_config.laneKeys[static_cast<size_t>(i)]);
 
     // 初始化判定系统
     m_judge.Initialize();
@@ -115,12 +94,26 @@ void SceneGame::OnEnter()
         return;
     }
 
-    // 初始化计分器
-    int totalNotes = m_gameState.GetTotalNoteCount();
-    m_score.Initialize(totalNotes);
+    // 初始化判定核心（计分器随之按总判定数初始化）
+    m_judgeSession.Start(m_gameState.GetKeyboardNotes(), m_gameState.GetMouseNotes(), m_judge);
+    m_hudScore    = m_judgeSession.GetScore().GetScore();
+    m_hudCombo    = m_judgeSession.GetScore().GetCombo();
+    m_hudAccuracy = m_judgeSession.GetScore().GetAccuracy();
+
+    // 可选：独立判定线程 + 渲染卡顿压力测试
+    m_useJudgeThread   = m_config.judgeThread;
+    m_stressStallMs    = std::max(0, m_config.judgeStressStallMs);
+    m_stressFrameCount = 0;
+    if (m_useJudgeThread)
+    {
+        m_judgeThread.Start(m_judgeSession, &sakura::game::GameState::HostTimeUs);
+        LOG_INFO("[SceneGame] 独立判定线程已启动（{}Hz）", sakura::game::JudgeThread::TICK_HZ);
+    }
+    if (m_stressStallMs > 0)
+        LOG_WARN("[SceneGame] 渲染卡顿压力测试：每 {} 帧阻塞 {}ms",
+                 STRESS_STALL_INTERVAL, m_stressStallMs);
 
     // 清空状态
-    m_holdStates.clear();
     m_sliderStates.clear();
     m_judgeFlashes.clear();
 
@@ -137,8 +130,13 @@ void SceneGame::OnEnter()
 void SceneGame::OnExit()
 {
     LOG_INFO("[SceneGame] 退出游戏场景");
+    if (m_judgeThread.IsRunning())
+    {
+        m_judgeThread.Stop();
+        LOG_INFO("[SceneGame] 判定线程已停止：tick={}，最大 tick 间隔={:.2f}ms",
+                 m_judgeThread.GetTickCount(), m_judgeThread.GetMaxTickGapUs() / 1000.0);
+    }
     sakura::audio::AudioManager::GetInstance().StopMusic();
-    m_holdStates.clear();
     m_sliderStates.clear();
     m_judgeFlashes.clear();
     m_particles.Clear();
@@ -147,188 +145,185 @@ void SceneGame::OnExit()
 
 // ── CalcNoteRenderY ───────────────────────────────────────────────────────────
 
-float SceneGame::CalcNoteRenderY(int noteTimeMs, int currentTimeMs,
-                                  float svSpeed) const
+float SceneGame::CalcNoteRenderY(double noteScrollPos, double currentScrollPos) const
 {
-    auto& cfg      = sakura::core::Config::GetInstance();
-    float noteSpeed = cfg.Get<float>("gameplay.note_speed", 1.0f);
-
-    float dtMs      = static_cast<float>(noteTimeMs - currentTimeMs);
-    float fallRate  = noteSpeed * svSpeed * JUDGE_LINE_Y / BASE_APPROACH_RANGE;
-    return JUDGE_LINE_Y - dtMs * fallRate;
+    // 滚动位置差已含两者之间所有 SV 变化（1.0 倍速时等于毫秒差）
+    float dist     = static_cast<float>(noteScrollPos - currentScrollPos);
+    float fallRate = m_config.noteSpeed * JUDGE_LINE_Y / BASE_APPROACH_RANGE;
+    return JUDGE_LINE_Y - dist * fallRate;
 }
 
 // ── CalcApproachScale ─────────────────────────────────────────────────────────
 
-float SceneGame::CalcApproachScale(int noteTimeMs, int currentTimeMs) const
+float SceneGame::CalcApproachScale(int noteTimeMs, double currentTimeMs) const
 {
     float dtMs  = static_cast<float>(noteTimeMs - currentTimeMs);
     float t     = std::max(0.0f, std::min(1.0f, dtMs / BASE_APPROACH_RANGE));
     return 1.0f + 1.5f * t;   // 2.5 → 1.0
 }
 
-// ── HandleKeyPress ────────────────────────────────────────────────────────────
+// ── 输入转发 ──────────────────────────────────────────────────────────────────
 
-void SceneGame::HandleKeyPress(SDL_Scancode key)
+int SceneGame::LaneForKey(SDL_Scancode key) const
 {
-    if (!m_gameState.IsPlaying()) return;
-
-    // 找出按键对应轨道
-    int lane = -1;
     for (int i = 0; i < LANE_COUNT; ++i)
     {
-        if (m_laneKeys[i] == key) { lane = i; break; }
+        if (m_laneKeys[i] == key) return i;
     }
+    return -1;
+}
+
+void SceneGame::SubmitJudgeInput(const sakura::game::JudgeInput& input)
+{
+    if (m_useJudgeThread)
+        m_judgeThread.PushInput(input);
+    else
+        m_judgeSession.HandleInput(input);
+}
+
+void SceneGame::HandleKeyPress(SDL_Scancode key, double pressTimeMs)
+{
+    if (!m_gameState.IsPlaying()) return;
+    const int lane = LaneForKey(key);
     if (lane < 0) return;
 
-    int now = m_gameState.GetCurrentTime();
-    auto& kbNotes = m_gameState.GetKeyboardNotes();
+    // 以按下事件的真实时刻判定，而不是本次固定步长更新的时刻
+    sakura::game::JudgeInput in;
+    in.kind   = sakura::game::JudgeInput::Kind::KeyDown;
+    in.lane   = lane;
+    in.timeMs = pressTimeMs;
+    SubmitJudgeInput(in);
+}
 
-    // 在活跃键盘音符中找同轨道最近未判定的音符
-    auto activeKb = m_gameState.GetActiveKeyboardNotes();
-    int  bestIdx  = -1;
-    int  bestDist = INT_MAX;
+void SceneGame::HandleKeyRelease(SDL_Scancode key, double releaseTimeMs)
+{
+    if (!m_gameState.IsPlaying()) return;
+    const int lane = LaneForKey(key);
+    if (lane < 0) return;
 
-    for (auto& note : activeKb)
-    {
-        if (note.isJudged) continue;
-        if (note.lane != lane) continue;
-        int dist = std::abs(note.time - now);
-        if (dist < bestDist)
-        {
-            bestDist = dist;
-            // 找到索引（需要与 kbNotes 对齐）
-            for (int i = 0; i < static_cast<int>(kbNotes.size()); ++i)
-            {
-                if (&kbNotes[i] == &note) { bestIdx = i; break; }
-            }
-        }
-    }
+    // 松开事件的真实时刻作为 Hold 松开时刻
+    sakura::game::JudgeInput in;
+    in.kind   = sakura::game::JudgeInput::Kind::KeyUp;
+    in.lane   = lane;
+    in.timeMs = releaseTimeMs;
+    SubmitJudgeInput(in);
+}
 
-    if (bestIdx < 0) return;
+void SceneGame::HandleMouseClick(float normX, float normY, double clickTimeMs)
+{
+    if (!m_gameState.IsPlaying()) return;
 
-    auto& note = kbNotes[bestIdx];
+    // 将屏幕归一化坐标转换为鼠标区域内归一化坐标（越界由 JudgeSession 忽略）
+    sakura::game::JudgeInput in;
+    in.kind   = sakura::game::JudgeInput::Kind::MouseDown;
+    in.x      = (normX - MOUSE_X) / MOUSE_W;
+    in.y      = (normY - MOUSE_Y) / MOUSE_H;
+    in.timeMs = clickTimeMs;
+    SubmitJudgeInput(in);
+}
 
-    // Hold 起始
-    if (note.type == sakura::game::NoteType::Hold)
-    {
-        auto result = m_judge.JudgeKeyboardNote(note, now);
-        if (result != sakura::game::JudgeResult::Miss &&
-            result != sakura::game::JudgeResult::None)
-        {
-            // 立即标记 isJudged=true（防 CheckMisses 误判），result 留 None 等 Hold 结束
-            note.isJudged = true;
-            note.result   = sakura::game::JudgeResult::None;
-
-            // 开始 Hold 状态追踪
-            sakura::game::HoldState hs;
-            hs.noteIndex  = bestIdx;
-            hs.isHeld     = true;
-            hs.headJudged = true;
-            hs.headResult = result;
-            hs.lastHeldTimeMs = now;
-            m_holdStates.push_back(hs);
-        }
-        // 头部判定结果反馈（闪光 + 计入头 Hit / Miss）
-        m_score.OnJudge(result, sakura::game::Judge::GetHitError(note.time, now));
-        AddJudgeFlash(result, true, lane);
-    }
-    // Tap（普通）
-    else
-    {
-        auto result = m_judge.JudgeKeyboardNote(note, now);
-        m_score.OnJudge(result, sakura::game::Judge::GetHitError(note.time, now));
-        AddJudgeFlash(result, true, lane);
-    }
+void SceneGame::SyncJudgeClock()
+{
+    if (!m_useJudgeThread) return;
+    m_judgeThread.SyncClock(sakura::game::GameState::HostTimeUs(),
+                            m_gameState.GetCurrentTimeMsPrecise(),
+                            m_gameState.GetClockSlope(),
+                            m_gameState.IsPlaying(),
+                            static_cast<double>(sakura::core::Input::GetEventPumpTimeNs()) / 1000.0);
 }
 
-// ── HandleMouseClick ──────────────────────────────────────────────────────────
+// ── ApplyJudgeEvent ───────────────────────────────────────────────────────────
 
-void SceneGame::HandleMouseClick(float normX, float normY)
+void SceneGame::ApplyJudgeEvent(const sakura::game::JudgeEvent& ev)
 {
-    if (!m_gameState.IsPlaying()) return;
+    using Kind = sakura::game::JudgeEventKind;
 
-    // 将屏幕归一化坐标转换为鼠标区域内归一化坐标
-    float mouseX = (normX - MOUSE_X) / MOUSE_W;
-    float mouseY = (normY - MOUSE_Y) / MOUSE_H;
-
-    // 超出鼠标区域
-    if (mouseX < 0.0f || mouseX > 1.0f ||
-        mouseY < 0.0f || mouseY > 1.0f) return;
+    // 显示副本：已判定音符淡出；SliderTick 不改变音符状态
+    if (ev.kind != Kind::SliderTick)
+    {
+        auto& states = ev.isKeyboard ? m_gameState.GetKeyboardStates()
+                                     : m_gameState.GetMouseStates();
+        if (ev.noteIndex < states.size())
+        {
+            states[ev.noteIndex].isJudged = true;
+            states[ev.noteIndex].result   = ev.noteResult;
+        }
+    }
 
-    int now = m_gameState.GetCurrentTime();
-    auto& msNotes = m_gameState.GetMouseNotes();
-    auto  activeMs= m_gameState.GetActiveMouseNotes();
-
-    // 优先选取空间距离最近且在时间窗口内的未判定音符
-    // （鼠标区音符分布在二维空间，空间优先比时间优先更准确）
-    int   bestIdx      = -1;
-    int   bestPriority = INT_MAX;
-    float bestDist     = FLT_MAX;
-    int   bestTDist    = INT_MAX;
-    for (auto& n : activeMs)
+    // 进行中 Slider 的显示进度（渲染路径上的已过 / 下一个拐点）
+    if (!ev.isKeyboard)
     {
-        if (n.isJudged) continue;
-        // 排除时间上完全超前（还未进入判定窗口）或已经彻底过期的音符，
-        // 避免点击被尚未可打/已经 Miss 的鼠标音符抢走。
-        int timeDiff = now - n.time;
-        if (timeDiff < -m_judge.GetWindows().miss ||
-            timeDiff > m_judge.GetWindows().miss) continue;
-
-        float dx = mouseX - n.x;
-        float dy = mouseY - n.y;
-        float dist = std::sqrt(dx * dx + dy * dy);
-        float tolerance = sakura::game::Judge::GetMouseHitTolerance(n);
-        if (dist > tolerance) continue;
-
-        int   absT = std::abs(timeDiff);
-        int   priority = JudgePriority(m_judge.GetResultByTimeDiff(absT));
-
-        // 仅在点击真正落入音符头部范围后再比较优先级：
-        // 先取时间判定更好的目标，再用空间距离/时间差打破平局。
-        if (priority < bestPriority ||
-            (priority == bestPriority &&
-             (dist < bestDist - 1e-4f ||
-              (dist < bestDist + 1e-4f && absT < bestTDist))))
+        const int noteIndex = static_cast<int>(ev.noteIndex);
+        auto it = std::find_if(m_sliderStates.begin(), m_sliderStates.end(),
+            [noteIndex](const sakura::game::SliderState& s) { return s.noteIndex == noteIndex; });
+
+        if (ev.kind == Kind::Hit && ev.noteResult == sakura::game::JudgeResult::None &&
+            it == m_sliderStates.end())
+        {
+            sakura::game::SliderState ss;
+            ss.noteIndex  = noteIndex;
+            ss.headJudged = true;
+            ss.headResult = ev.result;
+            m_sliderStates.push_back(ss);
+        }
+        else if (ev.kind == Kind::SliderTick && it != m_sliderStates.end())
+        {
+            it->nextWaypointIndex = ev.waypoint + 1;
+        }
+        else if (ev.kind == Kind::SliderEnd && it != m_sliderStates.end())
         {
-            bestPriority = priority;
-            bestDist     = dist;
-            bestTDist    = absT;
-            bestIdx      = static_cast<int>(&n - msNotes.data());
+            m_sliderStates.erase(it);
         }
     }
-    if (bestIdx < 0) return;
 
-    auto& note   = msNotes[bestIdx];
-    auto  result = m_judge.JudgeMouseNote(note, now, mouseX, mouseY);
+    m_hudScore    = ev.score;
+    m_hudCombo    = ev.combo;
+    m_hudAccuracy = ev.accuracy;
 
-    if (note.type == sakura::game::NoteType::Slider &&
-        result != sakura::game::JudgeResult::Miss &&
-        result != sakura::game::JudgeResult::None)
+    if (ev.result == sakura::game::JudgeResult::None) return;
+
+    // 判定闪现：键盘在轨道上，鼠标在音符 / 拐点位置（鼠标区坐标转换为屏幕坐标）
+    if (ev.isKeyboard)
+    {
+        if (ev.lane >= 0 && ev.lane < LANE_COUNT)
+            AddJudgeFlash(ev.result, true, ev.lane);
+    }
+    else
     {
-        // 标记音符已判定（防止 CheckMouseMisses 在 Slider 进行中误判为 Miss）
-        // result 暂置 None，Slider 所有拐点判定完毕后在 OnUpdate 中填入终判结果
-        note.isJudged = true;
-        note.result   = sakura::game::JudgeResult::None;
-
-        // 开始 Slider 追踪
-        sakura::game::SliderState ss;
-        ss.noteIndex   = bestIdx;
-        ss.headJudged  = true;
-        ss.headResult  = result;
-        m_sliderStates.push_back(ss);
+        AddJudgeFlash(ev.result, false, 0,
+                      MOUSE_X + ev.x * MOUSE_W, MOUSE_Y + ev.y * MOUSE_H);
     }
+}
+
+// ── FinishGame ────────────────────────────────────────────────────────────────
+
+void SceneGame::FinishGame()
+{
+    LOG_INFO("[SceneGame] 游戏完成，切换到结算");
 
-    // 仅在有效判定（非 None）时计分并显示判定闪现
-    // None 表示点击未命中音符（距离过远或时间太早），不应产生任何反馈
-    if (result != sakura::game::JudgeResult::None)
+    // 停止判定线程后 m_judgeSession 归主线程所有：先处理剩余事件，再补判 Miss
+    if (m_judgeThread.IsRunning())
     {
-        m_score.OnJudge(result, sakura::game::Judge::GetHitError(note.time, now));
-        // 将鼠标区局部坐标转换为屏幕坐标再存入闪现记录
-        float flashSX = MOUSE_X + note.x * MOUSE_W;
-        float flashSY = MOUSE_Y + note.y * MOUSE_H;
-        AddJudgeFlash(result, false, 0, flashSX, flashSY);
+        m_judgeThread.Stop();
+        m_judgeThread.DrainEvents([this](const sakura::game::JudgeEvent& ev) { ApplyJudgeEvent(ev); });
     }
+    m_judgeSession.Finish();
+    m_sliderStates.clear();
+
+    const auto& score = m_judgeSession.GetScore();
+    auto result = score.GetResult(
+        m_chartInfo.id,
+        m_chartInfo.title,
+        m_difficultyIndex < static_cast<int>(m_chartInfo.difficulties.size())
+            ? m_chartInfo.difficulties[m_difficultyIndex].name : "Unknown",
+        m_difficultyIndex,
+        m_difficultyIndex < static_cast<int>(m_chartInfo.difficulties.size())
+            ? m_chartInfo.difficulties[m_difficultyIndex].level : 0.0f,
+        std::max(0.0, static_cast<double>(m_gameState.GetCurrentTime()) / 1000.0)
+    );
+    m_manager.SwitchScene(
+        std::make_unique<SceneResult>(m_manager, result, m_chartInfo),
+        TransitionType::Fade, 0.5f);
 }
 
 // ── AddJudgeFlash ─────────────────────────────────────────────────────────────
@@ -391,189 +386,65 @@ void SceneGame::AddJudgeFlash(sakura::game::JudgeResult r, bool isKb,
 
 void SceneGame::OnUpdate(float dt)
 {
+    // 配置变更（如暂停菜单中调整流速）后刷新快照
+    const auto& cfgSnap = sakura::core::Config::GetInstance().GetSnapshot();
+    if (cfgSnap.version != m_config.version) m_config = cfgSnap;
+
     // 更新 GameState（倒计时、时间推进）
     m_gameState.Update(dt);
 
     // ── 游戏结束 → 切换到结算场景（在 IsPlaying 守卫之前检查）─────────────────
     if (m_gameState.IsFinished())
     {
-        LOG_INFO("[SceneGame] 游戏完成，切换到结算");
-
-        // 将活跃 Slider 中未完成的拐点计为 Miss（音乐结束时 Slider 可能仍在进行中）
-        auto& msNotes = m_gameState.GetMouseNotes();
-        for (auto& ss : m_sliderStates)
-        {
-            if (ss.noteIndex >= 0 && ss.noteIndex < static_cast<int>(msNotes.size()))
-            {
-                const auto& sliderNote = msNotes[ss.noteIndex];
-                int remaining = static_cast<int>(sliderNote.sliderPath.size())
-                                - ss.nextWaypointIndex;
-                for (int i = 0; i < remaining; ++i)
-                    m_score.OnJudge(sakura::game::JudgeResult::Miss, 0);
-            }
-        }
-        m_sliderStates.clear();
-
-        // 将 CheckFinished 中强制判定的 Miss 计入分数
-        int forcedMisses = m_gameState.TakeForcedMisses();
-        for (int i = 0; i < forcedMisses; ++i)
-            m_score.OnJudge(sakura::game::JudgeResult::Miss, 0);
-
-        auto result = m_score.GetResult(
-            m_chartInfo.id,
-            m_chartInfo.title,
-            m_difficultyIndex < static_cast<int>(m_chartInfo.difficulties.size())
-                ? m_chartInfo.difficulties[m_difficultyIndex].name : "Unknown",
-            m_difficultyIndex,
-            m_difficultyIndex < static_cast<int>(m_chartInfo.difficulties.size())
-                ? m_chartInfo.difficulties[m_difficultyIndex].level : 0.0f,
-            std::max(0.0, static_cast<double>(m_gameState.GetCurrentTime()) / 1000.0)
-        );
-        m_manager.SwitchScene(
-            std::make_unique<SceneResult>(m_manager, result, m_chartInfo),
-            TransitionType::Fade, 0.5f);
+        FinishGame();
         return;
     }
 
-    if (!m_gameState.IsPlaying()) return;
-
-    int now = m_gameState.GetCurrentTime();
-
-    // 按帧消费输入缓冲，避免同帧多个键鼠按下互相覆盖。
-    for (const auto& keyPress : sakura::core::Input::GetKeyPressEvents())
-        HandleKeyPress(static_cast<SDL_Scancode>(keyPress.scancode));
-
-    for (const auto& mousePress : sakura::core::Input::GetMouseButtonPressEvents())
-    {
-        if (mousePress.button == SDL_BUTTON_LEFT)
-            HandleMouseClick(mousePress.normX, mousePress.normY);
-    }
-
-    // ── 自动 Miss 检测 ─────────────────────────────────────────────────────────
+    if (m_gameState.IsPlaying())
     {
-        int misses = m_judge.CheckMisses(
-            m_gameState.GetKeyboardNotes(), now);
-        int mouseMisses = m_judge.CheckMouseMisses(
-            m_gameState.GetMouseNotes(), now);
+        // 按帧消费输入缓冲，避免同帧多个键鼠按下互相覆盖。
+        for (const auto& keyPress : sakura::core::Input::GetKeyPressEvents())
+            HandleKeyPress(static_cast<SDL_Scancode>(keyPress.scancode),
+                           m_gameState.EventTimeToGameMs(keyPress.timestampNs));
 
-        for (int i = 0; i < misses + mouseMisses; ++i)
-            m_score.OnJudge(sakura::game::JudgeResult::Miss, 0);
-    }
-
-    // ── Hold 持续判定 ────────────────────────────────────────────────────────
-    auto& kbNotes = m_gameState.GetKeyboardNotes();
-    for (auto it = m_holdStates.begin(); it != m_holdStates.end(); )
-    {
-        auto& hs   = *it;
-        if (hs.noteIndex < 0 || hs.noteIndex >= static_cast<int>(kbNotes.size()))
+        for (const auto& mousePress : sakura::core::Input::GetMouseButtonPressEvents())
         {
-            it = m_holdStates.erase(it);
-            continue;
+            if (mousePress.button == SDL_BUTTON_LEFT)
+                HandleMouseClick(mousePress.normX, mousePress.normY,
+                                 m_gameState.EventTimeToGameMs(mousePress.timestampNs));
         }
-        auto& note = kbNotes[hs.noteIndex];
 
-        // 按键短断触滤波：短时间掉键不立即视为松开
-        bool keyHeld = false;
-        if (note.lane >= 0 && note.lane < LANE_COUNT)
-            keyHeld = sakura::core::Input::IsKeyHeld(m_laneKeys[note.lane]);
-
-        if (keyHeld)
-        {
-            hs.isHeld = true;
-            hs.lastHeldTimeMs = now;
-            hs.releaseTimeMs = -1;
-        }
-        else
-        {
-            if (hs.releaseTimeMs < 0)
-            {
-                hs.releaseTimeMs = now;
-            }
-
-            bool withinGapTolerance = (hs.lastHeldTimeMs >= 0) &&
-                (now - hs.lastHeldTimeMs <= sakura::game::HoldState::INPUT_GAP_TOLERANCE_MS);
-            hs.isHeld = withinGapTolerance;
-            if (withinGapTolerance)
-                hs.releaseTimeMs = -1;
-        }
-
-        auto tickResult = m_judge.UpdateHoldTick(hs, note, now);
-        if (tickResult != sakura::game::JudgeResult::None)
-        {
-            // 写入终判结果（覆盖占位的 None）
-            note.result = tickResult;
-            m_score.OnJudge(tickResult, 0);
-            AddJudgeFlash(tickResult, true, note.lane);
-        }
-
-        // finalized 置位后移除（由 UpdateHoldTick 内部设置）
-        if (hs.finalized)
-        {
-            it = m_holdStates.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        // 鼠标位置 / 按住状态（Slider 路径追踪）
+        auto [mx, my] = sakura::core::Input::GetMousePosition();
+        sakura::game::JudgeInput mouse;
+        mouse.kind      = sakura::game::JudgeInput::Kind::MouseState;
+        mouse.x         = (mx - MOUSE_X) / MOUSE_W;
+        mouse.y         = (my - MOUSE_Y) / MOUSE_H;
+        mouse.mouseDown = sakura::core::Input::IsMouseButtonHeld(SDL_BUTTON_LEFT);
+        mouse.timeMs    = m_gameState.GetCurrentTimeMsPrecise();
+        SubmitJudgeInput(mouse);
+
+        // 同步模式：自动 Miss / Hold / Slider 判定在本帧时刻推进
+        if (!m_useJudgeThread)
+            m_judgeSession.Tick(m_gameState.GetCurrentTimeMsPrecise());
     }
 
-    // ── Slider 路径追踪 ───────────────────────────────────────────────────────
-    auto& msNotes = m_gameState.GetMouseNotes();
-    auto [mx, my] = sakura::core::Input::GetMousePosition();
-    float mouseX = (mx - MOUSE_X) / MOUSE_W;
-    float mouseY = (my - MOUSE_Y) / MOUSE_H;
-    bool  mouseDown = sakura::core::Input::IsMouseButtonHeld(SDL_BUTTON_LEFT);
+    // 线程模式：本帧输入转发完毕后再同步时钟，输入水位才不会越过尚未送达的按键
+    SyncJudgeClock();
 
-    for (auto it = m_sliderStates.begin(); it != m_sliderStates.end(); )
+    // ── 判定事件 → 闪现 / 粒子 / 音效 ────────────────────────────────────────
+    if (m_useJudgeThread)
     {
-        auto& ss = *it;
-        if (ss.noteIndex < 0 || ss.noteIndex >= static_cast<int>(msNotes.size()))
-        {
-            it = m_sliderStates.erase(it);
-            continue;
-        }
-        auto& note = msNotes[ss.noteIndex];
-
-        if (mouseDown)
-        {
-            ss.lastDownTimeMs = now;
-        }
-        bool filteredMouseDown = mouseDown ||
-            (ss.lastDownTimeMs >= 0 &&
-             now - ss.lastDownTimeMs <= sakura::game::SliderState::INPUT_GAP_TOLERANCE_MS);
-
-        auto sResult = m_judge.UpdateSliderTracking(
-            ss, note, now, mouseX, mouseY, filteredMouseDown);
-
-        // 拐点判定结果：计分并发出判定闪现
-        if (sResult != sakura::game::JudgeResult::None)
-        {
-            m_score.OnJudge(sResult, 0);
-            // 在刚判定的拐点位置显示判定结果
-            // UpdateSliderTracking 在判定后执行了 ++nextWaypointIndex，因此减 1 还原到刚判定的索引
-            // 边界检查确保安全（正常情况下 judgedIdx 恒 ≥ 0）
-            int judgedIdx = ss.nextWaypointIndex - 1;
-            if (judgedIdx >= 0 && judgedIdx < static_cast<int>(note.sliderPath.size()))
-            {
-                float wpSX = MOUSE_X + note.sliderPath[judgedIdx].first  * MOUSE_W;
-                float wpSY = MOUSE_Y + note.sliderPath[judgedIdx].second * MOUSE_H;
-                AddJudgeFlash(sResult, false, 0, wpSX, wpSY);
-            }
-        }
-
-        // 所有拐点判定完毕 → 填入终判结果，移除状态
-        if (ss.finalized)
-        {
-            note.result = ss.isMissed
-                ? sakura::game::JudgeResult::Miss
-                : ss.headResult;
-            it = m_sliderStates.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
+        m_judgeThread.DrainEvents([this](const sakura::game::JudgeEvent& ev) { ApplyJudgeEvent(ev); });
     }
+    else
+    {
+        for (const auto& ev : m_judgeSession.GetEvents())
+            ApplyJudgeEvent(ev);
+        m_judgeSession.ClearEvents();
+    }
+
+    if (!m_gameState.IsPlaying()) return;
 
     // ── 更新判定闪现计时器 ────────────────────────────────────────────────────
     for (auto it = m_judgeFlashes.begin(); it != m_judgeFlashes.end(); )
@@ -601,7 +472,7 @@ void SceneGame::OnUpdate(float dt)
     }
 
     // 连击里程碑检测（50/100/200/500/1000）
-    int currCombo = m_score.GetCombo();
+    int currCombo = m_hudCombo;
     static constexpr int MILESTONES[] = { 50, 100, 200, 500, 1000 };
     for (int ms : MILESTONES)
     {
@@ -636,6 +507,7 @@ void SceneGame::OnEvent(const SDL_Event& event)
             m_gameState.IsPlaying())
         {
             m_gameState.Pause();
+            SyncJudgeClock();   // 判定线程随之冻结
             m_manager.PushScene(
                 std::make_unique<ScenePause>(m_manager, m_gameState),
                 TransitionType::Fade, 0.3f);
@@ -644,25 +516,11 @@ void SceneGame::OnEvent(const SDL_Event& event)
         break;
 
     case SDL_EVENT_KEY_UP:
-    {
-        // 检测 Hold 松开 → 记录松开时刻
-        for (auto& hs : m_holdStates)
-        {
-            if (hs.noteIndex < 0) continue;
-            auto& kbNotes = m_gameState.GetKeyboardNotes();
-            if (hs.noteIndex < static_cast<int>(kbNotes.size()))
-            {
-                int lane = kbNotes[hs.noteIndex].lane;
-                if (event.key.scancode == m_laneKeys[lane] && hs.isHeld)
-                {
-                    hs.isHeld       = false;
-                    hs.releaseTimeMs = m_gameState.GetCurrentTime();
-                }
-            }
-        }
-
+        // 记录松开事件的真实时刻（映射到歌曲时间轴），Hold 以此判定松开
+        HandleKeyRelease(event.key.scancode,
+                         m_gameState.EventTimeToGameMs(event.key.timestamp));
         break;
-    }
+
     default:
         break;
     }
@@ -790,22 +648,26 @@ void SceneGame::RenderKeyboardNotes(sakura::core::Renderer& renderer)
 
     const auto& theme = sakura::core::Theme::GetInstance();
 
-    int now = m_gameState.GetCurrentTime();
-    auto activeNotes = m_gameState.GetActiveKeyboardNotes();
+    const double renderMs  = m_gameState.SampleRenderTimeUs() / 1000.0;
+    const double renderPos = m_gameState.GetScrollMap().PositionAt(renderMs);   // 每帧一次二分查找
+    auto activeNotes  = m_gameState.GetActiveKeyboardNotes();
+    auto activeStates = m_gameState.GetActiveKeyboardStates();
+    auto activeScroll = m_gameState.GetActiveKeyboardScroll();
 
-    for (const auto& note : activeNotes)
+    for (size_t i = 0; i < activeNotes.size(); ++i)
     {
-        if (note.isJudged && note.alpha <= 0.01f) continue;
+        const auto& note  = activeNotes[i];
+        const auto& state = activeStates[i];
+        if (state.isJudged && state.alpha <= 0.01f) continue;
 
-        float sv   = m_gameState.GetCurrentSVSpeed(now);
-        float ry   = CalcNoteRenderY(note.time, now, sv);
+        float ry   = CalcNoteRenderY(activeScroll[i].head, renderPos);
         float lx   = GetLaneX(note.lane);
-        float alpha = note.alpha;
+        float alpha = state.alpha;
 
         // Hold：预先计算尾部 Y，用于精确可见性判断
         float tailY = -999.0f;
         if (note.type == sakura::game::NoteType::Hold)
-            tailY = CalcNoteRenderY(note.time + note.duration, now, sv);
+            tailY = CalcNoteRenderY(activeScroll[i].tail, renderPos);
 
         // ── 可见性剔除 ─────────────────────────────────────────────────────────
         // Hold 头部可能已过判定线（ry > 1.05），但尾部仍在屏幕内，不可跳过
@@ -841,8 +703,8 @@ void SceneGame::RenderKeyboardNotes(sakura::core::Renderer& renderer)
         case sakura::game::NoteType::Hold:
         {
             // 持按中：头部钳制到判定线，保持视觉稳定
-            bool isHolding = note.isJudged &&
-                             (note.result == sakura::game::JudgeResult::None);
+            bool isHolding = state.isJudged &&
+                             (state.result == sakura::game::JudgeResult::None);
             float headY = (isHolding && ry > JUDGE_LINE_Y) ? JUDGE_LINE_Y : ry;
 
             float topY = std::min(headY - NOTE_H * 0.5f, tailY);
@@ -878,7 +740,10 @@ void SceneGame::RenderMouseNotes(sakura::core::Renderer& renderer)
     const auto& theme = sakura::core::Theme::GetInstance();
 
     int now = m_gameState.GetCurrentTime();
-    auto activeNotes = m_gameState.GetActiveMouseNotes();
+    const double renderMs = m_gameState.SampleRenderTimeUs() / 1000.0;
+    auto activeNotes  = m_gameState.GetActiveMouseNotes();
+    auto activeStates = m_gameState.GetActiveMouseStates();
+    const int activeBegin = static_cast<int>(m_gameState.GetActiveMouseBegin());
 
     auto drawGradientApproachRing = [&](float sx,
                                         float sy,
@@ -918,12 +783,14 @@ void SceneGame::RenderMouseNotes(sakura::core::Renderer& renderer)
         }
     };
 
-    for (const auto& note : activeNotes)
+    for (size_t i = 0; i < activeNotes.size(); ++i)
     {
-        if (note.isJudged && note.alpha <= 0.01f) continue;
+        const auto& note  = activeNotes[i];
+        const auto& state = activeStates[i];
+        if (state.isJudged && state.alpha <= 0.01f) continue;
 
-        float scale = CalcApproachScale(note.time, now);
-        uint8_t alpha = static_cast<uint8_t>(note.alpha * 220.0f);
+        float scale = CalcApproachScale(note.time, renderMs);
+        uint8_t alpha = static_cast<uint8_t>(state.alpha * 220.0f);
 
         switch (note.type)
         {
@@ -959,8 +826,7 @@ void SceneGame::RenderMouseNotes(sakura::core::Renderer& renderer)
             float sy = MOUSE_Y + note.y * MOUSE_H;
 
             // 查找对应的活跃 SliderState
-            auto& msNotes = m_gameState.GetMouseNotes();
-            int noteIndex = static_cast<int>(&note - msNotes.data());
+            int noteIndex = activeBegin + static_cast<int>(i);
             const sakura::game::SliderState* ssPtr = nullptr;
             for (const auto& s : m_sliderStates)
             {
@@ -1081,7 +947,7 @@ void SceneGame::RenderHUD(sakura::core::Renderer& renderer)
     // 分数（右对齐 0.96, 0.02）
     {
         std::ostringstream ss;
-        ss << std::setw(7) << std::setfill('0') << m_score.GetScore();
+        ss << std::setw(7) << std::setfill('0') << m_hudScore;
         renderer.DrawText(m_fontHUD, ss.str(),
             0.96f, 0.02f, 0.040f,
             sakura::core::Color{ theme.Text().r, theme.Text().g, theme.Text().b, 230 },
@@ -1090,7 +956,7 @@ void SceneGame::RenderHUD(sakura::core::Renderer& renderer)
 
     // 连击（居中 0.225, 0.05，只在 ≥10 时显示）
     {
-        int combo = m_score.GetCombo();
+        int combo = m_hudCombo;
         if (combo >= 10)
         {
             renderer.DrawText(m_fontHUD, std::to_string(combo),
@@ -1107,7 +973,7 @@ void SceneGame::RenderHUD(sakura::core::Renderer& renderer)
     // 准确率（右对齐 0.96, 0.065）
     {
         std::ostringstream ss;
-        ss << std::fixed << std::setprecision(2) << m_score.GetAccuracy() << "%";
+        ss << std::fixed << std::setprecision(2) << m_hudAccuracy << "%";
         renderer.DrawText(m_fontSmall, ss.str(),
             0.96f, 0.065f, 0.025f,
             sakura::core::Color{ theme.Text().r, theme.Text().g, theme.Text().b, 200 },
@@ -1196,6 +1062,10 @@ void SceneGame::RenderJudgeFlashes(sakura::core::Renderer& renderer)
 
 void SceneGame::OnRender(sakura::core::Renderer& renderer)
 {
+    // 压力测试：人为制造渲染卡顿（判定线程模式下判定时刻应不受影响）
+    if (m_stressStallMs > 0 && ++m_stressFrameCount % STRESS_STALL_INTERVAL == 0)
+        SDL_Delay(static_cast<Uint32>(m_stressStallMs));
+
     RenderBackground(renderer);
     RenderTrack(renderer);
 
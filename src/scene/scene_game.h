@@ -4,11 +4,13 @@
 
 #include "scene.h"
 #include "scene_manager.h"
+#include "core/config.h"
 #include "core/renderer.h"
 #include "core/resource_manager.h"
 #include "game/game_state.h"
 #include "game/judge.h"
-#include "game/score.h"
+#include "game/judge_session.h"
+#include "game/judge_thread.h"
 #include "effects/particle_system.h"
 #include "effects/glow.h"
 #include "effects/screen_shake.h"
@@ -56,14 +58,28 @@ private:
     // 游戏核心系统
     sakura::game::GameState        m_gameState;
     sakura::game::Judge            m_judge;
-    sakura::game::ScoreCalculator  m_score;
+    sakura::game::JudgeSession     m_judgeSession;   // 判定 + 计分（权威状态）
+    sakura::game::JudgeThread      m_judgeThread;    // 可选：1kHz 独立判定线程驱动 m_judgeSession
+    bool                           m_useJudgeThread = false;
+
+    // HUD 显示的计分快照（取自最近处理的 JudgeEvent）
+    int   m_hudScore    = 0;
+    int   m_hudCombo    = 0;
+    float m_hudAccuracy = 100.0f;
+
+    // 配置快照：OnEnter 时拷贝，之后按版本号在 OnUpdate 中刷新（渲染路径只读这里）
+    sakura::core::ConfigSnapshot m_config;
+
+    // 压力测试：每隔若干帧在渲染中人为阻塞（Config "debug.judge_stress_stall_ms"，0 = 关闭）
+    int m_stressStallMs   = 0;
+    int m_stressFrameCount = 0;
+    static constexpr int STRESS_STALL_INTERVAL = 30;   // 帧
 
     // 初始化参数（OnEnter 时传给 GameState::Start）
     sakura::game::ChartInfo m_chartInfo;
     int                     m_difficultyIndex;
 
-    // Hold/Slider 活跃状态
-    std::vector<sakura::game::HoldState>   m_holdStates;
+    // 进行中 Slider 的显示状态（由 JudgeEvent 维护，只用于渲染路径进度）
     std::vector<sakura::game::SliderState> m_sliderStates;
 
     // 判定闪现
@@ -111,19 +127,37 @@ private:
     // ── 内部方法 ──────────────────────────────────────────────────────────────
 
     // 计算键盘音符的渲染 Y（判定线=0.85，向上为正方向）
-    float CalcNoteRenderY(int noteTimeMs, int currentTimeMs, float svSpeed) const;
+    // 参数为 SV 滚动位置（ScrollMap）：音符位置取自 GetActiveKeyboardScroll() 缓存，
+    // 当前位置为 PositionAt(亚毫秒渲染时间)，每帧计算一次
+    float CalcNoteRenderY(double noteScrollPos, double currentScrollPos) const;
 
     // 计算鼠标音符的接近圈缩放倍率（2.5~1.0）
-    float CalcApproachScale(int noteTimeMs, int currentTimeMs) const;
+    float CalcApproachScale(int noteTimeMs, double currentTimeMs) const;
 
     // 获取轨道 X 坐标（左边缘）
     float GetLaneX(int lane) const { return TRACK_X + lane * LANE_W; }
 
-    // 响应按键判定
-    void HandleKeyPress(SDL_Scancode key);
+    // 按键 → 轨道（未绑定返回 -1）
+    int LaneForKey(SDL_Scancode key) const;
+
+    // 转发按键 / 松开（timeMs: 事件时刻映射到的游戏时间，见 GameState::EventTimeToGameMs）
+    void HandleKeyPress(SDL_Scancode key, double pressTimeMs);
+    void HandleKeyRelease(SDL_Scancode key, double releaseTimeMs);
+
+    // 转发鼠标点击（clickTimeMs 同上）
+    void HandleMouseClick(float normX, float normY, double clickTimeMs);
+
+    // 输入交给判定：线程模式入队，同步模式立即处理
+    void SubmitJudgeInput(const sakura::game::JudgeInput& input);
+
+    // 线程模式：把当前歌曲时钟与输入水位（本帧事件泵取时刻）同步给判定线程
+    void SyncJudgeClock();
+
+    // 处理一条判定事件：更新显示状态 / HUD 快照，并触发闪现、粒子、音效
+    void ApplyJudgeEvent(const sakura::game::JudgeEvent& ev);
 
-    // 响应鼠标点击判定
-    void HandleMouseClick(float normX, float normY);
+    // 结算：停止判定线程、处理剩余事件并补判 Miss，切换到结算场景
+    void FinishGame();
 
     // 添加判定闪现
     void AddJudgeFlash(sakura::game::JudgeResult r, bool isKb, int lane = 0,
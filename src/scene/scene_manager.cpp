@@ -233,6 +233,9 @@ void SceneManager::RenderTransition(sakura::core::Renderer& renderer)
     const int sh = renderer.GetScreenHeight();
     const float t = std::clamp(m_transitionTimer / m_transitionDuration, 0.0f, 1.0f);
 
+    // 以下混用 Renderer 批处理与原生 SDL 绘制：原生绘制前先提交已累积的图元
+    renderer.Flush();
+
     // 首帧：录制源场景快照
     if (!m_texFrom && !m_sceneStack.empty())
     {
@@ -245,7 +248,7 @@ void SceneManager::RenderTransition(sakura::core::Renderer& renderer)
 
         if (m_texFrom)
         {
-            SDL_SetRenderTarget(sdlRenderer, m_texFrom);
+            renderer.SetRenderTarget(m_texFrom);
             SDL_SetRenderDrawColor(sdlRenderer, 15, 15, 35, 255);
             SDL_RenderClear(sdlRenderer);
 
@@ -255,7 +258,7 @@ void SceneManager::RenderTransition(sakura::core::Renderer& renderer)
                 scene->OnRender(renderer);
             }
 
-            SDL_SetRenderTarget(sdlRenderer, nullptr);
+            renderer.SetRenderTarget(nullptr);
         }
     }
 
@@ -277,6 +280,7 @@ void SceneManager::RenderTransition(sakura::core::Renderer& renderer)
                 {
                     scene->OnRender(renderer);
                 }
+                renderer.Flush();
             }
 
             // 叠加一层逐渐加深的过渡遮罩
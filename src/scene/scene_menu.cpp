@@ -9,7 +9,7 @@
 #include "scene_chart_wizard.h"
 #include "audio/audio_visualizer.h"
 #include "core/input.h"
-#include "game/chart_loader.h"
+#include "game/chart_library.h"
 #include "utils/logger.h"
 #include "utils/easing.h"
 #include "effects/particle_system.h"
@@ -225,9 +225,8 @@ void SceneMenu::ScanCustomCharts()
     std::error_code ec;
     std::filesystem::create_directories(CUSTOM_CHARTS_PATH, ec);
 
-    sakura::game::ChartLoader loader;
-    auto charts = loader.ScanCharts(CUSTOM_CHARTS_PATH);
-    for (auto& ci : charts)
+    auto charts = sakura::game::ChartLibrary::GetInstance().GetCharts(CUSTOM_CHARTS_PATH);
+    for (const auto& ci : *charts)
     {
         ChartEntry entry;
         entry.folderPath = ci.folderPath;
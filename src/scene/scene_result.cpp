@@ -88,7 +88,9 @@ void SceneResult::OnEnter()
     sakura::audio::AudioManager::GetInstance().StopMusic();
 
     // ── 保存成绩到数据库 ──────────────────────────────────────────────────────
+    // 只入队，不等待提交；下面的成就检查读取时已包含这局成绩
     sakura::data::Database::GetInstance().SaveScore(m_result);
+    sakura::game::PPCalculator::GetInstance().SubmitBest(m_result);
 
     for (const auto& achievement : sakura::game::AchievementManager::GetInstance().CheckAndUnlock(m_result))
     {
@@ -8,7 +8,7 @@
 #include "utils/logger.h"
 #include "utils/easing.h"
 #include "audio/audio_manager.h"
-#include "game/chart_loader.h"
+#include "game/chart_library.h"
 #include "data/database.h"
 #include "ui/visual_style.h"
 
@@ -45,10 +45,9 @@ void SceneSelect::OnEnter()
     m_fontUI    = rm.GetDefaultFontHandle();
     m_fontSmall = rm.GetDefaultFontHandle();
 
-    // 扫描谱面
-    sakura::game::ChartLoader loader;
-    m_charts = loader.ScanCharts("resources/charts/");
-    LOG_INFO("[SceneSelect] 找到 {} 首曲目", static_cast<int>(m_charts.size()));
+    // 获取共享谱面列表（每次进入都做一次只 stat 的增量扫描，运行期间增删改的谱面随即可见）
+    m_charts = sakura::game::ChartLibrary::GetInstance().GetCharts("resources/charts/");
+    LOG_INFO("[SceneSelect] 找到 {} 首曲目", static_cast<int>(m_charts->size()));
 
     // 建立 UI
     SetupUI();
@@ -57,7 +56,7 @@ void SceneSelect::OnEnter()
     UpdateSongList();
 
     // 若有谱面则默认选中第一首
-    if (!m_charts.empty())
+    if (!m_charts->empty())
     {
         m_songList->SetSelectedIndex(0);
         OnSongSelected(0);
@@ -80,7 +79,7 @@ void SceneSelect::SetupUI()
     {
         m_selectedChart = idx;
         if (m_btnStart) m_btnStart->SetEnabled(true);
-        LOG_INFO("[SceneSelect] 双击确认: {}", m_charts[idx].title);
+        LOG_INFO("[SceneSelect] 双击确认: {}", (*m_charts)[idx].title);
         // Step 1.11 完成后：切换到 SceneGame
     });
 
@@ -100,17 +99,17 @@ void SceneSelect::SetupUI()
         sakura::core::NormRect{ 0.78f, 0.926f, 0.18f, 0.055f },
         "开始游戏", m_fontUI, 0.026f, 0.010f);
     sakura::ui::VisualStyle::ApplyButton(m_btnStart.get(), sakura::ui::ButtonVariant::Primary);
-    m_btnStart->SetEnabled(!m_charts.empty());
+    m_btnStart->SetEnabled(!m_charts->empty());
     m_btnStart->SetOnClick([this]()
     {
-        if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts.size()))
+        if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts->size()))
             return;
         LOG_INFO("[SceneSelect] 开始游戏: {} [{}]",
-                 m_charts[m_selectedChart].title, m_selectedDifficulty);
+                 (*m_charts)[m_selectedChart].title, m_selectedDifficulty);
         StopPreview();
         m_manager.SwitchScene(
             std::make_unique<SceneGame>(m_manager,
-                m_charts[m_selectedChart], m_selectedDifficulty),
+                (*m_charts)[m_selectedChart], m_selectedDifficulty),
             TransitionType::Fade, 0.5f);
     });
 }
@@ -122,8 +121,8 @@ void SceneSelect::UpdateSongList()
     if (!m_songList) return;
 
     std::vector<std::string> items;
-    items.reserve(m_charts.size());
-    for (const auto& info : m_charts)
+    items.reserve(m_charts->size());
+    for (const auto& info : *m_charts)
         items.push_back(FormatListItem(info));
 
     m_songList->SetItems(items);
@@ -156,10 +155,10 @@ std::string SceneSelect::FormatListItem(const sakura::game::ChartInfo& info) con
 void SceneSelect::RefreshDifficultyButtons()
 {
     m_diffButtons.clear();
-    if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts.size()))
+    if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts->size()))
         return;
 
-    const auto& chart = m_charts[m_selectedChart];
+    const auto& chart = (*m_charts)[m_selectedChart];
     int diffCount = std::min(static_cast<int>(chart.difficulties.size()),
                              MAX_DIFF_BUTTONS);
     if (diffCount <= 0) return;
@@ -210,7 +209,7 @@ void SceneSelect::RefreshDifficultyButtons()
 
 void SceneSelect::OnSongSelected(int index)
 {
-    if (index < 0 || index >= static_cast<int>(m_charts.size())) return;
+    if (index < 0 || index >= static_cast<int>(m_charts->size())) return;
 
     // 切换谱面时立即停止当前预览，并重置状态以触发新预览倒计时
     StopPreview();
@@ -221,7 +220,7 @@ void SceneSelect::OnSongSelected(int index)
     m_previewTimer     = 0.0f;   // 重置预览计时
 
     // 加载封面
-    const auto& chart = m_charts[index];
+    const auto& chart = (*m_charts)[index];
     if (!chart.coverFile.empty())
     {
         std::string coverPath = chart.folderPath + "/" + chart.coverFile;
@@ -254,10 +253,10 @@ void SceneSelect::OnExit()
 
 void SceneSelect::StartPreview()
 {
-    if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts.size()))
+    if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts->size()))
         return;
 
-    const auto& chart = m_charts[m_selectedChart];
+    const auto& chart = (*m_charts)[m_selectedChart];
     if (chart.musicFile.empty()) return;
 
     std::string musicPath = chart.folderPath + "/" + chart.musicFile;
@@ -303,7 +302,7 @@ void SceneSelect::OnUpdate(float dt)
     }
 
     // 键盘上下切换
-    int listSize = static_cast<int>(m_charts.size());
+    int listSize = static_cast<int>(m_charts->size());
     if (listSize > 0)
     {
         if (sakura::core::Input::IsKeyPressed(SDL_SCANCODE_UP) ||
@@ -329,13 +328,13 @@ void SceneSelect::OnUpdate(float dt)
         {
             if (m_btnStart && m_btnStart->IsEnabled() &&
                 m_selectedChart >= 0 &&
-                m_selectedChart < static_cast<int>(m_charts.size()))
+                m_selectedChart < static_cast<int>(m_charts->size()))
             {
                 LOG_INFO("[SceneSelect] 键盘确认选曲");
                 StopPreview();
                 m_manager.SwitchScene(
                     std::make_unique<SceneGame>(m_manager,
-                        m_charts[m_selectedChart], m_selectedDifficulty),
+                        (*m_charts)[m_selectedChart], m_selectedDifficulty),
                     TransitionType::Fade, 0.5f);
             }
         }
@@ -364,7 +363,7 @@ void SceneSelect::RenderDetailPanel(sakura::core::Renderer& renderer)
 {
     sakura::ui::VisualStyle::DrawPanel(renderer, { 0.50f, 0.10f, 0.48f, 0.80f }, false, true);
 
-    if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts.size()))
+    if (m_selectedChart < 0 || m_selectedChart >= static_cast<int>(m_charts->size()))
     {
         // 未选中提示
         if (m_fontUI != sakura::core::INVALID_HANDLE)
@@ -377,7 +376,7 @@ void SceneSelect::RenderDetailPanel(sakura::core::Renderer& renderer)
         return;
     }
 
-    const auto& chart = m_charts[m_selectedChart];
+    const auto& chart = (*m_charts)[m_selectedChart];
 
     // 封面区 (0.52, 0.12, 0.20, 0.35)
     sakura::core::NormRect coverRect = { 0.52f, 0.12f, 0.20f, 0.35f };
@@ -38,8 +38,8 @@ public:
 private:
     SceneManager& m_manager;
 
-    // 谱面列表（OnEnter 扫描填充）
-    std::vector<sakura::game::ChartInfo> m_charts;
+    // 谱面列表（OnEnter 时取 ChartLibrary 共享快照）
+    std::shared_ptr<const std::vector<sakura::game::ChartInfo>> m_charts;
     int m_selectedChart    = -1;  // 当前选中曲目下标
     int m_selectedDifficulty = 0; // 当前选中难度下标
 
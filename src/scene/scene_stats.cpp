@@ -230,17 +230,20 @@ void SceneStats::RefreshData()
 {
     auto& db = sakura::data::Database::GetInstance();
 
-    sakura::game::PPCalculator calculator;
-    calculator.RecalculateTotal(db.GetAllBestScores());
+    // 排名常驻内存，结算时增量更新；仅首次进入时从 best_scores 加载
+    auto& calculator = sakura::game::PPCalculator::GetInstance();
+    if (!calculator.IsLoaded())
+        calculator.LoadFromDatabase();
 
     m_stats.totalPP = calculator.GetTotalPP();
-    m_stats.playCount = db.GetTotalPlayCount();
-    m_stats.playTimeSeconds = db.GetTotalPlayTimeSeconds();
-    m_stats.totalNotes = db.GetTotalNotesJudged();
-    m_stats.averageAccuracy = db.GetAverageAccuracy();
-    m_stats.fullComboCount = db.GetFullComboCount();
-    m_stats.allPerfectCount = db.GetAllPerfectCount();
-    m_stats.gradeDistribution = db.GetGradeDistribution();
+    const auto aggregates = db.GetStatsSnapshot();
+    m_stats.playCount = aggregates.playCount;
+    m_stats.playTimeSeconds = aggregates.playTimeSeconds;
+    m_stats.totalNotes = static_cast<int>(aggregates.notesJudged);
+    m_stats.averageAccuracy = aggregates.AverageAccuracy();
+    m_stats.fullComboCount = aggregates.fullComboCount;
+    m_stats.allPerfectCount = aggregates.allPerfectCount;
+    m_stats.gradeDistribution = aggregates.gradeDistribution;
 
     m_recentScores = db.GetRecentScores(20);
     m_topPPPlays = calculator.GetBestPlays(10);
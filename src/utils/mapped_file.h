@@ -0,0 +1,43 @@
+#pragma once
+
+// mapped_file.h — 只读内存映射文件（RAII）
+// Windows 使用 CreateFileMapping，其他平台使用 mmap
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sakura::utils
+{
+
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // 以只读方式映射整个文件；空文件或打开失败返回 false
+    bool Open(const std::string& path);
+    void Close();
+
+    bool           IsOpen() const { return m_data != nullptr; }
+    const uint8_t* Data()   const { return m_data; }
+    size_t         Size()   const { return m_size; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t         m_size = 0;
+#ifdef _WIN32
+    void*          m_fileHandle    = nullptr;
+    void*          m_mappingHandle = nullptr;
+#else
+    int            m_fd = -1;
+#endif
+};
+
+} // namespace sakura::utils
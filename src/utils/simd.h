@@ -0,0 +1,123 @@
+#pragma once
+
+// simd.h — 可移植的单精度浮点向量封装（仅覆盖批量积分所需的逐元素运算）
+// 按编译目标选择宽度：AVX 8 路 → SSE2 4 路 → NEON 4 路 → 标量 1 路。
+// x86-64 默认即有 SSE2；以 -mavx / /arch:AVX 编译时自动启用 8 路。
+// 读写均为非对齐访问，调用方按 Width 分块处理，尾部用标量收尾：
+//
+//   size_t i = 0;
+//   for (; i + FloatV::Width <= n; i += FloatV::Width)
+//       (FloatV::Load(x + i) + FloatV::Load(v + i) * dtv).Store(x + i);
+//   for (; i < n; ++i) x[i] += v[i] * dt;
+
+#include <cstddef>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define SAKURA_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SAKURA_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define SAKURA_SIMD_NEON 1
+#endif
+
+namespace sakura::utils::simd
+{
+
+#if defined(SAKURA_SIMD_AVX)
+
+struct FloatV
+{
+    static constexpr size_t Width = 8;
+    static constexpr const char* Name = "AVX";
+
+    __m256 v;
+
+    FloatV() : v(_mm256_setzero_ps()) {}
+    explicit FloatV(float s) : v(_mm256_set1_ps(s)) {}
+    FloatV(__m256 raw) : v(raw) {}
+
+    static FloatV Load(const float* p) { return _mm256_loadu_ps(p); }
+    void Store(float* p) const         { _mm256_storeu_ps(p, v); }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return _mm256_add_ps(a.v, b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return _mm256_sub_ps(a.v, b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return _mm256_mul_ps(a.v, b.v); }
+    friend FloatV Min(FloatV a, FloatV b)       { return _mm256_min_ps(a.v, b.v); }
+    friend FloatV Max(FloatV a, FloatV b)       { return _mm256_max_ps(a.v, b.v); }
+};
+
+#elif defined(SAKURA_SIMD_SSE2)
+
+struct FloatV
+{
+    static constexpr size_t Width = 4;
+    static constexpr const char* Name = "SSE2";
+
+    __m128 v;
+
+    FloatV() : v(_mm_setzero_ps()) {}
+    explicit FloatV(float s) : v(_mm_set1_ps(s)) {}
+    FloatV(__m128 raw) : v(raw) {}
+
+    static FloatV Load(const float* p) { return _mm_loadu_ps(p); }
+    void Store(float* p) const         { _mm_storeu_ps(p, v); }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return _mm_add_ps(a.v, b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return _mm_sub_ps(a.v, b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return _mm_mul_ps(a.v, b.v); }
+    friend FloatV Min(FloatV a, FloatV b)       { return _mm_min_ps(a.v, b.v); }
+    friend FloatV Max(FloatV a, FloatV b)       { return _mm_max_ps(a.v, b.v); }
+};
+
+#elif defined(SAKURA_SIMD_NEON)
+
+struct FloatV
+{
+    static constexpr size_t Width = 4;
+    static constexpr const char* Name = "NEON";
+
+    float32x4_t v;
+
+    FloatV() : v(vdupq_n_f32(0.0f)) {}
+    explicit FloatV(float s) : v(vdupq_n_f32(s)) {}
+    FloatV(float32x4_t raw) : v(raw) {}
+
+    static FloatV Load(const float* p) { return vld1q_f32(p); }
+    void Store(float* p) const         { vst1q_f32(p, v); }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return vaddq_f32(a.v, b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return vsubq_f32(a.v, b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return vmulq_f32(a.v, b.v); }
+    friend FloatV Min(FloatV a, FloatV b)       { return vminq_f32(a.v, b.v); }
+    friend FloatV Max(FloatV a, FloatV b)       { return vmaxq_f32(a.v, b.v); }
+};
+
+#else
+
+// 标量回退：接口一致，编译器仍可自行向量化
+struct FloatV
+{
+    static constexpr size_t Width = 1;
+    static constexpr const char* Name = "scalar";
+
+    float v = 0.0f;
+
+    FloatV() = default;
+    explicit FloatV(float s) : v(s) {}
+
+    static FloatV Load(const float* p) { return FloatV(*p); }
+    void Store(float* p) const         { *p = v; }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return FloatV(a.v + b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return FloatV(a.v - b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return FloatV(a.v * b.v); }
+    friend FloatV Min(FloatV a, FloatV b)       { return FloatV(a.v < b.v ? a.v : b.v); }
+    friend FloatV Max(FloatV a, FloatV b)       { return FloatV(a.v < b.v ? b.v : a.v); }
+};
+
+#endif
+
+} // namespace sakura::utils::simd
@@ -0,0 +1,81 @@
+#pragma once
+
+// spsc_ring.h — 单生产者 / 单消费者无锁环形队列
+// 固定容量（2 的幂），元素按值拷贝。生产者只写 m_tail、消费者只写 m_head，
+// 两端各缓存一份对端索引，只有缓存判定"满 / 空"时才重新读取对端原子变量，
+// 避免每次操作都在两个核心之间来回传递缓存行。
+// 仅限一个线程 TryPush、另一个线程 TryPop；不阻塞、不分配。
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace sakura::utils
+{
+
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing 容量须为 2 的幂");
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SpscRing 元素须可平凡拷贝");
+
+public:
+    static constexpr size_t CAPACITY = Capacity;
+
+    // 生产者：队列已满返回 false（元素未写入）
+    bool TryPush(const T& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == Capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == Capacity) return false;
+        }
+        m_slots[tail & MASK] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：队列为空返回 false
+    bool TryPop(T& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) return false;
+        }
+        out = m_slots[head & MASK];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似元素数（两端并发时仅供统计 / 调试）
+    size_t SizeApprox() const
+    {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool EmptyApprox() const { return SizeApprox() == 0; }
+
+private:
+    static constexpr size_t MASK       = Capacity - 1;
+    static constexpr size_t CACHE_LINE = 64;
+
+    // 生产者侧
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{ 0 };
+    size_t m_cachedHead = 0;
+
+    // 消费者侧
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{ 0 };
+    size_t m_cachedTail = 0;
+
+    alignas(CACHE_LINE) std::array<T, Capacity> m_slots{};
+};
+
+} // namespace sakura::utils
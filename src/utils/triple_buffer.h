@@ -0,0 +1,50 @@
+#pragma once
+
+// triple_buffer.h — 单写者 / 单读者无锁三缓冲
+// 写者在后台缓冲上写完整一帧后 Publish()，读者 Fetch() 取得最新已发布的一帧。
+// 三个缓冲轮换，写者永不等待读者、读者永远读到完整的一帧（中间帧可能被跳过）。
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace sakura::utils
+{
+
+template <typename T>
+class TripleBuffer
+{
+public:
+    // ── 写者 ──────────────────────────────────────────────────────────────────
+
+    T& WriteBuffer() { return m_buffers[m_back]; }
+
+    // 发布 WriteBuffer() 中的内容，并换到一个空闲缓冲继续写
+    void Publish()
+    {
+        m_back = m_middle.exchange(static_cast<uint8_t>(m_back | DIRTY), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // ── 读者 ──────────────────────────────────────────────────────────────────
+
+    // 有新发布的帧时切换到该帧并返回 true；否则保持上一帧
+    bool Fetch()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & DIRTY)) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& ReadBuffer() const { return m_buffers[m_front]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t DIRTY = 0x4;
+
+    std::array<T, 3>     m_buffers{};
+    std::atomic<uint8_t> m_middle{ 1 };
+    uint8_t              m_back  = 0;   // 仅写者
+    uint8_t              m_front = 2;   // 仅读者
+};
+
+} // namespace sakura::utils
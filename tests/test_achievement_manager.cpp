@@ -4,8 +4,13 @@
 #include "game/achievement_manager.h"
 #include "game/chart.h"
 
+#include <sqlite3.h>
+
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -77,7 +82,7 @@ TEST_CASE("AchievementManager 首次游玩触发 first_play", "[achievement]")
     REQUIRE(manager.LoadAchievements());
 
     auto result = MakeResult(850000, 95.2f, 48, false, false);
-    REQUIRE(database.SaveScore(result));
+    auto saved  = database.SaveScore(result);
 
     auto unlocked = manager.CheckAndUnlock(result);
     REQUIRE(!unlocked.empty());
@@ -87,6 +92,9 @@ TEST_CASE("AchievementManager 首次游玩触发 first_play", "[achievement]")
             return progress.definition.id == "first_play";
         }));
     REQUIRE(database.IsAchievementUnlocked("first_play"));
+
+    database.Flush();
+    REQUIRE(saved.get());
 }
 
 TEST_CASE("AchievementManager 根据成绩和连击解锁一次性成就", "[achievement]")
@@ -99,7 +107,7 @@ TEST_CASE("AchievementManager 根据成绩和连击解锁一次性成就", "[ach
 
     auto result = MakeResult(999500, 99.61f, 120, true, true, sakura::game::Grade::SS,
         "spring_breeze", "Hard", 5.5f);
-    REQUIRE(database.SaveScore(result));
+    auto saved = database.SaveScore(result);
 
     auto unlocked = manager.CheckAndUnlock(result);
     REQUIRE(unlocked.size() >= 6);
@@ -109,6 +117,9 @@ TEST_CASE("AchievementManager 根据成绩和连击解锁一次性成就", "[ach
     REQUIRE(database.IsAchievementUnlocked("combo_100"));
     REQUIRE(database.IsAchievementUnlocked("accuracy_99"));
     REQUIRE(database.IsAchievementUnlocked("score_999k"));
+
+    database.Flush();
+    REQUIRE(saved.get());
 }
 
 TEST_CASE("AchievementManager 累计游玩阈值可解锁", "[achievement]")
@@ -124,8 +135,10 @@ TEST_CASE("AchievementManager 累计游玩阈值可解锁", "[achievement]")
         auto result = MakeResult(800000 + index, 90.0f + static_cast<float>(index) * 0.1f,
             30 + index, false, false, sakura::game::Grade::B,
             "tutorial_song", "Easy", 1.0f);
-        REQUIRE(database.SaveScore(result));
+        auto saved = database.SaveScore(result);
         manager.CheckAndUnlock(result);
+        database.Flush();
+        REQUIRE(saved.get());
     }
 
     REQUIRE(database.IsAchievementUnlocked("play_10"));
@@ -136,3 +149,100 @@ TEST_CASE("AchievementManager 累计游玩阈值可解锁", "[achievement]")
     REQUIRE(progress->target == 50);
     REQUIRE_THAT(progress->progress, sakura::tests::Matchers::WithinAbs(0.2, 0.001));
 }
+
+TEST_CASE("AchievementManager 按 metric 编译条件，谱面库变化时复查库总量阈值", "[achievement]")
+{
+    TempDatabaseScope scope("sakura-achievement-metrics.db");
+    auto& database = sakura::data::Database::GetInstance();
+    auto& manager  = sakura::game::AchievementManager::GetInstance();
+
+    const fs::path definitions = fs::temp_directory_path() / "sakura-achievement-metrics.json";
+    {
+        std::ofstream file(definitions, std::ios::trunc);
+        file << R"({ "achievements": [
+            { "id": "combo_50",    "metric": "highest_combo",       "target": 50 },
+            { "id": "combo_20",    "metric": "highest_combo",       "target": 20 },
+            { "id": "every_chart", "metric": "charts_played",       "target": "library" },
+            { "id": "s_twice",     "metric": "difficulties_s_rank", "target": 2 },
+            { "id": "mystery",     "metric": "unknown_metric",      "target": 1 }
+        ] })";
+    }
+    REQUIRE(manager.LoadAchievements(definitions.string()));
+    manager.OnEvent(sakura::game::ChartsChangedEvent{ 3, 6 });
+
+    auto play = [&](const char* chartId, int combo, sakura::game::Grade grade, int score)
+    {
+        auto result = MakeResult(score, 90.0f, combo, false, false, grade, chartId, "Hard", 4.0f);
+        database.SaveScore(result);
+        std::vector<std::string> ids;
+        for (const auto& progress : manager.CheckAndUnlock(result))
+            ids.push_back(progress.definition.id);
+        return ids;
+    };
+
+    // 同一度量按阈值升序，只解锁达到的那个
+    REQUIRE(play("a", 30, sakura::game::Grade::S, 900000) == std::vector<std::string>{ "combo_20" });
+    REQUIRE(manager.GetProgress("combo_50")->current == 30);
+
+    // 同一难度的更低分不替换最高分，S 评级计数不变
+    REQUIRE(play("a", 10, sakura::game::Grade::A, 800000).empty());
+    REQUIRE(manager.GetProgress("s_twice")->current == 1);
+    REQUIRE(play("b", 10, sakura::game::Grade::SS, 950000) == std::vector<std::string>{ "s_twice" });
+
+    // 阈值取谱面库总量：3 首中玩过 2 首，删掉一首后立即达成
+    REQUIRE(manager.GetProgress("every_chart")->target == 3);
+    REQUIRE(manager.GetProgress("every_chart")->current == 2);
+    auto unlocked = manager.OnEvent(sakura::game::ChartsChangedEvent{ 2, 4 });
+    REQUIRE(unlocked.size() == 1);
+    REQUIRE(unlocked[0].definition.id == "every_chart");
+
+    REQUIRE(!manager.GetProgress("mystery")->unlocked);
+
+    // 度量从数据库重建后与增量维护的结果一致
+    database.Flush();
+    REQUIRE(manager.LoadAchievements(definitions.string()));
+    REQUIRE(manager.GetProgress("combo_50")->current == 30);
+    REQUIRE(manager.GetProgress("s_twice")->unlocked);
+    REQUIRE(database.IsAchievementUnlocked("every_chart"));
+
+    std::error_code ec;
+    fs::remove(definitions, ec);
+}
+
+TEST_CASE("AchievementManager 数据库写入失败后从数据库重建度量", "[achievement]")
+{
+    TempDatabaseScope scope("sakura-achievement-failed-write.db");
+    auto& database = sakura::data::Database::GetInstance();
+    auto& manager  = sakura::game::AchievementManager::GetInstance();
+
+    // 另一条连接加触发器，让指定谱面的成绩插入失败
+    {
+        sqlite3* raw = nullptr;
+        REQUIRE(sqlite3_open(scope.path.string().c_str(), &raw) == SQLITE_OK);
+        REQUIRE(sqlite3_exec(raw, R"sql(
+            CREATE TRIGGER reject_boom BEFORE INSERT ON scores
+            WHEN NEW.chart_id = 'boom'
+            BEGIN SELECT RAISE(ABORT, 'rejected'); END;
+        )sql", nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(raw);
+    }
+
+    REQUIRE(manager.LoadAchievements());
+
+    auto play = [&](const std::string& chartId)
+    {
+        auto result = MakeResult(800000, 90.0f, 30, false, false, sakura::game::Grade::B, chartId);
+        auto saved  = database.SaveScore(result);
+        manager.CheckAndUnlock(result);
+        database.Flush();
+        return saved.get();
+    };
+
+    REQUIRE(play("tutorial_song"));
+    REQUIRE(!play("boom"));
+    REQUIRE(manager.GetProgress("play_10")->current == 2);   // 乐观计入了失败的一局
+
+    REQUIRE(play("tutorial_song"));
+    REQUIRE(manager.GetProgress("play_10")->current == 2);   // 重建后只计已落盘的成绩
+    REQUIRE(database.GetTotalPlayCount() == 2);
+}
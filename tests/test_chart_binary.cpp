@@ -0,0 +1,136 @@
+// tests/test_chart_binary.cpp — .skc 预编译谱面缓存往返与失效校验
+
+#include "test_framework.h"
+
+#include "game/chart_binary.h"
+#include "game/chart_loader.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace sakura::game;
+
+namespace
+{
+
+constexpr const char* kChartJson = R"({
+    "version": 2,
+    "timing_points": [{ "time": 0, "bpm": 150.0, "time_signature": [3, 4] }],
+    "sv_points": [
+        { "time": 2000, "speed": 0.5, "easing": "ease_in" },
+        { "time": 1000, "speed": 1.5 }
+    ],
+    "keyboard_notes": [
+        { "time": 1500, "lane": 3, "type": "hold", "duration": 400 },
+        { "time": 500,  "lane": 1, "type": "tap" }
+    ],
+    "mouse_notes": [
+        { "time": 900, "x": 0.2, "y": 0.3, "type": "slider", "slider_duration": 300,
+          "slider_path": [[0.4, 0.3], [0.6, 0.5]] },
+        { "time": 700, "x": 0.8, "y": 0.1, "type": "circle" }
+    ]
+})";
+
+std::filesystem::path WriteChart(const char* dirName, const std::string& text)
+{
+    const auto dir = std::filesystem::temp_directory_path() / dirName;
+    std::filesystem::create_directories(dir);
+    const auto path = dir / "hard.json";
+    std::ofstream ofs(path, std::ios::trunc);
+    ofs << text;
+    ofs.close();
+    std::filesystem::remove(ChartBinary::GetCachePath(path.string()));
+    return path;
+}
+
+} // namespace
+
+TEST_CASE("LoadChartData 首次加载生成 .skc 且缓存结果与 JSON 一致", "[charts][binary]")
+{
+    const auto path = WriteChart("sakura-chart-binary-roundtrip", kChartJson);
+    const auto cachePath = ChartBinary::GetCachePath(path.string());
+
+    ChartLoader loader;
+    auto fromJson = loader.LoadChartData(path.string());
+    REQUIRE(fromJson.has_value());
+    REQUIRE(std::filesystem::exists(cachePath));
+
+    auto fromCache = ChartBinary::Read(cachePath);
+    REQUIRE(fromCache.has_value());
+
+    REQUIRE(fromCache->version == fromJson->version);
+    REQUIRE(fromCache->timingPoints.size() == 1);
+    REQUIRE(fromCache->timingPoints[0].timeSigNumerator == 3);
+    REQUIRE_THAT(fromCache->timingPoints[0].bpm, sakura::tests::Matchers::WithinAbs(150.0, 1e-6));
+
+    REQUIRE(fromCache->svPoints.size() == 2);
+    REQUIRE(fromCache->svPoints[0].time == 1000);
+    REQUIRE(fromCache->svPoints[0].easing == "linear");
+    REQUIRE(fromCache->svPoints[1].easing == "ease_in");
+
+    REQUIRE(fromCache->keyboardNotes.size() == 2);
+    REQUIRE(fromCache->keyboardNotes[0].time == 500);
+    REQUIRE(fromCache->keyboardNotes[1].type == NoteType::Hold);
+    REQUIRE(fromCache->keyboardNotes[1].lane == 3);
+    REQUIRE(fromCache->keyboardNotes[1].duration == 400);
+
+    REQUIRE(fromCache->mouseNotes.size() == 2);
+    REQUIRE(fromCache->mouseNotes[0].type == NoteType::Circle);
+    const auto& slider = fromCache->mouseNotes[1];
+    REQUIRE(slider.type == NoteType::Slider);
+    REQUIRE(slider.sliderDuration == 300);
+    REQUIRE(slider.sliderPath.size() == 2);
+    REQUIRE_THAT(slider.sliderPath[1].first, sakura::tests::Matchers::WithinAbs(0.6, 1e-6));
+
+    // 第二次加载命中缓存
+    auto again = loader.LoadChartData(path.string());
+    REQUIRE(again.has_value());
+    REQUIRE(again->keyboardNotes.size() == fromJson->keyboardNotes.size());
+    REQUIRE(again->mouseNotes[1].sliderPath.size() == 2);
+}
+
+TEST_CASE("JSON 修改后 .skc 自动失效并重建", "[charts][binary]")
+{
+    const auto path = WriteChart("sakura-chart-binary-invalidate", kChartJson);
+
+    ChartLoader loader;
+    REQUIRE(loader.LoadChartData(path.string()).has_value());
+
+    std::string edited = kChartJson;
+    edited.replace(edited.find("\"lane\": 1"), 9, "\"lane\": 2");
+    {
+        std::ofstream ofs(path, std::ios::trunc);
+        ofs << edited;
+    }
+    // 保证 mtime 一定变化（部分文件系统 mtime 精度较粗）
+    std::filesystem::last_write_time(path,
+        std::filesystem::last_write_time(path) + std::chrono::seconds(2));
+
+    auto reloaded = loader.LoadChartData(path.string());
+    REQUIRE(reloaded.has_value());
+    REQUIRE(reloaded->keyboardNotes[0].lane == 2);
+
+    auto stamp = ChartBinary::ReadStamp(ChartBinary::GetCachePath(path.string()));
+    REQUIRE(stamp.has_value());
+    REQUIRE(stamp->hash == ChartBinary::HashBytes(edited));
+}
+
+TEST_CASE("损坏的 .skc 被忽略并从 JSON 重建", "[charts][binary]")
+{
+    const auto path = WriteChart("sakura-chart-binary-corrupt", kChartJson);
+    const auto cachePath = ChartBinary::GetCachePath(path.string());
+
+    ChartLoader loader;
+    REQUIRE(loader.LoadChartData(path.string()).has_value());
+
+    // 截断缓存文件（头部仍完好，但段长度与文件大小不符）
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 8);
+    REQUIRE(!ChartBinary::Read(cachePath).has_value());
+
+    auto reloaded = loader.LoadChartData(path.string());
+    REQUIRE(reloaded.has_value());
+    REQUIRE(reloaded->mouseNotes.size() == 2);
+    REQUIRE(ChartBinary::Read(cachePath).has_value());
+}
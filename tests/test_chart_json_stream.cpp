@@ -0,0 +1,110 @@
+// tests/test_chart_json_stream.cpp — 谱面数据流式解析容错与排序
+
+#include "test_framework.h"
+
+#include "game/chart_json_stream.h"
+
+#include <string>
+
+using namespace sakura::game;
+using sakura::tests::Matchers::WithinAbs;
+
+TEST_CASE("流式解析对缺失、null 与类型错误字段回退默认值", "[charts][stream]")
+{
+    const std::string text = R"({
+        "version": "two",
+        "timing_points": [
+            { "time": 0, "bpm": "fast", "numerator": 3 },
+            { "time": 500, "time_signature": [7, 8], "numerator": 5 },
+            { "time": 900, "time_signature": [6] }
+        ],
+        "sv_points": [{ "time": 100, "speed": null, "easing": 3 }],
+        "keyboard_notes": [
+            { "time": 1000, "lane": "2", "type": "hold", "duration": 300.9, "extra": { "nested": [1, 2] } },
+            { "time": 1200.7, "lane": 3, "type": 42 },
+            7,
+            { "time": 1500, "lane": 1, "type": "tap", "time": 1600 }
+        ],
+        "mouse_notes": [
+            { "time": 2000, "type": "slider", "slider_path": [[0.1, 0.2], [0.3], "bad", [0.5, 0.6, 0.7]] },
+            { "time": 2100, "x": true, "y": [0.1] }
+        ],
+        "unknown_section": { "deep": [[[{}]]] }
+    })";
+
+    auto data = ChartJsonStream::Parse(text, "inline");
+    REQUIRE(data.has_value());
+    REQUIRE(data->version == 1);
+
+    REQUIRE(data->timingPoints.size() == 3);
+    REQUIRE_THAT(data->timingPoints[0].bpm, WithinAbs(120.0, 1e-6));
+    REQUIRE(data->timingPoints[0].timeSigNumerator == 3);
+    REQUIRE(data->timingPoints[0].timeSigDenominator == 4);
+    REQUIRE(data->timingPoints[1].timeSigNumerator == 7);
+    REQUIRE(data->timingPoints[1].timeSigDenominator == 8);
+    REQUIRE(data->timingPoints[2].timeSigNumerator == 4);   // 数组不足 2 项，回退 numerator 默认值
+
+    REQUIRE(data->svPoints.size() == 1);
+    REQUIRE_THAT(data->svPoints[0].speed, WithinAbs(1.0, 1e-6));
+    REQUIRE(data->svPoints[0].easing == "linear");
+
+    // 非对象元素按全默认值音符处理（time=0，排到最前）
+    REQUIRE(data->keyboardNotes.size() == 4);
+    REQUIRE(data->keyboardNotes[0].time == 0);
+    REQUIRE(data->keyboardNotes[1].lane == 0);
+    REQUIRE(data->keyboardNotes[1].type == NoteType::Hold);
+    REQUIRE(data->keyboardNotes[1].duration == 300);
+    REQUIRE(data->keyboardNotes[2].time == 1200);
+    REQUIRE(data->keyboardNotes[2].type == NoteType::Tap);
+    REQUIRE(data->keyboardNotes[3].time == 1600);          // 重复字段以最后一次为准
+
+    REQUIRE(data->mouseNotes.size() == 2);
+    const auto& slider = data->mouseNotes[0];
+    REQUIRE(slider.type == NoteType::Slider);
+    REQUIRE(slider.sliderPath.size() == 2);
+    REQUIRE_THAT(slider.sliderPath[1].first, WithinAbs(0.5, 1e-6));
+    REQUIRE_THAT(slider.sliderPath[1].second, WithinAbs(0.6, 1e-6));
+    REQUIRE_THAT(data->mouseNotes[1].x, WithinAbs(1.0, 1e-6));
+    REQUIRE_THAT(data->mouseNotes[1].y, WithinAbs(0.5, 1e-6));
+    REQUIRE(data->mouseNotes[1].type == NoteType::Circle);
+}
+
+TEST_CASE("流式解析对乱序数组排序并补默认时间点", "[charts][stream]")
+{
+    const std::string text = R"({
+        "keyboard_notes": [
+            { "time": 300, "lane": 0 }, { "time": 100, "lane": 1 }, { "time": 200, "lane": 2 }
+        ],
+        "mouse_notes": [{ "time": 50 }, { "time": 50 }, { "time": 60 }]
+    })";
+
+    auto data = ChartJsonStream::Parse(text, "inline");
+    REQUIRE(data.has_value());
+    REQUIRE(data->timingPoints.size() == 1);
+    REQUIRE_THAT(data->timingPoints[0].bpm, WithinAbs(120.0, 1e-6));
+
+    REQUIRE(data->keyboardNotes.size() == 3);
+    REQUIRE(data->keyboardNotes[0].lane == 1);
+    REQUIRE(data->keyboardNotes[1].lane == 2);
+    REQUIRE(data->keyboardNotes[2].lane == 0);
+
+    REQUIRE(data->mouseNotes.size() == 3);
+    REQUIRE(data->mouseNotes[2].time == 60);
+}
+
+TEST_CASE("流式解析遇到语法错误或非对象根返回预期结果", "[charts][stream]")
+{
+    REQUIRE(!ChartJsonStream::Parse(R"({ "keyboard_notes": [ { "time": 1 )", "inline").has_value());
+    REQUIRE(!ChartJsonStream::Parse(R"({ "version": 2 } trailing)", "inline").has_value());
+
+    auto fromArray = ChartJsonStream::Parse(R"([1, 2, 3])", "inline");
+    REQUIRE(fromArray.has_value());
+    REQUIRE(fromArray->keyboardNotes.empty());
+    REQUIRE(fromArray->timingPoints.size() == 1);
+
+    // 同名 section 被非数组值覆盖时清空
+    auto overridden = ChartJsonStream::Parse(
+        R"({ "keyboard_notes": [{ "time": 1 }], "keyboard_notes": null })", "inline");
+    REQUIRE(overridden.has_value());
+    REQUIRE(overridden->keyboardNotes.empty());
+}
@@ -0,0 +1,168 @@
+// tests/test_chart_library.cpp — 谱面库增量扫描与持久化索引
+
+#include "test_framework.h"
+
+#include "game/chart_library.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace sakura::game;
+
+namespace
+{
+
+void WriteInfo(const std::filesystem::path& folder, const std::string& id, const std::string& title)
+{
+    std::filesystem::create_directories(folder);
+    std::ofstream ofs(folder / "info.json", std::ios::trunc);
+    ofs << R"({ "version": 2, "id": ")" << id << R"(", "title": ")" << title
+        << R"(", "difficulties": [{ "name": "Normal", "level": 4, "chart_file": "normal.json", "note_count": 12 }] })";
+}
+
+// 每个用例使用独立的谱面根目录与索引文件，结束时恢复为纯内存模式
+struct TempLibraryScope
+{
+    std::filesystem::path root;
+    std::filesystem::path indexPath;
+
+    explicit TempLibraryScope(const char* name)
+    {
+        const auto base = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(base);
+        root      = base / "charts";
+        indexPath = base / "data" / ChartLibrary::INDEX_FILE_NAME;
+        std::filesystem::create_directories(root);
+        ChartLibrary::GetInstance().SetIndexPath(indexPath.string());
+    }
+
+    ~TempLibraryScope()
+    {
+        ChartLibrary::GetInstance().SetIndexPath("");
+    }
+};
+
+} // namespace
+
+TEST_CASE("ChartLibrary 首次扫描全量解析，再次扫描全部复用", "[charts][library]")
+{
+    TempLibraryScope scope("sakura-chart-library-basic");
+    for (int i = 0; i < 6; ++i)
+        WriteInfo(scope.root / ("song_" + std::to_string(i)), "song_" + std::to_string(i), "Song");
+
+    auto& library = ChartLibrary::GetInstance();
+    auto charts = library.Refresh(scope.root.string());
+    REQUIRE(charts->size() == 6);
+    REQUIRE(library.GetLastScanStats().parsed == 6);
+    REQUIRE(std::filesystem::exists(scope.indexPath));
+
+    // 目录无变化时 GetCharts 返回同一份快照
+    REQUIRE(library.GetCharts(scope.root.string()) == charts);
+
+    library.Refresh(scope.root.string());
+    REQUIRE(library.GetLastScanStats().parsed == 0);
+    REQUIRE(library.GetLastScanStats().reused == 6);
+
+    // 丢弃内存状态后从磁盘索引恢复，不需要重新解析
+    library.Clear();
+    auto restored = library.GetCharts(scope.root.string());
+    REQUIRE(restored->size() == 6);
+    REQUIRE(library.GetLastScanStats().parsed == 0);
+    REQUIRE(library.GetLastScanStats().reused == 6);
+    REQUIRE(restored->front().difficulties.size() == 1);
+    REQUIRE(restored->front().difficulties[0].noteCount == 12);
+}
+
+TEST_CASE("ChartLibrary 仅重新解析变化的谱面并移除已删除的谱面", "[charts][library]")
+{
+    TempLibraryScope scope("sakura-chart-library-incremental");
+    WriteInfo(scope.root / "alpha", "alpha", "Alpha");
+    WriteInfo(scope.root / "beta",  "beta",  "Beta");
+    WriteInfo(scope.root / "gamma", "gamma", "Gamma");
+
+    auto& library = ChartLibrary::GetInstance();
+    library.Refresh(scope.root.string());
+    REQUIRE(library.GetLastScanStats().parsed == 3);
+
+    WriteInfo(scope.root / "beta", "beta", "Beta (Remastered)");
+    const auto betaInfo = scope.root / "beta" / "info.json";
+    std::filesystem::last_write_time(betaInfo,
+        std::filesystem::last_write_time(betaInfo) + std::chrono::seconds(2));
+    std::filesystem::remove_all(scope.root / "gamma");
+
+    auto charts = library.GetCharts(scope.root.string());
+    const auto stats = library.GetLastScanStats();
+    REQUIRE(stats.parsed == 1);
+    REQUIRE(stats.reused == 1);
+    REQUIRE(stats.removed == 1);
+    REQUIRE(charts->size() == 2);
+
+    bool sawRemaster = false;
+    for (const auto& info : *charts)
+        sawRemaster = sawRemaster || info.title == "Beta (Remastered)";
+    REQUIRE(sawRemaster);
+}
+
+TEST_CASE("ChartLibrary 运行期间新增 / 删除的谱面在下一次 GetCharts 中可见", "[charts][library]")
+{
+    TempLibraryScope scope("sakura-chart-library-live");
+    WriteInfo(scope.root / "alpha", "alpha", "Alpha");
+
+    auto& library = ChartLibrary::GetInstance();
+    auto first = library.GetCharts(scope.root.string());
+    REQUIRE(first->size() == 1);
+
+    // 不经过任何通知，直接在磁盘上放入新文件夹
+    WriteInfo(scope.root / "beta", "beta", "Beta");
+    auto second = library.GetCharts(scope.root.string());
+    REQUIRE(second->size() == 2);
+    REQUIRE(library.GetLastScanStats().parsed == 1);
+    REQUIRE(library.GetLastScanStats().reused == 1);
+    REQUIRE(first->size() == 1);   // 旧快照不受影响
+
+    bool sawBeta = false;
+    for (const auto& info : *second)
+        sawBeta = sawBeta || info.id == "beta";
+    REQUIRE(sawBeta);
+
+    std::filesystem::remove_all(scope.root / "alpha");
+    auto third = library.GetCharts(scope.root.string());
+    REQUIRE(third->size() == 1);
+    REQUIRE(third->front().id == "beta");
+    REQUIRE(library.GetLastScanStats().removed == 1);
+
+    // 之后无变化：不重新解析，沿用同一份快照
+    REQUIRE(library.GetCharts(scope.root.string()) == third);
+    REQUIRE(library.GetLastScanStats().parsed == 0);
+}
+
+TEST_CASE("ChartLibrary 仅在快照内容变化时通知订阅者", "[charts][library]")
+{
+    TempLibraryScope scope("sakura-chart-library-listener");
+    for (int i = 0; i < 3; ++i)
+        WriteInfo(scope.root / ("song_" + std::to_string(i)), "song_" + std::to_string(i), "Song");
+
+    auto& library = ChartLibrary::GetInstance();
+    std::vector<size_t> notified;
+    const auto id = library.Subscribe(scope.root.string() + "/",
+        [&](const ChartLibrary::ChartList& charts) { notified.push_back(charts.size()); });
+
+    library.GetCharts(scope.root.string());
+    REQUIRE(notified == std::vector<size_t>{ 3 });
+
+    // 无变化的重新扫描不通知
+    library.Refresh(scope.root.string());
+    REQUIRE(notified.size() == 1);
+
+    WriteInfo(scope.root / "song_new", "song_new", "New");
+    library.GetCharts(scope.root.string());
+    REQUIRE((notified == std::vector<size_t>{ 3, 4 }));
+
+    library.Unsubscribe(id);
+    std::filesystem::remove_all(scope.root / "song_new");
+    library.Refresh(scope.root.string());
+    REQUIRE(notified.size() == 2);
+}
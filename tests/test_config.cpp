@@ -0,0 +1,88 @@
+// tests/test_config.cpp — Config 预编译键、类型化快照与变更通知测试
+
+#include "test_framework.h"
+
+#include "core/config.h"
+
+#include <string>
+#include <vector>
+
+using sakura::core::Config;
+using sakura::core::ConfigKey;
+namespace ConfigKeys = sakura::core::ConfigKeys;
+using sakura::tests::Matchers::WithinAbs;
+
+TEST_CASE("预编译键与字符串键读取结果一致", "[config]")
+{
+    auto& cfg = Config::GetInstance();
+    cfg.ResetToDefaults();
+
+    const ConfigKey<float> noteSpeed{ ConfigKeys::kNoteSpeed, 1.0f };
+    REQUIRE_THAT(cfg.Get(noteSpeed), WithinAbs(cfg.Get<float>(ConfigKeys::kNoteSpeed, 0.0f), 1e-6));
+
+    cfg.Set(noteSpeed, 7.5f);
+    REQUIRE_THAT(cfg.Get<float>(ConfigKeys::kNoteSpeed, 0.0f), WithinAbs(7.5, 1e-6));
+
+    // 不存在 / 类型不符时回退到键的默认值
+    const ConfigKey<int> missing{ "test.no_such_key", 42 };
+    REQUIRE(cfg.Get(missing) == 42);
+    const ConfigKey<int> wrongType{ ConfigKeys::kScrollDir, -1 };
+    REQUIRE(cfg.Get(wrongType) == -1);
+
+    cfg.ResetToDefaults();
+}
+
+TEST_CASE("Set 后快照立即更新且版本号递增", "[config]")
+{
+    auto& cfg = Config::GetInstance();
+    cfg.ResetToDefaults();
+
+    const auto& snap   = cfg.GetSnapshot();
+    const auto  before = snap.version;
+    REQUIRE_THAT(snap.noteSpeed, WithinAbs(5.0, 1e-6));
+    REQUIRE(!snap.scrollUp);
+    REQUIRE(snap.laneKeys[0] == 4);
+
+    cfg.Set(ConfigKeys::kNoteSpeed, 3.25f);
+    cfg.Set(ConfigKeys::kScrollDir, std::string("up"));
+    cfg.Set(std::string(ConfigKeys::kKeyLane2), 12);
+    REQUIRE_THAT(snap.noteSpeed, WithinAbs(3.25, 1e-6));
+    REQUIRE(snap.scrollUp);
+    REQUIRE(snap.laneKeys[2] == 12);
+    REQUIRE(snap.version == before + 3);
+
+    cfg.Remove(ConfigKeys::kKeyLane2);
+    REQUIRE(snap.laneKeys[2] == 7);
+
+    cfg.ResetToDefaults();
+    REQUIRE_THAT(snap.noteSpeed, WithinAbs(5.0, 1e-6));
+}
+
+TEST_CASE("变更通知在快照重建后触发，退订后不再触发", "[config]")
+{
+    auto& cfg = Config::GetInstance();
+    cfg.ResetToDefaults();
+
+    std::vector<std::string> keys;
+    float seenSpeed = 0.0f;
+    const auto id = cfg.Subscribe([&](std::string_view key) {
+        keys.emplace_back(key);
+        seenSpeed = Config::GetInstance().GetSnapshot().noteSpeed;
+    });
+
+    cfg.Set(ConfigKeys::kNoteSpeed, 8.0f);
+    REQUIRE(keys.size() == 1);
+    REQUIRE(keys[0] == ConfigKeys::kNoteSpeed);
+    REQUIRE_THAT(seenSpeed, WithinAbs(8.0, 1e-6));
+
+    // 整体重置只通知一次（空键）
+    cfg.ResetToDefaults();
+    REQUIRE(keys.size() == 2);
+    REQUIRE(keys[1].empty());
+
+    cfg.Unsubscribe(id);
+    cfg.Set(ConfigKeys::kNoteSpeed, 2.0f);
+    REQUIRE(keys.size() == 2);
+
+    cfg.ResetToDefaults();
+}
@@ -0,0 +1,499 @@
+// tests/test_database.cpp — 表结构迁移、best_scores 物化表（含 PP）、聚合统计、判定偏差存储、预编译语句缓存与写入队列
+
+#include "test_framework.h"
+
+#include "data/database.h"
+#include "game/chart.h"
+#include "game/pp_calculator.h"
+
+#include <sqlite3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+using sakura::data::Database;
+
+namespace
+{
+
+fs::path TempDbPath(const char* name)
+{
+    fs::path path = fs::temp_directory_path() / name;
+    std::error_code ec;
+    fs::remove(path, ec);
+    fs::remove(path.string() + "-wal", ec);
+    fs::remove(path.string() + "-shm", ec);
+    return path;
+}
+
+struct TempDatabaseScope
+{
+    fs::path path;
+
+    explicit TempDatabaseScope(const char* name)
+        : path(TempDbPath(name))
+    {
+        auto& db = Database::GetInstance();
+        db.Shutdown();
+        REQUIRE(db.Initialize(path.string()));
+    }
+
+    ~TempDatabaseScope()
+    {
+        Database::GetInstance().Shutdown();
+        TempDbPath(path.filename().string().c_str());
+    }
+};
+
+sakura::game::GameResult MakeResult(const std::string& chartId, const std::string& difficulty,
+                                    int score, long long playedAt, float level = 3.0f)
+{
+    sakura::game::GameResult result;
+    result.chartId         = chartId;
+    result.chartTitle      = chartId;
+    result.difficulty      = difficulty;
+    result.difficultyLevel = level;
+    result.score           = score;
+    result.accuracy        = static_cast<float>(score) / 10000.0f;
+    result.playedAt        = playedAt;
+    result.hitErrors       = { -3, 0, 5 };
+    return result;
+}
+
+// 入队并立即提交，返回写入结果
+bool SaveNow(const sakura::game::GameResult& result)
+{
+    auto& db = Database::GetInstance();
+    auto saved = db.SaveScore(result);
+    db.Flush();
+    return saved.get();
+}
+
+} // namespace
+
+TEST_CASE("Database 打开旧版（无版本号）库时迁移并回填 best_scores", "[database]")
+{
+    const fs::path path = TempDbPath("sakura-db-migration.db");
+
+    // 按迁移机制引入前的表结构手工建库
+    {
+        sqlite3* raw = nullptr;
+        REQUIRE(sqlite3_open(path.string().c_str(), &raw) == SQLITE_OK);
+        const char* legacy = R"sql(
+            CREATE TABLE scores (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                chart_id TEXT NOT NULL, chart_title TEXT NOT NULL DEFAULT '',
+                difficulty TEXT NOT NULL DEFAULT '', difficulty_level REAL NOT NULL DEFAULT 0.0,
+                score INTEGER NOT NULL DEFAULT 0, accuracy REAL NOT NULL DEFAULT 0.0,
+                max_combo INTEGER NOT NULL DEFAULT 0, grade TEXT NOT NULL DEFAULT 'D',
+                perfect_count INTEGER NOT NULL DEFAULT 0, great_count INTEGER NOT NULL DEFAULT 0,
+                good_count INTEGER NOT NULL DEFAULT 0, bad_count INTEGER NOT NULL DEFAULT 0,
+                miss_count INTEGER NOT NULL DEFAULT 0, is_full_combo INTEGER NOT NULL DEFAULT 0,
+                is_all_perfect INTEGER NOT NULL DEFAULT 0, played_at INTEGER NOT NULL DEFAULT 0,
+                hit_errors_json TEXT NOT NULL DEFAULT '[]');
+            CREATE TABLE statistics (key TEXT PRIMARY KEY NOT NULL, value REAL NOT NULL DEFAULT 0.0);
+            CREATE TABLE achievements (id TEXT PRIMARY KEY NOT NULL, unlocked_at INTEGER NOT NULL DEFAULT 0);
+            INSERT INTO scores (chart_id, difficulty, difficulty_level, score, played_at) VALUES
+                ('a', 'Easy', 2.0, 500000, 1), ('a', 'Easy', 2.0, 900000, 2),
+                ('a', 'Easy', 2.0, 900000, 3), ('a', 'Hard', 7.0, 700000, 4),
+                ('b', 'Easy', 3.0, 100000, 5);
+            UPDATE scores SET hit_errors_json = '[-20, 4, 150]' WHERE chart_id = 'b';
+            INSERT INTO statistics (key, value) VALUES ('total_play_count', 5);
+        )sql";
+        REQUIRE(sqlite3_exec(raw, legacy, nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(raw);
+    }
+
+    auto& db = Database::GetInstance();
+    db.Shutdown();
+    REQUIRE(db.Initialize(path.string()));
+    REQUIRE(db.GetSchemaVersion() == 5);
+    REQUIRE(db.GetTotalPlayCount() == 5);
+
+    // 同分保留最早的一局
+    auto best = db.GetBestScore("a", "Easy");
+    REQUIRE(best.has_value());
+    REQUIRE(best->score == 900000);
+    REQUIRE(best->playedAt == 2);
+
+    auto all = db.GetAllBestScores();
+    REQUIRE(all.size() == 3);
+    REQUIRE(all[0].difficulty == "Hard");   // 按难度等级降序
+    REQUIRE(all[0].score == 700000);
+
+    // player_aggregates 从已有成绩回填
+    auto snapshot = db.GetStatsSnapshot();
+    REQUIRE(snapshot.scoreCount == 5);
+    REQUIRE(snapshot.playCount == 5);
+    REQUIRE(snapshot.highestScore == 900000);
+    REQUIRE(snapshot.gradeDistribution[5] == 5);
+
+    // 迁移前的最高分回填 PP
+    for (const auto& play : db.GetAllBestPlays())
+        REQUIRE(play.pp == sakura::game::PPCalculator::CalculatePP(play.result, play.result.difficultyLevel));
+
+    // hit_errors_json 转码为 BLOB
+    REQUIRE((db.GetBestScore("b", "Easy")->hitErrors == std::vector<int>{ -20, 4, 150 }));
+    REQUIRE(db.GetBestScore("a", "Easy")->hitErrors.empty());
+    REQUIRE(db.GetHitErrorStats("b", "Easy").count == 3);
+    REQUIRE(db.GetHitErrorStats("b", "Easy").sum == 134);
+
+    // 迁移后新成绩正常维护
+    REQUIRE(SaveNow(MakeResult("b", "Easy", 150000, 6)));
+    REQUIRE(db.GetBestScore("b", "Easy")->score == 150000);
+    REQUIRE(db.GetTotalPlayCount() == 6);
+    REQUIRE(db.GetStatsSnapshot().playCount == 6);
+
+    // 重新打开不重复迁移
+    db.Shutdown();
+    REQUIRE(db.Initialize(path.string()));
+    REQUIRE(db.GetSchemaVersion() == 5);
+    REQUIRE(db.GetAllBestScores().size() == 3);
+
+    db.Shutdown();
+    TempDbPath("sakura-db-migration.db");
+}
+
+TEST_CASE("Database best_scores 与逐行取最大值的结果一致", "[database]")
+{
+    TempDatabaseScope scope("sakura-db-best-scores.db");
+    auto& db = Database::GetInstance();
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> chartDist(0, 5);
+    std::uniform_int_distribution<int> diffDist(0, 2);
+    std::uniform_int_distribution<int> scoreDist(0, 40);   // 范围小，制造大量同分
+    const char* diffs[] = { "Easy", "Normal", "Hard" };
+
+    // key → (最高分, 最早达成时间)
+    std::map<std::pair<std::string, std::string>, std::pair<int, long long>> expected;
+    std::vector<std::future<bool>> saved;
+    for (int i = 0; i < 300; ++i)
+    {
+        const std::string chart = "chart_" + std::to_string(chartDist(rng));
+        const std::string diff  = diffs[diffDist(rng)];
+        const int score = scoreDist(rng) * 25000;
+        saved.push_back(db.SaveScore(MakeResult(chart, diff, score, 1000 + i)));
+
+        auto [it, inserted] = expected.try_emplace({ chart, diff }, score, 1000 + i);
+        if (!inserted && score > it->second.first)
+            it->second = { score, 1000 + i };
+    }
+    db.Flush();
+    for (auto& f : saved)
+        REQUIRE(f.get());
+
+    auto all = db.GetAllBestScores();
+    REQUIRE(all.size() == expected.size());
+    for (const auto& r : all)
+    {
+        const auto& want = expected.at({ r.chartId, r.difficulty });
+        REQUIRE(r.score == want.first);
+        REQUIRE(r.playedAt == want.second);
+        REQUIRE(r.hitErrors.size() == 3);
+    }
+
+    for (const auto& [key, want] : expected)
+    {
+        auto top = db.GetTopScores(key.first, key.second, 5);
+        REQUIRE(!top.empty());
+        REQUIRE(top.front().score == want.first);
+        for (size_t i = 1; i < top.size(); ++i)
+            REQUIRE(top[i - 1].score >= top[i].score);
+    }
+
+    REQUIRE(!db.GetBestScore("chart_missing", "Easy").has_value());
+    REQUIRE(db.GetTotalPlayCount() == 300);
+}
+
+TEST_CASE("Database 聚合统计快照与逐行汇总的结果一致", "[database]")
+{
+    TempDatabaseScope scope("sakura-db-aggregates.db");
+    auto& db = Database::GetInstance();
+
+    std::mt19937 rng(20240614);
+    std::uniform_int_distribution<int> scoreDist(0, 1000000);
+    std::uniform_int_distribution<int> countDist(0, 400);
+    std::uniform_int_distribution<int> gradeDist(0, 5);
+    std::uniform_int_distribution<int> flagDist(0, 3);
+
+    const sakura::game::Grade grades[] = {
+        sakura::game::Grade::SS, sakura::game::Grade::S, sakura::game::Grade::A,
+        sakura::game::Grade::B,  sakura::game::Grade::C, sakura::game::Grade::D,
+    };
+
+    sakura::data::PlayerStatsSnapshot expected;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto result = MakeResult("chart_" + std::to_string(i % 7), "Hard", scoreDist(rng), 100 + i);
+        result.maxCombo        = countDist(rng);
+        result.perfectCount    = countDist(rng);
+        result.greatCount      = countDist(rng);
+        result.missCount       = countDist(rng);
+        result.isFullCombo     = flagDist(rng) == 0;
+        result.isAllPerfect    = result.isFullCombo && flagDist(rng) == 0;
+        result.playTimeSeconds = 90.0;
+        const int grade        = gradeDist(rng);
+        result.grade           = grades[grade];
+        db.SaveScore(result);
+
+        ++expected.scoreCount;
+        expected.accuracySum    += result.accuracy;
+        expected.highestScore    = std::max(expected.highestScore, result.score);
+        expected.highestAccuracy = std::max(expected.highestAccuracy, result.accuracy);
+        expected.highestCombo    = std::max(expected.highestCombo, result.maxCombo);
+        expected.notesJudged    += result.perfectCount + result.greatCount + result.missCount;
+        expected.fullComboCount += result.isFullCombo  ? 1 : 0;
+        expected.allPerfectCount += result.isAllPerfect ? 1 : 0;
+        ++expected.gradeDistribution[static_cast<size_t>(grade)];
+    }
+
+    // 读取前无需 Flush：快照包含队列中的写入
+    const auto snapshot = db.GetStatsSnapshot();
+    REQUIRE(snapshot.scoreCount == 200);
+    REQUIRE(snapshot.playCount == 200);
+    REQUIRE(snapshot.playTimeSeconds == 200 * 90.0);
+    REQUIRE(std::abs(snapshot.AverageAccuracy() - expected.AverageAccuracy()) < 1e-6);
+    REQUIRE(snapshot.highestScore == expected.highestScore);
+    REQUIRE(snapshot.highestAccuracy == expected.highestAccuracy);
+    REQUIRE(snapshot.highestCombo == expected.highestCombo);
+    REQUIRE(snapshot.notesJudged == expected.notesJudged);
+    REQUIRE(snapshot.fullComboCount == expected.fullComboCount);
+    REQUIRE(snapshot.allPerfectCount == expected.allPerfectCount);
+    REQUIRE(snapshot.gradeDistribution == expected.gradeDistribution);
+
+    // 便捷接口与快照一致
+    REQUIRE(db.GetHighestScore() == expected.highestScore);
+    REQUIRE(db.GetGradeDistribution() == expected.gradeDistribution);
+    REQUIRE(db.HasAnyFullCombo() == (expected.fullComboCount > 0));
+}
+
+TEST_CASE("Database 判定偏差按 BLOB 存取，按谱面汇总均值与 UR", "[database]")
+{
+    TempDatabaseScope scope("sakura-db-hit-errors.db");
+    auto& db = Database::GetInstance();
+
+    std::mt19937 rng(77);
+    std::uniform_int_distribution<int> chartDist(0, 3);
+    std::uniform_int_distribution<int> lengthDist(0, 400);
+    std::normal_distribution<double>   errorDist(4.0, 30.0);
+
+    // key → 全部偏差（参考值用原始序列两遍计算）
+    std::map<std::pair<std::string, std::string>, std::vector<int>> expected;
+    std::map<std::pair<std::string, std::string>, int> plays;
+    std::vector<std::future<bool>> saved;
+    for (int i = 0; i < 60; ++i)
+    {
+        auto result = MakeResult("chart_" + std::to_string(chartDist(rng)), i % 2 ? "Hard" : "Easy",
+                                 100000 + i, 1000 + i);
+        result.hitErrors.resize(static_cast<size_t>(lengthDist(rng)));
+        for (int& err : result.hitErrors)
+            err = static_cast<int>(std::lround(std::clamp(errorDist(rng), -150.0, 150.0)));
+
+        const std::pair key{ result.chartId, result.difficulty };
+        expected[key].insert(expected[key].end(), result.hitErrors.begin(), result.hitErrors.end());
+        ++plays[key];
+        saved.push_back(db.SaveScore(result));
+    }
+    db.Flush();
+    for (auto& f : saved)
+        REQUIRE(f.get());
+
+    auto all = db.GetAllHitErrorStats();
+    REQUIRE(all.size() == expected.size());
+    for (const auto& chart : all)
+    {
+        const auto& errors = expected.at({ chart.chartId, chart.difficulty });
+        double mean = 0.0;
+        for (int err : errors) mean += err;
+        mean = errors.empty() ? 0.0 : mean / static_cast<double>(errors.size());
+        double variance = 0.0;
+        for (int err : errors) variance += (err - mean) * (err - mean);
+        variance = errors.empty() ? 0.0 : variance / static_cast<double>(errors.size());
+
+        REQUIRE(chart.plays == plays.at({ chart.chartId, chart.difficulty }));
+        REQUIRE(chart.errors.count == static_cast<long long>(errors.size()));
+        REQUIRE(std::abs(chart.errors.Mean() - mean) < 1e-9);
+        REQUIRE(std::abs(chart.errors.UnstableRate() - std::sqrt(variance) * 10.0) < 1e-6);
+
+        const auto single = db.GetHitErrorStats(chart.chartId, chart.difficulty);
+        REQUIRE(single.count == chart.errors.count);
+        REQUIRE(single.sum == chart.errors.sum);
+        REQUIRE(single.sumSquares == chart.errors.sumSquares);
+    }
+    REQUIRE(std::is_sorted(all.begin(), all.end(), [](const auto& a, const auto& b)
+    {
+        return std::tie(a.chartId, a.difficulty) < std::tie(b.chartId, b.difficulty);
+    }));
+
+    // 逐局读取与写入一致（含空序列）
+    auto empty = MakeResult("chart_empty", "Easy", 1, 5000);
+    empty.hitErrors.clear();
+    REQUIRE(SaveNow(empty));
+    REQUIRE(db.GetBestScore("chart_empty", "Easy")->hitErrors.empty());
+    REQUIRE(db.GetHitErrorStats("chart_empty", "Easy").count == 0);
+    REQUIRE(db.GetHitErrorStats("chart_missing", "Easy").count == 0);
+
+    auto extreme = MakeResult("chart_extreme", "Easy", 1, 5001);
+    extreme.hitErrors = { 0, -1, 63, -64, 64, 150, -150, 8191, -8192, 100000 };
+    REQUIRE(SaveNow(extreme));
+    REQUIRE(db.GetBestScore("chart_extreme", "Easy")->hitErrors == extreme.hitErrors);
+}
+
+TEST_CASE("Database 预编译语句在连接存活期间复用，绑定不残留", "[database]")
+{
+    TempDatabaseScope scope("sakura-db-statements.db");
+    auto& db = Database::GetInstance();
+
+    REQUIRE(SaveNow(MakeResult("x", "Easy", 800000, 10)));
+    REQUIRE(SaveNow(MakeResult("y", "Easy", 600000, 11)));
+
+    REQUIRE(db.GetBestScore("x", "Easy")->score == 800000);
+    const size_t cached = db.GetCachedStatementCount();
+    REQUIRE(cached > 0);
+
+    // 同一语句换参数反复使用，不新增缓存，也不沿用上一次的绑定
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(db.GetBestScore("y", "Easy")->score == 600000);
+        REQUIRE(db.GetBestScore("x", "Easy")->score == 800000);
+        REQUIRE(!db.GetBestScore("z", "Easy").has_value());
+    }
+    REQUIRE(SaveNow(MakeResult("x", "Easy", 900000, 12)));
+    REQUIRE(db.GetBestScore("x", "Easy")->score == 900000);
+    REQUIRE(db.GetCachedStatementCount() == cached);
+
+    db.Shutdown();
+    REQUIRE(db.GetCachedStatementCount() == 0);
+    REQUIRE(!db.GetBestScore("x", "Easy").has_value());
+}
+
+TEST_CASE("Database 写入入队后立即可读，按批提交，关闭前落盘", "[database]")
+{
+    const fs::path path = TempDbPath("sakura-db-write-behind.db");
+    auto& db = Database::GetInstance();
+    db.Shutdown();
+    REQUIRE(db.Initialize(path.string()));
+
+    const long long batchesBefore = db.GetCommittedBatchCount();
+
+    // 结算场景的写入序列：成绩 + 统计 + 成就，不等待 future
+    auto score   = db.SaveScore(MakeResult("song", "Hard", 950000, 100));
+    auto stat    = db.IncrementStatistic("retry_count", 2.0);
+    auto unlock  = db.SaveAchievement("first_play");
+
+    // 另一条连接只看得到已提交的数据
+    auto committedScores = [&]
+    {
+        sqlite3* raw = nullptr;
+        REQUIRE(sqlite3_open(path.string().c_str(), &raw) == SQLITE_OK);
+        sqlite3_stmt* stmt = nullptr;
+        REQUIRE(sqlite3_prepare_v2(raw, "SELECT COUNT(*) FROM scores;", -1, &stmt, nullptr) == SQLITE_OK);
+        int count = -1;
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+            count = sqlite3_column_int(stmt, 0);
+        sqlite3_finalize(stmt);
+        sqlite3_close(raw);
+        return count;
+    };
+
+    // read-your-writes：读取先提交队列中的写入，读到的总是已落盘的数据
+    REQUIRE(db.GetBestScore("song", "Hard")->score == 950000);
+    REQUIRE(committedScores() == 1);
+    REQUIRE(db.GetCommittedBatchCount() == batchesBefore + 1);
+    REQUIRE(score.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    REQUIRE(db.GetTotalPlayCount() == 1);
+    REQUIRE(db.GetStatistic("retry_count") == 2.0);
+    REQUIRE(db.IsAchievementUnlocked("first_play"));
+    REQUIRE(score.get());
+    REQUIRE(stat.get());
+    REQUIRE(unlock.get());
+
+    // 无人读取时数据库线程在攒批窗口后自行提交
+    auto later = db.SaveScore(MakeResult("song", "Hard", 100, 101));
+    REQUIRE(later.get());
+    REQUIRE(committedScores() == 2);
+
+    // 连续写入合并为极少数批次
+    const long long batchesMid = db.GetCommittedBatchCount();
+    std::vector<std::future<bool>> saved;
+    for (int i = 0; i < 20; ++i)
+        saved.push_back(db.SaveScore(MakeResult("song", "Normal", 600000 + i, 150 + i)));
+    db.Flush();
+    for (auto& f : saved)
+        REQUIRE(f.get());
+    REQUIRE(db.GetCommittedBatchCount() - batchesMid <= 2);
+
+    // 关闭时未提交的写入也会落盘
+    for (int i = 0; i < 20; ++i)
+        db.SaveScore(MakeResult("song", "Easy", 500000 + i, 200 + i));
+    db.Shutdown();
+    REQUIRE(committedScores() == 42);
+
+    REQUIRE(db.Initialize(path.string()));
+    REQUIRE(db.GetBestScore("song", "Easy")->score == 500019);
+    REQUIRE(db.GetTotalPlayCount() == 42);
+
+    // 未打开时写入立即失败
+    db.Shutdown();
+    REQUIRE(!db.SaveScore(MakeResult("song", "Easy", 1, 1)).get());
+
+    TempDbPath("sakura-db-write-behind.db");
+}
+
+TEST_CASE("Database 写入失败时递增失败批次数，PP 排名据此从数据库重建", "[database]")
+{
+    TempDatabaseScope scope("sakura-db-failed-write.db");
+    auto& db = Database::GetInstance();
+
+    // 另一条连接加触发器，让指定谱面的成绩插入失败（保存点回滚）
+    {
+        sqlite3* raw = nullptr;
+        REQUIRE(sqlite3_open(scope.path.string().c_str(), &raw) == SQLITE_OK);
+        REQUIRE(sqlite3_exec(raw, R"sql(
+            CREATE TRIGGER reject_boom BEFORE INSERT ON scores
+            WHEN NEW.chart_id = 'boom'
+            BEGIN SELECT RAISE(ABORT, 'rejected'); END;
+        )sql", nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(raw);
+    }
+
+    REQUIRE(SaveNow(MakeResult("ok", "Hard", 800000, 1, 8.0f)));
+    auto& pp = sakura::game::PPCalculator::GetInstance();
+    REQUIRE(pp.LoadFromDatabase());
+    REQUIRE(pp.GetRankedCount() == 1);
+    const long long failedBefore = db.GetFailedBatchCount();
+
+    // 结算场景：入队后立即乐观更新排名，随后这条写入失败
+    const auto boom = MakeResult("boom", "Hard", 990000, 2, 12.0f);
+    auto saved = db.SaveScore(boom);
+    auto stat  = db.IncrementStatistic("retry_count");
+    REQUIRE(pp.SubmitBest(boom));
+    REQUIRE(pp.GetRankedCount() == 2);
+    db.Flush();
+
+    REQUIRE(!saved.get());
+    REQUIRE(stat.get());   // 同批其他写入不受影响
+    REQUIRE(db.GetFailedBatchCount() == failedBefore + 1);
+    REQUIRE(!db.GetBestScore("boom", "Hard").has_value());
+
+    // 排名不再视为已加载；下一次提交先从数据库重建，回滚的成绩随之消失
+    REQUIRE(!pp.IsLoaded());
+    const auto next = MakeResult("ok", "Easy", 700000, 3, 5.0f);
+    REQUIRE(SaveNow(next));
+    pp.SubmitBest(next);
+    REQUIRE(pp.IsLoaded());
+    REQUIRE(pp.GetRankedCount() == 2);
+    for (const auto& play : pp.GetBestPlays())
+        REQUIRE(play.result.chartId == "ok");
+}
@@ -45,4 +45,21 @@ TEST_CASE("FrameInputBuffer Clear 会清空全部事件", "[input][buffer]")
 
     REQUIRE(buffer.GetKeyPresses().empty());
     REQUIRE(buffer.GetMouseButtonPresses().empty());
-}
\ No newline at end of file
+}
+TEST_CASE("FrameInputBuffer 保留按下事件的 SDL 时间戳", "[input][buffer]")
+{
+    FrameInputBuffer buffer;
+
+    buffer.PushKeyPress(4, 1'000'000'123ull);
+    buffer.PushKeyPress(7);
+    buffer.PushMouseButtonPress(1, 0.1f, 0.2f, 10.0f, 20.0f, 2'500'000'000ull);
+
+    auto keys = buffer.GetKeyPresses();
+    REQUIRE(keys.size() == 2);
+    REQUIRE(keys[0].timestampNs == 1'000'000'123ull);
+    REQUIRE(keys[1].timestampNs == 0);   // 未提供时间戳时为 0（按更新时刻判定）
+
+    auto mouse = buffer.GetMouseButtonPresses();
+    REQUIRE(mouse.size() == 1);
+    REQUIRE(mouse[0].timestampNs == 2'500'000'000ull);
+}
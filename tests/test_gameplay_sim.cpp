@@ -0,0 +1,102 @@
+// tests/test_gameplay_sim.cpp — 无界面对局模拟（GameplaySimulator）单元测试
+
+#include "test_framework.h"
+
+#include "game/gameplay_sim.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace sakura::game;
+
+TEST_CASE("合成谱面有序、数量准确且同轨道音符不重叠", "[sim]")
+{
+    SyntheticChartOptions opt;
+    opt.noteCount  = 5000;
+    opt.mouseRatio = 0.25f;
+    const auto chart = GenerateSyntheticChart(opt);
+
+    REQUIRE(chart.keyboardNotes.size() + chart.mouseNotes.size() == 5000);
+    REQUIRE(chart.mouseNotes.size() == 1250);
+
+    auto byTime = [](const auto& a, const auto& b) { return a.time < b.time; };
+    REQUIRE(std::is_sorted(chart.keyboardNotes.begin(), chart.keyboardNotes.end(), byTime));
+    REQUIRE(std::is_sorted(chart.mouseNotes.begin(), chart.mouseNotes.end(), byTime));
+
+    std::vector<int> laneEnd(4, -1000);
+    bool overlap = false;
+    for (const auto& n : chart.keyboardNotes)
+    {
+        overlap = overlap || n.time < laneEnd[static_cast<size_t>(n.lane)] + 80;
+        laneEnd[static_cast<size_t>(n.lane)] = n.time + n.duration;
+    }
+    REQUIRE(!overlap);
+    for (size_t i = 1; i < chart.mouseNotes.size(); ++i)
+    {
+        const auto& prev = chart.mouseNotes[i - 1];
+        REQUIRE(prev.time + prev.sliderDuration < chart.mouseNotes[i].time);
+    }
+
+    // 同一 seed 结果一致
+    const auto again = GenerateSyntheticChart(opt);
+    REQUIRE(again.keyboardNotes.size() == chart.keyboardNotes.size());
+    REQUIRE(again.keyboardNotes.back().time == chart.keyboardNotes.back().time);
+    REQUIRE(again.mouseNotes.back().x == chart.mouseNotes.back().x);
+}
+
+TEST_CASE("自动演奏全部 Perfect，且不同 tick 频率结果一致", "[sim]")
+{
+    SyntheticChartOptions opt;
+    opt.noteCount = 3000;
+    const auto chart  = GenerateSyntheticChart(opt);
+    const auto script = BuildAutoplayScript(chart);
+
+    GameplaySimulator sim(chart);
+    SimulationOptions fast;
+    fast.tickRateHz = 1000.0;
+    const auto a = sim.Run(script, fast);
+
+    // Hold 头部与终判各计一次判定；Slider 头部之外每个拐点再计一次
+    int extra = 0;
+    for (const auto& n : chart.keyboardNotes) extra += (n.type == NoteType::Hold) ? 1 : 0;
+    for (const auto& n : chart.mouseNotes)    extra += static_cast<int>(n.sliderPath.size());
+    REQUIRE(extra > static_cast<int>(chart.mouseNotes.size()) / 10);
+    const int judgements = static_cast<int>(chart.keyboardNotes.size() + chart.mouseNotes.size()) + extra;
+
+    REQUIRE(a.result.isAllPerfect);
+    REQUIRE(a.result.perfectCount == judgements);
+    REQUIRE(a.result.maxCombo == judgements);
+    REQUIRE(a.inputs == script.size());
+    REQUIRE(a.ticks > 0);
+    REQUIRE(a.tickNsP50 <= a.tickNsP99);
+    REQUIRE(a.tickNsP99 <= a.tickNsMax);
+
+    SimulationOptions slow;
+    slow.tickRateHz = 60.0;
+    const auto b = sim.Run(script, slow);
+    REQUIRE(b.result.score == a.result.score);
+    REQUIRE(b.result.perfectCount == a.result.perfectCount);
+    REQUIRE(b.result.hitErrors == a.result.hitErrors);
+}
+
+TEST_CASE("带偏差的演奏可复现，空脚本全部 Miss", "[sim]")
+{
+    SyntheticChartOptions opt;
+    opt.noteCount  = 2000;
+    opt.mouseRatio = 0.0f;
+    const auto chart = GenerateSyntheticChart(opt);
+
+    GameplaySimulator sim(chart);
+    const auto jittered = BuildAutoplayScript(chart, 60.0, 7);
+    const auto r1 = sim.Run(jittered);
+    const auto r2 = sim.Run(jittered);
+    REQUIRE(r1.result.score == r2.result.score);
+    REQUIRE(r1.result.hitErrors == r2.result.hitErrors);
+    REQUIRE(!r1.result.isAllPerfect);
+    REQUIRE(r1.result.greatCount + r1.result.goodCount > 0);
+
+    const auto none = sim.Run({});
+    REQUIRE(none.result.missCount == 2000);
+    REQUIRE(none.result.score == 0);
+    REQUIRE(none.events == 2000);
+}
@@ -0,0 +1,128 @@
+// tests/test_geometry_batch.cpp — 帧级几何批处理：合批边界、索引偏移与统计
+
+#include "test_framework.h"
+
+#include "core/geometry_batch.h"
+
+#include <vector>
+
+using namespace sakura::core;
+
+namespace
+{
+
+struct Submission
+{
+    void*                    texture = nullptr;
+    std::vector<BatchVertex> vertices;
+    std::vector<int>         indices;
+};
+
+BatchVertex At(float x, float y) { return { x, y }; }
+
+void AddUnitQuad(GeometryBatch& batch, void* texture, float x)
+{
+    batch.AddQuad(texture, At(x, 0), At(x + 1, 0), At(x + 1, 1), At(x, 1));
+}
+
+} // namespace
+
+TEST_CASE("几何批处理仅在纹理切换时提交，索引为批次内绝对下标", "[render]")
+{
+    std::vector<Submission> submitted;
+    GeometryBatch batch([&](void* tex, const BatchVertex* v, int vc, const int* idx, int ic) {
+        submitted.push_back({ tex, { v, v + vc }, { idx, idx + ic } });
+    });
+
+    int texA = 0, texB = 0;
+    AddUnitQuad(batch, nullptr, 0);
+    AddUnitQuad(batch, nullptr, 2);
+    auto fan = batch.Add(nullptr, 3, 3);
+    fan.vertices[0] = At(10, 10);
+    fan.vertices[1] = At(11, 10);
+    fan.vertices[2] = At(10, 11);
+    for (int i = 0; i < 3; ++i) fan.indices[i] = fan.baseVertex + i;
+    REQUIRE(submitted.empty());
+
+    AddUnitQuad(batch, &texA, 0);   // 纹理切换：提交前三个纯色图元
+    AddUnitQuad(batch, &texA, 4);
+    AddUnitQuad(batch, &texB, 8);   // 再次切换
+    batch.Flush(FlushReason::FrameEnd);
+    batch.Flush(FlushReason::FrameEnd);   // 空批次不计数
+
+    REQUIRE(submitted.size() == 3);
+    REQUIRE(submitted[0].texture == nullptr);
+    REQUIRE(submitted[0].vertices.size() == 11);
+    REQUIRE(submitted[0].indices.size() == 15);
+    REQUIRE(submitted[0].indices[6] == 4);     // 第二个四边形从顶点 4 开始
+    REQUIRE(submitted[0].indices[12] == 8);    // 三角形从顶点 8 开始
+    REQUIRE(submitted[0].vertices[8].x == 10.0f);
+    REQUIRE(submitted[1].texture == &texA);
+    REQUIRE(submitted[1].indices.size() == 12);
+    REQUIRE(submitted[1].indices[0] == 0);     // 新批次重新从 0 编号
+    REQUIRE(submitted[1].indices[6] == 4);
+    REQUIRE(submitted[1].vertices[4].x == 4.0f);
+    REQUIRE(submitted[2].texture == &texB);
+
+    const auto& stats = batch.GetStats();
+    REQUIRE(stats.drawCalls == 3);
+    REQUIRE(stats.primitives == 6);
+    REQUIRE(stats.vertices == 23);
+    REQUIRE(stats.indices == 33);
+    REQUIRE(stats.FlushCount(FlushReason::Texture) == 2);
+    REQUIRE(stats.FlushCount(FlushReason::FrameEnd) == 1);
+}
+
+TEST_CASE("几何批处理关闭时逐图元提交，外部提交与丢弃", "[render]")
+{
+    int submits = 0;
+    GeometryBatch batch([&](void*, const BatchVertex*, int, const int*, int) { ++submits; });
+
+    batch.SetEnabled(false);
+    for (int i = 0; i < 10; ++i)
+        AddUnitQuad(batch, nullptr, static_cast<float>(i));
+    batch.Flush(FlushReason::FrameEnd);
+    REQUIRE(submits == 10);
+    REQUIRE(batch.GetStats().drawCalls == batch.GetStats().primitives);
+    REQUIRE(batch.GetStats().FlushCount(FlushReason::Unbatched) == 9);
+
+    batch.SetEnabled(true);
+    batch.ResetStats();
+    submits = 0;
+    for (int i = 0; i < 10; ++i)
+        AddUnitQuad(batch, nullptr, static_cast<float>(i));
+    batch.Flush(FlushReason::BlendMode);
+    AddUnitQuad(batch, nullptr, 0);
+    batch.Flush(FlushReason::External);
+    AddUnitQuad(batch, nullptr, 0);
+    batch.Discard();
+    batch.Flush(FlushReason::FrameEnd);
+
+    REQUIRE(submits == 2);
+    REQUIRE(batch.Empty());
+    REQUIRE(batch.GetStats().primitives == 12);
+    REQUIRE(batch.GetStats().FlushCount(FlushReason::BlendMode) == 1);
+    REQUIRE(batch.GetStats().FlushCount(FlushReason::External) == 1);
+    REQUIRE(batch.GetStats().FlushCount(FlushReason::FrameEnd) == 0);
+}
+
+TEST_CASE("几何批处理缓冲跨帧复用，稳定后不再重新分配", "[render]")
+{
+    const BatchVertex* lastData = nullptr;
+    bool reallocated = false;
+    GeometryBatch batch([&](void*, const BatchVertex* v, int, const int*, int) {
+        if (lastData && v != lastData) reallocated = true;
+        lastData = v;
+    });
+
+    // 超过初始预留容量，首帧增长一次，之后各帧保持同一缓冲
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        for (int i = 0; i < 3000; ++i)
+            AddUnitQuad(batch, nullptr, static_cast<float>(i));
+        batch.Flush(FlushReason::FrameEnd);
+        if (frame == 0) lastData = nullptr;
+    }
+    REQUIRE(!reallocated);
+    REQUIRE(batch.GetStats().drawCalls == 5);
+}
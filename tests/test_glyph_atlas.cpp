@@ -0,0 +1,129 @@
+// tests/test_glyph_atlas.cpp — 字形图集：货架装箱、UTF-8 解码与缓存排版 / 测量
+
+#include "test_framework.h"
+
+#include "core/glyph_atlas.h"
+
+#include <string>
+#include <vector>
+
+using namespace sakura::core;
+
+namespace
+{
+
+bool Overlaps(const AtlasRect& a, const AtlasRect& b)
+{
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+} // namespace
+
+TEST_CASE("货架装箱不重叠、留出间隔且不越界", "[text]")
+{
+    ShelfPacker packer(128, 64, 1);
+    std::vector<AtlasRect> rects;
+    AtlasRect rect;
+    // 同一字号的字形高度相同、宽度不一
+    while (packer.Pack(7 + static_cast<int>(rects.size() % 5), 20, rect))
+        rects.push_back(rect);
+
+    REQUIRE(rects.size() >= 12);   // 3 行 × 每行至少 4 个
+    bool valid = true;
+    for (size_t i = 0; i < rects.size(); ++i)
+    {
+        const auto& r = rects[i];
+        valid = valid && r.x >= 1 && r.y >= 1 && r.x + r.w + 1 <= 128 && r.y + r.h + 1 <= 64;
+        for (size_t j = i + 1; j < rects.size(); ++j)
+        {
+            // 加上间隔后仍不重叠
+            const AtlasRect grown = { r.x - 1, r.y - 1, r.w + 2, r.h + 2 };
+            valid = valid && !Overlaps(grown, rects[j]);
+        }
+    }
+    REQUIRE(valid);
+
+    // 较矮的矩形仍可塞入已有货架的剩余空间
+    ShelfPacker mixed(64, 32, 0);
+    AtlasRect tall, shortRect;
+    REQUIRE(mixed.Pack(10, 30, tall));
+    REQUIRE(mixed.Pack(10, 10, shortRect));
+    REQUIRE(shortRect.y == tall.y);
+    REQUIRE(!mixed.Pack(65, 1, rect));
+}
+
+TEST_CASE("UTF-8 解码：多字节字符与非法序列", "[text]")
+{
+    const std::string text = "A\xC3\xA9\xE6\xA8\xB1\xF0\x9F\x8E\xB5";   // A é 樱 🎵
+    std::vector<uint32_t> cps;
+    for (size_t pos = 0; pos < text.size();)
+        cps.push_back(NextCodepoint(text, pos));
+    REQUIRE(cps.size() == 4);
+    REQUIRE(cps[0] == 0x41);
+    REQUIRE(cps[1] == 0xE9);
+    REQUIRE(cps[2] == 0x6A31);
+    REQUIRE(cps[3] == 0x1F3B5);
+
+    // 截断、孤立续字节、过长编码、代理区：各替换为 U+FFFD 且继续前进
+    const std::string bad = "\xE6\xA8" "x" "\x80" "\xC0\xAF" "\xED\xA0\x80";
+    std::vector<uint32_t> out;
+    for (size_t pos = 0; pos < bad.size();)
+        out.push_back(NextCodepoint(bad, pos));
+    REQUIRE(out.size() == 9);
+    REQUIRE(out[0] == 0xFFFD);
+    REQUIRE(out[2] == 'x');
+    REQUIRE(out[3] == 0xFFFD);
+    REQUIRE(out[4] == 0xFFFD);
+    REQUIRE(out[6] == 0xFFFD);
+}
+
+TEST_CASE("字形图集按需缓存，排版与测量累加步进和字距", "[text]")
+{
+    GlyphAtlas atlas(24, 64);
+    REQUIRE(atlas.GetLineHeight() == 24);
+
+    // 未缓存时不排版
+    int width = -1;
+    REQUIRE(!atlas.IsCached("AV"));
+    REQUIRE(!atlas.Measure("AV", width));
+    REQUIRE(width == -1);
+
+    bool newPage = false;
+    const auto& a = atlas.Insert('A', 12, 14, 24, newPage);
+    REQUIRE(newPage);
+    REQUIRE(a.page == 0);
+    atlas.Insert('V', 11, 13, 24, newPage);
+    REQUIRE(!newPage);
+    atlas.Insert(' ', 6, 0, 0, newPage);   // 空白：只有步进
+    REQUIRE(atlas.Find(' ')->page == -1);
+    REQUIRE(!atlas.IsCached("AV"));         // 字距尚未缓存
+
+    atlas.SetKerning('A', 'V', -2);
+    atlas.SetKerning('V', ' ', 0);
+    atlas.SetKerning(' ', 'A', 0);
+    REQUIRE(atlas.IsCached("AV A"));
+    REQUIRE(atlas.Measure("AV A", width));
+    REQUIRE(width == 12 - 2 + 11 + 6 + 12);
+
+    std::vector<int> pens;
+    atlas.Layout("AV A", [&](const GlyphAtlas::Glyph&, int penX) { pens.push_back(penX); });
+    REQUIRE(pens.size() == 4);
+    REQUIRE(pens[0] == 0);
+    REQUIRE(pens[1] == 10);
+    REQUIRE(pens[2] == 21);
+    REQUIRE(pens[3] == 27);
+
+    // 页满后开新页；大于一页的位图按无位图记录
+    size_t pagesBefore = atlas.GetPageCount();
+    bool sawNewPage = false;
+    for (uint32_t cp = 0x4E00; cp < 0x4E00 + 16; ++cp)
+    {
+        atlas.Insert(cp, 24, 22, 24, newPage);
+        sawNewPage = sawNewPage || newPage;
+    }
+    REQUIRE(sawNewPage);
+    REQUIRE(atlas.GetPageCount() > pagesBefore);
+    REQUIRE(atlas.Find(0x4E00 + 15)->page == static_cast<int>(atlas.GetPageCount()) - 1);
+    REQUIRE(atlas.Insert(0x1F3B5, 80, 80, 80, newPage).page == -1);
+    REQUIRE(atlas.Find(0x1F3B5)->advance == 80);
+}
@@ -0,0 +1,164 @@
+// tests/test_hit_error_codec.cpp — 判定偏差 zigzag + varint 编解码与流式统计
+
+#include "test_framework.h"
+
+#include "data/hit_error_codec.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace sakura::data;
+
+TEST_CASE("HitErrorCodec 往返一致，含边界值", "[hit_error_codec]")
+{
+    const std::vector<int> errors = {
+        0, 1, -1, 63, -64, 64, -65, 150, -150, 8191, -8192, 8192, INT_MAX, INT_MIN
+    };
+    const auto encoded = EncodeHitErrors(errors);
+    REQUIRE(encoded.front() == HIT_ERROR_FORMAT_VARINT);
+    REQUIRE(DecodeHitErrors(encoded.data(), encoded.size()) == errors);
+
+    REQUIRE(EncodeHitErrors({}).empty());
+    REQUIRE(DecodeHitErrors(nullptr, 0).empty());
+}
+
+TEST_CASE("HitErrorCodec ±63 ms 内每个偏差 1 字节，±150 ms 内不超过 2 字节", "[hit_error_codec]")
+{
+    std::vector<int> small;
+    for (int err = -64; err <= 63; ++err)
+        small.push_back(err);
+    REQUIRE(EncodeHitErrors(small).size() == 1 + small.size());
+
+    std::vector<int> window;
+    for (int err = -150; err <= 150; ++err)
+        window.push_back(err);
+    REQUIRE(EncodeHitErrors(window).size() <= 1 + 2 * window.size());
+}
+
+TEST_CASE("HitErrorWriter 逐条追加与一次编码结果相同", "[hit_error_codec]")
+{
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> dist(-300, 300);
+
+    std::vector<int> errors(1000);
+    for (int& err : errors)
+        err = dist(rng);
+
+    std::vector<uint8_t> streamed;
+    HitErrorWriter writer(streamed);
+    for (int err : errors)
+        writer.Append(err);
+    REQUIRE(writer.Count() == errors.size());
+    REQUIRE(streamed == EncodeHitErrors(errors));
+
+    HitErrorReader reader(streamed.data(), streamed.size());
+    int value = 0;
+    size_t index = 0;
+    while (reader.Next(value))
+    {
+        REQUIRE(index < errors.size());
+        REQUIRE(value == errors[index++]);
+    }
+    REQUIRE(index == errors.size());
+    REQUIRE(!reader.Failed());
+}
+
+TEST_CASE("HitErrorReader 拒绝未知格式与截断数据", "[hit_error_codec]")
+{
+    const std::vector<uint8_t> unknown = { 0x7F, 0x00 };
+    HitErrorReader badFormat(unknown.data(), unknown.size());
+    int value = 0;
+    REQUIRE(!badFormat.Next(value));
+    REQUIRE(badFormat.Failed());
+
+    // 最后一个 varint 缺少结束字节：保留已解出的前缀
+    auto encoded = EncodeHitErrors({ 5, -7, 1000 });
+    encoded.pop_back();
+    REQUIRE((DecodeHitErrors(encoded.data(), encoded.size()) == std::vector<int>{ 5, -7 }));
+
+    HitErrorStats stats;
+    REQUIRE(!AccumulateHitErrors(encoded.data(), encoded.size(), stats));
+    REQUIRE(stats.count == 2);
+}
+
+TEST_CASE("HitErrorStats 流式累计与两遍法的均值、UR 一致，合并与顺序无关", "[hit_error_codec]")
+{
+    std::mt19937 rng(5);
+    std::normal_distribution<double> dist(-6.0, 25.0);
+
+    std::vector<int> first(700), second(300);
+    for (int& err : first)  err = static_cast<int>(std::lround(dist(rng)));
+    for (int& err : second) err = static_cast<int>(std::lround(dist(rng)));
+
+    const auto a = EncodeHitErrors(first);
+    const auto b = EncodeHitErrors(second);
+
+    HitErrorStats merged;
+    REQUIRE(AccumulateHitErrors(a.data(), a.size(), merged));
+    HitErrorStats tail;
+    REQUIRE(AccumulateHitErrors(b.data(), b.size(), tail));
+    merged.Merge(tail);
+
+    HitErrorStats reversed;
+    REQUIRE(AccumulateHitErrors(b.data(), b.size(), reversed));
+    REQUIRE(AccumulateHitErrors(a.data(), a.size(), reversed));
+    REQUIRE(reversed.sum == merged.sum);
+    REQUIRE(reversed.sumSquares == merged.sumSquares);
+
+    std::vector<int> all = first;
+    all.insert(all.end(), second.begin(), second.end());
+    double mean = 0.0;
+    for (int err : all) mean += err;
+    mean /= static_cast<double>(all.size());
+    double variance = 0.0;
+    for (int err : all) variance += (err - mean) * (err - mean);
+    variance /= static_cast<double>(all.size());
+
+    REQUIRE(merged.count == static_cast<long long>(all.size()));
+    REQUIRE(std::abs(merged.Mean() - mean) < 1e-9);
+    REQUIRE(std::abs(merged.UnstableRate() - std::sqrt(variance) * 10.0) < 1e-6);
+
+    HitErrorStats none;
+    REQUIRE(none.Mean() == 0.0);
+    REQUIRE(none.UnstableRate() == 0.0);
+}
+
+TEST_CASE("HitErrorStats 大量偏差时 UR 不受 n·Σx² 舍入影响", "[hit_error_codec]")
+{
+    // 偏移大、离散小的真实分布：两遍法逐条累加偏差平方作参考
+    constexpr long long kCount = 20'000'000;
+    auto sample = [](uint32_t& state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return 140 + static_cast<int>((state >> 16) % 5);   // 140 … 144
+    };
+
+    HitErrorStats stats;
+    uint32_t state = 42;
+    for (long long i = 0; i < kCount; ++i)
+        stats.Add(sample(state));
+
+    const double mean = static_cast<double>(stats.sum) / static_cast<double>(kCount);
+    double squares = 0.0;
+    state = 42;
+    for (long long i = 0; i < kCount; ++i)
+    {
+        const double d = sample(state) - mean;
+        squares += d * d;
+    }
+    const double reference = std::sqrt(squares / static_cast<double>(kCount)) * 10.0;
+    REQUIRE(std::abs(stats.UnstableRate() - reference) < 1e-9 * reference);
+
+    // 极端情形：1 亿个 150 ms 中只有一个 149 ms，σ² = p(1 − p)，p = 1/n
+    HitErrorStats nearConstant;
+    nearConstant.count      = 100'000'000;
+    nearConstant.sum        = 150LL * nearConstant.count - 1;
+    nearConstant.sumSquares = 22500LL * (nearConstant.count - 1) + 149 * 149;
+    const double p = 1.0 / static_cast<double>(nearConstant.count);
+    const double expected = std::sqrt(p * (1.0 - p)) * 10.0;
+    REQUIRE(std::abs(nearConstant.UnstableRate() - expected) < 1e-9 * expected);
+    REQUIRE(std::abs(nearConstant.Mean() - (150.0 - p)) < 1e-12);
+}
@@ -5,6 +5,9 @@
 
 #include "game/judge.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace sakura::game;
 
 // ─────────────────────────────────────────────────────────────────────────────
@@ -137,8 +140,173 @@ TEST_CASE("JudgeMouseNote 对 Slider 头部使用更宽容的点击范围", "[ju
     const float hitX = slider.x + 0.095f;
     const float hitY = slider.y;
 
-    REQUIRE(judge.JudgeMouseNote(circle, 1000, hitX, hitY) == JudgeResult::None);
-    REQUIRE(judge.JudgeMouseNote(slider, 1000, hitX, hitY) == JudgeResult::Perfect);
+    NoteState circleState;
+    NoteState sliderState;
+    REQUIRE(judge.JudgeMouseNote(circle, circleState, 1000, hitX, hitY) == JudgeResult::None);
+    REQUIRE(judge.JudgeMouseNote(slider, sliderState, 1000, hitX, hitY) == JudgeResult::Perfect);
+    // Slider 头部命中不直接终判，由场景在路径追踪结束后写入结果
+    REQUIRE(sliderState.isJudged == false);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// 运行时状态与谱面数据分离
+// ─────────────────────────────────────────────────────────────────────────────
+
+TEST_CASE("JudgeKeyboardNote 只写入平行状态，已判定的音符不再重复判定", "[judge][state]")
+{
+    Judge judge;
+
+    KeyboardNote tap;
+    tap.time = 1000;
+    tap.type = NoteType::Tap;
+
+    NoteState state;
+    REQUIRE(judge.JudgeKeyboardNote(tap, state, 1010) == JudgeResult::Perfect);
+    REQUIRE(state.isJudged == true);
+    REQUIRE(state.result == JudgeResult::Perfect);
+    REQUIRE(judge.JudgeKeyboardNote(tap, state, 1010) == JudgeResult::None);
+
+    // Hold 头部只返回结果，状态由场景在 Hold 结束时写入
+    KeyboardNote hold = tap;
+    hold.type     = NoteType::Hold;
+    hold.duration = 500;
+    NoteState holdState;
+    REQUIRE(judge.JudgeKeyboardNote(hold, holdState, 1040) == JudgeResult::Great);
+    REQUIRE(holdState.isJudged == false);
+}
+
+TEST_CASE("CheckMisses 按下标写入状态数组并统计 Slider 拐点", "[judge][state]")
+{
+    Judge judge;
+
+    std::vector<KeyboardNote> keyboard(4);
+    for (int i = 0; i < 4; ++i)
+        keyboard[i].time = 1000 + i * 100;
+    std::vector<NoteState> keyboardStates(keyboard.size());
+    keyboardStates[0].isJudged = true;
+    keyboardStates[0].result   = JudgeResult::Perfect;
+
+    // now=1260：time ≤ 1109 的音符超出 miss 窗口（150ms）
+    REQUIRE(judge.CheckMisses(keyboard, keyboardStates, 1260) == 1);
+    REQUIRE(keyboardStates[0].result == JudgeResult::Perfect);
+    REQUIRE(keyboardStates[1].isJudged == true);
+    REQUIRE(keyboardStates[1].result == JudgeResult::Miss);
+    REQUIRE(keyboardStates[2].isJudged == false);
+    REQUIRE(judge.CheckMisses(keyboard, keyboardStates, 1260) == 0);
+
+    std::vector<MouseNote> mouse(2);
+    mouse[0].time       = 500;
+    mouse[0].type       = NoteType::Slider;
+    mouse[0].sliderPath = { { 0.2f, 0.2f }, { 0.4f, 0.4f }, { 0.6f, 0.6f } };
+    mouse[1].time       = 5000;
+    std::vector<NoteState> mouseStates(mouse.size());
+
+    // Slider 头部 Miss 时拐点一并计入
+    REQUIRE(judge.CheckMouseMisses(mouse, mouseStates, 1000) == 4);
+    REQUIRE(mouseStates[0].result == JudgeResult::Miss);
+    REQUIRE(mouseStates[1].isJudged == false);
+}
+
+TEST_CASE("SweepMisses 游标只前进到 Miss 期限已过的音符并报告下标", "[judge][state]")
+{
+    Judge judge;
+
+    std::vector<KeyboardNote> keyboard(5);
+    for (int i = 0; i < 5; ++i)
+    {
+        keyboard[i].time = 1000 + i * 100;
+        keyboard[i].lane = i % 4;
+    }
+    std::vector<NoteState> states(keyboard.size());
+    states[1].isJudged = true;                 // 已被玩家命中
+    states[3].isJudged = true;                 // 提前命中（游标之后的已判定音符）
+
+    MissCursor cursor;
+    std::vector<uint32_t> missed;
+
+    // now=1100：没有音符超过 150ms
+    REQUIRE(judge.SweepMisses(keyboard, states, 1100, cursor) == 0);
+    REQUIRE(cursor.next == 0);
+
+    // now=1260：0、1 号期限已过，1 号已判定只跳过
+    REQUIRE(judge.SweepMisses(keyboard, states, 1260, cursor, &missed) == 1);
+    REQUIRE(cursor.next == 2);
+    REQUIRE(missed.size() == 1);
+    REQUIRE(missed[0] == 0);
+    REQUIRE(states[0].result == JudgeResult::Miss);
+
+    // 时间不变时再次调用不重复计数
+    REQUIRE(judge.SweepMisses(keyboard, states, 1260, cursor, &missed) == 0);
+
+    // now=2000：剩余全部越过期限，3 号已判定保持原结果
+    missed.clear();
+    REQUIRE(judge.SweepMisses(keyboard, states, 2000, cursor, &missed) == 2);
+    REQUIRE(cursor.next == keyboard.size());
+    REQUIRE(missed.size() == 2);
+    REQUIRE(missed[0] == 2);
+    REQUIRE(missed[1] == 4);
+    REQUIRE(states[3].result == JudgeResult::None);
+
+    std::vector<MouseNote> mouse(2);
+    mouse[0].time       = 500;
+    mouse[0].type       = NoteType::Slider;
+    mouse[0].sliderPath = { { 0.2f, 0.2f }, { 0.4f, 0.4f } };
+    mouse[1].time       = 5000;
+    std::vector<NoteState> mouseStates(mouse.size());
+    MissCursor mouseCursor;
+    missed.clear();
+
+    REQUIRE(judge.SweepMouseMisses(mouse, mouseStates, 1000, mouseCursor, &missed) == 3);
+    REQUIRE(mouseCursor.next == 1);
+    REQUIRE(missed.size() == 1);
+    REQUIRE(missed[0] == 0);
+    REQUIRE(mouseStates[1].isJudged == false);
+}
+
+TEST_CASE("SweepMisses 逐帧推进与全量 CheckMisses 结果一致", "[judge][state]")
+{
+    Judge judge;
+
+    std::vector<KeyboardNote> notes(20000);
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        notes[i].time = 2000 + static_cast<int>(i) * 7;
+        notes[i].lane = static_cast<int>(i % 4);
+    }
+
+    std::vector<NoteState> swept(notes.size());
+    std::vector<NoteState> scanned(notes.size());
+    for (size_t i = 0; i < notes.size(); i += 3)
+    {
+        swept[i].isJudged   = scanned[i].isJudged = true;
+        swept[i].result     = scanned[i].result   = JudgeResult::Great;
+    }
+
+    MissCursor cursor;
+    std::vector<uint32_t> missed;
+    int sweptTotal   = 0;
+    int scannedTotal = 0;
+    size_t maxStep   = 0;
+    const int endTime = notes.back().time + 1000;
+    for (int now = 0; now <= endTime; now += 16)
+    {
+        const size_t before = cursor.next;
+        missed.clear();
+        sweptTotal   += judge.SweepMisses(notes, swept, now, cursor, &missed);
+        maxStep       = std::max(maxStep, cursor.next - before);
+        REQUIRE(missed.size() <= cursor.next - before);
+
+        if (now % 1600 == 0)
+            scannedTotal += judge.CheckMisses(notes, scanned, now);
+    }
+    scannedTotal += judge.CheckMisses(notes, scanned, endTime);
+
+    REQUIRE(sweptTotal == scannedTotal);
+    REQUIRE(cursor.next == notes.size());
+    // 每帧只跨过本帧新越过期限的音符（16ms / 7ms 间隔 → 至多 3 个）
+    REQUIRE(maxStep <= 3);
+    for (size_t i = 0; i < notes.size(); ++i)
+        REQUIRE(swept[i].result == scanned[i].result);
 }
 
 TEST_CASE("UpdateSliderTracking 使用与教程一致的路径容差", "[judge][slider]")
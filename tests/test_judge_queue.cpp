@@ -0,0 +1,177 @@
+// tests/test_judge_queue.cpp — 按轨道待判定队列（LaneJudgeQueue）单元测试
+
+#include "test_framework.h"
+
+#include "game/judge.h"
+#include "game/judge_queue.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+using namespace sakura::game;
+
+namespace
+{
+
+// 合成谱面：每 step 毫秒一个时间点，轨道按伪随机分布，每 5 个时间点出一个双押
+std::vector<KeyboardNote> MakeSyntheticChart(size_t count, int step)
+{
+    std::vector<KeyboardNote> notes;
+    notes.reserve(count);
+    uint32_t seed = 12345u;
+    int time = 1000;
+    while (notes.size() < count)
+    {
+        seed = seed * 1103515245u + 12345u;
+        int lane = static_cast<int>((seed >> 16) % 4);
+        KeyboardNote n;
+        n.time = time;
+        n.lane = lane;
+        if ((seed >> 8) % 10 == 0)
+        {
+            n.type     = NoteType::Hold;
+            n.duration = 200;
+        }
+        notes.push_back(n);
+
+        if (notes.size() % 5 == 0 && notes.size() < count)
+        {
+            KeyboardNote chord = n;
+            chord.lane = (lane + 2) % 4;
+            chord.type = NoteType::Tap;
+            chord.duration = 0;
+            notes.push_back(chord);
+        }
+        time += step;
+    }
+    return notes;
+}
+
+// 旧逻辑：线性扫描全部音符，找 lane 上最近的未判定音符
+int BruteForceNearest(const std::vector<KeyboardNote>& notes, const std::vector<NoteState>& states,
+                      int lane, int now, int maxAheadMs)
+{
+    int bestIdx  = -1;
+    int bestDist = INT_MAX;
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        if (states[i].isJudged || notes[i].lane != lane) continue;
+        if (notes[i].time > now + maxAheadMs) continue;
+        int dist = std::abs(notes[i].time - now);
+        if (dist < bestDist)
+        {
+            bestDist = dist;
+            bestIdx  = static_cast<int>(i);
+        }
+    }
+    return bestIdx;
+}
+
+} // namespace
+
+TEST_CASE("LaneJudgeQueue 按轨道拆分并忽略负轨道", "[judge][queue]")
+{
+    std::vector<KeyboardNote> notes = {
+        { 100, 0 }, { 200, 2 }, { 300, 0 }, { 400, -1 }, { 500, 2 },
+    };
+    LaneJudgeQueue queue;
+    queue.Build(notes);
+
+    REQUIRE(queue.GetLaneCount() == 3);
+    REQUIRE(queue.GetLaneSize(0) == 2);
+    REQUIRE(queue.GetLaneSize(1) == 0);
+    REQUIRE(queue.GetLaneSize(2) == 2);
+
+    std::vector<NoteState> states(notes.size());
+    REQUIRE(queue.FindNearest(1, 200, 2000, notes, states) == -1);
+    REQUIRE(queue.FindNearest(-1, 400, 2000, notes, states) == -1);
+    REQUIRE(queue.FindNearest(7, 400, 2000, notes, states) == -1);
+    REQUIRE(queue.FindNearest(0, 190, 2000, notes, states) == 0);
+    REQUIRE(queue.FindNearest(0, 210, 2000, notes, states) == 2);
+    REQUIRE(queue.FindNearest(0, 200, 2000, notes, states) == 0);   // 等距取较早音符
+    REQUIRE(queue.FindNearest(2, 0, 100, notes, states) == -1);      // 尚未进入活跃窗口
+
+    states[0].isJudged = true;
+    REQUIRE(queue.FindNearest(0, 100, 2000, notes, states) == 2);
+    REQUIRE(queue.GetLaneCursor(0) == 1);
+
+    // 重试：状态整体重置后游标归零
+    states.assign(notes.size(), NoteState{});
+    queue.Reset();
+    REQUIRE(queue.GetLaneCursor(0) == 0);
+    REQUIRE(queue.FindNearest(0, 100, 2000, notes, states) == 0);
+}
+
+TEST_CASE("LaneJudgeQueue 与线性扫描结果一致（抖动、漏按、跳按）", "[judge][queue]")
+{
+    const auto notes = MakeSyntheticChart(3000, 60);
+    std::vector<NoteState> states(notes.size());
+    LaneJudgeQueue queue;
+    queue.Build(notes);
+    Judge judge;
+
+    uint32_t seed = 777u;
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        if ((seed >> 16) % 7 == 0) continue;   // 漏按：留给后续按键或 Miss 检测
+
+        const int jitter = static_cast<int>((seed >> 8) % 241) - 120;
+        const int now    = notes[i].time + jitter;
+        const int lane   = notes[i].lane;
+
+        const int expected = BruteForceNearest(notes, states, lane, now, 2000);
+        const int actual   = queue.FindNearest(lane, now, 2000, notes, states);
+        REQUIRE(actual == expected);
+        if (actual >= 0)
+        {
+            judge.JudgeKeyboardNote(notes[actual], states[actual], now);
+            states[actual].isJudged = true;   // Hold 头部命中后场景同样立即置位
+        }
+
+        // 周期性模拟自动 Miss，让游标跨过被漏掉的音符
+        if (i % 50 == 0)
+            judge.CheckMisses(notes, states, now);
+    }
+}
+
+TEST_CASE("LaneJudgeQueue 完整演奏 10 万音符合成谱面", "[judge][queue]")
+{
+    const auto notes = MakeSyntheticChart(100000, 40);
+    REQUIRE(notes.size() == 100000);
+
+    std::vector<NoteState> states(notes.size());
+    LaneJudgeQueue queue;
+    queue.Build(notes);
+    Judge judge;
+
+    size_t totalQueued = 0;
+    for (int lane = 0; lane < queue.GetLaneCount(); ++lane)
+        totalQueued += queue.GetLaneSize(lane);
+    REQUIRE(totalQueued == notes.size());
+
+    // 每个音符都在其判定时间精确按下：必须命中该音符本身，且全部 Perfect
+    int perfects = 0;
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        const auto& note = notes[i];
+        const int idx = queue.FindNearest(note.lane, note.time, 2000, notes, states);
+        REQUIRE(idx == static_cast<int>(i));
+
+        auto result = judge.JudgeKeyboardNote(notes[idx], states[idx], note.time);
+        if (note.type == NoteType::Hold)
+            states[idx].isJudged = true;
+        if (result == JudgeResult::Perfect)
+            ++perfects;
+    }
+    REQUIRE(perfects == static_cast<int>(notes.size()));
+
+    // 全部判定后再查询：各轨道游标走到队尾
+    for (int lane = 0; lane < queue.GetLaneCount(); ++lane)
+    {
+        REQUIRE(queue.FindNearest(lane, notes.back().time, 2000, notes, states) == -1);
+        REQUIRE(queue.GetLaneCursor(lane) == queue.GetLaneSize(lane));
+    }
+}
@@ -0,0 +1,200 @@
+// tests/test_judge_session.cpp — 单局判定核心（JudgeSession）单元测试
+// 以 JudgeInput 驱动按键 / Hold / Slider / 自动 Miss，检查产生的 JudgeEvent 与计分
+
+#include "test_framework.h"
+
+#include "game/judge_session.h"
+
+#include <vector>
+
+using namespace sakura::game;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+JudgeInput Key(JudgeInput::Kind kind, int lane, double timeMs)
+{
+    JudgeInput in;
+    in.kind   = kind;
+    in.lane   = lane;
+    in.timeMs = timeMs;
+    return in;
+}
+
+JudgeInput Mouse(JudgeInput::Kind kind, float x, float y, bool down, double timeMs)
+{
+    JudgeInput in;
+    in.kind      = kind;
+    in.x         = x;
+    in.y         = y;
+    in.mouseDown = down;
+    in.timeMs    = timeMs;
+    return in;
+}
+
+// 取走并返回本次产生的事件
+std::vector<JudgeEvent> Take(JudgeSession& session)
+{
+    std::vector<JudgeEvent> events = session.GetEvents();
+    session.ClearEvents();
+    return events;
+}
+
+} // namespace
+
+TEST_CASE("JudgeSession 按键命中产生事件，超时音符自动 Miss", "[judge_session]")
+{
+    std::vector<KeyboardNote> kb(2);
+    kb[0].time = 1000; kb[0].lane = 0;
+    kb[1].time = 1500; kb[1].lane = 1;
+
+    JudgeSession session;
+    session.Start(kb, {}, Judge{});
+
+    session.HandleInput(Key(JudgeInput::Kind::KeyDown, 0, 1010.5));
+    auto events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].kind == JudgeEventKind::Hit);
+    REQUIRE(events[0].result == JudgeResult::Perfect);
+    REQUIRE(events[0].noteResult == JudgeResult::Perfect);
+    REQUIRE(events[0].lane == 0);
+    REQUIRE(events[0].noteIndex == 0);
+    REQUIRE_THAT(events[0].hitErrorMs, WithinAbs(-10.5, 1e-9));
+    REQUIRE(events[0].combo == 1);
+
+    // 1650 是第二个音符的 Miss 期限：恰好到达时不判，越过后判 Miss
+    session.Tick(1650.0);
+    REQUIRE(Take(session).empty());
+    session.Tick(1651.0);
+    events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].kind == JudgeEventKind::Miss);
+    REQUIRE(events[0].lane == 1);
+    REQUIRE(events[0].combo == 0);
+
+    REQUIRE(session.GetKeyboardStates()[1].isJudged);
+    REQUIRE(session.GetScore().GetPerfectCount() == 1);
+    REQUIRE(session.GetScore().GetMissCount() == 1);
+}
+
+TEST_CASE("JudgeSession Hold 以松开时间戳判定，乱序到达的松开不会卡住按键", "[judge_session]")
+{
+    std::vector<KeyboardNote> kb(2);
+    kb[0].time = 1000; kb[0].lane = 2; kb[0].type = NoteType::Hold; kb[0].duration = 500;
+    kb[1].time = 2000; kb[1].lane = 3; kb[1].type = NoteType::Hold; kb[1].duration = 500;
+
+    JudgeSession session;
+    session.Start(kb, {}, Judge{});
+
+    // 同一帧内松开先于按下到达（松开在事件回调转发、按下在固定步长转发）
+    session.HandleInput(Key(JudgeInput::Kind::KeyUp, 2, 1010.0));
+    session.HandleInput(Key(JudgeInput::Kind::KeyDown, 2, 1000.0));
+    auto events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].result == JudgeResult::Perfect);
+    REQUIRE(events[0].noteResult == JudgeResult::None);   // Hold 进行中
+
+    session.Tick(1020.0);
+    REQUIRE(Take(session).empty());                        // 仍在断触容错内
+    session.Tick(1100.0);
+    events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].kind == JudgeEventKind::HoldEnd);
+    REQUIRE(events[0].result == JudgeResult::Miss);        // 1010 松开，远早于末端
+
+    // 第二个 Hold 按住到末端附近才松开 → 沿用头部判定
+    session.HandleInput(Key(JudgeInput::Kind::KeyDown, 3, 2030.0));
+    events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].result == JudgeResult::Great);
+    for (int t = 2040; t <= 2600; t += 10)
+    {
+        if (t == 2550)
+            session.HandleInput(Key(JudgeInput::Kind::KeyUp, 3, 2550.0));
+        session.Tick(t);
+        events = Take(session);
+        if (t <= 2580)
+        {
+            REQUIRE(events.empty());
+        }
+        else if (t == 2590)
+        {
+            REQUIRE(events.size() == 1);
+            REQUIRE(events[0].kind == JudgeEventKind::HoldEnd);
+            REQUIRE(events[0].result == JudgeResult::Great);
+            REQUIRE(events[0].noteResult == JudgeResult::Great);
+        }
+    }
+    REQUIRE(session.GetKeyboardStates()[1].result == JudgeResult::Great);
+}
+
+TEST_CASE("JudgeSession Slider 头部点击、拐点追踪与结束事件", "[judge_session]")
+{
+    std::vector<MouseNote> ms(1);
+    ms[0].time = 3000;
+    ms[0].x = 0.5f; ms[0].y = 0.5f;
+    ms[0].type = NoteType::Slider;
+    ms[0].sliderDuration = 400;
+    ms[0].sliderPath = { { 0.6f, 0.5f }, { 0.7f, 0.5f } };
+
+    JudgeSession session;
+    session.Start({}, ms, Judge{});
+
+    // 鼠标区外的点击被忽略
+    session.HandleInput(Mouse(JudgeInput::Kind::MouseDown, 1.5f, 0.5f, true, 3000.0));
+    REQUIRE(Take(session).empty());
+
+    session.HandleInput(Mouse(JudgeInput::Kind::MouseDown, 0.5f, 0.5f, true, 3005.0));
+    auto events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].kind == JudgeEventKind::Hit);
+    REQUIRE(!events[0].isKeyboard);
+    REQUIRE(events[0].noteResult == JudgeResult::None);
+
+    session.HandleInput(Mouse(JudgeInput::Kind::MouseState, 0.6f, 0.5f, true, 3200.0));
+    session.Tick(3200.0);
+    events = Take(session);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].kind == JudgeEventKind::SliderTick);
+    REQUIRE(events[0].waypoint == 0);
+    REQUIRE_THAT(events[0].x, WithinAbs(0.6, 1e-6));
+
+    session.HandleInput(Mouse(JudgeInput::Kind::MouseState, 0.7f, 0.5f, true, 3400.0));
+    session.Tick(3400.0);
+    events = Take(session);
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0].kind == JudgeEventKind::SliderTick);
+    REQUIRE(events[0].waypoint == 1);
+    REQUIRE(events[1].kind == JudgeEventKind::SliderEnd);
+    REQUIRE(events[1].result == JudgeResult::None);
+    REQUIRE(events[1].noteResult == JudgeResult::Perfect);
+
+    REQUIRE(session.GetScore().GetPerfectCount() == 3);
+    REQUIRE(session.GetScore().GetJudgedCount() == 3);
+}
+
+TEST_CASE("JudgeSession Finish 把剩余音符与拐点计为 Miss", "[judge_session]")
+{
+    std::vector<KeyboardNote> kb(1);
+    kb[0].time = 1000; kb[0].lane = 0;
+    std::vector<MouseNote> ms(1);
+    ms[0].time = 1200;
+    ms[0].type = NoteType::Slider;
+    ms[0].sliderDuration = 300;
+    ms[0].sliderPath = { { 0.2f, 0.2f }, { 0.3f, 0.3f }, { 0.4f, 0.4f } };
+
+    JudgeSession session;
+    session.Start(kb, ms, Judge{});
+    session.Tick(500.0);
+    session.Finish();
+
+    // 键盘 1 + Slider 头部 1 + 拐点 3
+    REQUIRE(session.GetScore().GetMissCount() == 5);
+    REQUIRE(session.GetKeyboardStates()[0].result == JudgeResult::Miss);
+    REQUIRE(session.GetMouseStates()[0].result == JudgeResult::Miss);
+
+    session.Reset();
+    REQUIRE(session.GetScore().GetJudgedCount() == 0);
+    REQUIRE(!session.GetKeyboardStates()[0].isJudged);
+}
@@ -0,0 +1,234 @@
+// tests/test_judge_thread.cpp — 无锁 SPSC 队列与独立判定线程测试
+// 压力测试：模拟主线程周期性卡顿（渲染卡顿），验证判定线程的偏差不受影响、
+// Miss 只在输入水位越过期限后才判定（卡顿期间的按键不会被提前判 Miss）
+
+#include "test_framework.h"
+
+#include "game/judge_thread.h"
+#include "utils/spsc_ring.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace sakura::game;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+double SteadyUs()
+{
+    using namespace std::chrono;
+    return static_cast<double>(
+        duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// 等判定线程完整跑过至少两次 Tick（此前入队的输入已全部处理）
+void WaitTicks(const JudgeThread& thread)
+{
+    const uint64_t start = thread.GetTickCount();
+    while (thread.GetTickCount() < start + 2)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+} // namespace
+
+TEST_CASE("SpscRing 跨线程按序传递且满时拒绝写入", "[spsc]")
+{
+    sakura::utils::SpscRing<uint32_t, 8> small;
+    for (uint32_t i = 0; i < 8; ++i)
+        REQUIRE(small.TryPush(i));
+    REQUIRE(!small.TryPush(99));
+    REQUIRE(small.SizeApprox() == 8);
+    uint32_t v = 0;
+    REQUIRE(small.TryPop(v));
+    REQUIRE(v == 0);
+    REQUIRE(small.TryPush(8));
+
+    // 生产者 / 消费者各一个线程，20 万个元素顺序不乱、不丢
+    sakura::utils::SpscRing<uint32_t, 256> ring;
+    constexpr uint32_t COUNT = 200000;
+    std::thread producer([&ring] {
+        for (uint32_t i = 0; i < COUNT; )
+        {
+            if (ring.TryPush(i)) ++i;
+            else std::this_thread::yield();
+        }
+    });
+
+    uint32_t expected = 0;
+    bool     ordered  = true;
+    while (expected < COUNT)
+    {
+        uint32_t got = 0;
+        if (ring.TryPop(got))
+        {
+            ordered = ordered && (got == expected);
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    REQUIRE(ordered);
+    REQUIRE(ring.EmptyApprox());
+}
+
+TEST_CASE("JudgeThread 主线程卡顿时判定偏差与 Miss 时刻不受影响", "[judge_thread]")
+{
+    // 每 40ms 一个音符，轨道轮换；偶数下标由脚本按下（偏差 -7~+7ms），奇数下标放任超时
+    std::vector<KeyboardNote> kb;
+    for (int i = 0; i < 30; ++i)
+    {
+        KeyboardNote n;
+        n.time = 200 + i * 40;
+        n.lane = i % 4;
+        kb.push_back(n);
+    }
+    struct ScriptedPress { int lane; double timeMs; uint32_t note; };
+    std::vector<ScriptedPress> presses;
+    for (uint32_t i = 0; i < kb.size(); i += 2)
+        presses.push_back({ kb[i].lane, kb[i].time + static_cast<double>(i % 15) - 7.0 + 0.25, i });
+
+    JudgeSession session;
+    session.Start(kb, {}, Judge{});
+    JudgeThread thread;
+    thread.Start(session, &SteadyUs);
+
+    // 游戏时间 = 主机时间 - 起点（原速）
+    const double originUs = SteadyUs();
+    auto gameMs = [originUs] { return (SteadyUs() - originUs) / 1000.0; };
+
+    std::vector<JudgeEvent> events;
+    std::vector<double>     watermarks;   // 每帧送达的输入水位（游戏时间）
+    size_t nextPress = 0;
+    int    frame     = 0;
+    constexpr double STALL_MS = 120.0;
+    while (gameMs() < 200.0 + 30 * 40 + 250.0)
+    {
+        // “事件泵”：把已经发生的按键连同其发生时刻一并转发（卡顿期间的按键在卡顿后才送达），
+        // 转发完毕后再同步时钟，输入水位即本帧泵取时刻
+        const double now = gameMs();
+        while (nextPress < presses.size() && presses[nextPress].timeMs <= now)
+        {
+            JudgeInput in;
+            in.kind   = JudgeInput::Kind::KeyDown;
+            in.lane   = presses[nextPress].lane;
+            in.timeMs = presses[nextPress].timeMs;
+            thread.PushInput(in);
+            ++nextPress;
+        }
+        thread.SyncClock(originUs + now * 1000.0, now, 1.0, true, originUs + now * 1000.0);
+        watermarks.push_back(now);
+        thread.DrainEvents([&events](const JudgeEvent& ev) { events.push_back(ev); });
+
+        // 每 6 帧一次 120ms 的“渲染卡顿”，其余帧约 16ms
+        const auto frameMs = (++frame % 6 == 0) ? STALL_MS : 16.0;
+        std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(frameMs * 1000)));
+    }
+    thread.Stop();
+    thread.DrainEvents([&events](const JudgeEvent& ev) { events.push_back(ev); });
+    REQUIRE(thread.GetTickCount() > 0);
+
+    // 每个音符恰好一个事件
+    REQUIRE(events.size() == kb.size());
+    std::vector<int> seen(kb.size(), 0);
+    double worstMissLag = 0.0;
+    for (const auto& ev : events)
+    {
+        REQUIRE(ev.noteIndex < kb.size());
+        ++seen[ev.noteIndex];
+        const auto& note = kb[ev.noteIndex];
+        if (ev.noteIndex % 2 == 0)
+        {
+            // 按下的音符：偏差与脚本时刻完全一致（不受送达时机影响）
+            REQUIRE(ev.kind == JudgeEventKind::Hit);
+            const auto& press = presses[ev.noteIndex / 2];
+            REQUIRE_THAT(ev.hitErrorMs, WithinAbs(note.time - press.timeMs, 1e-9));
+            REQUIRE_THAT(ev.timeMs, WithinAbs(press.timeMs, 1e-9));
+        }
+        else
+        {
+            // 放任的音符：输入水位越过期限后才判 Miss，且不晚于越过期限的那次同步太多
+            REQUIRE(ev.kind == JudgeEventKind::Miss);
+            const double deadline = note.time + Judge{}.GetWindows().miss;
+            REQUIRE(ev.timeMs > deadline);
+            const auto firstPast = std::upper_bound(watermarks.begin(), watermarks.end(), deadline);
+            REQUIRE(firstPast != watermarks.end());
+            worstMissLag = std::max(worstMissLag, ev.timeMs - *firstPast);
+        }
+    }
+    for (int n : seen) REQUIRE(n == 1);
+    // 水位送达后判定线程在下一次 Tick 即判 Miss（宽松容差以适应 CI 调度抖动）
+    REQUIRE(worstMissLag < STALL_MS / 2.0);
+
+    const auto& score = session.GetScore();
+    REQUIRE(score.GetMissCount() == 15);
+    REQUIRE(score.GetJudgedCount() == 30);
+}
+
+TEST_CASE("JudgeThread 卡顿超过 Miss 窗口时，卡顿期间的按键仍按时间戳判定", "[judge_thread]")
+{
+    // 同一轨道两个音符：卡顿期间按下第一个；若判定线程按外推时间提前判 Miss，
+    // 迟到的按键会落到第二个音符上并带来很大的提前偏差
+    std::vector<KeyboardNote> kb(2);
+    kb[0].time = 300; kb[0].lane = 1;
+    kb[1].time = 600; kb[1].lane = 1;
+    const double missMs  = Judge{}.GetWindows().miss;
+    const double pressMs = 305.25;
+
+    JudgeSession session;
+    session.Start(kb, {}, Judge{});
+
+    // 受控的主机时钟：卡顿 = 时钟前进但主线程不泵取、不同步
+    std::atomic<double> hostUs{ 0.0 };
+    JudgeThread thread;
+    thread.Start(session, [&hostUs] { return hostUs.load(); });
+
+    std::vector<JudgeEvent> events;
+    auto frame = [&](double nowMs, bool delivered)
+    {
+        hostUs.store(nowMs * 1000.0);
+        if (delivered)
+            thread.SyncClock(nowMs * 1000.0, nowMs, 1.0, true, nowMs * 1000.0);
+        WaitTicks(thread);
+        thread.DrainEvents([&events](const JudgeEvent& ev) { events.push_back(ev); });
+    };
+
+    thread.SyncClock(0.0, 0.0, 1.0, true, 0.0);
+    frame(250.0, true);
+
+    // 250ms 起卡顿，持续超过 Miss 窗口；按键发生在卡顿期间，尚未送达
+    const double stallEndMs = 250.0 + missMs + 100.0;
+    frame(stallEndMs, false);
+    REQUIRE(events.empty());
+
+    // 卡顿结束：先转发按键，再同步时钟
+    JudgeInput press;
+    press.kind   = JudgeInput::Kind::KeyDown;
+    press.lane   = 1;
+    press.timeMs = pressMs;
+    thread.PushInput(press);
+    frame(stallEndMs, true);
+
+    // 第二个音符放任超时
+    frame(kb[1].time + missMs + 50.0, true);
+    thread.Stop();
+    thread.DrainEvents([&events](const JudgeEvent& ev) { events.push_back(ev); });
+
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0].kind == JudgeEventKind::Hit);
+    REQUIRE(events[0].noteIndex == 0);
+    REQUIRE_THAT(events[0].hitErrorMs, WithinAbs(kb[0].time - pressMs, 1e-9));
+    REQUIRE_THAT(events[0].timeMs, WithinAbs(pressMs, 1e-9));
+    REQUIRE(events[1].kind == JudgeEventKind::Miss);
+    REQUIRE(events[1].noteIndex == 1);
+    REQUIRE(session.GetScore().GetMissCount() == 1);
+}
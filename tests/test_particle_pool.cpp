@@ -0,0 +1,160 @@
+// tests/test_particle_pool.cpp — SoA 粒子池：SIMD 积分、swap-remove 与单图元几何
+
+#include "test_framework.h"
+
+#include "effects/particle_pool.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace sakura::effects;
+using sakura::core::BatchVertex;
+using sakura::core::FlushReason;
+using sakura::core::GeometryBatch;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+ParticleSpawn RandomSpawn(std::mt19937& rng, float life)
+{
+    std::uniform_real_distribution<float> d(-1.0f, 1.0f);
+    ParticleSpawn s;
+    s.x = d(rng);  s.y = d(rng);
+    s.vx = d(rng); s.vy = d(rng);
+    s.ax = d(rng); s.ay = d(rng);
+    s.rotation = d(rng) * 180.0f;
+    s.rotSpeed = d(rng) * 90.0f;
+    s.life = life;
+    return s;
+}
+
+} // namespace
+
+TEST_CASE("粒子池 SIMD 积分与逐粒子标量公式一致（含尾部）", "[particles]")
+{
+    std::mt19937 rng(7);
+    const size_t count = 37;   // 不是任何向量宽度的整数倍
+    ParticlePool pool(64);
+    std::vector<ParticleSpawn> expected;
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected.push_back(RandomSpawn(rng, 10.0f));
+        REQUIRE(pool.Spawn(expected.back()));
+    }
+
+    const float dt = 1.0f / 240.0f;
+    for (int step = 0; step < 50; ++step)
+    {
+        pool.Update(dt);
+        for (auto& s : expected)
+        {
+            s.life -= dt;
+            s.vx += s.ax * dt;
+            s.vy += s.ay * dt;
+            s.x  += s.vx * dt;
+            s.y  += s.vy * dt;
+            s.rotation += s.rotSpeed * dt;
+        }
+    }
+
+    REQUIRE(pool.GetCount() == count);   // 无死亡时顺序不变
+    for (size_t i = 0; i < count; ++i)
+    {
+        REQUIRE_THAT(pool.GetX()[i], WithinAbs(expected[i].x, 1e-5));
+        REQUIRE_THAT(pool.GetY()[i], WithinAbs(expected[i].y, 1e-5));
+        REQUIRE_THAT(pool.GetVX()[i], WithinAbs(expected[i].vx, 1e-5));
+        REQUIRE_THAT(pool.GetVY()[i], WithinAbs(expected[i].vy, 1e-5));
+        REQUIRE_THAT(pool.GetRotation()[i], WithinAbs(expected[i].rotation, 1e-3));
+        REQUIRE_THAT(pool.GetLife()[i], WithinAbs(expected[i].life, 1e-5));
+    }
+}
+
+TEST_CASE("粒子池满时拒绝发射，死亡粒子 swap-remove 后存活区间保持稠密", "[particles]")
+{
+    ParticlePool pool(10);
+    for (int i = 0; i < 10; ++i)
+    {
+        ParticleSpawn s;
+        s.x    = static_cast<float>(i);          // 用 x 标识粒子
+        s.life = (i % 3 == 0) ? 0.05f : 1.0f;    // 0、3、6、9 先死亡
+        s.kind = (i % 3 == 0) ? ParticleKind::Blossom : ParticleKind::Circle;
+        REQUIRE(pool.Spawn(s));
+    }
+    REQUIRE(pool.IsFull());
+    REQUIRE(!pool.Spawn(ParticleSpawn{}));
+    REQUIRE(pool.GetKindCount(ParticleKind::Blossom) == 4);
+
+    pool.Update(0.1f);
+    REQUIRE(pool.GetCount() == 6);
+    REQUIRE(pool.GetKindCount(ParticleKind::Blossom) == 0);
+    REQUIRE(pool.GetKindCount(ParticleKind::Circle) == 6);
+
+    std::vector<float> alive(pool.GetX(), pool.GetX() + pool.GetCount());
+    std::sort(alive.begin(), alive.end());
+    REQUIRE(alive == std::vector<float>({ 1, 2, 4, 5, 7, 8 }));
+
+    // 腾出的槽可立即复用
+    REQUIRE(pool.Spawn(ParticleSpawn{}));
+    REQUIRE(pool.GetCount() == 7);
+
+    pool.Clear();
+    REQUIRE(pool.GetCount() == 0);
+    REQUIRE(pool.GetKindCount(ParticleKind::Circle) == 0);
+}
+
+TEST_CASE("粒子池全部粒子写入单个图元、一次提交", "[particles]")
+{
+    ParticlePool pool(100);
+    for (int i = 0; i < 30; ++i)
+    {
+        ParticleSpawn s;
+        s.x = 0.5f;
+        s.y = 0.25f;
+        s.size = 0.01f;
+        s.sizeEnd = 0.01f;
+        s.life = 1.0f;
+        s.kind = static_cast<ParticleKind>(i % 3);
+        pool.Spawn(s);
+    }
+
+    size_t expectedVertices = 0, expectedIndices = 0;
+    for (int k = 0; k < 3; ++k)
+    {
+        size_t v = 0, idx = 0;
+        ParticlePool::GetGeometrySize(static_cast<ParticleKind>(k), v, idx);
+        expectedVertices += v * 10;
+        expectedIndices  += idx * 10;
+    }
+
+    std::vector<BatchVertex> vertices;
+    std::vector<int> indices;
+    GeometryBatch batch([&](void* tex, const BatchVertex* v, int vc, const int* idx, int ic) {
+        REQUIRE(tex == nullptr);
+        vertices.assign(v, v + vc);
+        indices.assign(idx, idx + ic);
+    });
+
+    // 批次中已有其他纯色图元：粒子顶点的下标须从其后开始
+    batch.AddQuad(nullptr, {}, {}, {}, {});
+    pool.AppendGeometry(batch, 1920.0f, 1080.0f);
+    batch.Flush(FlushReason::FrameEnd);
+
+    REQUIRE(batch.GetStats().drawCalls == 1);
+    REQUIRE(vertices.size() == expectedVertices + 4);
+    REQUIRE(indices.size() == expectedIndices + 6);
+    const auto [lo, hi] = std::minmax_element(indices.begin() + 6, indices.end());
+    REQUIRE(*lo == 4);
+    REQUIRE(*hi == static_cast<int>(vertices.size()) - 1);
+
+    // 第一个粒子是圆：圆心在像素坐标，半径按短边换算
+    REQUIRE_THAT(vertices[4].x, WithinAbs(960.0, 1e-3));
+    REQUIRE_THAT(vertices[4].y, WithinAbs(270.0, 1e-3));
+    REQUIRE_THAT(vertices[5].x - vertices[4].x, WithinAbs(10.8, 1e-3));
+
+    // 空池不产生图元
+    ParticlePool empty(4);
+    empty.AppendGeometry(batch, 1920.0f, 1080.0f);
+    REQUIRE(batch.Empty());
+}
@@ -1,7 +1,17 @@
 #include "test_framework.h"
 
+#include "data/database.h"
 #include "game/pp_calculator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
 using namespace sakura::game;
 
 namespace
@@ -25,6 +35,38 @@ GameResult MakePPResult(float level,
     return result;
 }
 
+// 增量实现之前的整体重算：逐条算 PP、整体排序、按名次 std::pow 加权求和
+double ReferenceTotalPP(const std::vector<GameResult>& bestScores, std::vector<double>& ranked)
+{
+    ranked.clear();
+    for (const auto& score : bestScores)
+        ranked.push_back(PPCalculator::CalculatePP(score, score.difficultyLevel));
+    std::sort(ranked.begin(), ranked.end(), std::greater<>());
+
+    double total = 0.0;
+    for (std::size_t index = 0; index < ranked.size(); ++index)
+        total += ranked[index] * std::pow(0.95, static_cast<double>(index));
+    return total;
+}
+
+GameResult RandomResult(std::mt19937& rng, int charts)
+{
+    std::uniform_int_distribution<int> chartDist(0, charts - 1);
+    std::uniform_int_distribution<int> diffDist(0, 2);
+    std::uniform_int_distribution<int> scoreDist(0, 1000);
+    std::uniform_real_distribution<float> accDist(60.0f, 100.0f);
+    std::uniform_int_distribution<int> flagDist(0, 4);
+    static const char* kDiffs[] = { "Easy", "Normal", "Hard" };
+
+    const int diff = diffDist(rng);
+    GameResult result = MakePPResult(2.0f + 4.0f * static_cast<float>(diff),
+                                     accDist(rng), scoreDist(rng) * 1000,
+                                     flagDist(rng) == 0, flagDist(rng) == 0);
+    result.chartId    = "chart_" + std::to_string(chartDist(rng));
+    result.difficulty = kDiffs[diff];
+    return result;
+}
+
 } // namespace
 
 TEST_CASE("PPCalculator 难度与准确率越高单谱 PP 越高", "[pp]")
@@ -73,4 +115,100 @@ TEST_CASE("PPCalculator 总 PP 按降序加权", "[pp]")
         + plays[1].pp * 0.95
         + plays[2].pp * 0.95 * 0.95;
     REQUIRE_THAT(calculator.GetTotalPP(), sakura::tests::Matchers::WithinAbs(expected, 0.0001));
-}
\ No newline at end of file
+}
+
+TEST_CASE("PPCalculator 增量更新与整体重算结果一致（随机历史）", "[pp]")
+{
+    for (unsigned seed = 1; seed <= 20; ++seed)
+    {
+        std::mt19937 rng(seed);
+        const int charts = 1 + static_cast<int>(seed) * 7;
+
+        // 空排名也算已加载：直接用 RecalculateTotal 建立空状态后逐局提交
+        PPCalculator incremental;
+        incremental.RecalculateTotal({});
+        REQUIRE(incremental.GetTotalPP() == 0.0);
+
+        std::map<std::pair<std::string, std::string>, GameResult> best;
+        for (int play = 0; play < 400; ++play)
+        {
+            const GameResult result = RandomResult(rng, charts);
+            const auto key = std::make_pair(result.chartId, result.difficulty);
+
+            auto it = best.find(key);
+            const bool improves = it == best.end() || result.score > it->second.score;
+            if (improves)
+                best[key] = result;
+
+            // RecalculateTotal 之后的实例按同样规则替换
+            REQUIRE(incremental.SubmitBest(result) == improves);
+        }
+
+        std::vector<GameResult> bestScores;
+        for (const auto& [key, result] : best)
+            bestScores.push_back(result);
+
+        std::vector<double> ranked;
+        const double expected = ReferenceTotalPP(bestScores, ranked);
+        REQUIRE(incremental.GetRankedCount() == ranked.size());
+        REQUIRE_THAT(incremental.GetTotalPP(),
+            sakura::tests::Matchers::WithinAbs(expected, std::max(1.0, expected) * 1e-12));
+
+        const auto plays = incremental.GetBestPlays(static_cast<int>(ranked.size()));
+        REQUIRE(plays.size() == ranked.size());
+        for (std::size_t i = 0; i < plays.size(); ++i)
+            REQUIRE(plays[i].pp == ranked[i]);
+
+        // 整体重建得到同一排名
+        PPCalculator rebuilt;
+        rebuilt.RecalculateTotal(bestScores);
+        REQUIRE_THAT(rebuilt.GetTotalPP(),
+            sakura::tests::Matchers::WithinAbs(expected, std::max(1.0, expected) * 1e-12));
+    }
+}
+
+TEST_CASE("PPCalculator 从数据库加载入库时计算的 PP", "[pp][database]")
+{
+    namespace fs = std::filesystem;
+    const fs::path path = fs::temp_directory_path() / "sakura-pp-ranking.db";
+    std::error_code ec;
+    fs::remove(path, ec);
+
+    auto& database = sakura::data::Database::GetInstance();
+    database.Shutdown();
+    REQUIRE(database.Initialize(path.string()));
+
+    std::mt19937 rng(99);
+    std::vector<GameResult> history;
+    for (int play = 0; play < 120; ++play)
+    {
+        history.push_back(RandomResult(rng, 15));
+        database.SaveScore(history.back());
+    }
+
+    PPCalculator loaded;
+    REQUIRE(loaded.LoadFromDatabase());
+
+    PPCalculator recalculated;
+    recalculated.RecalculateTotal(database.GetAllBestScores());
+    REQUIRE(loaded.GetRankedCount() == recalculated.GetRankedCount());
+    REQUIRE_THAT(loaded.GetTotalPP(),
+        sakura::tests::Matchers::WithinAbs(recalculated.GetTotalPP(), 1e-9));
+
+    // 之后的成绩增量提交，与重新加载一致
+    for (int play = 0; play < 30; ++play)
+    {
+        const GameResult result = RandomResult(rng, 15);
+        database.SaveScore(result);
+        loaded.SubmitBest(result);
+    }
+    PPCalculator reloaded;
+    REQUIRE(reloaded.LoadFromDatabase());
+    REQUIRE_THAT(loaded.GetTotalPP(),
+        sakura::tests::Matchers::WithinAbs(reloaded.GetTotalPP(), 1e-9));
+
+    database.Shutdown();
+    fs::remove(path, ec);
+    fs::remove(path.string() + "-wal", ec);
+    fs::remove(path.string() + "-shm", ec);
+}
@@ -0,0 +1,172 @@
+// tests/test_song_clock.cpp — SongClock 音频游标平滑单元测试
+// 模拟混音周期阶梯式更新的音频游标 + 带抖动的帧采样，验证输出平滑、单调并跟踪漂移
+
+#include "test_framework.h"
+
+#include "game/song_clock.h"
+
+#include <cmath>
+#include <cstdint>
+
+using namespace sakura::game;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+// 48kHz / 512 帧的混音周期（约 10.67ms）
+constexpr double PERIOD_US = 512.0 / 48000.0 * 1000000.0;
+
+// 音频线程报告的游标：只在周期边界前进
+double SteppedCursorUs(double trueUs)
+{
+    return std::floor(trueUs / PERIOD_US) * PERIOD_US;
+}
+
+// 帧间隔约 16.7ms，带 ±2ms 伪随机抖动
+struct FrameJitter
+{
+    uint32_t seed = 42u;
+    double Next()
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return 16667.0 + (static_cast<double>(seed >> 16) / 65535.0 - 0.5) * 4000.0;
+    }
+};
+
+} // namespace
+
+TEST_CASE("SongClock 平滑阶梯游标且输出单调", "[clock]")
+{
+    SongClock clock;
+    clock.Reset(0.0);
+    clock.Resume(0.0);
+
+    FrameJitter jitter;
+    double host = 0.0;
+    double prevOut = clock.GetTimeUs(host);
+    double maxStepError = 0.0;
+    double sumError = 0.0;
+    int    counted  = 0;
+
+    for (int frame = 0; frame < 600; ++frame)
+    {
+        const double prevHost = host;
+        host += jitter.Next();
+        const double trueUs = host;   // 原速播放，音频时间 = 主机时间
+        clock.AddSample(host, SteppedCursorUs(trueUs));
+        const double out = clock.GetTimeUs(host);
+
+        REQUIRE(out >= prevOut);
+        if (frame >= 60)   // 前 1s 用于收敛
+        {
+            // 相邻帧输出增量应接近真实帧间隔（原始游标会有 ±10ms 的量化跳变）
+            maxStepError = std::max(maxStepError, std::abs((out - prevOut) - (host - prevHost)));
+            sumError += out - trueUs;
+            ++counted;
+        }
+        prevOut = out;
+    }
+
+    REQUIRE(maxStepError < 1500.0);
+    // 游标平均滞后约半个周期；拟合输出的平均偏差应在一个周期以内
+    const double meanError = sumError / counted;
+    REQUIRE(meanError <= 0.0);
+    REQUIRE(meanError > -PERIOD_US);
+}
+
+TEST_CASE("SongClock 回归斜率跟踪声卡时钟漂移", "[clock]")
+{
+    SongClock clock;
+    clock.Reset(0.0);
+    clock.Resume(0.0);
+
+    const double drift = 1.002;   // 声卡比主机时钟快 0.2%
+    FrameJitter jitter;
+    double host = 0.0;
+    for (int frame = 0; frame < 300; ++frame)
+    {
+        host += jitter.Next();
+        clock.AddSample(host, SteppedCursorUs(host * drift));
+    }
+
+    REQUIRE_THAT(clock.GetSlope(), WithinAbs(drift, 0.0015));
+    REQUIRE(clock.GetSampleCount() == SongClock::MAX_SAMPLES);
+    REQUIRE(std::abs(clock.GetDriftUs()) < PERIOD_US);
+    // 外推 5ms 仍贴合真实位置（容差一个周期）
+    REQUIRE(std::abs(clock.GetTimeUs(host + 5000.0) - (host + 5000.0) * drift) < PERIOD_US);
+}
+
+TEST_CASE("SongClock 暂停冻结、Seek 跳转与变速", "[clock]")
+{
+    SongClock clock;
+    clock.Reset(1000000.0);
+    REQUIRE_THAT(clock.GetTimeUs(123456.0), WithinAbs(1000000.0, 1e-6));   // 未运行时恒定
+
+    clock.Resume(0.0);
+    REQUIRE_THAT(clock.GetTimeUs(250000.0), WithinAbs(1250000.0, 1e-6));   // 无采样时按主机时间运行
+
+    clock.Pause(500000.0);
+    REQUIRE(!clock.IsRunning());
+    REQUIRE_THAT(clock.GetTimeUs(900000.0), WithinAbs(1500000.0, 1e-6));
+    clock.AddSample(900000.0, 9000000.0);                                  // 暂停期间采样被忽略
+    REQUIRE_THAT(clock.GetTimeUs(900000.0), WithinAbs(1500000.0, 1e-6));
+
+    clock.Resume(1000000.0);
+    REQUIRE_THAT(clock.GetTimeUs(1100000.0), WithinAbs(1600000.0, 1e-6));
+
+    // Seek 允许时间回退
+    clock.Seek(1100000.0, 200000.0);
+    REQUIRE_THAT(clock.GetTimeUs(1100000.0), WithinAbs(200000.0, 1e-6));
+    REQUIRE_THAT(clock.GetTimeUs(1200000.0), WithinAbs(300000.0, 1e-6));
+
+    // 1.5 倍速：以当前时间为锚点，斜率随之改变
+    clock.SetSpeed(1200000.0, 1.5);
+    REQUIRE_THAT(clock.GetSlope(), WithinAbs(1.5, 1e-9));
+    REQUIRE_THAT(clock.GetTimeUs(1300000.0), WithinAbs(450000.0, 1e-6));
+}
+
+TEST_CASE("SongClock 游标大幅跳变时直接对齐", "[clock]")
+{
+    SongClock clock;
+    clock.Reset(0.0);
+    clock.Resume(0.0);
+
+    double host = 0.0;
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        host += 16667.0;
+        clock.AddSample(host, SteppedCursorUs(host));
+    }
+
+    // 音频卡顿 200ms 后恢复：游标比拟合直线落后，应立即对齐而不是缓慢回归
+    host += 16667.0;
+    const double stalled = SteppedCursorUs(host - 200000.0);
+    clock.AddSample(host, stalled);
+    REQUIRE_THAT(clock.GetTimeUs(host), WithinAbs(stalled, 1e-6));
+    REQUIRE(clock.GetSampleCount() == 1);
+}
+
+TEST_CASE("SongClock ProjectUs 按拟合直线回推过去的事件时刻", "[clock]")
+{
+    SongClock clock;
+    clock.Reset(0.0);
+    clock.Resume(0.0);
+
+    double host = 0.0;
+    for (int frame = 0; frame < 120; ++frame)
+    {
+        host += 16667.0;
+        clock.AddSample(host, SteppedCursorUs(host));
+    }
+
+    // 上一帧中间发生的按键：沿当前拟合直线回推约 8ms，且不受单调下限钳制
+    const double eventHost = host - 8000.0;
+    const double projected = clock.ProjectUs(eventHost);
+    REQUIRE_THAT(clock.ProjectUs(host) - projected, WithinAbs(8000.0 * clock.GetSlope(), 1e-6));
+    REQUIRE(std::abs(projected - eventHost) < PERIOD_US);
+    REQUIRE(projected <= clock.GetTimeUs(host));
+
+    clock.Pause(host);
+    REQUIRE_THAT(clock.ProjectUs(eventHost), WithinAbs(clock.GetTimeUs(host), 1e-6));
+}
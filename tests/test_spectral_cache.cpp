@@ -0,0 +1,158 @@
+// tests/test_spectral_cache.cpp — 离线频谱时间轴构建、插值与磁盘缓存测试
+
+#include "test_framework.h"
+
+#include "audio/spectral_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <numbers>
+#include <string>
+#include <vector>
+
+using namespace sakura::audio;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+constexpr uint32_t RATE = 44100;
+
+// 前半段 200Hz，后半段 6kHz 的正弦
+std::vector<float> TwoToneSignal(double seconds)
+{
+    const size_t count = static_cast<size_t>(seconds * RATE);
+    std::vector<float> mono(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float freq = (i < count / 2) ? 200.0f : 6000.0f;
+        mono[i] = 0.8f * std::sin(2.0f * std::numbers::pi_v<float> * freq * static_cast<float>(i) / RATE);
+    }
+    return mono;
+}
+
+size_t PeakBand(const std::array<float, SpectralTimeline::BAND_COUNT>& bands)
+{
+    return static_cast<size_t>(std::max_element(bands.begin(), bands.end()) - bands.begin());
+}
+
+std::filesystem::path FreshDir(const char* name)
+{
+    const auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+} // namespace
+
+TEST_CASE("频谱时间轴按 100 帧/秒量化且与实时分析一致", "[spectral_cache]")
+{
+    const auto mono = TwoToneSignal(2.0);
+    const auto timeline = SpectralCache::Build(mono.data(), mono.size(), RATE);
+
+    REQUIRE(timeline.framesPerSecond == 100);
+    REQUIRE(timeline.GetFrameCount() == 200);
+    REQUIRE_THAT(timeline.GetDurationSeconds(), WithinAbs(2.0, 1e-9));
+
+    std::array<float, SpectralTimeline::BAND_COUNT> early{}, late{};
+    REQUIRE(timeline.Sample(0.5, early));
+    REQUIRE(timeline.Sample(1.5, late));
+    REQUIRE(PeakBand(early) < PeakBand(late));
+
+    // 帧中心处的量化结果与对同一窗口直接分析的差值不超过半个量化步长
+    SpectrumAnalyzer analyzer(RATE);
+    SpectrumFrame frame;
+    const size_t center = static_cast<size_t>(0.5 * RATE);
+    analyzer.Analyze(mono.data() + center - SpectrumAnalyzer::WINDOW / 2, frame);
+    for (size_t band = 0; band < SpectralTimeline::BAND_COUNT; ++band)
+        REQUIRE_THAT(early[band], WithinAbs(std::clamp(frame.bands[band], 0.0f, 1.0f), 0.5 / 255.0 + 1e-6));
+
+    // 超出范围不写入
+    std::array<float, SpectralTimeline::BAND_COUNT> untouched{};
+    untouched.fill(-1.0f);
+    REQUIRE(!timeline.Sample(-0.01, untouched));
+    REQUIRE(!timeline.Sample(2.0, untouched));
+    REQUIRE(untouched[0] == -1.0f);
+    REQUIRE(!SpectralTimeline{}.Sample(0.0, untouched));
+}
+
+TEST_CASE("频谱时间轴在相邻帧之间线性插值", "[spectral_cache]")
+{
+    SpectralTimeline timeline;
+    timeline.framesPerSecond = 100;
+    timeline.levels.assign(SpectralTimeline::BAND_COUNT * 3, 0);
+    for (size_t band = 0; band < SpectralTimeline::BAND_COUNT; ++band)
+    {
+        timeline.levels[band]                                  = 0;
+        timeline.levels[SpectralTimeline::BAND_COUNT + band]     = 255;
+        timeline.levels[SpectralTimeline::BAND_COUNT * 2 + band] = 51;
+    }
+
+    std::array<float, SpectralTimeline::BAND_COUNT> out{};
+    REQUIRE(timeline.Sample(0.0025, out));
+    REQUIRE_THAT(out[0], WithinAbs(0.25, 1e-5));
+    REQUIRE(timeline.Sample(0.015, out));
+    REQUIRE_THAT(out[31], WithinAbs(0.6, 1e-5));
+    // 最后一帧之后不再外插
+    REQUIRE(timeline.Sample(0.025, out));
+    REQUIRE_THAT(out[7], WithinAbs(0.2, 1e-5));
+}
+
+TEST_CASE("频谱缓存按文件哈希读写，命中后不再解码", "[spectral_cache]")
+{
+    const auto dir = FreshDir("sakura-spectral-cache");
+    const auto audioPath = (dir / "song.ogg").string();
+    const auto cacheDir  = (dir / "cache").string();
+    {
+        std::ofstream ofs(audioPath, std::ios::binary);
+        ofs << "not really ogg, only the bytes are hashed";
+    }
+
+    int decodeCalls = 0;
+    const auto decode = [&decodeCalls](const std::string&, std::vector<float>& mono, uint32_t& rate) {
+        ++decodeCalls;
+        mono = TwoToneSignal(1.0);
+        rate = RATE;
+        return true;
+    };
+
+    const auto first = SpectralCache::LoadOrBuild(audioPath, cacheDir, decode);
+    REQUIRE(first.has_value());
+    REQUIRE(decodeCalls == 1);
+    REQUIRE(first->GetFrameCount() == 100);
+
+    const auto hash = SpectralCache::HashFile(audioPath);
+    REQUIRE(hash.has_value());
+    const auto cachePath = SpectralCache::GetCachePath(cacheDir, *hash);
+    REQUIRE(std::filesystem::exists(cachePath));
+    REQUIRE(std::filesystem::file_size(cachePath) == 32 + 100 * SpectralTimeline::BAND_COUNT);
+
+    const auto second = SpectralCache::LoadOrBuild(audioPath, cacheDir, decode);
+    REQUIRE(second.has_value());
+    REQUIRE(decodeCalls == 1);
+    REQUIRE(second->levels == first->levels);
+
+    // 哈希不符 / 截断的缓存被拒绝
+    REQUIRE(!SpectralCache::Read(cachePath, *hash + 1).has_value());
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 1);
+    REQUIRE(!SpectralCache::Read(cachePath, *hash).has_value());
+
+    // 文件内容变化 → 新哈希 → 重新分析
+    {
+        std::ofstream ofs(audioPath, std::ios::binary | std::ios::app);
+        ofs << "!";
+    }
+    REQUIRE(SpectralCache::LoadOrBuild(audioPath, cacheDir, decode).has_value());
+    REQUIRE(decodeCalls == 2);
+
+    // 解码失败 / 源文件缺失
+    const auto failing = [](const std::string&, std::vector<float>&, uint32_t&) { return false; };
+    std::filesystem::remove_all(cacheDir);
+    REQUIRE(!SpectralCache::LoadOrBuild(audioPath, cacheDir, failing).has_value());
+    REQUIRE(!SpectralCache::LoadOrBuild((dir / "missing.ogg").string(), cacheDir, decode).has_value());
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,141 @@
+// tests/test_spectrum.cpp — FFT、输出抽头、频谱分析与三缓冲测试
+
+#include "test_framework.h"
+
+#include "audio/spectrum.h"
+#include "utils/triple_buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+using namespace sakura::audio;
+using sakura::tests::Matchers::WithinAbs;
+
+TEST_CASE("radix-2 FFT 与朴素 DFT 结果一致", "[spectrum]")
+{
+    constexpr size_t N = 256;
+    std::vector<float> re(N), im(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        re[i] = std::sin(0.37f * static_cast<float>(i)) + 0.25f * std::cos(1.9f * static_cast<float>(i));
+        im[i] = (i % 7 == 0) ? 0.5f : 0.0f;
+    }
+    const auto inRe = re;
+    const auto inIm = im;
+
+    Fft fft(N);
+    fft.Forward(re.data(), im.data());
+
+    for (size_t k = 0; k < N; k += 5)
+    {
+        double sr = 0.0, si = 0.0;
+        for (size_t n = 0; n < N; ++n)
+        {
+            const double phase = -2.0 * std::numbers::pi * static_cast<double>(k * n) / N;
+            sr += inRe[n] * std::cos(phase) - inIm[n] * std::sin(phase);
+            si += inRe[n] * std::sin(phase) + inIm[n] * std::cos(phase);
+        }
+        REQUIRE_THAT(re[k], WithinAbs(sr, 1e-3));
+        REQUIRE_THAT(im[k], WithinAbs(si, 1e-3));
+    }
+}
+
+TEST_CASE("正弦输入的能量落在对应频带", "[spectrum]")
+{
+    constexpr uint32_t RATE = 48000;
+    SpectrumAnalyzer analyzer(RATE);
+
+    auto peakBand = [&](float freq) {
+        std::vector<float> mono(SpectrumAnalyzer::WINDOW);
+        for (size_t i = 0; i < mono.size(); ++i)
+            mono[i] = 0.8f * std::sin(2.0f * std::numbers::pi_v<float> * freq * static_cast<float>(i) / RATE);
+        SpectrumFrame frame;
+        analyzer.Analyze(mono.data(), frame);
+        return static_cast<size_t>(std::max_element(frame.bands.begin(), frame.bands.end()) - frame.bands.begin());
+    };
+
+    const size_t low  = peakBand(100.0f);
+    const size_t mid  = peakBand(1000.0f);
+    const size_t high = peakBand(8000.0f);
+    REQUIRE(low < mid);
+    REQUIRE(mid < high);
+    // 对数分布 40Hz~12kHz：1kHz 约在第 18 个频带
+    REQUIRE(mid >= 16);
+    REQUIRE(mid <= 20);
+
+    // 静音 → 全 0
+    std::vector<float> silence(SpectrumAnalyzer::WINDOW, 0.0f);
+    SpectrumFrame frame;
+    analyzer.Analyze(silence.data(), frame);
+    for (float b : frame.bands) REQUIRE(b == 0.0f);
+}
+
+TEST_CASE("SampleTap 缩混并读取最新窗口", "[spectrum]")
+{
+    SampleTap tap;
+    std::vector<float> out(4);
+    REQUIRE(!tap.ReadLatest(out.data(), out.size()));
+
+    // 立体声帧 (i, -i + 2i) → 单声道 i
+    std::vector<float> stereo;
+    for (int i = 0; i < 10000; ++i)
+    {
+        stereo.push_back(0.0f);
+        stereo.push_back(2.0f * static_cast<float>(i));
+    }
+    for (size_t f = 0; f < 10000; f += 500)
+        tap.Write(stereo.data() + f * 2, 500, 2);
+
+    REQUIRE(tap.GetWrittenCount() == 10000);
+    REQUIRE(tap.ReadLatest(out.data(), out.size()));
+    REQUIRE(out[0] == 9996.0f);
+    REQUIRE(out[3] == 9999.0f);
+    REQUIRE(!tap.ReadLatest(out.data(), SampleTap::CAPACITY));   // 超过可安全读取的窗口
+}
+
+TEST_CASE("TripleBuffer 读者总能取到完整的最新一帧", "[spectrum]")
+{
+    struct Frame { uint64_t a = 0; uint64_t b = 0; };
+    sakura::utils::TripleBuffer<Frame> tb;
+    REQUIRE(!tb.Fetch());
+
+    constexpr uint64_t COUNT = 200000;
+    std::atomic<bool> done{ false };
+    std::thread writer([&] {
+        for (uint64_t i = 1; i <= COUNT; ++i)
+        {
+            auto& f = tb.WriteBuffer();
+            f.a = i;
+            f.b = i * 3;
+            tb.Publish();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t last = 0;
+    bool consistent = true;
+    bool monotonic  = true;
+    for (;;)
+    {
+        const bool finished = done.load(std::memory_order_acquire);
+        if (tb.Fetch())
+        {
+            const auto& f = tb.ReadBuffer();
+            consistent = consistent && f.b == f.a * 3;
+            monotonic  = monotonic && f.a > last;
+            last = f.a;
+        }
+        else if (finished)
+        {
+            break;
+        }
+    }
+    writer.join();
+    REQUIRE(consistent);
+    REQUIRE(monotonic);
+    REQUIRE(tb.ReadBuffer().a == COUNT);
+}
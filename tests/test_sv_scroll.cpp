@@ -0,0 +1,125 @@
+// tests/test_sv_scroll.cpp — SV 滚动位置积分表（ScrollMap）单元测试
+
+#include "test_framework.h"
+
+#include "game/sv_scroll.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace sakura::game;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+SVPoint MakeSV(int time, float speed, const char* easing = "linear")
+{
+    SVPoint p;
+    p.time   = time;
+    p.speed  = speed;
+    p.easing = easing;
+    return p;
+}
+
+// 数值积分参考值（中点法，1µs 步长）
+double ReferencePosition(const ScrollMap& map, double from, double to)
+{
+    double sum = 0.0;
+    const double h = 0.001;
+    for (double t = from; t < to; t += h)
+        sum += map.SpeedAt(t + h * 0.5) * h;
+    return sum;
+}
+
+} // namespace
+
+TEST_CASE("无 SV 时滚动位置等于时间", "[sv]")
+{
+    ScrollMap map;
+    map.Build({});
+    REQUIRE(map.IsIdentity());
+    REQUIRE_THAT(map.PositionAt(1234.5), WithinAbs(1234.5, 1e-9));
+    REQUIRE_THAT(map.SpeedAt(500.0), WithinAbs(1.0, 1e-9));
+}
+
+TEST_CASE("step SV 积分为分段线性", "[sv]")
+{
+    const std::vector<SVPoint> sv = { MakeSV(1000, 2.0f, "step"), MakeSV(2000, 0.5f, "step") };
+    ScrollMap map;
+    map.Build(sv);
+
+    REQUIRE_THAT(map.PositionAt(500.0),  WithinAbs(500.0, 1e-9));    // 首个 SV 点前 1.0 倍速
+    REQUIRE_THAT(map.PositionAt(1500.0), WithinAbs(2000.0, 1e-9));   // 1000 + 500*2
+    REQUIRE_THAT(map.PositionAt(2000.0), WithinAbs(3000.0, 1e-9));
+    REQUIRE_THAT(map.PositionAt(3000.0), WithinAbs(3500.0, 1e-9));   // 之后 0.5 倍速
+    REQUIRE_THAT(map.SpeedAt(1999.0), WithinAbs(2.0, 1e-6));
+    REQUIRE_THAT(map.SpeedAt(2000.0), WithinAbs(0.5, 1e-6));
+}
+
+TEST_CASE("线性与缓动 SV 的积分与数值积分一致", "[sv]")
+{
+    const std::vector<SVPoint> sv = {
+        MakeSV(0,    1.0f, "linear"),
+        MakeSV(1000, 3.0f, "ease_in"),
+        MakeSV(2000, 1.0f, "ease_out_sine"),
+        MakeSV(3000, 2.0f, "step"),
+        MakeSV(4000, 2.0f),
+    };
+    ScrollMap map;
+    map.Build(sv);
+
+    // 线性段精确：∫₀¹⁰⁰⁰ (1 + 2t/1000) dt = 2000
+    REQUIRE_THAT(map.PositionAt(1000.0), WithinAbs(2000.0, 1e-6));
+    REQUIRE_THAT(map.SpeedAt(500.0), WithinAbs(2.0, 1e-6));
+
+    // 缓动段：速度连续、端点正确
+    REQUIRE_THAT(map.SpeedAt(1000.0), WithinAbs(3.0, 1e-6));
+    REQUIRE_THAT(map.SpeedAt(1999.999), WithinAbs(1.0, 1e-3));
+    REQUIRE(map.SpeedAt(1250.0) > 2.0);   // ease_in 前段下降缓慢
+
+    for (double t : { 250.0, 1250.0, 1750.0, 2500.0, 3500.0, 4500.0 })
+        REQUIRE_THAT(map.PositionAt(t), WithinAbs(ReferencePosition(map, 0.0, t), 0.05));
+
+    // 单调
+    double prev = map.PositionAt(-100.0);
+    for (double t = -99.0; t < 5000.0; t += 7.0)
+    {
+        const double p = map.PositionAt(t);
+        REQUIRE(p >= prev);
+        prev = p;
+    }
+}
+
+TEST_CASE("音符滚动位置缓存与逐个查询一致", "[sv]")
+{
+    std::vector<SVPoint> sv;
+    for (int i = 0; i < 300; ++i)
+        sv.push_back(MakeSV(i * 100, 0.5f + static_cast<float>(i % 7) * 0.25f,
+                            (i % 3 == 0) ? "ease_in_out" : (i % 3 == 1 ? "linear" : "step")));
+    ScrollMap map;
+    map.Build(sv);
+
+    std::vector<KeyboardNote> notes;
+    for (int i = 0; i < 200; ++i)
+    {
+        KeyboardNote n;
+        n.time = 37 + i * 149;
+        if (i % 5 == 0)
+        {
+            n.type     = NoteType::Hold;
+            n.duration = 333;
+        }
+        notes.push_back(n);
+    }
+
+    const auto pos = map.ComputeNotePositions(notes);
+    REQUIRE(pos.size() == notes.size());
+    for (size_t i = 0; i < notes.size(); ++i)
+    {
+        REQUIRE_THAT(pos[i].head, WithinAbs(map.PositionAt(notes[i].time), 1e-9));
+        const double tail = map.PositionAt(notes[i].time + notes[i].duration);
+        REQUIRE_THAT(pos[i].tail, WithinAbs(tail, 1e-9));
+        REQUIRE(pos[i].tail >= pos[i].head);
+    }
+}
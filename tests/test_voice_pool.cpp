@@ -0,0 +1,145 @@
+// tests/test_voice_pool.cpp — 预解码样本库与发声池（VoicePool）测试
+// 压力测试：主线程以 1000 次/秒触发 hitsound，音频线程按块混音
+
+#include "test_framework.h"
+
+#include "audio/voice_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace sakura::audio;
+using sakura::tests::Matchers::WithinAbs;
+
+namespace
+{
+
+PcmBuffer MakeConstant(size_t frames, uint32_t channels, float value)
+{
+    PcmBuffer b;
+    b.channels   = channels;
+    b.sampleRate = 48000;
+    b.samples.assign(frames * channels, value);
+    return b;
+}
+
+} // namespace
+
+TEST_CASE("SampleBank 按路径缓存样本且地址稳定", "[voice_pool]")
+{
+    SampleBank bank;
+    REQUIRE(bank.Find("a.wav") == nullptr);
+    const PcmBuffer* a = bank.Add("a.wav", MakeConstant(100, 2, 0.5f));
+    const PcmBuffer* b = bank.Add("b.wav", MakeConstant(10, 1, 0.25f));
+    for (int i = 0; i < 100; ++i)
+        bank.Add("filler_" + std::to_string(i), MakeConstant(1, 1, 0.0f));
+
+    REQUIRE(bank.Find("a.wav") == a);
+    REQUIRE(bank.Find("b.wav") == b);
+    REQUIRE(a->FrameCount() == 100);
+    REQUIRE(bank.GetCount() == 102);
+    REQUIRE(bank.GetTotalBytes() == (200 + 10 + 100) * sizeof(float));
+}
+
+TEST_CASE("VoicePool 混音叠加、单声道扩展且播完释放", "[voice_pool]")
+{
+    const PcmBuffer stereo = MakeConstant(64, 2, 0.25f);
+    const PcmBuffer mono   = MakeConstant(32, 1, 0.5f);
+
+    VoicePool pool;
+    pool.SetOutputChannels(2);
+    REQUIRE(pool.Trigger(&stereo, 1.0f));
+    REQUIRE(pool.Trigger(&mono, 0.5f));
+    REQUIRE(!pool.Trigger(nullptr));
+
+    std::vector<float> out(48 * 2, -1.0f);
+    pool.Mix(out.data(), 48);
+    REQUIRE_THAT(out[0],  WithinAbs(0.5, 1e-6));     // 0.25 + 0.5*0.5
+    REQUIRE_THAT(out[1],  WithinAbs(0.5, 1e-6));
+    REQUIRE_THAT(out[64], WithinAbs(0.25, 1e-6));    // 帧 32：单声道样本已播完
+    REQUIRE(pool.GetActiveVoices() == 1);
+
+    pool.Mix(out.data(), 48);
+    REQUIRE_THAT(out[0],  WithinAbs(0.25, 1e-6));
+    REQUIRE_THAT(out[40], WithinAbs(0.0, 1e-6));     // 帧 20：全部播完
+    REQUIRE(pool.GetActiveVoices() == 0);
+
+    // StopAll 同时取消已入队但未开始的命令
+    pool.Trigger(&stereo);
+    pool.StopAll();
+    pool.Mix(out.data(), 8);
+    REQUIRE_THAT(out[0], WithinAbs(0.0, 1e-6));
+    REQUIRE(pool.Trigger(&stereo));
+    pool.Mix(out.data(), 8);
+    REQUIRE_THAT(out[0], WithinAbs(0.25, 1e-6));
+}
+
+TEST_CASE("VoicePool 满载时抢占最早开始的发声", "[voice_pool]")
+{
+    // 每块 1ms（48 帧），每块触发一次，样本长 200ms：并发远超 MAX_VOICES
+    const PcmBuffer hit = MakeConstant(48 * 200, 2, 0.01f);
+    VoicePool pool;
+    pool.SetOutputChannels(2);
+
+    std::vector<float> out(48 * 2);
+    constexpr int HITS = 10000;   // 10 秒 @ 1000 次/秒
+    for (int i = 0; i < HITS; ++i)
+    {
+        REQUIRE(pool.Trigger(&hit));
+        pool.Mix(out.data(), 48);
+        REQUIRE(pool.GetActiveVoices() <= VoicePool::MAX_VOICES);
+    }
+    REQUIRE(pool.GetTriggeredCount() == HITS);
+    REQUIRE(pool.GetStolenCount() == HITS - VoicePool::MAX_VOICES);
+    REQUIRE(pool.GetDroppedCount() == 0);
+    // 满复音：输出 = 32 × 0.01
+    REQUIRE_THAT(out[0], WithinAbs(0.01 * VoicePool::MAX_VOICES, 1e-4));
+}
+
+TEST_CASE("VoicePool 压力测试：1000 次/秒触发，音频线程并发混音", "[voice_pool]")
+{
+    const PcmBuffer hit = MakeConstant(48 * 120, 2, 0.001f);   // 120ms
+    VoicePool pool;
+    pool.SetOutputChannels(2);
+
+    // 音频线程：每 5ms 混一块 240 帧（48kHz）
+    std::atomic<bool> running{ true };
+    std::atomic<uint64_t> blocks{ 0 };
+    float peak = 0.0f;
+    std::thread audio([&] {
+        std::vector<float> out(240 * 2);
+        auto next = std::chrono::steady_clock::now();
+        while (running.load(std::memory_order_acquire))
+        {
+            pool.Mix(out.data(), 240);
+            for (float v : out) peak = std::max(peak, std::fabs(v));
+            blocks.fetch_add(1, std::memory_order_relaxed);
+            next += std::chrono::milliseconds(5);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    // 主线程：1ms 一次触发，持续 1 秒
+    constexpr int HITS = 1000;
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < HITS; ++i)
+    {
+        pool.Trigger(&hit);
+        next += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    running.store(false, std::memory_order_release);
+    audio.join();
+
+    REQUIRE(blocks.load() > 100);
+    // 队列容量远大于单块内的触发数：无丢弃，全部开始发声
+    REQUIRE(pool.GetDroppedCount() == 0);
+    REQUIRE(pool.GetTriggeredCount() == HITS);
+    REQUIRE(pool.GetStolenCount() > 0);
+    REQUIRE(peak <= 0.001f * VoicePool::MAX_VOICES + 1e-5f);
+    REQUIRE(peak > 0.0f);
+}
@@ -0,0 +1,197 @@
+// tests/test_waveform_pyramid.cpp — 多分辨率波形金字塔：流式构建、逐步发布与 .skw 缓存
+
+#include "test_framework.h"
+
+#include "audio/waveform_pyramid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+using namespace sakura::audio;
+
+namespace
+{
+
+constexpr uint32_t RATE = WaveformPyramid::SAMPLE_RATE;
+
+// 振幅随时间线性增大的 440Hz 正弦
+std::vector<float> RisingTone(size_t count)
+{
+    std::vector<float> mono(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float t = static_cast<float>(i) / RATE;
+        const float amp = static_cast<float>(i) / static_cast<float>(count);
+        mono[i] = amp * std::sin(2.0f * std::numbers::pi_v<float> * 440.0f * t);
+    }
+    return mono;
+}
+
+size_t CeilDiv(size_t a, size_t b) { return (a + b - 1) / b; }
+
+} // namespace
+
+TEST_CASE("波形金字塔逐级合并 min / max / RMS 且与分块方式无关", "[waveform]")
+{
+    const size_t count = RATE * 3 + 1234;   // 3 秒多，尾部不足一个桶
+    const auto mono = RisingTone(count);
+
+    WaveformPyramid whole(count);
+    whole.Append(mono.data(), mono.size());
+    whole.Finish();
+
+    WaveformPyramid chunked(count);
+    for (size_t offset = 0; offset < count; offset += 37)
+        chunked.Append(mono.data() + offset, std::min<size_t>(37, count - offset));
+    chunked.Finish();
+
+    for (size_t level = 0; level < WaveformPyramid::LEVEL_COUNT; ++level)
+    {
+        const size_t expected = CeilDiv(count, WaveformPyramid::BASE_BUCKET_SAMPLES << level);
+        REQUIRE(whole.GetReadyCount(level) == expected);
+        REQUIRE(chunked.GetReadyCount(level) == expected);
+        for (size_t i = 0; i < expected; ++i)
+        {
+            const auto& a = whole.GetLevel(level)[i];
+            const auto& b = chunked.GetLevel(level)[i];
+            REQUIRE(a.min == b.min);
+            REQUIRE(a.max == b.max);
+            REQUIRE(a.rms == b.rms);
+        }
+    }
+
+    // 第 0 级：与直接计算一致
+    const size_t bucket = 1500;
+    const float* src = mono.data() + bucket * WaveformPyramid::BASE_BUCKET_SAMPLES;
+    float lo = src[0], hi = src[0];
+    double sumSq = 0.0;
+    for (size_t i = 0; i < WaveformPyramid::BASE_BUCKET_SAMPLES; ++i)
+    {
+        lo = std::min(lo, src[i]);
+        hi = std::max(hi, src[i]);
+        sumSq += static_cast<double>(src[i]) * src[i];
+    }
+    const auto& b0 = whole.GetLevel(0)[bucket];
+    REQUIRE(b0.min == static_cast<int8_t>(std::lround(lo * 127.0f)));
+    REQUIRE(b0.max == static_cast<int8_t>(std::lround(hi * 127.0f)));
+    REQUIRE(b0.rms == static_cast<uint8_t>(std::lround(std::sqrt(sumSq / WaveformPyramid::BASE_BUCKET_SAMPLES) * 255.0)));
+
+    // 父桶包络 = 子桶包络的并；RMS 为子桶能量平均（允许量化误差；跳过含尾部残桶的最后一对）
+    for (size_t level = 1; level < WaveformPyramid::LEVEL_COUNT; ++level)
+    {
+        const auto* parents  = whole.GetLevel(level);
+        const auto* children = whole.GetLevel(level - 1);
+        const size_t full = (whole.GetReadyCount(level - 1) - 1) / 2;
+        for (size_t i = 0; i < full; ++i)
+        {
+            const auto& c0 = children[2 * i];
+            const auto& c1 = children[2 * i + 1];
+            REQUIRE(parents[i].min == std::min(c0.min, c1.min));
+            REQUIRE(parents[i].max == std::max(c0.max, c1.max));
+            const double rms = std::sqrt((double(c0.rms) * c0.rms + double(c1.rms) * c1.rms) / 2.0);
+            REQUIRE(std::abs(parents[i].rms - rms) <= 1.0);
+        }
+    }
+    // 振幅递增：最粗一级的最后一个桶振幅最大
+    const size_t top = WaveformPyramid::LEVEL_COUNT - 1;
+    REQUIRE(whole.GetLevel(top)[whole.GetReadyCount(top) - 1].max > whole.GetLevel(top)[0].max);
+}
+
+TEST_CASE("波形金字塔按桶逐步发布，层级按缩放选择", "[waveform]")
+{
+    REQUIRE(WaveformPyramid::ChooseLevel(0.3) == 0);
+    REQUIRE(WaveformPyramid::ChooseLevel(1.0) == 0);
+    REQUIRE(WaveformPyramid::ChooseLevel(2.0) == 1);
+    REQUIRE(WaveformPyramid::ChooseLevel(7.9) == 2);
+    REQUIRE(WaveformPyramid::ChooseLevel(1e6) == WaveformPyramid::LEVEL_COUNT - 1);
+    REQUIRE(WaveformPyramid::GetBucketMs(WaveformPyramid::LEVEL_COUNT - 1) == 1024);
+
+    // 写入线程分块追加；读者看到的就绪计数单调不减，已就绪的桶内容不再变化
+    const size_t count = RATE * 20;
+    const auto mono = RisingTone(count);
+    WaveformPyramid pyramid(count);
+    REQUIRE(pyramid.GetReadyCount(0) == 0);
+    REQUIRE(pyramid.GetProgress() == 0.0f);
+
+    std::thread writer([&] {
+        for (size_t offset = 0; offset < count; offset += 4096)
+            pyramid.Append(mono.data() + offset, std::min<size_t>(4096, count - offset));
+        pyramid.Finish();
+    });
+
+    bool monotonic = true;
+    bool sawPartial = false;
+    size_t lastReady = 0;
+    std::vector<int8_t> seenMax;
+    while (!pyramid.IsComplete())
+    {
+        const size_t ready = pyramid.GetReadyCount(0);
+        monotonic = monotonic && ready >= lastReady;
+        sawPartial = sawPartial || (ready > 0 && ready < pyramid.GetBucketCount(0));
+        for (size_t i = lastReady; i < ready; ++i)
+            seenMax.push_back(pyramid.GetLevel(0)[i].max);
+        lastReady = ready;
+    }
+    writer.join();
+
+    REQUIRE(monotonic);
+    REQUIRE(pyramid.GetProgress() == 1.0f);
+    REQUIRE(pyramid.GetReadyCount(0) == pyramid.GetBucketCount(0));
+    bool stable = true;
+    for (size_t i = 0; i < seenMax.size(); ++i)
+        stable = stable && seenMax[i] == pyramid.GetLevel(0)[i].max;
+    REQUIRE(stable);
+    (void)sawPartial;   // 是否观察到中间状态取决于调度，不作要求
+}
+
+TEST_CASE("波形缓存往返，音频指纹不符或截断时拒绝", "[waveform]")
+{
+    const auto dir = std::filesystem::temp_directory_path() / "sakura-waveform-pyramid";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const auto cachePath = WaveformPyramid::GetCachePath((dir / "song.ogg").string());
+    REQUIRE(std::filesystem::path(cachePath).filename() == "song.skw");
+
+    // 预估长度大于实际解码长度（解码器给出的长度不精确时）
+    const size_t actual = RATE * 2 + 77;
+    const auto mono = RisingTone(actual);
+    WaveformPyramid built(actual + RATE);
+    built.Append(mono.data(), mono.size());
+    sakura::game::ChartSourceStamp stamp{ 123456789, 4242, 0 };
+    REQUIRE(!built.Write(cachePath, stamp));   // 未完成不写入
+    built.Finish();
+    REQUIRE(built.Write(cachePath, stamp));
+
+    auto loaded = WaveformPyramid::Read(cachePath, stamp);
+    REQUIRE(loaded != nullptr);
+    REQUIRE(loaded->IsComplete());
+    REQUIRE(loaded->GetTotalSamples() == actual);
+    for (size_t level = 0; level < WaveformPyramid::LEVEL_COUNT; ++level)
+    {
+        REQUIRE(loaded->GetReadyCount(level) == built.GetReadyCount(level));
+        REQUIRE(loaded->GetBucketCount(level) == loaded->GetReadyCount(level));
+        for (size_t i = 0; i < loaded->GetReadyCount(level); ++i)
+        {
+            REQUIRE(loaded->GetLevel(level)[i].max == built.GetLevel(level)[i].max);
+            REQUIRE(loaded->GetLevel(level)[i].rms == built.GetLevel(level)[i].rms);
+        }
+    }
+
+    sakura::game::ChartSourceStamp touched = stamp;
+    touched.mtime += 1;
+    REQUIRE(WaveformPyramid::Read(cachePath, touched) == nullptr);
+    touched = stamp;
+    touched.size += 1;
+    REQUIRE(WaveformPyramid::Read(cachePath, touched) == nullptr);
+
+    std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 4);
+    REQUIRE(WaveformPyramid::Read(cachePath, stamp) == nullptr);
+    REQUIRE(WaveformPyramid::Read((dir / "missing.skw").string(), stamp) == nullptr);
+
+    std::filesystem::remove_all(dir);
+}